@@ -71,7 +71,7 @@ struct t_conv1 : Benchmark_base
 
     conv_type conv(coeff, Domain<1>(size), Dec);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       conv(in, out);
     time = t1.elapsed();
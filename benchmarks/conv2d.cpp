@@ -83,7 +83,7 @@ struct t_conv2d : Benchmark_base
 
     conv_type conv(coeff, Domain<2>(rows_, cols), rdec);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       conv(in, out);
     time = t1.elapsed();
@@ -68,7 +68,7 @@ struct t_vcopy<T, SrcMapT, DstMapT, Impl_assign> : Benchmark_base
     if (pre_sync_)
       barrier();
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = A;
     time = t1.elapsed();
@@ -145,7 +145,7 @@ struct t_vcopy<T, SrcMapT, DstMapT, Impl_pa<ParAssignImpl> > : Benchmark_base
     if (pre_sync_)
       barrier();
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       cpa();
@@ -205,7 +205,7 @@ struct t_vcopy<T, SrcMapT, DstMapT, Impl_pa_na<ParAssignImpl> >
     if (pre_sync_)
       barrier();
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       ovxx::parallel::Assignment<dim, dst_block_t, src_block_t, ParAssignImpl>
@@ -267,7 +267,7 @@ struct t_vcopy<T, Local_map, Local_map, Impl_memcpy> : Benchmark_base
       dda::Data<src_block_t, dda::in> src_ext(A.block());
       dda::Data<dst_block_t, dda::out> dst_ext(Z.block());
     
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	std::memcpy(dst_ext.ptr(), src_ext.ptr(), size*sizeof(T));
       time = t1.elapsed();
@@ -52,7 +52,7 @@ struct t_corr1 : Benchmark_base
 
     corr_type corr((Domain<1>(ref_size_)), Domain<1>(size));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
      corr(bias_, ref, in, out);
     time = t1.elapsed();
@@ -122,7 +122,7 @@ struct t_corr2 : Benchmark_base
 
     corr_type corr((Domain<1>(ref_size_)), Domain<1>(size));
 
-    timer t1;
+    bench_timer t1;
     
     for (index_type l=0; l<loop; ++l)
      corr.correlate(bias_, ref, in, out);
@@ -124,7 +124,7 @@ struct t_dist_vmul<T, MapT, SP, Impl_assign> : Benchmark_base
 
     SP sp;
     
-    timer t1;
+    bench_timer t1;
     sp.sync();
     for (index_type l=0; l<loop; ++l)
     {
@@ -49,7 +49,7 @@ struct t_dot1 : Benchmark_base
     A(0) = T(3);
     B(0) = T(4);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       r = dot(A, B);
     time = t1.elapsed();
@@ -116,7 +116,7 @@ struct t_dot2 : Benchmark_base
 
     assert(Eval::ct_valid);
   
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       r = Eval::exec(A.block(), B.block());
     time = t1.elapsed();
@@ -85,7 +85,7 @@ struct t_vam : Benchmark_base
     Vector<T> C(size, T(5));
     Vector<T>        X(size, T(0));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       X = (A + B) * C;
     time = t1.elapsed();
@@ -127,7 +127,7 @@ struct t_vam_fcn : Benchmark_base
     Vector<T> C(size, T(5));
     Vector<T>        X(size, T(0));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
 //    X = (A + B) * C;
       X = am(A, B, C);
@@ -173,7 +173,7 @@ struct t_vam_nonfused : Benchmark_base
     Vector<T>        tmp(size, T(0));
     Vector<T>        X(size, T(0));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       tmp = A + B;
@@ -226,7 +226,7 @@ struct t_vam_ip : Benchmark_base
     Vector<TB> B(size, TB(0));
     Vector<T>         X(size, T(5));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       X *= A + B;
     time = t1.elapsed();
@@ -279,7 +279,7 @@ struct t_vam_ip_nonfused : Benchmark_base
     Vector<T>         tmp(size, T(0));
     Vector<T>         X(size, T(5));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       tmp = A + B;
@@ -331,7 +331,7 @@ struct t_vam_cSC : Benchmark_base
     Vector<complex<T> > C(size, complex<T>(5, 0));
     Vector<complex<T> > X(size, complex<T>(0, 0));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       X = (a + B) * C;
     time = t1.elapsed();
@@ -41,7 +41,7 @@ struct t_vatan1 : Benchmark_base
     Rand<T> gen(0, 0);
     A = gen.randu(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = atan(A);
     time = t1.elapsed();
@@ -86,7 +86,7 @@ struct t_vatan21 : Benchmark_base
     A = gen.randu(size);
     B = gen.randu(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = atan2(B,A);
     time = t1.elapsed();
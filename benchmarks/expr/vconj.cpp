@@ -43,7 +43,7 @@ struct t_vconjugate1 : Benchmark_base
 
     A.put(0, T(4,5));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = conj(A);
     time = t1.elapsed();
@@ -98,7 +98,7 @@ struct t_vconjugate2 : Benchmark_base
 
     A.put(0, T(4,5));
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = conj(A);
     time = t1.elapsed();
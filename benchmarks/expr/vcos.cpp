@@ -41,7 +41,7 @@ struct t_vcos1 : Benchmark_base
     Rand<T> gen(0, 0);
     A = gen.randu(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = cos(A);
     time = t1.elapsed();
@@ -84,7 +84,7 @@ struct t_vsin1 : Benchmark_base
     Rand<T> gen(0, 0);
     A = gen.randu(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = sin(A);
     time = t1.elapsed();
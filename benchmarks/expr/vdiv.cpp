@@ -46,7 +46,7 @@ struct t_vdiv1 : Benchmark_base
     A.put(0, T(6));
     B.put(0, T(3));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = A / B;
     time = t1.elapsed();
@@ -111,7 +111,7 @@ struct t_vdiv_ip1 : Benchmark_base
     chk = gen.randu(size);
     C = chk;
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C /= A;
     time = t1.elapsed();
@@ -147,7 +147,7 @@ struct t_vdiv_dom1 : Benchmark_base
 
     Domain<1> dom(size);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C(dom) = A(dom) / B(dom);
     time = t1.elapsed();
@@ -186,7 +186,7 @@ struct t_vdiv2 : Benchmark_base
     A.put(0, T(6));
     B.put(0, T(3));
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = A / B;
     time = t1.elapsed();
@@ -226,7 +226,7 @@ struct t_rcvdiv1 : Benchmark_base
     A = cgen.randu(size);
     B = sgen.randu(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = B / A;
     time = t1.elapsed();
@@ -262,7 +262,7 @@ struct t_svdiv1 : Benchmark_base
 
     ScalarT alpha = ScalarT(3);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = alpha / A;
     time = t1.elapsed();
@@ -294,7 +294,7 @@ struct t_svdiv2 : Benchmark_base
 
     A.put(0, T(6));
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = A / alpha;
     time = t1.elapsed();
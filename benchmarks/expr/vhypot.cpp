@@ -43,7 +43,7 @@ struct t_vhypot1 : Benchmark_base
     A = gen.randu(size);
     B = gen.randu(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = hypot(B,A);
     time = t1.elapsed();
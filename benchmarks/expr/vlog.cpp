@@ -41,7 +41,7 @@ struct t_vlog1 : Benchmark_base
     Rand<T> gen(0, 0);
     A = gen.randu(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = log(A);
     time = t1.elapsed();
@@ -91,7 +91,7 @@ struct t_vlog101 : Benchmark_base
     Rand<T> gen(0, 0);
     A = gen.randu(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = log10(A);
     time = t1.elapsed();
@@ -52,7 +52,7 @@ struct t_vmagsq1 : Benchmark_base
 
     A.put(0, T(3));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = magsq(A);
     time = t1.elapsed();
@@ -101,7 +101,7 @@ struct t_vmag1 : Benchmark_base
 
     A.put(0, T(3));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = mag(A);
     time = t1.elapsed();
@@ -152,7 +152,7 @@ struct t_vmag_dense_mat : Benchmark_base
 
     A.put(0, 0, T(3));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = mag(A);
     time = t1.elapsed();
@@ -207,7 +207,7 @@ struct t_vmag_nondense_mat : Benchmark_base
 
     A.put(0, 0, T(3));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = mag(A);
     time = t1.elapsed();
@@ -43,7 +43,7 @@ struct t_vminus1 : Benchmark_base
 
     A.put(0, T(16));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = -A;
     time = t1.elapsed();
@@ -96,7 +96,7 @@ struct t_vminus2 : Benchmark_base
 
     A.put(0, T(3));
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = -A;
     time = t1.elapsed();
@@ -103,7 +103,7 @@ struct t_vmul1_nonglobal : Benchmark_base
     A.put(0, T(3));
     B.put(0, T(4));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = A * B;
     time = t1.elapsed();
@@ -151,7 +151,7 @@ struct t_vmul1 : Benchmark_base
 
     SP sp;
     
-    timer t1;
+    bench_timer t1;
     sp.sync();
     for (index_type l=0; l<loop; ++l)
       C = A * B;
@@ -215,7 +215,7 @@ struct t_vmul_func : Benchmark_base
 
     SP sp;
     
-    timer t1;
+    bench_timer t1;
     sp.sync();
     for (index_type l=0; l<loop; ++l)
       C = mul(A, B);
@@ -277,7 +277,7 @@ struct t_vmul1_local : Benchmark_base
 
     SP sp;
     
-    timer t1;
+    bench_timer t1;
     sp.sync();
     for (index_type l=0; l<loop; ++l)
       C.local() = A.local() * B.local();
@@ -324,7 +324,7 @@ struct t_vmul1_early_local : Benchmark_base
 
     SP sp;
     
-    timer t1;
+    bench_timer t1;
     typename Vector<T, block_type>::local_type A_local = A.local();
     typename Vector<T, block_type>::local_type B_local = B.local();
     typename Vector<T, block_type>::local_type C_local = C.local();
@@ -367,7 +367,7 @@ struct t_vmul_gp : Benchmark_base
     A.put(0, T(3));
     B.put(0, T(4));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       for (index_type i=0; i<size; ++i)
 	C.put(i, A.get(i) * B.get(i));
@@ -399,7 +399,7 @@ struct t_vmul_ip1 : Benchmark_base
     chk = gen.randu(size);
     C = chk;
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C *= A;
     time = t1.elapsed();
@@ -445,7 +445,7 @@ struct t_vmul_dom1 : Benchmark_base
 
     Domain<1> dom(size);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C(dom) = A(dom) * B(dom);
     time = t1.elapsed();
@@ -480,7 +480,7 @@ struct t_vmul2 : Benchmark_base
     A.put(0, T(3));
     B.put(0, T(4));
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = A * B;
     time = t1.elapsed();
@@ -527,7 +527,7 @@ struct t_rcvmul1 : Benchmark_base
     A = cgen.randu(size);
     B = sgen.randu(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = B * A;
     time = t1.elapsed();
@@ -579,7 +579,7 @@ struct t_svmul1 : Benchmark_base
     A = gen.randu(size);
     A.put(0, T(4));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = alpha * A;
     time = t1.elapsed();
@@ -633,7 +633,7 @@ struct t_svmul_dom : Benchmark_base
 
     Domain<1> dom(size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C(dom) = alpha * A(dom);
     time = t1.elapsed();
@@ -688,7 +688,7 @@ struct t_svmul_cc : Benchmark_base
     A = gen.randu(rows, size);
     A.put(0, 0, T(4));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C.row(l%rows) = alpha * A.row(l%rows);
     time = t1.elapsed();
@@ -736,7 +736,7 @@ struct t_svmul3 : Benchmark_base
 
     A.put(0, T(4));
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = 3.f * A;
     time = t1.elapsed();
@@ -791,7 +791,7 @@ struct t_svmul4 : Benchmark_base
 
     T alpha;
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       alpha = K.get(1);
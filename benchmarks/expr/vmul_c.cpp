@@ -85,7 +85,7 @@ struct t_vmul1 : Benchmark_base
       T const * pb = data_b.ptr();
       T* pc = data_c.ptr();
     
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
       {
 	for (index_type j=0; j<size; ++j)
@@ -139,7 +139,7 @@ struct t_vmul2 : Benchmark_base
       T const * pb = data_b.ptr();
       T* pc = data_c.ptr();
     
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	vmul(size, pa, pb, pc);
       time = t1.elapsed();
@@ -188,7 +188,7 @@ struct t_svmul1 : Benchmark_base
       T const * pa = data_a.ptr();
       T* pc = data_c.ptr();
     
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	svmul(size, alpha, pa, pc);
       time = t1.elapsed();
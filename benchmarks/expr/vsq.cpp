@@ -43,7 +43,7 @@ struct t_vsquare1 : Benchmark_base
 
     A.put(0, T(4));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = sq(A);
     time = t1.elapsed();
@@ -96,7 +96,7 @@ struct t_vsquare2 : Benchmark_base
 
     A.put(0, T(4));
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = sq(A);
     time = t1.elapsed();
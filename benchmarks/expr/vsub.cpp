@@ -51,7 +51,7 @@ struct t_vsub1_nonglobal : Benchmark_base
     A.put(0, T(3));
     B.put(0, T(4));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       C = A - B;
     time = t1.elapsed();
@@ -96,7 +96,7 @@ struct t_fastconv_base<T, Impl1op> : fastconv_ops
     // frequency domain
     // for_fft(replica);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       // Perform fast convolution:
@@ -150,7 +150,7 @@ struct t_fastconv_base<T, Impl1ip> : fastconv_ops
     // for_fft(replica);
     
     // Impl1 ip
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       // Perform fast convolution:
@@ -205,7 +205,7 @@ struct t_fastconv_base<T, Impl1pip1> : fastconv_ops
     // for_fft(replica);
     
     // Impl1 pip
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       // Perform fast convolution:
@@ -279,7 +279,7 @@ struct t_fastconv_base<T, Impl1pip2> : fastconv_ops
     // for_fft(replica);
     
     // Impl1 pip2
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       length_type l_npulse  = data.local().size(0);
@@ -336,7 +336,7 @@ struct t_fastconv_base<T, Impl1pip2_nopar> : fastconv_ops
     // for_fft(replica);
     
     // Impl1 pip2
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       for (index_type p=0; p<npulse; ++p)
@@ -416,7 +416,7 @@ struct t_fastconv_base<T, Impl2op> : fastconv_ops
     // frequency domain
     // for_fft(replica);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       length_type l_npulse  = data.local().size(0);
@@ -511,7 +511,7 @@ struct t_fastconv_base<T, Impl2ip> : fastconv_ops
     // frequency domain
     // for_fft(replica);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       length_type l_npulse  = data.local().size(0);
@@ -606,7 +606,7 @@ struct t_fastconv_base<T, Impl2ip_tmp> : fastconv_ops
     // frequency domain
     // for_fft(replica);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       length_type l_npulse  = data.local().size(0);
@@ -718,7 +718,7 @@ struct t_fastconv_base<T, Impl3> : fastconv_ops
     // frequency domain
     // for_fft(replica);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       // Perform fast convolution:
@@ -794,7 +794,7 @@ struct t_fastconv_base<T, Impl4vc> : fastconv_ops
     // frequency domain
     // for_fft(replica);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       data = inv_fftm(vmmul<0>(replica, for_fftm(data)));
@@ -911,7 +911,7 @@ struct t_fastconv_base<T, Impl4mc> : fastconv_ops
     // frequency domain
     // for_fft(replica);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       data = inv_fftm(replica * for_fftm(data));
@@ -15,10 +15,13 @@
 #include <vsip/support.hpp>
 #include <vsip/math.hpp>
 #include <vsip/signal.hpp>
+#include <ovxx/signal/fft.hpp>
 #include "benchmark.hpp"
 
 using namespace vsip;
 
+namespace be = ovxx::dispatcher::be;
+
 
 float
 fft_ops(length_type len)
@@ -54,7 +57,7 @@ struct t_fft_op : Benchmark_base
 
     A = T(1);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       fft(A, Z);
     time = t1.elapsed();
@@ -111,7 +114,7 @@ struct t_fft_ip : Benchmark_base
 
     fft_type fft(Domain<1>(size), scale_ ? (1.f/size) : 1.f);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       fft(A);
     time = t1.elapsed();
@@ -157,7 +160,7 @@ struct t_fft_bv : Benchmark_base
 
     A = T(1);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = fft(A);
     time = t1.elapsed();
@@ -173,6 +176,50 @@ struct t_fft_bv : Benchmark_base
 
 
 
+/***********************************************************************
+  Fft, out-of-place, with a given backend
+***********************************************************************/
+
+/// The FFT backend to use, for comparing backends with each other.
+template <typename B> struct fft_backend_name;
+template <> struct fft_backend_name<be::builtin> { static char const *name() { return "builtin";}};
+template <> struct fft_backend_name<be::fftw> { static char const *name() { return "fftw";}};
+template <> struct fft_backend_name<be::generic> { static char const *name() { return "dft";}};
+
+template <typename T, typename B>
+struct t_fft_be : Benchmark_base
+{
+  typedef typename ovxx::dispatcher::make_type_list<B>::type list_type;
+  typedef ovxx::signal::Fft<1, T, T, list_type, fft_fwd, by_reference> fft_type;
+
+  char const* what() { return fft_backend_name<B>::name();}
+  float ops_per_point(length_type len)  { return fft_ops(len); }
+  int riob_per_point(length_type) { return -1*(int)sizeof(T); }
+  int wiob_per_point(length_type) { return -1*(int)sizeof(T); }
+  int mem_per_point(length_type)  { return 2*sizeof(T); }
+
+  void operator()(length_type size, length_type loop, float& time)
+  {
+    Vector<T>   A(size, T(1));
+    Vector<T>   Z(size);
+
+    fft_type fft(Domain<1>(size), 1.f);
+
+    bench_timer t1;
+    for (index_type l=0; l<loop; ++l)
+      fft(A, Z);
+    time = t1.elapsed();
+
+    if (!equal(Z.get(0), T(size)))
+    {
+      std::cout << "t_fft_be: ERROR" << std::endl;
+      abort();
+    }
+  }
+};
+
+
+
 void
 defaults(Loop1P& loop)
 {
@@ -238,6 +285,19 @@ benchmark(Loop1P& loop, int what)
   case 127: loop(t_fft_bv<complex<double>, patient>(true)); break;
 #endif
 
+  // Backend comparison. Only the backends built into the library
+  // are available.
+#if OVXX_BUILTIN_FFT
+  case  31: loop(t_fft_be<complex<float>, be::builtin>()); break;
+  case 131: loop(t_fft_be<complex<double>, be::builtin>()); break;
+#endif
+#if OVXX_FFTW
+  case  32: loop(t_fft_be<complex<float>, be::fftw>()); break;
+  case 132: loop(t_fft_be<complex<double>, be::fftw>()); break;
+#endif
+  case  33: loop(t_fft_be<complex<float>, be::generic>()); break;
+  case 133: loop(t_fft_be<complex<double>, be::generic>()); break;
+
   case 0:
     std::cout
       << "fft -- Fft (fast fourier transform)\n"
@@ -266,6 +326,13 @@ benchmark(Loop1P& loop, int what)
 #else
       << "Double precision FFT support not provided by library\n"
 #endif
+      << "\nBackend comparison (out-of-place CC fwd fft):\n"
+      << "  -31 -- builtin (single precision)\n"
+      << "  -32 -- fftw    (single precision)\n"
+      << "  -33 -- dft     (single precision)\n"
+      << " -131 -- builtin (double precision)\n"
+      << " -132 -- fftw    (double precision)\n"
+      << " -133 -- dft     (double precision)\n"
       ;
 
   default: return 0;
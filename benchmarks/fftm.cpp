@@ -91,7 +91,7 @@ struct t_fftm<T, Impl_op, SD> : Benchmark_base
     //  compensate for large Fftm sizes.
     fftm(A, Z);
  
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       fftm(A, Z);
     time = t1.elapsed();
@@ -166,7 +166,7 @@ struct t_fftm<T, Impl_ip, SD> : Benchmark_base
     //  compensate for large Fftm sizes.
     fftm(A);
  
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       fftm(A);
     time = t1.elapsed();
@@ -225,7 +225,7 @@ struct t_fftm<T, Impl_pop, SD> : Benchmark_base
     
     if (SD == row)
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<rows; ++i)
 	{
@@ -235,7 +235,7 @@ struct t_fftm<T, Impl_pop, SD> : Benchmark_base
     }
     else
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<cols; ++i)
 	{
@@ -294,7 +294,7 @@ struct t_fftm<T, Impl_pip1, SD> : Benchmark_base
     
     if (SD == row)
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<rows; ++i)
 	  fft(A.row(i));
@@ -306,7 +306,7 @@ struct t_fftm<T, Impl_pip1, SD> : Benchmark_base
     }
     else
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<cols; ++i)
 	  fft(A.col(i));
@@ -368,7 +368,7 @@ struct t_fftm<T, Impl_pip2, SD> : Benchmark_base
     
     if (SD == row)
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<rows; ++i)
 	{
@@ -386,7 +386,7 @@ struct t_fftm<T, Impl_pip2, SD> : Benchmark_base
     }
     else
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<cols; ++i)
 	{
@@ -459,7 +459,7 @@ struct t_fftm<T, Impl_bv, SD> : Benchmark_base
     //  compensate for large Fftm sizes.
     Z = fftm(A);
  
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = fftm(A);
     time = t1.elapsed();
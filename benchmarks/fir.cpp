@@ -61,7 +61,7 @@ struct t_fir1 : Benchmark_base
 
     in = ramp<T>(0, 1, size);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       fir(in, out);
     time = t1.elapsed();
@@ -143,7 +143,7 @@ struct t_fir2 : Benchmark_base
     Vector<T>   in (total_size_, T());
     Vector<T>   out(total_size_);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       for (index_type pos=0; pos<total_size_; pos += block_size)
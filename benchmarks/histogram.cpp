@@ -35,7 +35,7 @@ struct t_hist : Benchmark_base
     Vector<T> in = rgen.randu(size);
     Vector<int> hist(coeff_size_);
     Histogram<const_Vector, T> h(0, 1, coeff_size_);
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       hist = h(in);
     time = t1.elapsed();
@@ -18,6 +18,9 @@
 
 #include <vsip/vector.hpp>
 #include <vsip/math.hpp>
+#include <ovxx/profile.hpp>
+#include "report.hpp"
+#include "perf.hpp"
 #if OVXX_PARALLEL_API == 1
 # include <vsip/parallel.hpp>
 #endif
@@ -102,7 +105,13 @@ public:
     mode_        (sweep_mode),
     m_array_     (),
     param_       (),
-    allocator_   (0)
+    allocator_   (0),
+    format_      (text_report),
+    output_      (0),
+    compare_     (0),
+    tolerance_   (0.05),
+    regressions_ (0),
+    perf_        (false)
   {}
 
   template <typename Functor>
@@ -127,6 +136,14 @@ public:
   unsigned
   m_value(unsigned i);
 
+  template <typename Functor>
+  bench_result
+  result(Functor& fcn, std::size_t M, std::size_t L, std::size_t loop,
+	 std::vector<float> const& mtime);
+
+  template <typename Functor>
+  void report(Functor& fcn);
+
   // Member data.
 public:
   unsigned	start_;		// loop start "i-value"
@@ -152,6 +169,13 @@ public:
   std::vector<unsigned> m_array_;
   std::map<std::string, std::string> param_;
   ovxx::allocator *allocator_;
+  report_format format_;	// machine-readable report format
+  char const*   output_;	// report file (stdout if 0)
+  char const*   compare_;	// baseline to compare against (JSON report)
+  double        tolerance_;	// slowdown tolerated by the comparison
+  int           regressions_;	// regressions found by the comparison
+  std::vector<bench_result> results_;
+  bool          perf_;		// report hardware counters
 };
 
 
@@ -302,14 +326,19 @@ Loop1P::sweep(Functor fcn)
     } while (factor >= factor_thresh && loop > old_loop);
   }
 
-  if (proc == 0)
+  // A report written to stdout replaces the text output.
+  bool const text = format_ == text_report || output_;
+
+  if (proc == 0 && text)
   {
     if (metric_ == data_per_sec)
     {
       std::cout << "what," << fcn.what() << "," << what_ << std::endl;
       std::cout << "nproc," << nproc << std::endl;
-      std::cout << "size,med,min,max,mem/pt,ops/pt,riob/pt,wiob/pt,loop,time"
-		<< std::endl;
+      std::cout << "size,med,min,max,mem/pt,ops/pt,riob/pt,wiob/pt,loop,time";
+      if (perf_)
+	std::cout << ",cycles/pt,instructions/pt,ipc,llc_misses/pt,dtlb_misses/pt,llc_mbyte/s";
+      std::cout << std::endl;
     }
     else
     {
@@ -330,6 +359,9 @@ Loop1P::sweep(Functor fcn)
     if (this->note_)
       std::cout << "# note: " << this->note_ << '\n';
     std::cout << "# start_loop       : " << static_cast<unsigned long>(loop) << '\n';
+    if (perf_)
+      std::cout << "# perf columns     : cycles/pt instructions/pt ipc llc_misses/pt"
+		<< " dtlb_misses/pt llc_mbyte/s\n";
     }
   }
 
@@ -338,6 +370,8 @@ Loop1P::sweep(Functor fcn)
   {
     M = this->m_value(i);
 
+    if (perf_) perf_counters::instance().clear();
+
     for (unsigned j=0; j<n_time; ++j)
     {
       barrier();
@@ -359,16 +393,29 @@ Loop1P::sweep(Functor fcn)
 
     std::sort(mtime.begin(), mtime.end());
 
+    perf_metrics_type counters;
+    if (perf_)
+    {
+      double seconds = 0.;
+      for (unsigned j=0; j<n_time; ++j) seconds += mtime[j];
+      counters = perf_metrics((double)M * loop * n_time, seconds);
+    }
+
+    std::size_t L;
+    if (this->lhs_ == lhs_mem)
+      L = M * fcn.mem_per_point(M);
+    else // (this->lhs_ == lhs_pts)
+      L = M;
 
-    if (proc == 0)
+    if (format_ != text_report || compare_)
     {
-      std::size_t L;
-      
-      if (this->lhs_ == lhs_mem)
-	L = M * fcn.mem_per_point(M);
-      else // (this->lhs_ == lhs_pts)
-	L = M;
+      bench_result r = this->result(fcn, M, L, loop, mtime);
+      r.counters = counters;
+      if (proc == 0) results_.push_back(r);
+    }
 
+    if (proc == 0 && text)
+    {
       if (this->metric_ == all_per_sec)
 	std::cout << L << ' '
 		  << this->metric(fcn, M, loop, mtime[(n_time-1)/2], pts_per_sec) << ' '
@@ -398,6 +445,14 @@ Loop1P::sweep(Functor fcn)
 	std::cout << "  " << loop;
       if (this->show_time_)
 	std::cout << "  " << mtime[(n_time-1)/2];
+      if (this->metric_ == data_per_sec)
+	for (std::size_t c = 0; c != counters.size(); ++c)
+	{
+	  std::cout << ',';
+	  if (counters[c].second >= 0.) std::cout << counters[c].second;
+	}
+      else
+	write_perf_metrics(std::cout, counters);
       std::cout << std::endl;
     }
 
@@ -415,6 +470,8 @@ Loop1P::sweep(Functor fcn)
       if (loop < 1) loop = 1;
     }
   }
+
+  if (proc == 0) this->report(fcn);
 }
 
 
@@ -460,6 +517,9 @@ Loop1P::steady(Functor fcn)
     if (this->note_)
       std::cout << "# note: " << this->note_ << '\n';
     std::cout << "# start_loop       : " << static_cast<unsigned long>(loop) << '\n';
+    if (perf_)
+      std::cout << "# perf columns     : cycles/pt instructions/pt ipc llc_misses/pt"
+		<< " dtlb_misses/pt llc_mbyte/s\n";
   }
 
   // for real ---------------------------------------------------------
@@ -467,6 +527,8 @@ Loop1P::steady(Functor fcn)
   {
     M = (1 << start_);
 
+    if (perf_) perf_counters::instance().clear();
+
     barrier();
     {
       allocator *cur_allocator = ovxx::allocator::get_default();
@@ -483,6 +545,9 @@ Loop1P::steady(Functor fcn)
 
     time = maxval(glob_time.local(), idx);
 
+    perf_metrics_type counters;
+    if (perf_) counters = perf_metrics((double)M * loop, time);
+
     if (proc == 0)
     {
       if (this->metric_ == all_per_sec)
@@ -497,6 +562,7 @@ Loop1P::steady(Functor fcn)
 	std::cout << "  " << loop;
       if (this->show_time_)
 	std::cout << "  " << time;
+      write_perf_metrics(std::cout, counters);
       std::cout << std::endl;
     }
 
@@ -566,6 +632,7 @@ Loop1P::single(Functor fcn)
     } while (factor >= factor_thresh && loop > old_loop);
   }
   barrier();
+  if (perf_) perf_counters::instance().clear();
   ovxx::allocator *cur_allocator = ovxx::allocator::get_default();
   if (allocator_) ovxx::allocator::set_default(allocator_);
   fcn(M, loop, time);
@@ -579,17 +646,114 @@ Loop1P::single(Functor fcn)
 
   time = maxval(glob_time.local(), idx);
 
-  if (proc == 0)
+  perf_metrics_type counters;
+  if (perf_) counters = perf_metrics((double)M * loop, time);
+
+  if (format_ != text_report || compare_)
+  {
+    bench_result r = this->result(fcn, M, M, loop, std::vector<float>(1, time));
+    r.counters = counters;
+    if (proc == 0) results_.push_back(r);
+  }
+
+  if (proc == 0 && (format_ == text_report || output_))
   {
     std::cout << M << ", " 
 	      << this->metric(fcn, M, loop, time, ops_per_sec) << ", "
 	      << loop << ", "
-	      << time * 1e6 / loop << std::endl;
+	      << time * 1e6 / loop;
+    write_perf_metrics(std::cout, counters);
+    std::cout << std::endl;
   }
+
+  if (proc == 0) this->report(fcn);
 }
 
 
 
+// Collect the samples (times for `loop` calls, sorted) measured
+// for size `M` into a result.
+template <typename Functor>
+inline bench_result
+Loop1P::result(Functor& fcn, std::size_t M, std::size_t L, std::size_t loop,
+	       std::vector<float> const& mtime)
+{
+  bench_result r;
+  r.size = L;
+  r.loop = loop;
+  for (std::size_t i = 0; i != mtime.size(); ++i)
+    r.times.push_back(mtime[i] / loop);
+  double const median = percentile(r.times, 50.);
+  int const ops = fcn.ops_per_point(M);
+  int const riob = fcn.riob_per_point(M);
+  int const wiob = fcn.wiob_per_point(M);
+  r.mpts_per_sec = M / (median * 1e6);
+  r.mflop_per_sec = ops < 0 ? -1. : (double)M * ops / (median * 1e6);
+  r.mbyte_per_sec = riob < 0 || wiob < 0 ? -1. : (double)M * (riob + wiob) / (median * 1e6);
+
+#if OVXX_PROFILE
+  // Run once more with profiling on, to find out which operations
+  // (and backends) a call dispatches to.
+  if (!ovxx::profile::enabled())
+  {
+    float time;
+    ovxx::profile::set_mode(ovxx::profile::summary);
+    {
+      ovxx::allocator *cur_allocator = ovxx::allocator::get_default();
+      if (allocator_) ovxx::allocator::set_default(allocator_);
+      fcn(M, 1, time);
+      ovxx::allocator::set_default(cur_allocator);
+    }
+    ovxx::profile::set_mode(ovxx::profile::off);
+    std::vector<ovxx::profile::entry> entries = ovxx::profile::entries();
+    for (std::size_t i = 0; i != entries.size(); ++i)
+      r.dispatch.push_back(entries[i].name);
+    ovxx::profile::clear();
+  }
+#endif
+  return r;
+}
+
+// Write the collected results in the requested format, and compare
+// them to the baseline, if any.
+template <typename Functor>
+inline void
+Loop1P::report(Functor& fcn)
+{
+  char const *metric =
+    metric_ == pts_per_sec  ? "pts_per_sec" :
+    metric_ == ops_per_sec  ? "ops_per_sec" :
+    metric_ == iob_per_sec  ? "iob_per_sec" :
+    metric_ == riob_per_sec ? "riob_per_sec" :
+    metric_ == wiob_per_sec ? "wiob_per_sec" :
+    metric_ == all_per_sec  ? "all_per_sec" :
+    metric_ == data_per_sec ? "data_per_sec" :
+    metric_ == secs_per_pt  ? "usecs_per_pt" :
+    "*unknown*";
+
+  if (format_ != text_report)
+  {
+    std::ofstream file;
+    if (output_)
+    {
+      file.open(output_);
+      if (!file)
+      {
+	std::cerr << "ERROR: Unable to open " << output_ << std::endl;
+	std::exit(-1);
+      }
+    }
+    std::ostream &os = output_ ? file : std::cout;
+    if (format_ == json_report)
+      write_json(os, fcn.what(), what_, metric, results_);
+    else
+      write_csv(os, fcn.what(), what_, metric, results_);
+  }
+  if (compare_)
+    regressions_ += compare(std::cerr, compare_, results_, tolerance_);
+  results_.clear();
+}
+
 template <typename Functor>
 inline void
 Loop1P::diag(Functor fcn)
@@ -12,8 +12,12 @@
 #include <vsip/initfin.hpp>
 #include <ovxx/check_config.hpp>
 #include <ovxx/huge_page_allocator.hpp>
+#if OVXX_ENABLE_THREADING
+# include <ovxx/thread_pool.hpp>
+#endif
 #include "benchmark.hpp"
 
+#include <ctime>
 #include <fstream>
 #include <iostream>
 #if defined(_MC_EXEC)
@@ -29,6 +33,61 @@ using namespace ovxx;
 extern int benchmark(Loop1P& loop, int what);
 extern void defaults(Loop1P& loop);
 
+#ifndef BENCHMARK_CXXFLAGS
+# define BENCHMARK_CXXFLAGS "unknown"
+#endif
+
+metadata_type benchmark_metadata()
+{
+  metadata_type metadata;
+  std::string cpu = "unknown";
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line))
+    if (line.compare(0, 10, "model name") == 0)
+    {
+      std::string::size_type pos = line.find(':');
+      if (pos != std::string::npos)
+	cpu = line.substr(line.find_first_not_of(" \t", pos + 1));
+      break;
+    }
+  metadata.push_back(std::make_pair("cpu", cpu));
+#if defined(__clang__)
+  metadata.push_back(std::make_pair("compiler", std::string("clang ") + __clang_version__));
+#elif defined(__GNUC__)
+  metadata.push_back(std::make_pair("compiler", std::string("gcc ") + __VERSION__));
+#else
+  metadata.push_back(std::make_pair("compiler", std::string("unknown")));
+#endif
+  metadata.push_back(std::make_pair("cxxflags", std::string(BENCHMARK_CXXFLAGS)));
+  std::ostringstream oss;
+#if OVXX_ENABLE_THREADING
+  oss << ovxx::thread_pool::get_default()->concurrency();
+#else
+  oss << 1;
+#endif
+  metadata.push_back(std::make_pair("threads", oss.str()));
+  oss.str("");
+  oss << vsip::num_processors();
+  metadata.push_back(std::make_pair("nproc", oss.str()));
+  char host[256] = "unknown";
+#if !_WIN32
+  gethostname(host, sizeof(host));
+  host[sizeof(host) - 1] = '\0';
+#endif
+  metadata.push_back(std::make_pair("host", std::string(host)));
+  char date[32];
+  std::time_t now = std::time(0);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  metadata.push_back(std::make_pair("date", std::string(date)));
+#if OVXX_PROFILE
+  metadata.push_back(std::make_pair("profiling", std::string("on")));
+#else
+  metadata.push_back(std::make_pair("profiling", std::string("off")));
+#endif
+  return metadata;
+}
+
 
 
 int
@@ -138,6 +197,18 @@ main(int argc, char** argv)
       loop.mode_ = single_mode;
       loop.cal_  = atoi(argv[++i]);
     }
+    else if (!strcmp(argv[i], "-json"))
+      loop.format_ = json_report;
+    else if (!strcmp(argv[i], "-csv"))
+      loop.format_ = csv_report;
+    else if (!strcmp(argv[i], "-output"))
+      loop.output_ = argv[++i];
+    else if (!strcmp(argv[i], "-compare"))
+      loop.compare_ = argv[++i];
+    else if (!strcmp(argv[i], "-tolerance"))
+      loop.tolerance_ = atof(argv[++i]) / 100;
+    else if (!strcmp(argv[i], "-perf"))
+      loop.perf_ = perf_counters::instance().open();
     else if (!strcmp(argv[i], "-lib_config"))
     {
       std::cout << ovxx::library_config();
@@ -165,12 +236,30 @@ main(int argc, char** argv)
       std::cerr << "ERROR: Unknown argument: " << argv[i] << std::endl;
   }
 
+#if OVXX_ENABLE_THREADING
+  thread_pool *pool = thread_pool::get_default();
+  if (loop.perf_ && pool && pool->concurrency() > 1)
+    std::cerr << "# perf: counters cover the calling thread only, not the "
+	      << pool->concurrency() - 1 << " worker threads of the thread pool"
+	      << std::endl;
+#endif
+
   if (loop.metric_ == data_per_sec && loop.samples_ < 3)
   {
     std::cerr << "ERROR: -samples must be >= 3 when using -data" << std::endl;
     exit(-1);
   }
 
+  // Steady mode runs until interrupted, so it never gets to write a
+  // report, or to compare one against a baseline.
+  if (loop.mode_ == steady_mode &&
+      (loop.format_ != text_report || loop.output_ || loop.compare_))
+  {
+    std::cerr << "ERROR: -json, -csv, -output and -compare can't be used with -steady"
+	      << std::endl;
+    exit(-1);
+  }
+
   if (verbose)
   {
     std::cout << "what = " << what << std::endl;
@@ -202,5 +291,6 @@ main(int argc, char** argv)
   loop.what_ = what;
 
   benchmark(loop, what);
+  return loop.regressions_ ? 1 : 0;
 }
 
@@ -135,7 +135,7 @@ struct t_maxval1
     else if (init_ == 2)
       ctvh.assign_view(ramp(T(size-1), T(-1), size));
    
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = maxval(ctvh.view, idx);
     time = t1.elapsed();
@@ -192,7 +192,7 @@ struct t_maxval2
     else if (init_ == 2)
       ctvh.assign_view(ramp(T(size-1), T(-1), size));
    
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       eval::exec(val, ctvh.view.block(), idx);
     time = t1.elapsed();
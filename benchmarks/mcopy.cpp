@@ -82,7 +82,7 @@ struct t_mcopy<T, SrcBlock, DstBlock, Impl_assign> : Benchmark_base
 	A.put(m, n, T(m*N + n));
       }
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = A;
     time = t1.elapsed();
@@ -159,7 +159,7 @@ struct t_mcopy<T, SrcBlock, DstBlock, Impl_memcpy> : Benchmark_base
       dda::Data<SrcBlock, dda::in> src_data(A.block());
       dda::Data<DstBlock, dda::out> dst_data(Z.block());
     
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	std::memcpy(dst_data.ptr(), src_data.ptr(), M*N*sizeof(T));
       time = t1.elapsed();
@@ -43,7 +43,7 @@ struct t_meansqval1 : Benchmark_base
     else if (init_ == 2)
       view(size-1) = T(size);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = vsip::meansqval(view);
     time = t1.elapsed();
@@ -86,7 +86,7 @@ struct t_meansqval1_ext_base : Benchmark_base
       view(size-1) = T(256);
     }
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = meansqval(view, R());
     time = t1.elapsed();
@@ -143,7 +143,7 @@ struct t_meansqval_matrix : Benchmark_base
     
     view(0, 1) = itm;
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = vsip::meansqval(view);
     time = t1.elapsed();
@@ -210,7 +210,7 @@ struct t_meansqval_gp : Benchmark_base
     else if (init_ == 2)
       view(size-1) = T(size);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       val = T();
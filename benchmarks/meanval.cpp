@@ -46,7 +46,7 @@ struct t_meanval1 : Benchmark_base
     else if (init_ == 2)
       view(size-1) = T(size);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = vsip::meanval(view);
     time = t1.elapsed();
@@ -89,7 +89,7 @@ struct t_meanval1_ext_base : Benchmark_base
       view(size-1) = T(256);
     }
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = meanval(view, R());
     time = t1.elapsed();
@@ -141,7 +141,7 @@ struct t_meanval2 : Benchmark_base
     
     view(0, 1) = T(4*32*size);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = vsip::meanval(view);
     time = t1.elapsed();
@@ -181,7 +181,7 @@ struct t_meanval_gp : Benchmark_base
     else if (init_ == 2)
       view(size-1) = T(size);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       val = T();
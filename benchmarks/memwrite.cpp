@@ -31,7 +31,7 @@ struct t_memwrite1 : Benchmark_base
     Vector<T>   view(size, T());
     T           val = T(1);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       view = val;
     time = t1.elapsed();
@@ -70,7 +70,7 @@ struct t_memwrite_expl : Benchmark_base
     Vector<T>   view(size, T());
     T           val = T(1);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       for (index_type i=0; i<size; ++i)
 	view.put(i, val);
@@ -1565,7 +1565,7 @@ struct t_alltoall : Benchmark_base
     chk = T();
 
     // Assign src to dst
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       send();
     time = t1.elapsed();
@@ -1655,7 +1655,7 @@ struct t_alltoall_fr : Benchmark_base
     chk = T();
 
     // Assign src to dst
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       send();
     time = t1.elapsed();
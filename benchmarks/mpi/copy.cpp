@@ -564,7 +564,7 @@ struct t_copy : Benchmark_base
     }
 
     // Assign src to dst
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       send();
     time = t1.elapsed();
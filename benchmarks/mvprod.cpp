@@ -40,7 +40,7 @@ struct t_mvprod : public t_mprod_base<T>
     Vector<T, Dense<1, T> >            Z(M,    T(1));  // M x 1
 
     // column-major dimension ordering is used, as required by BLAS
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = prod(A, B);
     time = t1.elapsed();
@@ -95,7 +95,7 @@ struct t_mvprod_tag : public t_mprod_base<T>
     Vector<T, vblock_type> B(N,    T(1));  // N x 1
     Vector<T, vblock_type> Z(M,    T(1));  // M x 1
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       evaluator_type::exec(Z.block(), A.block(), B.block());
     time = t1.elapsed();
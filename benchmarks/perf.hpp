@@ -0,0 +1,271 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Hardware performance counters (Linux perf_event_open), read
+///   around the timed region of each benchmark.
+
+#ifndef perf_hpp_
+#define perf_hpp_
+
+#include <ovxx/timer.hpp>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__linux__)
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+# include <cerrno>
+#endif
+
+/// The counters, accumulated over all the timed regions since the
+/// last `clear()`.
+///
+/// Counters are per thread: they count the benchmarking thread (and
+/// threads it creates while counting), not those of a thread pool
+/// started beforehand. Benchmark main() notes this when a pool is
+/// running. Kernel activity is excluded, so that
+/// `perf_event_paranoid` levels up to 2 allow them.
+/// Counters the kernel or hardware doesn't provide (or doesn't allow)
+/// are reported as unavailable; the benchmark runs regardless.
+class perf_counters
+{
+public:
+  enum counter
+  {
+    cycles,
+    instructions,
+    llc_misses,
+    dtlb_misses,
+    num_counters
+  };
+
+  static perf_counters &instance()
+  {
+    static perf_counters counters;
+    return counters;
+  }
+
+  /// Open the counters. Return false if none is available.
+  bool open();
+  bool active() const { return active_;}
+
+  /// Start counting (called when a benchmark's timer starts).
+  void start();
+  /// Stop counting, and accumulate (called when it is read).
+  void stop();
+
+  void clear() { for (int i = 0; i != num_counters; ++i) total_[i] = 0.;}
+  bool available(counter c) const { return fd_[c] >= 0;}
+  /// The accumulated count, or -1 if unavailable.
+  double total(counter c) const { return available(c) ? total_[c] : -1.;}
+
+  static char const *name(counter c)
+  {
+    static char const *names[] =
+      { "cycles", "instructions", "llc_misses", "dtlb_misses"};
+    return names[c];
+  }
+
+private:
+  perf_counters() : active_(false), running_(false)
+  {
+    for (int i = 0; i != num_counters; ++i)
+    {
+      fd_[i] = -1;
+      total_[i] = 0.;
+    }
+  }
+  ~perf_counters();
+
+#if defined(__linux__)
+  // What a (non-grouped) counter reads, with
+  // PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING.
+  struct reading
+  {
+    reading() : value(0), enabled(0), running(0) {}
+    unsigned long long value;
+    unsigned long long enabled;
+    unsigned long long running;
+  };
+
+  static int open_counter(unsigned type, unsigned long long config)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+
+  reading read_counter(int fd)
+  {
+    reading r;
+    if (::read(fd, &r, 3 * sizeof(unsigned long long)) != 3 * sizeof(unsigned long long))
+      r = reading();
+    return r;
+  }
+
+  reading start_[num_counters];
+#endif
+
+  bool active_;
+  bool running_;
+  int fd_[num_counters];
+  double total_[num_counters];
+};
+
+#if defined(__linux__)
+
+inline bool
+perf_counters::open()
+{
+  unsigned long long const cache = PERF_COUNT_HW_CACHE_OP_READ << 8 |
+    PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+  fd_[cycles] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  int error = errno;
+  fd_[instructions] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  fd_[llc_misses] = open_counter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | cache);
+  fd_[dtlb_misses] = open_counter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | cache);
+  for (int i = 0; i != num_counters; ++i)
+    if (fd_[i] >= 0) active_ = true;
+  if (!active_)
+  {
+    std::cerr << "# perf: counters unavailable (" << std::strerror(error) << ')';
+    if (error == EACCES || error == EPERM)
+      std::cerr << ", check /proc/sys/kernel/perf_event_paranoid";
+    std::cerr << std::endl;
+  }
+  else
+    for (int i = 0; i != num_counters; ++i)
+      if (fd_[i] < 0)
+	std::cerr << "# perf: " << name(static_cast<counter>(i))
+		  << " unavailable" << std::endl;
+  return active_;
+}
+
+inline void
+perf_counters::start()
+{
+  if (!active_) return;
+  for (int i = 0; i != num_counters; ++i)
+    if (fd_[i] >= 0) start_[i] = read_counter(fd_[i]);
+  for (int i = 0; i != num_counters; ++i)
+    if (fd_[i] >= 0) ioctl(fd_[i], PERF_EVENT_IOC_ENABLE, 0);
+  running_ = true;
+}
+
+inline void
+perf_counters::stop()
+{
+  if (!running_) return;
+  for (int i = 0; i != num_counters; ++i)
+    if (fd_[i] >= 0) ioctl(fd_[i], PERF_EVENT_IOC_DISABLE, 0);
+  running_ = false;
+  for (int i = 0; i != num_counters; ++i)
+  {
+    if (fd_[i] < 0) continue;
+    reading r = read_counter(fd_[i]);
+    double value = r.value - start_[i].value;
+    unsigned long long enabled = r.enabled - start_[i].enabled;
+    unsigned long long running = r.running - start_[i].running;
+    // Scale up counts that were multiplexed with other events.
+    if (running && running < enabled) value *= static_cast<double>(enabled) / running;
+    total_[i] += value;
+  }
+}
+
+inline
+perf_counters::~perf_counters()
+{
+  for (int i = 0; i != num_counters; ++i)
+    if (fd_[i] >= 0) close(fd_[i]);
+}
+
+#else
+
+inline bool
+perf_counters::open()
+{
+  std::cerr << "# perf: counters not supported on this platform" << std::endl;
+  return false;
+}
+
+inline void perf_counters::start() {}
+inline void perf_counters::stop() {}
+inline perf_counters::~perf_counters() {}
+
+#endif
+
+/// The timer benchmarks measure their kernels with. With `-perf`, the
+/// hardware counters count while it runs, too.
+class bench_timer : public ovxx::timer
+{
+public:
+  bench_timer() { restart();}
+  ovxx::clock::time_point restart()
+  {
+    perf_counters::instance().start();
+    return ovxx::timer::restart();
+  }
+  double elapsed()
+  {
+    double time = ovxx::timer::elapsed();
+    perf_counters::instance().stop();
+    return time;
+  }
+};
+
+typedef std::vector<std::pair<std::string, double> > perf_metrics_type;
+
+/// Derive per-point metrics from the counts accumulated over `pts`
+/// points, processed in `seconds`: cycles, instructions, LLC and dTLB
+/// misses per point, instructions per cycle, and the memory bandwidth
+/// the last-level cache misses account for (in MB/s, assuming one
+/// cache line per miss). Unavailable metrics are -1.
+inline perf_metrics_type
+perf_metrics(double pts, double seconds)
+{
+  perf_counters const &c = perf_counters::instance();
+  double const cycles = c.total(perf_counters::cycles);
+  double const instructions = c.total(perf_counters::instructions);
+  double const llc = c.total(perf_counters::llc_misses);
+  double const dtlb = c.total(perf_counters::dtlb_misses);
+  long line = 64;
+#if defined(_SC_LEVEL1_DCACHE_LINESIZE)
+  if (sysconf(_SC_LEVEL1_DCACHE_LINESIZE) > 0) line = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+#endif
+  perf_metrics_type m;
+  m.push_back(std::make_pair("cycles_per_pt", cycles < 0 ? -1. : cycles / pts));
+  m.push_back(std::make_pair("instructions_per_pt", instructions < 0 ? -1. : instructions / pts));
+  m.push_back(std::make_pair("ipc", cycles <= 0 || instructions < 0 ? -1. : instructions / cycles));
+  m.push_back(std::make_pair("llc_misses_per_pt", llc < 0 ? -1. : llc / pts));
+  m.push_back(std::make_pair("dtlb_misses_per_pt", dtlb < 0 ? -1. : dtlb / pts));
+  m.push_back(std::make_pair("llc_mbyte_per_sec", llc < 0 || seconds <= 0 ? -1. : llc * line / (seconds * 1e6)));
+  return m;
+}
+
+/// Append `metrics` to a line of text output.
+inline void
+write_perf_metrics(std::ostream &os, perf_metrics_type const &metrics)
+{
+  for (perf_metrics_type::const_iterator i = metrics.begin(); i != metrics.end(); ++i)
+    if (i->second < 0) os << "  -";
+    else os << "  " << i->second;
+}
+
+#endif
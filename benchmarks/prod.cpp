@@ -51,7 +51,7 @@ struct t_prod1 : Benchmark_base
     Matrix<T>   B (N, P, T(1));
     Matrix<T>   Z (M, P, T(1));
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = prod(A, B);
     time = t1.elapsed();
@@ -94,7 +94,7 @@ struct t_prodh1 : Benchmark_base
     Matrix<T>   B (P, N, T());
     Matrix<T>   Z (M, P, T());
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = prodh(A, B);
     time = t1.elapsed();
@@ -137,7 +137,7 @@ struct t_prodt1 : Benchmark_base
     Matrix<T>   B (P, N, T());
     Matrix<T>   Z (M, P, T());
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = prodt(A, B);
     time = t1.elapsed();
@@ -191,7 +191,7 @@ struct t_prod2 : Benchmark_base
     Matrix<T, b_block_type>   B(N, P, T());
     Matrix<T, z_block_type>   Z(M, P, T());
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       evaluator_type::exec(Z.block(), A.block(), B.block());
     time = t1.elapsed();
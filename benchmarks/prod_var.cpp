@@ -296,7 +296,7 @@ struct t_prod1 : Benchmark_base
     Matrix<T>   chk(M, P);
     Matrix<scalar_type> gauge(M, P);
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       prod(Int_type<ImplI>(), A, B, Z);
     time = t1.elapsed();
@@ -0,0 +1,345 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Machine-readable benchmark reports, and their comparison
+///   against a baseline.
+
+#ifndef report_hpp_
+#define report_hpp_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum report_format
+{
+  text_report,
+  json_report,
+  csv_report
+};
+
+typedef std::vector<std::pair<std::string, std::string> > metadata_type;
+
+/// Describe the machine and build the benchmark runs on
+/// (CPU model, compiler, flags, threads, etc.). Defined in main.cpp.
+extern metadata_type benchmark_metadata();
+
+/// The measurements for one problem size.
+struct bench_result
+{
+  unsigned long size;
+  unsigned long loop;
+  /// Seconds per call, one per sample, in ascending order.
+  std::vector<double> times;
+  double mpts_per_sec;
+  double mflop_per_sec;  // negative if unknown
+  double mbyte_per_sec;  // negative if unknown
+  /// The operations (and the backends they were dispatched to)
+  /// a call performs, if the library was built with profiling.
+  std::vector<std::string> dispatch;
+  /// Hardware counter metrics (-perf), -1 if unavailable.
+  std::vector<std::pair<std::string, double> > counters;
+};
+
+/// Return the `p`-th percentile of the (sorted) `v`, by linear
+/// interpolation between closest ranks.
+inline double percentile(std::vector<double> const &v, double p)
+{
+  if (v.empty()) return 0.;
+  double rank = p / 100. * (v.size() - 1);
+  std::size_t lo = static_cast<std::size_t>(rank);
+  if (lo + 1 >= v.size()) return v.back();
+  return v[lo] + (rank - lo) * (v[lo + 1] - v[lo]);
+}
+
+namespace report_detail
+{
+inline void escape(std::ostream &os, std::string const &s)
+{
+  os << '"';
+  for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+    switch (*i)
+    {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\t': os << "\\t"; break;
+      default:
+	if (static_cast<unsigned char>(*i) >= 0x20) os << *i;
+    }
+  os << '"';
+}
+
+inline void number(std::ostream &os, double value)
+{
+  if (value < 0. || std::isnan(value) || std::isinf(value)) os << "null";
+  else os << value;
+}
+
+inline void csv_field(std::ostream &os, std::string const &s)
+{
+  if (s.find_first_of(",\"\n") == std::string::npos) os << s;
+  else
+  {
+    os << '"';
+    for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+    {
+      if (*i == '"') os << '"';
+      os << *i;
+    }
+    os << '"';
+  }
+}
+
+double const percentiles[] = { 0., 10., 25., 50., 75., 90., 100.};
+char const *const percentile_names[] = { "min", "p10", "p25", "median", "p75", "p90", "max"};
+std::size_t const num_percentiles = sizeof(percentiles) / sizeof(*percentiles);
+} // namespace report_detail
+
+/// Write `results` as a JSON document.
+inline void
+write_json(std::ostream &os, char const *what, int id, char const *metric,
+	   std::vector<bench_result> const &results)
+{
+  using namespace report_detail;
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision(9);
+  os << "{\n  \"benchmark\": ";
+  escape(os, what);
+  os << ",\n  \"id\": " << id << ",\n  \"metric\": ";
+  escape(os, metric);
+  os << ",\n  \"metadata\": {";
+  metadata_type metadata = benchmark_metadata();
+  for (metadata_type::const_iterator i = metadata.begin(); i != metadata.end(); ++i)
+  {
+    os << (i == metadata.begin() ? "\n    " : ",\n    ");
+    escape(os, i->first);
+    os << ": ";
+    escape(os, i->second);
+  }
+  os << "\n  },\n  \"results\": [";
+  for (std::vector<bench_result>::const_iterator r = results.begin();
+       r != results.end(); ++r)
+  {
+    os << (r == results.begin() ? "\n    " : ",\n    ");
+    os << "{\"size\": " << r->size << ", \"loop\": " << r->loop
+       << ", \"samples\": [";
+    for (std::size_t i = 0; i != r->times.size(); ++i)
+      os << (i ? ", " : "") << r->times[i];
+    os << "], \"seconds\": {";
+    for (std::size_t i = 0; i != num_percentiles; ++i)
+      os << (i ? ", " : "") << '"' << percentile_names[i] << "\": "
+	 << percentile(r->times, percentiles[i]);
+    os << "}, \"mpts_per_sec\": ";
+    number(os, r->mpts_per_sec);
+    os << ", \"mflop_per_sec\": ";
+    number(os, r->mflop_per_sec);
+    os << ", \"mbyte_per_sec\": ";
+    number(os, r->mbyte_per_sec);
+    os << ", \"dispatch\": [";
+    for (std::size_t i = 0; i != r->dispatch.size(); ++i)
+    {
+      if (i) os << ", ";
+      escape(os, r->dispatch[i]);
+    }
+    os << ']';
+    if (!r->counters.empty())
+    {
+      os << ", \"counters\": {";
+      for (std::size_t i = 0; i != r->counters.size(); ++i)
+      {
+	os << (i ? ", " : "") << '"' << r->counters[i].first << "\": ";
+	number(os, r->counters[i].second);
+      }
+      os << '}';
+    }
+    os << '}';
+  }
+  os << "\n  ]\n}\n";
+  os.precision(precision);
+  os.flags(flags);
+}
+
+/// Write `results` as CSV: "key,value" lines describing the run,
+/// followed by a table with one row per size.
+inline void
+write_csv(std::ostream &os, char const *what, int id, char const *metric,
+	  std::vector<bench_result> const &results)
+{
+  using namespace report_detail;
+  std::ios::fmtflags flags = os.flags();
+  std::streamsize precision = os.precision(9);
+  os << "benchmark,";
+  csv_field(os, what);
+  os << "\nid," << id << "\nmetric," << metric << '\n';
+  metadata_type metadata = benchmark_metadata();
+  for (metadata_type::const_iterator i = metadata.begin(); i != metadata.end(); ++i)
+  {
+    csv_field(os, i->first);
+    os << ',';
+    csv_field(os, i->second);
+    os << '\n';
+  }
+  os << "size,loop,samples";
+  for (std::size_t i = 0; i != num_percentiles; ++i)
+    os << ',' << percentile_names[i];
+  os << ",mpts/s,mflop/s,mbyte/s,dispatch";
+  if (!results.empty())
+    for (std::size_t i = 0; i != results.front().counters.size(); ++i)
+      os << ',' << results.front().counters[i].first;
+  os << '\n';
+  for (std::vector<bench_result>::const_iterator r = results.begin();
+       r != results.end(); ++r)
+  {
+    os << r->size << ',' << r->loop << ',' << r->times.size();
+    for (std::size_t i = 0; i != num_percentiles; ++i)
+      os << ',' << percentile(r->times, percentiles[i]);
+    os << ',' << r->mpts_per_sec << ',';
+    if (r->mflop_per_sec >= 0.) os << r->mflop_per_sec;
+    os << ',';
+    if (r->mbyte_per_sec >= 0.) os << r->mbyte_per_sec;
+    os << ',';
+    std::string dispatch;
+    for (std::size_t i = 0; i != r->dispatch.size(); ++i)
+      dispatch += (i ? ";" : "") + r->dispatch[i];
+    csv_field(os, dispatch);
+    for (std::size_t i = 0; i != r->counters.size(); ++i)
+    {
+      os << ',';
+      if (r->counters[i].second >= 0.) os << r->counters[i].second;
+    }
+    os << '\n';
+  }
+  os.precision(precision);
+  os.flags(flags);
+}
+
+/// Read the per-size samples back from a JSON report written by
+/// `write_json()`.
+inline std::map<unsigned long, std::vector<double> >
+read_baseline(char const *filename)
+{
+  std::map<unsigned long, std::vector<double> > baseline;
+  std::ifstream ifs(filename);
+  if (!ifs)
+  {
+    std::cerr << "ERROR: Unable to open baseline " << filename << std::endl;
+    std::exit(-1);
+  }
+  std::stringstream buffer;
+  buffer << ifs.rdbuf();
+  std::string const doc = buffer.str();
+  std::string::size_type pos = doc.find("\"results\"");
+  while (pos != std::string::npos &&
+	 (pos = doc.find("\"size\":", pos)) != std::string::npos)
+  {
+    unsigned long size = std::strtoul(doc.c_str() + pos + 7, 0, 10);
+    pos = doc.find("\"samples\":", pos);
+    if (pos == std::string::npos) break;
+    pos = doc.find('[', pos) + 1;
+    std::string::size_type end = doc.find(']', pos);
+    std::vector<double> &samples = baseline[size];
+    char const *c = doc.c_str() + pos;
+    char const *const stop = doc.c_str() + end;
+    while (c < stop)
+    {
+      char *next;
+      double value = std::strtod(c, &next);
+      if (next == c) ++c;
+      else
+      {
+	samples.push_back(value);
+	c = next;
+      }
+    }
+    std::sort(samples.begin(), samples.end());
+    pos = end;
+  }
+  return baseline;
+}
+
+/// One-sided Mann-Whitney U test: return the probability of observing
+/// `current` samples at least this much slower than `base` ones if both
+/// came from the same distribution (normal approximation, with ties
+/// counted as one half).
+inline double
+slower_p_value(std::vector<double> const &base, std::vector<double> const &current)
+{
+  double const n1 = base.size(), n2 = current.size();
+  double u = 0.;
+  for (std::size_t i = 0; i != current.size(); ++i)
+    for (std::size_t j = 0; j != base.size(); ++j)
+      if (current[i] > base[j]) u += 1.;
+      else if (current[i] == base[j]) u += 0.5;
+  double const mean = n1 * n2 / 2.;
+  double const sigma = std::sqrt(n1 * n2 * (n1 + n2 + 1.) / 12.);
+  if (sigma == 0.) return 1.;
+  // Continuity correction.
+  double const z = (u - mean - 0.5) / sigma;
+  return 0.5 * std::erfc(z / std::sqrt(2.));
+}
+
+/// Compare `results` against the baseline in `filename`, and report
+/// the outcome for each size to `os`.
+///
+/// A size regresses if its median time grew by more than `tolerance`
+/// (a fraction) and, given at least three samples on both sides, the
+/// slowdown is significant at the 5% level.
+/// Return the number of regressions.
+inline int
+compare(std::ostream &os, char const *filename,
+	std::vector<bench_result> const &results, double tolerance)
+{
+  std::map<unsigned long, std::vector<double> > baseline = read_baseline(filename);
+  std::ios::fmtflags flags = os.flags();
+  int regressions = 0;
+  os << "# compare against " << filename
+     << " (tolerance " << tolerance * 100 << "%)\n"
+     << "# size  base median (s)   median (s)   change      p  status\n";
+  for (std::vector<bench_result>::const_iterator r = results.begin();
+       r != results.end(); ++r)
+  {
+    std::map<unsigned long, std::vector<double> >::const_iterator b =
+      baseline.find(r->size);
+    if (b == baseline.end() || b->second.empty() || r->times.empty())
+    {
+      os << std::setw(6) << r->size << "  (no baseline)\n";
+      continue;
+    }
+    double const base = percentile(b->second, 50.);
+    double const current = percentile(r->times, 50.);
+    double const change = base > 0. ? current / base - 1. : 0.;
+    bool const testable = b->second.size() >= 3 && r->times.size() >= 3;
+    double const p = testable ? slower_p_value(b->second, r->times) : 0.;
+    bool const regressed = change > tolerance && p < 0.05;
+    bool const improved = change < -tolerance;
+    if (regressed) ++regressions;
+    os << std::setw(6) << r->size << ' '
+       << std::scientific << std::setprecision(4)
+       << std::setw(16) << base << ' ' << std::setw(12) << current << ' '
+       << std::fixed << std::setprecision(1)
+       << std::showpos << std::setw(7) << change * 100 << '%' << std::noshowpos
+       << ' ' << std::setprecision(3) << std::setw(6);
+    if (testable) os << p;
+    else os << "-";
+    os << "  " << (regressed ? "REGRESSION" : improved ? "improved" : "ok") << '\n';
+  }
+  os << "# " << regressions << " regression(s)" << std::endl;
+  os.flags(flags);
+  return regressions;
+}
+
+#endif
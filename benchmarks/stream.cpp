@@ -97,7 +97,7 @@ struct t_composite_vpp : Benchmark_base
     time = 0;
     for (index_type l=0; l<loop; ++l)
     {
-      timer t1;
+      bench_timer t1;
       C = A;
       times[0][l] = t1.elapsed();
       t1.restart();
@@ -259,7 +259,7 @@ struct t_composite_c : Benchmark_base
     for (index_type l=0; l<loop; ++l)
     {
       int j;
-      timer t1;
+      bench_timer t1;
       for (j=0; j<N; j++)
 	c[j] = a[j];
       times[0][l] = t1.elapsed();
@@ -40,7 +40,7 @@ struct t_sumsqval1 : Benchmark_base
     else if (init_ == 2)
       view(size-1) = T(2);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = vsip::sumsqval(view);
     time = t1.elapsed();
@@ -83,7 +83,7 @@ struct t_sumsqval1_ext_base : Benchmark_base
       view(size-1) = T(256);
     }
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = sumsqval(view, R());
     time = t1.elapsed();
@@ -135,7 +135,7 @@ struct t_sumsqval2 : Benchmark_base
     
     view(0, 1) = T(2);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = vsip::sumsqval(view);
     time = t1.elapsed();
@@ -173,7 +173,7 @@ struct t_sumsqval_gp : Benchmark_base
     else if (init_ == 2)
       view(size-1) = T(2);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       val = T();
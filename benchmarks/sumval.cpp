@@ -44,7 +44,7 @@ struct t_sumval1 : Benchmark_base
     else if (init_ == 2)
       view(size-1) = T(2);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = vsip::sumval(view);
     time = t1.elapsed();
@@ -87,7 +87,7 @@ struct t_sumval1_ext_base : Benchmark_base
       view(size-1) = T(65534);
     }
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = sumval(view, R());
     time = t1.elapsed();
@@ -139,7 +139,7 @@ struct t_sumval2 : Benchmark_base
     
     view(0, 1) = T(2);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       val = vsip::sumval(view);
     time = t1.elapsed();
@@ -177,7 +177,7 @@ struct t_sumval_gp : Benchmark_base
     else if (init_ == 2)
       view(size-1) = T(2);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       val = T();
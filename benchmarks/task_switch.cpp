@@ -93,7 +93,7 @@ struct t_fastconv_base<T, Impl1> : fastconv_ops
     
     for_fftm(data, tmp);
     tmp = vmmul<0>(replica, tmp);
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       // Perform half-fast convolution:
@@ -103,7 +103,7 @@ struct t_fastconv_base<T, Impl1> : fastconv_ops
     time = t1.elapsed();
 
     for_fftm(data, tmp);
-    timer t2;
+    bench_timer t2;
     for (index_type l=0; l<loop; ++l)
     {
       // Perform fast convolution:
@@ -112,7 +112,7 @@ struct t_fastconv_base<T, Impl1> : fastconv_ops
     float t2_time = t2.elapsed();
 
     tmp = vmmul<0>(replica, tmp);
-    timer t3;
+    bench_timer t3;
     for (index_type l=0; l<loop; ++l)
     {
       // Perform fast convolution:
@@ -209,7 +209,7 @@ struct t_fastconv_base<T, Impl2> : fastconv_ops
     Ax = Bx * Cx;
     A1 = B * C;
     A2 = B + C;
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
     {
       A1 = B * C;
@@ -219,7 +219,7 @@ struct t_fastconv_base<T, Impl2> : fastconv_ops
 
     // Step 2: measure * only
     A1 = B * C;
-    timer t2;
+    bench_timer t2;
     for (index_type l=0; l<loop; ++l)
     {
       A1 = B * C;
@@ -228,7 +228,7 @@ struct t_fastconv_base<T, Impl2> : fastconv_ops
 
     // Step 2: measure + only
     A2 = B + C;
-    timer t3;
+    bench_timer t3;
     for (index_type l=0; l<loop; ++l)
     {
       A2 = B + C;
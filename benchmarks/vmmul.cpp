@@ -66,7 +66,7 @@ struct t_vmmul<T, Impl_op, SD> : Benchmark_base
     W = ramp(T(1), T(1), W.size());
     A = rand.randu(rows, cols);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = vmmul<SD>(W, A);
     time = t1.elapsed();
@@ -127,7 +127,7 @@ struct t_vmmul<T, Impl_pop, SD> : Benchmark_base
     
     if (SD == row)
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<rows; ++i)
 	  Z.row(i) = W * A.row(i);
@@ -135,7 +135,7 @@ struct t_vmmul<T, Impl_pop, SD> : Benchmark_base
     }
     else
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<cols; ++i)
 	  Z.col(i) = W * A.col(i);
@@ -169,7 +169,7 @@ struct t_vmmul<T, Impl_s_op, SD> : Benchmark_base
     W = ramp(T(1), T(1), W.size());
     A = T(1);
     
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = T(2) * vmmul<SD>(W, A);
     time = t1.elapsed();
@@ -203,7 +203,7 @@ struct t_vmmul<T, Impl_s_pop, SD> : Benchmark_base
     
     if (SD == row)
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<rows; ++i)
 	  Z.row(i) = T(2) * W * A.row(i);
@@ -211,7 +211,7 @@ struct t_vmmul<T, Impl_s_pop, SD> : Benchmark_base
     }
     else
     {
-      timer t1;
+      bench_timer t1;
       for (index_type l=0; l<loop; ++l)
 	for (index_type i=0; i<cols; ++i)
 	  Z.col(i) = T(2) * W * A.col(i);
@@ -38,7 +38,7 @@ struct t_vmprod : public t_mprod_base<T>
     Matrix<T> B(N, P, T(1));  // N x P
     Vector<T> Z(   P, T(1));  // 1 x P
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       Z = prod(A, B);
     time = t1.elapsed();
@@ -92,7 +92,7 @@ struct t_vmprod_tag : public t_mprod_base<T>
     Matrix<T, mblock_type> B(N, P, T(1));  // N x P
     Vector<T, vblock_type> Z(   P, T(1));  // 1 x P
 
-    timer t1;
+    bench_timer t1;
     for (index_type l=0; l<loop; ++l)
       evaluator_type::exec(Z.block(), A.block(), B.block());
     time = t1.elapsed();
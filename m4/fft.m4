@@ -11,7 +11,7 @@ AC_DEFUN([OVXX_CHECK_FFT],
 AC_ARG_ENABLE(fft,
   AS_HELP_STRING([--enable-fft],
                  [Specify list of FFT engines. Available engines are:
-                  fftw, ipp, sal, cvsip, cuda, dft, or no_fft [[fftw]].]),,
+                  fftw, ipp, sal, cvsip, cuda, builtin, dft, or no_fft [[fftw]].]),,
   [enable_fft=fftw])
   
 AC_ARG_WITH(fftw_prefix,
@@ -46,6 +46,11 @@ for fft_be in ${fft_backends} ; do
         AC_MSG_ERROR([The cuda FFT backend requires --with-cuda.])
       fi
       ;;
+    builtin)
+      AC_SUBST(OVXX_BUILTIN_FFT, 1)
+      AC_DEFINE_UNQUOTED(OVXX_BUILTIN_FFT, 1,
+        [Define to enable the built-in FFT backend.])
+      ;;
     dft)
       AC_SUBST(OVXX_DFT_FFT, 1)
       AC_DEFINE_UNQUOTED(OVXX_DFT_FFT, 1,
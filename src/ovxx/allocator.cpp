@@ -8,11 +8,25 @@
 
 #include <ovxx/allocator.hpp>
 #include <ovxx/aligned_allocator.hpp>
+#include <ovxx/pool_allocator.hpp>
+#include <ovxx/huge_page_allocator.hpp>
+#include <ovxx/numa_allocator.hpp>
 #include <limits>
 #include <cstdlib>
+#include <cstring>
 
 namespace ovxx
 {
+namespace
+{
+enum kind_type { use_aligned, use_pool, use_huge, use_interleave, use_first_touch };
+kind_type kind = use_aligned;
+// All but aligned allocators are shared by all threads,
+// and deleted once the last of them has finalized.
+std::mutex shared_guard;
+allocator *shared = 0;
+unsigned int shared_users = 0;
+} // namespace <unnamed>
 
 #if OVXX_ENABLE_THREADING
 thread_local allocator *allocator::default_ = 0;
@@ -20,13 +34,71 @@ thread_local allocator *allocator::default_ = 0;
 allocator *allocator::default_ = 0;
 #endif
 
+void allocator::parse_options(int &argc, char **&argv)
+{
+  char const *name = "--ovxx-allocator=";
+  size_t const len = std::strlen(name);
+  int i = 1;
+  while (i < argc)
+  {
+    if (std::strncmp(argv[i], name, len))
+    {
+      ++i;
+      continue;
+    }
+    char const *value = argv[i] + len;
+    if (!std::strcmp(value, "pool")) kind = use_pool;
+    else if (!std::strcmp(value, "aligned")) kind = use_aligned;
+#if OVXX_ENABLE_HUGE_PAGE_POOL
+    else if (!std::strcmp(value, "huge")) kind = use_huge;
+#endif
+    else if (!std::strcmp(value, "interleave")) kind = use_interleave;
+    else if (!std::strcmp(value, "first-touch")) kind = use_first_touch;
+    else
+      OVXX_DO_THROW(std::invalid_argument("invalid --ovxx-allocator value"));
+    // Remove the recognized option.
+    for (int j = i; j < argc; ++j) argv[j] = argv[j + 1];
+    --argc;
+  }
+}
+
 void allocator::initialize(int &/*argc*/, char **&/*argv*/)
 {
-  default_ = new aligned_allocator();
+  if (kind == use_aligned)
+  {
+    default_ = new aligned_allocator();
+    return;
+  }
+  std::lock_guard<std::mutex> lock(shared_guard);
+  if (!shared)
+  {
+    switch (kind)
+    {
+      case use_pool: shared = new pool_allocator(); break;
+      case use_huge: shared = new huge_page_allocator(); break;
+      case use_interleave: shared = new numa_allocator(numa::interleave); break;
+      default: shared = new numa_allocator(numa::first_touch); break;
+    }
+  }
+  ++shared_users;
+  default_ = shared;
 }
 
 void allocator::finalize()
 {
+  {
+    std::lock_guard<std::mutex> lock(shared_guard);
+    if (default_ && default_ == shared)
+    {
+      if (!--shared_users)
+      {
+	delete shared;
+	shared = 0;
+      }
+      default_ = 0;
+      return;
+    }
+  }
   delete default_;
   default_ = 0;
 }
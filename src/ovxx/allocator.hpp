@@ -36,6 +36,15 @@ public:
     deallocate((void*)ptr, size * sizeof(T));
   }
 
+  /// Process (and remove) the allocator options in `argv`:
+  ///
+  ///   --ovxx-allocator=aligned  a new aligned_allocator per thread (default)
+  ///   --ovxx-allocator=pool     one pool_allocator shared by all threads
+  ///   --ovxx-allocator=huge     one huge_page_allocator shared by all threads
+  ///   --ovxx-allocator=interleave|first-touch
+  ///                             one numa_allocator with the given policy,
+  ///                             shared by all threads
+  static void parse_options(int &argc, char **&argv);
   static void initialize(int &argc, char **&argv);
   static void finalize();
   static allocator *get_default()
@@ -16,7 +16,15 @@
 #include <ovxx/parallel/assign_fwd.hpp>
 #include <ovxx/dda.hpp>
 #include <ovxx/assign/copy.hpp>
+#include <ovxx/assign/transpose.hpp>
+#include <ovxx/assign/threaded.hpp>
 #include <ovxx/assign/loop_fusion.hpp>
+#if OVXX_PROFILE
+# include <ovxx/expr/unary.hpp>
+# include <ovxx/expr/binary.hpp>
+# include <ovxx/expr/ternary.hpp>
+# include <ovxx/profile.hpp>
+#endif
 #ifdef OVXX_PARALLEL
 # include <ovxx/parallel/map_traits.hpp>
 # include <ovxx/parallel/expr.hpp>
@@ -107,8 +115,75 @@ struct Dispatcher<3, LHS, RHS, serial_expr>
   }
 };
 
+#if OVXX_PROFILE
+/// The number of operations per element evaluating block `B` takes.
+/// Only elementwise operations are counted; non-elementwise ones
+/// are dispatched (and profiled) separately.
+template <typename B>
+struct ops_per_element { static unsigned int const value = 0;};
+
+template <typename B>
+struct ops_per_element<B const> : ops_per_element<B> {};
+
+template <template <typename> class O, typename B>
+struct ops_per_element<expr::Unary<O, B, true> >
+{
+  typedef typename expr::Unary<O, B, true>::value_type value_type;
+  static unsigned int const value =
+    ops_count::traits<value_type>::add + ops_per_element<B>::value;
+};
+
+template <template <typename, typename> class O, typename B1, typename B2>
+struct ops_per_element<expr::Binary<O, B1, B2, true> >
+{
+  typedef typename expr::Binary<O, B1, B2, true>::value_type value_type;
+  static unsigned int const value = ops_count::traits<value_type>::add +
+    ops_per_element<B1>::value + ops_per_element<B2>::value;
+};
+
+template <template <typename, typename, typename> class O,
+	  typename B1, typename B2, typename B3>
+struct ops_per_element<expr::Ternary<O, B1, B2, B3, true> >
+{
+  typedef typename expr::Ternary<O, B1, B2, B3, true>::value_type value_type;
+  static unsigned int const value = 2 * ops_count::traits<value_type>::add +
+    ops_per_element<B1>::value + ops_per_element<B2>::value +
+    ops_per_element<B3>::value;
+};
+#endif
+
 } // namespace ovxx::assignment
 
+#if OVXX_PROFILE
+namespace dispatcher
+{
+/// Record assignments, tagged with the backend evaluating them.
+/// Assignments issued from within a parallel loop are the parts of a
+/// threaded assignment, which is recorded as a whole.
+template <dimension_type D, typename E>
+struct Event<op::assign<D>, E>
+{
+  template <typename LHS, typename RHS>
+  Event(LHS &lhs, RHS const &)
+    : event_(!thread_pool::in_parallel_region(),
+	     [&]()
+	     {
+	       return profile::tag
+		 ("assign", detail::backend_of<E>::name(),
+		  ops_count::datatype<typename LHS::value_type>::value(),
+		  lhs.size());
+	     },
+	     [&]()
+	     {
+	       return double(lhs.size()) *
+		 assignment::ops_per_element<RHS>::value;
+	     })
+  {}
+  profile::event event_;
+};
+} // namespace ovxx::dispatcher
+#endif
+
 /// Assign one block to another.
 /// This process involves a fairly sophisticated multi-dispatch logic.
 template <dimension_type D, typename LHS, typename RHS>
@@ -17,47 +17,6 @@ namespace ovxx
 {
 namespace assignment
 {
-// in-place transpose
-template <typename T>
-void
-transpose(T *data,
-	  stride_type row_stride,
-	  stride_type col_stride,
-	  length_type rows,
-	  length_type cols)
-{
-  for (index_type i=0; i<rows; ++i)
-    for (index_type j=i; j<cols; ++j)
-    {
-      std::swap(data[col_stride * i + row_stride * j],
-		data[col_stride * j + row_stride * i]);
-    }
-}
-
-// in-place transpose
-template <typename T>
-void
-transpose(std::pair<T*, T*> const &d,
-	  stride_type row_stride,
-	  stride_type col_stride,
-	  length_type rows,
-	  length_type cols)
-{
-  transpose(d.first,  row_stride, col_stride, rows, cols);
-  transpose(d.second, row_stride, col_stride, rows, cols);
-}
-
-template <typename T1, typename T2>
-void
-transpose(T1 *lhs, stride_type lhs_col_stride,
-	  T2 const *rhs, stride_type rhs_row_stride,
-	  length_type lhs_rows, length_type lhs_cols)
-{
-  for (index_type r = 0; r != lhs_rows; ++r)
-    for (index_type c = 0; c != lhs_cols; ++c)
-      lhs[r+c*lhs_col_stride] = rhs[r*rhs_row_stride+c];
-}
-
 template <typename T>
 void
 copy(T *lhs, stride_type lhs_stride,
@@ -157,63 +116,6 @@ void copy(LHS &lhs, RHS const &rhs, col2_type, col2_type)
        lhs_data.size(1), lhs_data.size(0));
 }
 
-template <typename LHS, typename RHS>
-void copy(LHS &lhs, RHS const &rhs, col2_type, row2_type)
-{
-  vsip::dda::Data<LHS, dda::out> lhs_data(lhs);
-  vsip::dda::Data<RHS, dda::in> rhs_data(rhs);
-
-  if (is_same_ptr(lhs_data.ptr(), rhs_data.ptr()))
-  {
-    // in-place transpose
-    OVXX_PRECONDITION(lhs.size(2, 0) == lhs.size(2, 1));
-    transpose(lhs_data.ptr(),
-	      lhs_data.stride(0), lhs_data.stride(1),
-	      lhs.size(2, 0), lhs.size(2, 1));
-  }
-  else if (lhs_data.stride(0) == 1 && rhs_data.stride(1) == 1)
-  {
-    transpose(lhs_data.ptr(), lhs_data.stride(1),
-	      rhs_data.ptr(), rhs_data.stride(0),
-	      lhs.size(2, 0), lhs.size(2, 1));
-  }
-  else
-  {
-    copy(lhs_data.ptr(), lhs_data.stride(0), lhs_data.stride(1),
-
-	 rhs_data.ptr(), rhs_data.stride(0), rhs_data.stride(1),
-	 lhs.size(2, 0), lhs.size(2, 1));
-  }
-}
-
-template <typename LHS, typename RHS>
-void copy(LHS &lhs, RHS const &rhs, row2_type, col2_type)
-{
-  vsip::dda::Data<LHS, dda::out> lhs_data(lhs);
-  vsip::dda::Data<RHS, dda::in> rhs_data(rhs);
-
-  if (is_same_ptr(lhs_data.ptr(), rhs_data.ptr()))
-  {
-    // in-place transpose
-    OVXX_PRECONDITION(lhs.size(2, 0) == lhs.size(2, 1));
-    transpose(lhs_data.ptr(),
-	      lhs_data.stride(0), lhs_data.stride(1),
-	      lhs.size(2, 0), lhs.size(2, 1));
-  }
-  else if (lhs_data.stride(1) == 1 && rhs_data.stride(0) == 1)
-  {
-    transpose(lhs_data.ptr(), lhs_data.stride(0),
-	      rhs_data.ptr(), rhs_data.stride(1),
-	      lhs.size(2, 1), lhs.size(2, 0));
-  }
-  else
-  {
-    copy(lhs_data.ptr(), lhs_data.stride(0), lhs_data.stride(1),
-	 rhs_data.ptr(), rhs_data.stride(0), rhs_data.stride(1),
-	 lhs.size(2, 1), lhs.size(2, 0));
-  }
-}
-
 } // namespace ovxx::assignment
 
 namespace dispatcher
@@ -273,8 +175,8 @@ struct Evaluator<op::assign<1>, be::copy, void(LHS &, RHS const &)>
   }
 };
 
-/// 2D copy assignment. This includes transpose depending
-/// on the blocks' dimension-ordering.
+/// 2D copy assignment between blocks of equal dimension-ordering.
+/// Transposes are handled by the be::transpose evaluator.
 template <typename LHS, typename RHS>
 struct Evaluator<op::assign<2>, be::copy, void(LHS &, RHS const &)>
 {
@@ -299,6 +201,7 @@ struct Evaluator<op::assign<2>, be::copy, void(LHS &, RHS const &)>
 
   static bool const ct_valid =
     is_same<rhs_value_type, lhs_value_type>::value &&
+    is_same<rhs_order_type, lhs_order_type>::value &&
     !is_rhs_expr &&
     lhs_cost == 0 && rhs_cost == 0 &&
     (is_lhs_split == is_rhs_split);
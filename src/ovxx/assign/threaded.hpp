@@ -0,0 +1,337 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_assign_threaded_hpp_
+#define ovxx_assign_threaded_hpp_
+
+#include <ovxx/c++11.hpp>
+#include <ovxx/expr/evaluate.hpp>
+#include <ovxx/expr/subset.hpp>
+#include <ovxx/dispatch.hpp>
+#include <ovxx/domain_utils.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <algorithm>
+
+namespace ovxx
+{
+namespace expr
+{
+template <dimension_type D, typename Block0, typename Block1>
+class Vmmul;
+} // namespace ovxx::expr
+
+namespace assignment
+{
+
+/// Assignments with fewer elements than this are evaluated serially.
+inline length_type &threaded_threshold()
+{
+  static length_type threshold = 32768;
+  return threshold;
+}
+
+/// The number of elements assigned per task, chosen such that
+/// a task's operands stay within the first-level cache.
+template <typename T>
+struct threaded_chunk
+{
+  static length_type const value =
+    sizeof(T) < 16384 / 1024 ? 1024 : 16384 / sizeof(T);
+};
+
+/// Determine whether concurrent `get()` calls on a block are safe,
+/// provided its non-elementwise sub-expressions have been evaluated.
+template <typename B>
+struct is_threadable
+{
+  static bool const value = !is_expr_block<B>::value;
+};
+
+template <typename B>
+struct is_threadable<B const> : is_threadable<B> {};
+
+template <dimension_type D, typename T>
+struct is_threadable<expr::Scalar<D, T> >
+{
+  static bool const value = true;
+};
+
+// Generators may carry state (e.g. random number generators).
+template <dimension_type D, typename G>
+struct is_threadable<expr::Generator<D, G> >
+{
+  static bool const value = false;
+};
+
+template <typename B>
+struct is_threadable<expr::Subset<B> > : is_threadable<B> {};
+
+template <typename B>
+struct is_threadable<expr::Transposed<B> > : is_threadable<B> {};
+
+template <typename B, template <typename> class E>
+struct is_threadable<expr::Component<B, E> > : is_threadable<B> {};
+
+template <template <typename> class O, typename B>
+struct is_threadable<expr::Unary<O, B, true> > : is_threadable<B> {};
+
+// Non-elementwise operations are accessed through their cache.
+template <template <typename> class O, typename B>
+struct is_threadable<expr::Unary<O, B, false> >
+{
+  static bool const value = true;
+};
+
+template <template <typename, typename> class O, typename B1, typename B2>
+struct is_threadable<expr::Binary<O, B1, B2, true> >
+{
+  static bool const value =
+    is_threadable<B1>::value && is_threadable<B2>::value;
+};
+
+template <template <typename, typename> class O, typename B1, typename B2>
+struct is_threadable<expr::Binary<O, B1, B2, false> >
+{
+  static bool const value = true;
+};
+
+template <template <typename, typename, typename> class O,
+	  typename B1, typename B2, typename B3>
+struct is_threadable<expr::Ternary<O, B1, B2, B3, true> >
+{
+  static bool const value =
+    is_threadable<B1>::value &&
+    is_threadable<B2>::value &&
+    is_threadable<B3>::value;
+};
+
+template <template <typename, typename, typename> class O,
+	  typename B1, typename B2, typename B3>
+struct is_threadable<expr::Ternary<O, B1, B2, B3, false> >
+{
+  static bool const value = true;
+};
+
+template <dimension_type D, typename V, typename M>
+struct is_threadable<expr::Vmmul<D, V, M> >
+{
+  static bool const value = is_threadable<V>::value && is_threadable<M>::value;
+};
+
+/// Only element-wise expressions are split. Non-elementwise
+/// operations write directly into the result block.
+template <typename B>
+struct is_threaded_expr
+{
+  static bool const value = false;
+};
+
+template <typename B>
+struct is_threaded_expr<B const> : is_threaded_expr<B> {};
+
+template <typename B>
+struct is_threaded_expr<expr::Subset<B> > : is_threaded_expr<B> {};
+
+template <template <typename> class O, typename B>
+struct is_threaded_expr<expr::Unary<O, B, true> >
+  : is_threadable<expr::Unary<O, B, true> > {};
+
+template <template <typename, typename> class O, typename B1, typename B2>
+struct is_threaded_expr<expr::Binary<O, B1, B2, true> >
+  : is_threadable<expr::Binary<O, B1, B2, true> > {};
+
+template <template <typename, typename, typename> class O,
+	  typename B1, typename B2, typename B3>
+struct is_threaded_expr<expr::Ternary<O, B1, B2, B3, true> >
+  : is_threadable<expr::Ternary<O, B1, B2, B3, true> > {};
+
+template <dimension_type D, typename V, typename M>
+struct is_threaded_expr<expr::Vmmul<D, V, M> >
+  : is_threadable<expr::Vmmul<D, V, M> > {};
+
+/// Map an expression block to the block computing its elements
+/// within a sub-domain. Leaves (including non-elementwise operations,
+/// which are evaluated beforehand) become subsets of `L`; elementwise
+/// operations are rebuilt over the sub-blocks of their arguments, so
+/// the assignment backends can still recognize them. Both are held
+/// by value, as expression blocks hold them.
+template <typename B, typename L = B>
+struct subexpr
+{
+  typedef expr::Subset<L> type;
+  template <dimension_type D>
+  static type apply(B const &block, Domain<D> const &dom)
+  { return type(dom, const_cast<L &>(block));}
+};
+
+/// Expression blocks are only usable as const blocks.
+template <typename B>
+struct subexpr<B const>
+  : subexpr<B, typename conditional<is_expr_block<B>::value, B const, B>::type>
+{};
+
+template <dimension_type D, typename T, typename L>
+struct subexpr<expr::Scalar<D, T>, L>
+{
+  typedef expr::Scalar<D, T> type;
+  static type const &apply(type const &block, Domain<D> const &) { return block;}
+};
+
+template <template <typename> class O, typename B, typename L>
+struct subexpr<expr::Unary<O, B, true>, L>
+{
+  typedef expr::Unary<O, typename subexpr<B>::type, true> const type;
+  template <dimension_type D>
+  static type apply(expr::Unary<O, B, true> const &block, Domain<D> const &dom)
+  { return type(block.operation(), subexpr<B>::apply(block.arg(), dom));}
+};
+
+template <template <typename, typename> class O,
+	  typename B1, typename B2, typename L>
+struct subexpr<expr::Binary<O, B1, B2, true>, L>
+{
+  typedef expr::Binary<O, typename subexpr<B1>::type,
+		       typename subexpr<B2>::type, true> const type;
+  template <dimension_type D>
+  static type apply(expr::Binary<O, B1, B2, true> const &block, Domain<D> const &dom)
+  {
+    return type(block.operation(),
+		subexpr<B1>::apply(block.arg1(), dom),
+		subexpr<B2>::apply(block.arg2(), dom));
+  }
+};
+
+template <template <typename, typename, typename> class O,
+	  typename B1, typename B2, typename B3, typename L>
+struct subexpr<expr::Ternary<O, B1, B2, B3, true>, L>
+{
+  typedef expr::Ternary<O, typename subexpr<B1>::type,
+			typename subexpr<B2>::type,
+			typename subexpr<B3>::type, true> const type;
+  template <dimension_type D>
+  static type apply(expr::Ternary<O, B1, B2, B3, true> const &block,
+		    Domain<D> const &dom)
+  {
+    return type(block.operation(),
+		subexpr<B1>::apply(block.arg1(), dom),
+		subexpr<B2>::apply(block.arg2(), dom),
+		subexpr<B3>::apply(block.arg3(), dom));
+  }
+};
+
+/// Determine whether the leaves `subexpr` takes subsets of are
+/// `D`-dimensional blocks. (A Vector may use a 2-D block, for example,
+/// which can't be subset with a `Domain<1>`.)
+template <typename B, dimension_type D>
+struct has_subset_dim
+{
+  static bool const value = B::dim == D;
+};
+
+template <typename B, dimension_type D>
+struct has_subset_dim<B const, D> : has_subset_dim<B, D> {};
+
+template <template <typename> class O, typename B, dimension_type D>
+struct has_subset_dim<expr::Unary<O, B, true>, D> : has_subset_dim<B, D> {};
+
+template <template <typename, typename> class O,
+	  typename B1, typename B2, dimension_type D>
+struct has_subset_dim<expr::Binary<O, B1, B2, true>, D>
+{
+  static bool const value =
+    has_subset_dim<B1, D>::value && has_subset_dim<B2, D>::value;
+};
+
+template <template <typename, typename, typename> class O,
+	  typename B1, typename B2, typename B3, dimension_type D>
+struct has_subset_dim<expr::Ternary<O, B1, B2, B3, true>, D>
+{
+  static bool const value =
+    has_subset_dim<B1, D>::value &&
+    has_subset_dim<B2, D>::value &&
+    has_subset_dim<B3, D>::value;
+};
+
+/// The backends following `B` in the backend list `L`.
+template <typename L, typename B>
+struct backends_after : backends_after<typename L::tail, B> {};
+
+template <typename B, typename N>
+struct backends_after<dispatcher::type_list<B, N>, B>
+{
+  typedef N type;
+};
+
+/// Split an assignment into chunks along its outermost dimension,
+/// and assign the chunks concurrently, each by the backend the
+/// assignment dispatcher selects for it from those following
+/// this one.
+template <typename LHS, typename RHS,
+	  dimension_type D = LHS::dim,
+	  typename O = typename get_block_layout<LHS>::order_type>
+struct threaded
+{
+  static void exec(LHS &lhs, RHS const &rhs, thread_pool &pool)
+  {
+    typedef expr::Subset<LHS> lhs_type;
+    typedef typename subexpr<RHS>::type rhs_type;
+    typedef dispatcher::op::assign<D> op_type;
+    typedef dispatcher::Dispatcher<
+      op_type, void(lhs_type &, rhs_type const &),
+      typename backends_after<typename dispatcher::List<op_type>::type,
+			      dispatcher::be::threaded>::type> dispatcher_type;
+
+    dimension_type const outer = O::impl_dim0;
+    length_type const size = lhs.size(D, outer);
+    if (!size) return;
+    length_type const chunk =
+      std::max<length_type>(1, threaded_chunk<typename LHS::value_type>::value /
+			    (lhs.size() / size));
+    pool.parallel_for((size + chunk - 1) / chunk, [&](index_type c)
+    {
+      Domain<1> dom[D];
+      for (dimension_type d = 0; d != D; ++d)
+	dom[d] = Domain<1>(lhs.size(D, d));
+      dom[outer] = Domain<1>(c * chunk, 1, std::min(size - c * chunk, chunk));
+      Domain<D> const sub = construct_domain<D>(dom);
+      lhs_type l(sub, lhs);
+      rhs_type r = subexpr<RHS>::apply(rhs, sub);
+      dispatcher_type::dispatch(l, r);
+    });
+  }
+};
+
+} // namespace ovxx::assignment
+
+namespace dispatcher
+{
+template <dimension_type D, typename LHS, typename RHS>
+struct Evaluator<op::assign<D>, be::threaded, void(LHS &, RHS const &)>
+{
+  static bool const ct_valid =
+    assignment::is_threaded_expr<RHS>::value &&
+    assignment::has_subset_dim<LHS, D>::value &&
+    assignment::has_subset_dim<RHS, D>::value;
+  static std::string name() { return OVXX_DISPATCH_EVAL_NAME;}
+  static bool rt_valid(LHS &lhs, RHS const &)
+  {
+    thread_pool *pool = thread_pool::get_default();
+    return pool && pool->concurrency() > 1 &&
+      !thread_pool::in_parallel_region() &&
+      lhs.size() >= assignment::threaded_threshold();
+  }
+  static void exec(LHS &lhs, RHS const &rhs)
+  {
+    expr::evaluate(rhs);
+    assignment::threaded<LHS, RHS, D>::exec(lhs, rhs, *thread_pool::get_default());
+  }
+};
+
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
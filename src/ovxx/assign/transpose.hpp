@@ -0,0 +1,316 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_assign_transpose_hpp_
+#define ovxx_assign_transpose_hpp_
+
+#include <ovxx/assign_fwd.hpp>
+#include <ovxx/assign/copy.hpp>
+#include <ovxx/assign/threaded.hpp>
+#include <ovxx/is_same_ptr.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <vsip/dda.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace ovxx
+{
+namespace assignment
+{
+
+/// Transposes are split into square tiles of this edge length, such
+/// that a source and a destination tile fit into the first-level cache
+/// together.
+template <typename T>
+struct transpose_tile
+{
+  static length_type const value = sizeof(T) <= 4 ? 64 : sizeof(T) <= 8 ? 32 : 16;
+};
+
+/// Within a tile, blocks of this edge length are loaded into registers,
+/// and stored back transposed.
+template <typename T>
+struct transpose_block
+{
+  static length_type const value = sizeof(T) <= 4 ? 8 : 4;
+};
+
+/// Return the pool a transpose of `size` elements should run on,
+/// or 0 if it should run serially.
+inline thread_pool *transpose_pool(length_type size)
+{
+  thread_pool *pool = thread_pool::get_default();
+  if (pool && pool->concurrency() > 1 && size >= threaded_threshold())
+    return pool;
+  return 0;
+}
+
+/// Run `f(i)` for all `i` in `[0, n)`, in parallel if `pool` is set.
+template <typename F>
+void transpose_for(thread_pool *pool, length_type n, F f)
+{
+  if (pool) pool->parallel_for(n, f);
+  else for (index_type i = 0; i != n; ++i) f(i);
+}
+
+template <length_type K, typename T1, typename T2>
+inline void
+transpose_block_kernel(T1 *lhs, stride_type lhs_col_stride,
+		       T2 const *rhs, stride_type rhs_row_stride)
+{
+  T2 block[K][K];
+  for (index_type r = 0; r != K; ++r)
+    for (index_type c = 0; c != K; ++c)
+      block[c][r] = rhs[r*rhs_row_stride + c];
+  for (index_type c = 0; c != K; ++c)
+    for (index_type r = 0; r != K; ++r)
+      lhs[r + c*lhs_col_stride] = block[c][r];
+}
+
+template <typename T1, typename T2>
+void
+transpose_tile_kernel(T1 *lhs, stride_type lhs_col_stride,
+		      T2 const *rhs, stride_type rhs_row_stride,
+		      length_type lhs_rows, length_type lhs_cols)
+{
+  length_type const K = transpose_block<T2>::value;
+  index_type r = 0;
+  for (; r + K <= lhs_rows; r += K)
+  {
+    index_type c = 0;
+    for (; c + K <= lhs_cols; c += K)
+      transpose_block_kernel<K>(lhs + r + c*lhs_col_stride, lhs_col_stride,
+				rhs + r*rhs_row_stride + c, rhs_row_stride);
+    for (; c != lhs_cols; ++c)
+      for (index_type i = r; i != r + K; ++i)
+	lhs[i + c*lhs_col_stride] = rhs[i*rhs_row_stride + c];
+  }
+  for (; r != lhs_rows; ++r)
+    for (index_type c = 0; c != lhs_cols; ++c)
+      lhs[r + c*lhs_col_stride] = rhs[r*rhs_row_stride + c];
+}
+
+/// Out-of-place transpose of a row-major source into a
+/// column-major destination, tile by tile.
+template <typename T1, typename T2>
+void
+transpose(T1 *lhs, stride_type lhs_col_stride,
+	  T2 const *rhs, stride_type rhs_row_stride,
+	  length_type lhs_rows, length_type lhs_cols)
+{
+  length_type const tile = transpose_tile<T2>::value;
+  length_type const row_tiles = (lhs_rows + tile - 1) / tile;
+  length_type const col_tiles = (lhs_cols + tile - 1) / tile;
+  transpose_for(transpose_pool(lhs_rows * lhs_cols), row_tiles * col_tiles,
+		[&](index_type t)
+  {
+    index_type const r = (t / col_tiles) * tile;
+    index_type const c = (t % col_tiles) * tile;
+    transpose_tile_kernel(lhs + r + c*lhs_col_stride, lhs_col_stride,
+			  rhs + r*rhs_row_stride + c, rhs_row_stride,
+			  std::min(tile, lhs_rows - r), std::min(tile, lhs_cols - c));
+  });
+}
+
+template <typename T>
+void
+transpose(std::pair<T*, T*> const &lhs, stride_type lhs_col_stride,
+	  std::pair<T const*, T const*> const &rhs, stride_type rhs_row_stride,
+	  length_type lhs_rows, length_type lhs_cols)
+{
+  transpose(lhs.first, lhs_col_stride, rhs.first, rhs_row_stride, lhs_rows, lhs_cols);
+  transpose(lhs.second, lhs_col_stride, rhs.second, rhs_row_stride, lhs_rows, lhs_cols);
+}
+
+/// In-place transpose of a square matrix. Pairs of tiles mirrored
+/// across the diagonal are swapped with each other.
+template <typename T>
+void
+transpose(T *data,
+	  stride_type row_stride,
+	  stride_type col_stride,
+	  length_type rows,
+	  length_type cols)
+{
+  OVXX_PRECONDITION(rows == cols);
+  length_type const tile = transpose_tile<T>::value;
+  length_type const tiles = (rows + tile - 1) / tile;
+  auto swap = [&](index_type ti, index_type tj)
+  {
+    index_type const i_end = std::min(rows, (ti + 1) * tile);
+    index_type const j_end = std::min(rows, (tj + 1) * tile);
+    for (index_type i = ti * tile; i != i_end; ++i)
+      for (index_type j = ti == tj ? i + 1 : tj * tile; j < j_end; ++j)
+	std::swap(data[col_stride * i + row_stride * j],
+		  data[col_stride * j + row_stride * i]);
+  };
+  // Tile row `t` holds `tiles - t` tiles on or above the diagonal.
+  // Pairing it with row `tiles - 1 - t` balances the tasks.
+  transpose_for(transpose_pool(rows * cols), (tiles + 1) / 2, [&](index_type t)
+  {
+    for (index_type tj = t; tj != tiles; ++tj) swap(t, tj);
+    index_type const u = tiles - 1 - t;
+    if (u != t)
+      for (index_type tj = u; tj != tiles; ++tj) swap(u, tj);
+  });
+}
+
+template <typename T>
+void
+transpose(std::pair<T*, T*> const &d,
+	  stride_type row_stride,
+	  stride_type col_stride,
+	  length_type rows,
+	  length_type cols)
+{
+  transpose(d.first,  row_stride, col_stride, rows, cols);
+  transpose(d.second, row_stride, col_stride, rows, cols);
+}
+
+/// In-place transpose of a dense row-major `rows` x `cols` matrix
+/// into a dense row-major `cols` x `rows` matrix.
+///
+/// The element at position `p` moves to `p * rows mod (size - 1)`.
+/// Each cycle of that permutation is followed once, using one bit
+/// per element to track the positions already visited.
+template <typename T>
+void
+transpose(T *data, length_type rows, length_type cols)
+{
+  length_type const size = rows * cols;
+  if (rows == 1 || cols == 1) return;
+  std::vector<bool> done(size);
+  for (index_type start = 1; start < size - 1; ++start)
+  {
+    if (done[start]) continue;
+    T value = data[start];
+    index_type p = start;
+    do
+    {
+      p = (p * rows) % (size - 1);
+      std::swap(data[p], value);
+      done[p] = true;
+    }
+    while (p != start);
+  }
+}
+
+template <typename T>
+void
+transpose(std::pair<T*, T*> const &d, length_type rows, length_type cols)
+{
+  transpose(d.first, rows, cols);
+  transpose(d.second, rows, cols);
+}
+
+template <typename LHS, typename RHS>
+void transpose(LHS &lhs, RHS const &rhs, col2_type, row2_type)
+{
+  vsip::dda::Data<LHS, dda::out> lhs_data(lhs);
+  vsip::dda::Data<RHS, dda::in> rhs_data(rhs);
+  length_type const rows = lhs.size(2, 0);
+  length_type const cols = lhs.size(2, 1);
+
+  if (is_same_ptr(lhs_data.ptr(), rhs_data.ptr()))
+  {
+    if (rows == cols)
+      transpose(lhs_data.ptr(), lhs_data.stride(0), lhs_data.stride(1), rows, cols);
+    else
+    {
+      // Only dense data can be transposed in place unless it's square.
+      OVXX_PRECONDITION(rhs_data.stride(1) == 1 &&
+			rhs_data.stride(0) == static_cast<stride_type>(cols) &&
+			lhs_data.stride(0) == 1 &&
+			lhs_data.stride(1) == static_cast<stride_type>(rows));
+      transpose(lhs_data.ptr(), rows, cols);
+    }
+  }
+  else if (lhs_data.stride(0) == 1 && rhs_data.stride(1) == 1)
+  {
+    transpose(lhs_data.ptr(), lhs_data.stride(1),
+	      rhs_data.ptr(), rhs_data.stride(0),
+	      rows, cols);
+  }
+  else
+  {
+    copy(lhs_data.ptr(), lhs_data.stride(0), lhs_data.stride(1),
+	 rhs_data.ptr(), rhs_data.stride(0), rhs_data.stride(1),
+	 rows, cols);
+  }
+}
+
+template <typename LHS, typename RHS>
+void transpose(LHS &lhs, RHS const &rhs, row2_type, col2_type)
+{
+  vsip::dda::Data<LHS, dda::out> lhs_data(lhs);
+  vsip::dda::Data<RHS, dda::in> rhs_data(rhs);
+  length_type const rows = lhs.size(2, 0);
+  length_type const cols = lhs.size(2, 1);
+
+  if (is_same_ptr(lhs_data.ptr(), rhs_data.ptr()))
+  {
+    if (rows == cols)
+      transpose(lhs_data.ptr(), lhs_data.stride(0), lhs_data.stride(1), rows, cols);
+    else
+    {
+      // Only dense data can be transposed in place unless it's square.
+      OVXX_PRECONDITION(rhs_data.stride(0) == 1 &&
+			rhs_data.stride(1) == static_cast<stride_type>(rows) &&
+			lhs_data.stride(1) == 1 &&
+			lhs_data.stride(0) == static_cast<stride_type>(cols));
+      transpose(lhs_data.ptr(), cols, rows);
+    }
+  }
+  else if (lhs_data.stride(1) == 1 && rhs_data.stride(0) == 1)
+  {
+    transpose(lhs_data.ptr(), lhs_data.stride(0),
+	      rhs_data.ptr(), rhs_data.stride(1),
+	      cols, rows);
+  }
+  else
+  {
+    copy(lhs_data.ptr(), lhs_data.stride(0), lhs_data.stride(1),
+	 rhs_data.ptr(), rhs_data.stride(0), rhs_data.stride(1),
+	 rows, cols);
+  }
+}
+
+} // namespace ovxx::assignment
+
+namespace dispatcher
+{
+
+/// 2D copy assignment between blocks of different dimension-ordering,
+/// i.e. matrix transpose.
+template <typename LHS, typename RHS>
+struct Evaluator<op::assign<2>, be::transpose, void(LHS &, RHS const &)>
+{
+  static std::string name() { return OVXX_DISPATCH_EVAL_NAME;}
+
+  typedef typename get_block_layout<RHS>::order_type rhs_order_type;
+  typedef typename get_block_layout<LHS>::order_type lhs_order_type;
+
+  static bool const ct_valid =
+    is_same<typename RHS::value_type, typename LHS::value_type>::value &&
+    !is_same<rhs_order_type, lhs_order_type>::value &&
+    !is_expr_block<RHS>::value &&
+    dda::Data<LHS, dda::out>::ct_cost == 0 &&
+    dda::Data<RHS, dda::in>::ct_cost == 0 &&
+    is_split_block<LHS>::value == is_split_block<RHS>::value;
+
+  static bool rt_valid(LHS &, RHS const &) { return true;}
+
+  static void exec(LHS &lhs, RHS const &rhs)
+  {
+    assignment::transpose(lhs, rhs, lhs_order_type(), rhs_order_type());
+  }
+};
+
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
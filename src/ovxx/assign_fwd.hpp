@@ -51,7 +51,9 @@ struct List<op::assign<D> >
 {
   typedef make_type_list<be::user,
 			 be::cuda,
+			 be::threaded,
 			 be::dense_expr,
+			 be::transpose,
 			 be::copy,
 			 be::op_expr,
 			 be::simd,
@@ -126,6 +126,7 @@ class Fft<1, complex<T>, complex<T>, S>
   typedef fft_traits<1, complex<T>, S == fft_fwd ? -1 : 1> traits;
 
 public:
+  virtual char const* name() { return "cvsip<1,complex,complex>";}
   Fft(Domain<1> const &d, rtype scale, unsigned int n, int /*h*/)
     : impl_(traits::create(d.size(), scale, n))
   {}
@@ -176,6 +177,7 @@ class Fft<1, T, complex<T>, 0>
   typedef fft_traits<1, T, -1> traits;
 
 public:
+  virtual char const* name() { return "cvsip<1,real,complex>";}
   Fft(Domain<1> const &d, rtype scale, unsigned int n, int /*h*/)
     : impl_(traits::create(d.size(), scale, n))
   {}
@@ -212,6 +214,7 @@ class Fft<1, complex<T>, T, 0>
   typedef fft_traits<1, T, 1> traits;
 
 public:
+  virtual char const* name() { return "cvsip<1,complex,real>";}
   Fft(Domain<1> const &d, rtype scale, unsigned int n, int /*h*/)
     : impl_(traits::create(d.size(), scale, n))
   {}
@@ -252,6 +255,7 @@ class Fftm<complex<T>, complex<T>, A, D>
   static int const axis = A == vsip::col ? 0 : 1;
 
 public:
+  virtual char const* name() { return "cvsip_m<complex,complex>";}
   Fftm(Domain<2> const &dom, rtype scale, unsigned int n, int /*h*/)
     : impl_(traits::create(dom[axis].size(), scale, n)),
       mult_(dom[1-axis].size())
@@ -413,6 +417,7 @@ class Fftm<T, complex<T>, A, fft_fwd>
   static int const axis = A == vsip::col ? 0 : 1;
 
 public:
+  virtual char const* name() { return "cvsip_m<real,complex>";}
   Fftm(Domain<2> const &dom, rtype scale, unsigned int n, int /*h*/)
     : impl_(traits::create(dom[axis].size(), scale, n)),
       mult_(dom[1-axis].size())
@@ -512,6 +517,7 @@ class Fftm<complex<T>, T, A, fft_inv>
   static int const axis = A == vsip::col ? 0 : 1;
 
 public:
+  virtual char const* name() { return "cvsip_m<complex,real>";}
   Fftm(Domain<2> const &dom, rtype scale, unsigned int n, int /*h*/)
     : impl_(traits::create(dom[axis].size(), scale, n)),
       mult_(dom[1-axis].size())
@@ -204,6 +204,7 @@ public:
   }
 
   virtual void reset() VSIP_NOTHROW { traits::reset(fir_);}
+  virtual char const* name() { return "cvsip";}
 private:
   aligned_array<T> kernel_data_;
   View<1, T> kernel_;
@@ -99,6 +99,12 @@
   cfg << "  OVXX_SAL_FFT                  - 0\n";
 #endif
 
+#if OVXX_BUILTIN_FFT
+  cfg << "  OVXX_BUILTIN_FFT              - 1\n";
+#else
+  cfg << "  OVXX_BUILTIN_FFT              - 0\n";
+#endif
+
 #if OVXX_DFT_FFT
   cfg << "  OVXX_DFT_FFT                  - 1\n";
 #else
@@ -111,6 +111,7 @@ OVXX_BE_NAME(user)
 OVXX_BE_NAME(transpose)
 OVXX_BE_NAME(opencl)
 OVXX_BE_NAME(cuda)
+OVXX_BE_NAME(threaded)
 OVXX_BE_NAME(blas)
 OVXX_BE_NAME(dense_expr)
 OVXX_BE_NAME(copy)
@@ -120,6 +121,12 @@ OVXX_BE_NAME(fc_expr)
 OVXX_BE_NAME(rbo_expr)
 OVXX_BE_NAME(mdim_expr)
 OVXX_BE_NAME(loop_fusion)
+OVXX_BE_NAME(fftw)
+OVXX_BE_NAME(builtin)
+OVXX_BE_NAME(bluestein)
+OVXX_BE_NAME(no_fft)
+OVXX_BE_NAME(lapack)
+OVXX_BE_NAME(parallel)
 OVXX_BE_NAME(cvsip)
 OVXX_BE_NAME(opt)
 OVXX_BE_NAME(generic)
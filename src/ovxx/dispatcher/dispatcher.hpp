@@ -64,6 +64,20 @@ struct Evaluator
   static bool const ct_valid = false;
 };
 
+/// A profiling hook: when profiling is compiled in (see
+/// ovxx/profile.hpp), an Event is constructed from the arguments of
+/// each evaluation the Dispatcher performs, and lives as long as it.
+/// Operations that want to be profiled specialize it.
+///
+/// Template parameters:
+///   :O: Operation tag
+///   :E: The evaluator being executed.
+template <typename O, typename E>
+struct Event
+{
+  template <typename ...A> Event(A const &...) {}
+};
+
 template <typename O,                               // operation
           typename S = typename Signature<O>::type, // signature
           typename L = typename List<O>::type,      // list of backends
@@ -102,7 +116,12 @@ struct Dispatcher<O, R(A...), L, B, N, E, true>
   static R dispatch(A... args)
   {
     if (E::rt_valid(args...))
+    {
+#if OVXX_PROFILE
+      Event<O, E> event(args...);
+#endif
       return E::exec(args...);
+    }
     else return Dispatcher<O, R(A...), N>::dispatch(args...);
   }
 };
@@ -114,7 +133,13 @@ struct Dispatcher<O, R(A...), L, B, null_type, E, true>
   typedef B backend;
   static R dispatch(A... args)
   {
-    if (E::rt_valid(args...)) return E::exec(args...);
+    if (E::rt_valid(args...))
+    {
+#if OVXX_PROFILE
+      Event<O, E> event(args...);
+#endif
+      return E::exec(args...);
+    }
     else throw std::runtime_error("No backend");
   }
 };
@@ -22,6 +22,8 @@ namespace be
 struct user;
 /// Optimized Matrix Transpose
 struct transpose;
+/// Multi-threaded expr evaluation
+struct threaded;
 /// Dense multi-dim expr reduction
 struct dense_expr;
 /// Optimized Copy
@@ -40,6 +42,10 @@ struct mdim_expr;
 struct loop_fusion;
 /// FFTW.
 struct fftw;
+/// Built-in FFT
+struct builtin;
+/// Chirp-z FFT for sizes with large prime factors
+struct bluestein;
 /// Dummy FFT
 struct no_fft;
 
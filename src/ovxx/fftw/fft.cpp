@@ -9,8 +9,14 @@
 #include <ovxx/support.hpp>
 #include <ovxx/layout.hpp>
 #include <ovxx/aligned_array.hpp>
+#include <ovxx/thread.hpp>
 #include <vsip/dense.hpp>
 #include <fftw3.h>
+#include <vector>
+#include <map>
+#include <string>
+#include <cstring>
+#include <stdexcept>
 
 namespace ovxx
 {
@@ -23,6 +29,68 @@ namespace fftw
 // As best guess we use the library default complex storage-format.
 storage_format_type const complex_storage_format = Dense<1, complex<float> >::storage_format;
 
+// FFTW's planner is not thread-safe, so all plan creation and
+// destruction is serialized.
+std::mutex planner_mutex;
+
+// Plans are shared among all backends performing the same transform.
+// They are keyed on the planner arguments, and destroyed when the
+// last backend using them goes away.
+// All access is guarded by planner_mutex.
+class plan_cache
+{
+public:
+  typedef std::vector<long> key_type;
+
+  // Return the plan for `key` and add a reference to it,
+  // or return 0 if there is none.
+  void *acquire(key_type const &key)
+  {
+    map_type::iterator i = plans_.find(key);
+    if (i == plans_.end()) return 0;
+    ++i->second.refs;
+    return i->second.plan;
+  }
+  void insert(key_type const &key, void *plan)
+  {
+    entry &e = plans_[key];
+    e.plan = plan;
+    e.refs = 1;
+  }
+  // Remove a reference to `plan`, and return true if that
+  // was the last one, in which case the caller destroys it.
+  bool release(void *plan)
+  {
+    for (map_type::iterator i = plans_.begin(); i != plans_.end(); ++i)
+      if (i->second.plan == plan)
+      {
+	if (--i->second.refs) return false;
+	plans_.erase(i);
+	return true;
+      }
+    // Not a cached plan.
+    return true;
+  }
+
+private:
+  struct entry
+  {
+    void *plan;
+    unsigned int refs;
+  };
+  typedef std::map<key_type, entry> map_type;
+
+  map_type plans_;
+};
+
+plan_cache plans;
+
+// The kinds of plans a planner creates.
+enum plan_kind { c2c_in_place, c2c_out_of_place, r2c, c2r};
+
+// The file wisdom is loaded from and saved to, if any.
+std::string wisdom_file;
+
 // Turn a dimension to make 'A' the major axis
 Domain<1> turn(Domain<1> const &dom, int) { return dom;}
 Domain<2> turn(Domain<2> const &dom, int A)
@@ -98,3 +166,68 @@ template <typename I, typename O, int A, int D> class fftm;
 #  undef SCALAR_TYPE
 #  undef FFTW
 #endif
+
+namespace ovxx
+{
+namespace fftw
+{
+namespace
+{
+// Single- and double-precision wisdom can't share a file,
+// so each gets its own suffix.
+std::string wisdom_file_name(char const *suffix)
+{
+  return wisdom_file + suffix;
+}
+}
+
+void initialize(int &argc, char **&argv)
+{
+#if defined(OVXX_FFTW_THREADS)
+# ifdef OVXX_FFTW_HAVE_FLOAT
+  if (!fftwf_init_threads())
+    OVXX_DO_THROW(std::runtime_error("Error during FFTW initialization"));
+# endif
+# ifdef OVXX_FFTW_HAVE_DOUBLE
+  if (!fftw_init_threads())
+    OVXX_DO_THROW(std::runtime_error("Error during FFTW initialization"));
+# endif
+#endif
+  char const *option = "--ovxx-fftw-wisdom=";
+  size_t const length = std::strlen(option);
+  for (int i = 1; i < argc; ++i)
+  {
+    if (std::strncmp(argv[i], option, length)) continue;
+    wisdom_file = argv[i] + length;
+    for (int j = i; j < argc; ++j) argv[j] = argv[j + 1];
+    --argc;
+    break;
+  }
+  if (wisdom_file.empty()) return;
+
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  // A missing file simply means there is no wisdom yet.
+#ifdef OVXX_FFTW_HAVE_FLOAT
+  fftwf_import_wisdom_from_filename(wisdom_file_name(".f").c_str());
+#endif
+#ifdef OVXX_FFTW_HAVE_DOUBLE
+  fftw_import_wisdom_from_filename(wisdom_file_name(".d").c_str());
+#endif
+}
+
+void finalize()
+{
+  if (wisdom_file.empty()) return;
+
+  std::lock_guard<std::mutex> lock(planner_mutex);
+#ifdef OVXX_FFTW_HAVE_FLOAT
+  fftwf_export_wisdom_to_filename(wisdom_file_name(".f").c_str());
+#endif
+#ifdef OVXX_FFTW_HAVE_DOUBLE
+  fftw_export_wisdom_to_filename(wisdom_file_name(".d").c_str());
+#endif
+  wisdom_file.clear();
+}
+
+} // namespace ovxx::fftw
+} // namespace ovxx
@@ -20,6 +20,14 @@ namespace fftw
 {
 using vsip::complex;
 
+/// Initialize FFTW. If the command line contains
+/// `--ovxx-fftw-wisdom=<file>`, the option is removed and
+/// wisdom is imported from `<file>.f` (single precision)
+/// and `<file>.d` (double precision), where they exist.
+void initialize(int &argc, char **&argv);
+/// Export accumulated wisdom to the files named at initialization.
+void finalize();
+
 template <typename I, dimension_type D>
 std::unique_ptr<I>
 create(vsip::Domain<D> const &dom, unsigned);
@@ -36,6 +36,56 @@ template <dimension_type D>
 Domain<D> FFTW(iosize)(Domain<D> const &dom)
 { return io_size<D, complex<SCALAR_TYPE>, SCALAR_TYPE, D-1>::size(dom);}
 
+// Serialize planning, and tell FFTW how many threads the plan
+// about to be created may use.
+struct FFTW(plan_guard)
+{
+  FFTW(plan_guard)(length_type points)
+    : lock_(planner_mutex),
+      threads_(signal::fft::planning_threads(points))
+  {
+#if defined(OVXX_FFTW_THREADS)
+    FFTW(plan_with_nthreads)(threads_);
+#endif
+  }
+  // Return the cached plan for the given parameters, or else
+  // create (and cache) one by calling `make`.
+  template <typename F>
+  FFTW(plan) operator()(plan_kind kind, int rank, FFTW(iodim) const *dims,
+			int exp, int flags, F make)
+  {
+    plan_cache::key_type key;
+    key.push_back(sizeof(SCALAR_TYPE));
+    key.push_back(kind);
+    key.push_back(exp);
+    key.push_back(flags);
+    key.push_back(threads_);
+    for (int i = 0; i != rank; ++i)
+    {
+      key.push_back(dims[i].n);
+      key.push_back(dims[i].is);
+      key.push_back(dims[i].os);
+    }
+    FFTW(plan) plan = static_cast<FFTW(plan)>(plans.acquire(key));
+    if (!plan && (plan = make())) plans.insert(key, plan);
+    return plan;
+  }
+  // Drop a reference to `plan`, destroying it if it was the last.
+  void release(FFTW(plan) plan)
+  {
+    if (plans.release(plan)) FFTW(destroy_plan)(plan);
+  }
+
+  std::lock_guard<std::mutex> lock_;
+  unsigned int threads_;
+};
+
+inline void FFTW(release_plan)(FFTW(plan) plan)
+{
+  std::lock_guard<std::mutex> lock(planner_mutex);
+  if (plans.release(plan)) FFTW(destroy_plan)(plan);
+}
+
 template <dimension_type D>
 struct planner<D, complex<SCALAR_TYPE>, complex<SCALAR_TYPE> >
 {
@@ -58,6 +108,7 @@ struct planner<D, complex<SCALAR_TYPE>, complex<SCALAR_TYPE> >
     in_buffer_ = aligned_array<complex<SCALAR_TYPE> >(32, total_size);
     out_buffer_ = aligned_array<complex<SCALAR_TYPE> >(32, total_size);
 
+    FFTW(plan_guard) guard(dom.size() * mult_);
     FFTW(iodim) dims[D];
     for (index_type i = 0; i != D; ++i) 
     { 
@@ -70,14 +121,20 @@ struct planner<D, complex<SCALAR_TYPE>, complex<SCALAR_TYPE> >
 	array_cast<split_complex>(in_buffer_);
       std::pair<SCALAR_TYPE*,SCALAR_TYPE*> out = 
 	array_cast<split_complex>(out_buffer_);
-      plan_ip_ = FFTW(plan_guru_split_dft)(D, dims, 0, 0,
-					   in.first, in.second,
-					   in.first, in.second,
-					   flags);
-      plan_op_ = FFTW(plan_guru_split_dft)(D, dims, 0, 0,
-					   in.first, in.second,
-					   out.first, out.second,
-					   flags);
+      plan_ip_ = guard(c2c_in_place, D, dims, exp, flags, [&]()
+      {
+	return FFTW(plan_guru_split_dft)(D, dims, 0, 0,
+					 in.first, in.second,
+					 in.first, in.second,
+					 flags);
+      });
+      plan_op_ = guard(c2c_out_of_place, D, dims, exp, flags, [&]()
+      {
+	return FFTW(plan_guru_split_dft)(D, dims, 0, 0,
+					 in.first, in.second,
+					 out.first, out.second,
+					 flags);
+      });
     }
     else
     {
@@ -85,26 +142,32 @@ struct planner<D, complex<SCALAR_TYPE>, complex<SCALAR_TYPE> >
 	reinterpret_cast<FFTW(complex)*>(in_buffer_.get());
       FFTW(complex) *out =
 	reinterpret_cast<FFTW(complex)*>(out_buffer_.get());
-      plan_ip_ = FFTW(plan_guru_dft)(D, dims, 0, 0,
-				     in,
-				     in,
-				     exp, flags);
-      plan_op_ = FFTW(plan_guru_dft)(D, dims, 0, 0,
-				     in,
-				     out,
-				     exp, flags);
+      plan_ip_ = guard(c2c_in_place, D, dims, exp, flags, [&]()
+      {
+	return FFTW(plan_guru_dft)(D, dims, 0, 0,
+				   in,
+				   in,
+				   exp, flags);
+      });
+      plan_op_ = guard(c2c_out_of_place, D, dims, exp, flags, [&]()
+      {
+	return FFTW(plan_guru_dft)(D, dims, 0, 0,
+				   in,
+				   out,
+				   exp, flags);
+      });
     }
-    if (!plan_ip_) OVXX_DO_THROW(std::bad_alloc());
-    if (!plan_op_)
+    if (!plan_ip_ || !plan_op_)
     {
-      FFTW(destroy_plan)(plan_ip_);
+      if (plan_ip_) guard.release(plan_ip_);
+      if (plan_op_) guard.release(plan_op_);
       OVXX_DO_THROW(std::bad_alloc());
     }
   }
   ~planner() VSIP_NOTHROW
   {
-    FFTW(destroy_plan)(plan_op_);
-    FFTW(destroy_plan)(plan_ip_);
+    FFTW(release_plan)(plan_op_);
+    FFTW(release_plan)(plan_ip_);
   }
 
   aligned_array<complex<SCALAR_TYPE> > in_buffer_;
@@ -164,6 +227,7 @@ struct planner<D, SCALAR_TYPE, complex<SCALAR_TYPE> >
     in_buffer_ = aligned_array<SCALAR_TYPE>(32, in_total_size);
     out_buffer_ = aligned_array<complex<SCALAR_TYPE> >(32, out_total_size);
 
+    FFTW(plan_guard) guard(dom.size() * mult_);
     FFTW(iodim) dims[D];
     for (index_type i = 0; i != D; ++i) 
     {
@@ -176,19 +240,23 @@ struct planner<D, SCALAR_TYPE, complex<SCALAR_TYPE> >
       SCALAR_TYPE *in = in_buffer_.get();
       std::pair<SCALAR_TYPE*,SCALAR_TYPE*> out = 
 	array_cast<split_complex>(out_buffer_);
-      plan_ = FFTW(plan_guru_split_dft_r2c)(D, dims, 0, 0,
-					    in, out.first, out.second,
-					    flags);
+      plan_ = guard(r2c, D, dims, 0, flags, [&]()
+      {
+	return FFTW(plan_guru_split_dft_r2c)(D, dims, 0, 0,
+					     in, out.first, out.second,
+					     flags);
+      });
     }
     else
     {
       SCALAR_TYPE *in = in_buffer_.get();
       FFTW(complex) *out = reinterpret_cast<FFTW(complex)*>(out_buffer_.get());
-      plan_ = FFTW(plan_guru_dft_r2c)(D, dims, 0, 0, in, out, flags);
+      plan_ = guard(r2c, D, dims, 0, flags, [&]()
+      { return FFTW(plan_guru_dft_r2c)(D, dims, 0, 0, in, out, flags);});
     }
     if (!plan_) OVXX_DO_THROW(std::bad_alloc());
   }
-  ~planner() VSIP_NOTHROW { FFTW(destroy_plan)(plan_);}
+  ~planner() VSIP_NOTHROW { FFTW(release_plan)(plan_);}
 
   aligned_array<SCALAR_TYPE> in_buffer_;
   aligned_array<complex<SCALAR_TYPE> > out_buffer_;
@@ -246,6 +314,7 @@ struct planner<D, complex<SCALAR_TYPE>, SCALAR_TYPE>
     in_buffer_ = aligned_array<complex<SCALAR_TYPE> >(32, in_total_size);
     out_buffer_ = aligned_array<SCALAR_TYPE>(32, out_total_size);
     
+    FFTW(plan_guard) guard(dom.size() * mult_);
     FFTW(iodim) dims[D];    
     for (index_type i = 0; i != D; ++i) 
     {
@@ -258,19 +327,23 @@ struct planner<D, complex<SCALAR_TYPE>, SCALAR_TYPE>
       std::pair<SCALAR_TYPE*,SCALAR_TYPE*> in = 
 	array_cast<split_complex>(in_buffer_);
       SCALAR_TYPE *out = out_buffer_.get();
-      plan_ = FFTW(plan_guru_split_dft_c2r)(D, dims, 0, 0,
-					    in.first, in.second, out,
-					    flags);
+      plan_ = guard(c2r, D, dims, 0, flags, [&]()
+      {
+	return FFTW(plan_guru_split_dft_c2r)(D, dims, 0, 0,
+					     in.first, in.second, out,
+					     flags);
+      });
     }
     else
     {
       FFTW(complex) *in = reinterpret_cast<FFTW(complex)*>(in_buffer_.get());
       SCALAR_TYPE *out = out_buffer_.get();
-      plan_ = FFTW(plan_guru_dft_c2r)(D, dims, 0, 0, in, out, flags);
+      plan_ = guard(c2r, D, dims, 0, flags, [&]()
+      { return FFTW(plan_guru_dft_c2r)(D, dims, 0, 0, in, out, flags);});
     }
     if (!plan_) OVXX_DO_THROW(std::bad_alloc());
   }
-  ~planner() VSIP_NOTHROW { FFTW(destroy_plan)(plan_);}
+  ~planner() VSIP_NOTHROW { FFTW(release_plan)(plan_);}
 
   aligned_array<complex<SCALAR_TYPE> > in_buffer_;
   aligned_array<SCALAR_TYPE> out_buffer_;
@@ -291,6 +364,7 @@ class fft<1, complex<SCALAR_TYPE>, complex<SCALAR_TYPE>, S>
   typedef std::pair<rtype*, rtype*> ztype;
 
 public:
+  virtual char const* name() { return "fftw<1,complex,complex>";}
   fft(Domain<1> const &dom, unsigned number)
     : planner<1, ctype, ctype>
       (dom, exponent<ctype, ctype, S>::value, make_flags<ctype>(dom, number))
@@ -363,6 +437,7 @@ class fft<1, SCALAR_TYPE, complex<SCALAR_TYPE>, 0>
   typedef std::pair<rtype*, rtype*> ztype;
 
 public:
+  virtual char const* name() { return "fftw<1,real,complex>";}
   fft(Domain<1> const &dom, unsigned number)
     : planner<1, rtype, ctype>(dom, 0, make_flags<rtype>(dom, number))
   {}
@@ -405,6 +480,7 @@ class fft<1, complex<SCALAR_TYPE>, SCALAR_TYPE, 0>
   typedef std::pair<rtype*, rtype*> ztype;
 
 public:
+  virtual char const* name() { return "fftw<1,complex,real>";}
   fft(Domain<1> const &dom, unsigned number)
     : planner<1, ctype, rtype>(dom, 0, make_flags<rtype>(dom, number))
   {}
@@ -445,6 +521,7 @@ class fft<2, complex<SCALAR_TYPE>, complex<SCALAR_TYPE>, S>
   typedef std::pair<rtype*, rtype*> ztype;
 
 public:
+  virtual char const* name() { return "fftw<2,complex,complex>";}
   fft(Domain<2> const &dom, unsigned number)
     : planner<2, ctype, ctype>
       (dom, exponent<ctype, ctype, S>::value, make_flags(number))
@@ -522,6 +599,7 @@ class fft<2, SCALAR_TYPE, complex<SCALAR_TYPE>, A>
   typedef std::pair<rtype*, rtype*> ztype;
 
 public:
+  virtual char const* name() { return "fftw<2,real,complex>";}
   fft(Domain<2> const &dom, unsigned number)
     : planner<2, rtype, ctype>(dom, A, make_flags(number))
   {}
@@ -567,6 +645,7 @@ class fft<2, complex<SCALAR_TYPE>, SCALAR_TYPE, A>
   typedef std::pair<rtype*, rtype*> ztype;
 
 public:
+  virtual char const* name() { return "fftw<2,complex,real>";}
   fft(Domain<2> const &dom, unsigned number)
     : planner<2, ctype, rtype>(dom, A, make_flags(number, false))
   {}
@@ -611,6 +690,7 @@ class fft<3, complex<SCALAR_TYPE>, complex<SCALAR_TYPE>, S>
   typedef std::pair<rtype*, rtype*> ztype;
 
 public:
+  virtual char const* name() { return "fftw<3,complex,complex>";}
   fft(Domain<3> const &dom, unsigned number)
     : planner<3, ctype, ctype>(dom, exponent<ctype, ctype, S>::value, make_flags(number))
   {}
@@ -688,6 +768,7 @@ class fft<3, SCALAR_TYPE, complex<SCALAR_TYPE>, A>
   typedef std::pair<rtype*, rtype*> ztype;
 
 public:
+  virtual char const* name() { return "fftw<3,real,complex>";}
   fft(Domain<3> const &dom, unsigned number)
     : planner<3, rtype, ctype>(dom, A, make_flags(number))
   {}
@@ -735,6 +816,7 @@ class fft<3, complex<SCALAR_TYPE>, SCALAR_TYPE, A>
   typedef std::pair<rtype*, rtype*> ztype;
 
 public:
+  virtual char const* name() { return "fftw<3,complex,real>";}
   fft(Domain<3> const &dom, unsigned number)
     : planner<3, ctype, rtype>(dom, A, make_flags(number, false))
   {}
@@ -786,6 +868,7 @@ class fftm<SCALAR_TYPE, complex<SCALAR_TYPE>, A, fft_fwd>
   static int const axis = A == vsip::col ? 0 : 1;
 
 public:
+  virtual char const* name() { return "fftw_m<real,complex>";}
   fftm(Domain<2> const &dom, unsigned number)
     : planner<1, rtype, ctype>(dom[axis], 0, make_flags<rtype>(dom[axis], number, false),
 			       dom[1 - axis].length())
@@ -853,6 +936,7 @@ class fftm<complex<SCALAR_TYPE>, SCALAR_TYPE, A, fft_inv>
   static int const axis = A == vsip::col ? 0 : 1;
 
 public:
+  virtual char const* name() { return "fftw_m<complex,real>";}
   fftm(Domain<2> const &dom, unsigned number)
     : planner<1, ctype, rtype>(dom[axis], 0, make_flags<rtype>(dom[axis], number), dom[1-axis].length())
   {
@@ -913,6 +997,7 @@ class fftm<complex<SCALAR_TYPE>, complex<SCALAR_TYPE>, A, D>
   static int const axis = A == vsip::col ? 0 : 1;
 
 public:
+  virtual char const* name() { return "fftw_m<complex,complex>";}
   fftm(Domain<2> const &dom, int number)
     : planner<1, ctype, ctype>
       (dom[axis], exponent<ctype, ctype, D>::value, make_flags<ctype>(dom[axis], number), dom[1-axis].size())
@@ -6,15 +6,18 @@
 // This file is part of OpenVSIP. It is made available under the
 // license contained in the accompanying LICENSE.BSD file.
 
+#include <algorithm>
 #include <limits>
 #include <cstdlib>
-#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
 #include <fcntl.h>
-#include <string.h>
-#include <errno.h>
 #include <unistd.h>
 
 #include <ovxx/config.hpp>
@@ -22,186 +25,363 @@
 
 namespace ovxx
 {
-
-// Allocate memory in huge page space (that are freed on program
-// termination)
-//
-// Requires
-//   MEM_FILE to be a filename in the /huge pages directory.
-//   PAGES to be the number of pages.
-//
-// Returns a pointer to the start of the memory if successful,
-//   NULL otherwise.
-
-char *open_huge_pages(char const* mem_file, int pages)
+namespace
 {
-  int   fmem;
-  char* mem_addr;
-
-  if ((fmem = open(mem_file, O_CREAT | O_RDWR, 0755)) == -1)
-  {
-    std::cerr << "WARNING: unable to open file " << mem_file
-	      << " (errno=" << errno << " " << strerror(errno) << ")\n";
-    return 0;
-  }
-
+// Map `size` bytes of the hugetlbfs file `file`.
+// Return 0 on failure.
+char *map_hugetlbfs(char const *file, size_t size, size_t page_size)
+{
+  if (!file) return 0;
+  int fd = open(file, O_CREAT | O_RDWR, 0755);
+  if (fd == -1) return 0;
   // Delete file so that huge pages will get freed on program termination.
-  remove(mem_file);
-	
-  mem_addr = (char *)mmap(0, pages * 0x1000000,
-			  PROT_READ | PROT_WRITE, MAP_SHARED, fmem, 0);
-
-  if (mem_addr == MAP_FAILED)
-  {
-    std::cerr << "ERROR: unable to mmap file " << mem_file
-	      << " (errno=" << errno << " " << strerror(errno) << ")\n";
-    close(fmem);
-    return 0;
-  }
-
-    // Touch each of the large pages.
-    for (int i=0; i<pages; ++i)
-      mem_addr[i*0x1000000 + 0x0800000] = (char) 0;
-
-  return mem_addr;
+  remove(file);
+  void *addr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) return 0;
+  // Touch each of the large pages.
+  char *mem = static_cast<char *>(addr);
+  for (size_t offset = 0; offset < size; offset += page_size)
+    mem[offset] = 0;
+  return mem;
 }
 
-huge_page_allocator::huge_page_allocator(char const*file, int pages)
-  : pool_(open_huge_pages(file, pages)),
-    size_(pages * 0x1000000),
-    free_(pool_),
-    total_avail_(size_)
+// Map `size` bytes of anonymous memory from the reserved huge pages.
+// Return 0 on failure.
+char *map_anonymous(size_t size)
 {
-  *(char**)free_ = 0; // next block
-  ((std::size_t*)free_)[1] = size_;
+#ifdef MAP_HUGETLB
+  void *addr = mmap(0, size, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (addr != MAP_FAILED) return static_cast<char *>(addr);
+#endif
+  return 0;
 }
 
-void *huge_page_allocator::allocate(std::size_t size)
+// Map `size` bytes of anonymous memory aligned to `page_size`,
+// and ask the kernel to back it with transparent huge pages.
+// Return 0 on failure.
+char *map_transparent(size_t size, size_t page_size)
 {
-  // If size == 0, allocate 1 byte.
-  if (size < 2*sizeof(char*))
-    size = 2*sizeof(char*);
+  void *addr = mmap(0, size + page_size, PROT_READ | PROT_WRITE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED) return 0;
+  // Trim the mapping to a huge page boundary.
+  char *raw = static_cast<char *>(addr);
+  char *mem = reinterpret_cast<char *>
+    ((reinterpret_cast<size_t>(raw) + page_size - 1) & ~(page_size - 1));
+  if (mem != raw) munmap(raw, mem - raw);
+  if (mem + size != raw + size + page_size)
+    munmap(mem + size, raw + page_size - mem);
+#ifdef MADV_HUGEPAGE
+  madvise(mem, size, MADV_HUGEPAGE);
+#endif
+  return mem;
+}
 
-  // Maintain 128 B alignment
-  if (size % 128 != 0)
-    size += 128 - (size % 128);
+inline unsigned int msb(size_t n) { return 63 - __builtin_clzll(n);}
+inline unsigned int lsb(size_t n) { return __builtin_ctzll(n);}
 
-  char*  prev  = 0;
-  char*  ptr   = free_;
-  std::size_t avail = ptr ? ((std::size_t*)ptr)[1] : 0;
+} // namespace <unnamed>
 
-  while (ptr && avail < size)
+/// A two-level segregated fit arena.
+///
+/// Every block starts with a header holding the size of the block and
+/// a pointer to its physical predecessor. Free blocks additionally link
+/// into the list of their size class. Block sizes are multiples of
+/// `align`, and blocks start `header` bytes before an `align` boundary,
+/// so all payloads are aligned. A zero-sized sentinel block marks the
+/// end of the arena.
+struct huge_page_allocator::arena
+{
+  struct block
   {
-    prev  = ptr;
-    ptr   = *(char**)ptr;
-    avail = ptr ? ((std::size_t*)ptr)[1] : 0;
-  }
-
-  if (ptr == 0)
-    OVXX_THROW(std::bad_alloc());
-
-  total_avail_ -= size;
+    block *prev_phys;
+    // The size in bytes, including the header. The lowest bit is
+    // set if the block is free.
+    size_t size;
+    // Only valid in free blocks.
+    block *next_free;
+    block *prev_free;
+  };
+  static size_t const header = 2 * sizeof(void *);
+  // Each power-of-two range of sizes is split into 2^sl_log2 classes.
+  static unsigned int const sl_log2 = 4;
+  static unsigned int const sl_count = 1 << sl_log2;
+  static unsigned int const fl_count = 64 - sl_log2;
 
-  if (avail == size)
+  void initialize(char *begin, size_t size)
   {
-    // Exact match.
-    if (prev == 0)
-      free_ = *(char**)ptr;
-    else
-      *(char**)prev = *(char**)ptr;
+    avail = 0;
+    fl_bitmap = 0;
+    for (unsigned int f = 0; f != fl_count; ++f)
+    {
+      sl_bitmap[f] = 0;
+      for (unsigned int s = 0; s != sl_count; ++s) free[f][s] = 0;
+    }
+    if (size < 2 * align) return;
+    block *first = reinterpret_cast<block *>(begin + align - header);
+    size_t const bytes = (size - align) & ~(align - 1);
+    block *last = reinterpret_cast<block *>(reinterpret_cast<char *>(first) + bytes);
+    first->prev_phys = 0;
+    first->size = bytes;
+    last->prev_phys = first;
+    last->size = 0;
+    insert(first);
+    avail = bytes;
   }
-  else
+
+  static size_t size_of(block *b) { return b->size & ~size_t(1);}
+  static bool is_free(block *b) { return b->size & 1;}
+  static block *next_phys(block *b)
+  { return reinterpret_cast<block *>(reinterpret_cast<char *>(b) + size_of(b));}
+
+  // Compute the list a block of `bytes` bytes belongs to.
+  static void mapping(size_t bytes, unsigned int &f, unsigned int &s)
   {
-    // Larger match, carve out chunk.
-    if (prev == 0)
+    size_t const n = bytes / align;
+    if (n < sl_count)
     {
-      free_ = ptr + size;
+      f = 0;
+      s = n;
     }
     else
     {
-      *(char**)prev = ptr + size;
+      unsigned int const m = msb(n);
+      f = m - sl_log2 + 1;
+      s = (n >> (m - sl_log2)) - sl_count;
     }
-
-    *(char**)(ptr + size) = *(char**)ptr;
-    ((std::size_t*)(ptr + size))[1] = avail - size;
   }
 
-  return (void*)ptr;
-}
-
-void huge_page_allocator::deallocate(void *return_ptr, std::size_t size)
-{
-  if (size < 2*sizeof(char*))
-    size = 2*sizeof(char*);
-
-  // Maintain 128 B alignment
-  if (size % 128 != 0)
-    size += 128 - (size % 128);
-
-  char*  prev  = 0;
-  char*  ptr   = free_;
-
-  while (ptr && ptr < return_ptr)
+  void insert(block *b)
   {
-    prev  = ptr;
-    ptr   = *(char**)ptr;
+    unsigned int f, s;
+    mapping(size_of(b), f, s);
+    b->size |= 1;
+    b->prev_free = 0;
+    b->next_free = free[f][s];
+    if (b->next_free) b->next_free->prev_free = b;
+    free[f][s] = b;
+    fl_bitmap |= size_t(1) << f;
+    sl_bitmap[f] |= 1u << s;
   }
 
-  if (ptr == 0)
+  void remove(block *b)
   {
-    // Free list empty.
-    ((std::size_t*)(return_ptr))[1] = size;
-    free_ = (char*)return_ptr;
+    unsigned int f, s;
+    mapping(size_of(b), f, s);
+    if (b->prev_free) b->prev_free->next_free = b->next_free;
+    else free[f][s] = b->next_free;
+    if (b->next_free) b->next_free->prev_free = b->prev_free;
+    if (!free[f][s])
+    {
+      sl_bitmap[f] &= ~(1u << s);
+      if (!sl_bitmap[f]) fl_bitmap &= ~(size_t(1) << f);
+    }
+    b->size &= ~size_t(1);
   }
-  else if (prev == 0)
+
+  // Find a free block of at least `bytes` bytes. Rounding the request
+  // up to the next class boundary guarantees that any block in the
+  // class found is large enough. Failing that, the head of the
+  // request's own class may still fit.
+  block *find(size_t bytes)
   {
-    assert(free_ == ptr);
-    assert(ptr-(char*)return_ptr >= (ptrdiff_t)size);
-    if ((ptrdiff_t)size == ptr - (char*)return_ptr)
+    size_t n = bytes / align;
+    if (n >= sl_count) n += (size_t(1) << (msb(n) - sl_log2)) - 1;
+    unsigned int f, s;
+    mapping(n * align, f, s);
+    if (f < fl_count)
     {
-      // Insert at front of free list, merge with next entry.
-      *(char**)(return_ptr)      = *(char**)ptr;
-      ((std::size_t*)(return_ptr))[1] = size + ((std::size_t*)(ptr))[1];
-      free_ = (char*)return_ptr;
+      unsigned int sl_map = sl_bitmap[f] & (~0u << s);
+      if (!sl_map && f + 1 < fl_count)
+      {
+	size_t const fl_map = fl_bitmap & (~size_t(0) << (f + 1));
+	if (fl_map)
+	{
+	  f = lsb(fl_map);
+	  sl_map = sl_bitmap[f];
+	}
+      }
+      if (sl_map) return free[f][lsb(sl_map)];
     }
-    else
+    mapping(bytes, f, s);
+    block *b = free[f][s];
+    return b && size_of(b) >= bytes ? b : 0;
+  }
+
+  void *allocate(size_t size)
+  {
+    size_t const bytes = (size + header + align - 1) & ~(align - 1);
+    std::lock_guard<std::mutex> lock(mutex);
+    block *b = find(bytes);
+    if (!b) return 0;
+    remove(b);
+    size_t const total = size_of(b);
+    if (total - bytes >= align)
     {
-      // Insert at front of free list, no merge.
-      *(char**)(return_ptr)      = ptr;
-      ((std::size_t*)(return_ptr))[1] = size;
-      free_ = (char*)return_ptr;
+      // Split off the remainder.
+      block *r = reinterpret_cast<block *>(reinterpret_cast<char *>(b) + bytes);
+      r->prev_phys = b;
+      r->size = total - bytes;
+      next_phys(r)->prev_phys = r;
+      b->size = bytes;
+      insert(r);
     }
+    avail -= size_of(b);
+    return reinterpret_cast<char *>(b) + header;
   }
-  else
+
+  void deallocate(void *ptr)
   {
-    assert(ptr-(char*)return_ptr >= (ptrdiff_t)size);
-    if ((ptrdiff_t)size == ptr - (char*)return_ptr)
+    block *b = reinterpret_cast<block *>(static_cast<char *>(ptr) - header);
+    std::lock_guard<std::mutex> lock(mutex);
+    avail += size_of(b);
+    block *next = next_phys(b);
+    if (is_free(next))
     {
-      // Insert in middle of free list, merge
-      *(char**)(return_ptr)      = *(char**)ptr;
-      ((std::size_t*)(return_ptr))[1] = size + ((std::size_t*)(ptr))[1];
+      remove(next);
+      b->size += size_of(next);
+      next_phys(b)->prev_phys = b;
     }
-    else
+    block *prev = b->prev_phys;
+    if (prev && is_free(prev))
     {
-      // Insert in middle of free list, no merge
-      *(char**)(return_ptr)      = ptr;
-      ((std::size_t*)(return_ptr))[1] = size;
+      remove(prev);
+      prev->size += size_of(b);
+      next_phys(prev)->prev_phys = prev;
+      b = prev;
     }
+    insert(b);
+  }
+
+  std::mutex mutex;
+  size_t avail;
+  size_t fl_bitmap;
+  unsigned int sl_bitmap[fl_count];
+  block *free[fl_count][sl_count];
+};
+
+size_t huge_page_allocator::default_page_size()
+{
+  static size_t page_size = 0;
+  if (!page_size)
+  {
+    char line[1024];
+    unsigned long kb = 2048;
+    std::ifstream file("/proc/meminfo");
+    while (file.getline(line, sizeof(line)))
+      if (std::sscanf(line, "Hugepagesize: %lu kB", &kb) == 1)
+	break;
+    page_size = size_t(kb) * 1024;
+  }
+  return page_size;
+}
+
+huge_page_allocator::huge_page_allocator(parameters const &p)
+  : fallbacks_(0)
+{
+  map(p);
+}
 
-    std::size_t prev_size = ((std::size_t*)prev)[1];
+huge_page_allocator::huge_page_allocator(char const *file, int pages)
+  : fallbacks_(0)
+{
+  parameters p;
+  p.source = hugetlbfs;
+  p.file = file;
+  p.size = pages * default_page_size();
+  p.fallback = false;
+  map(p);
+}
+
+huge_page_allocator::~huge_page_allocator()
+{
+  delete [] arenas_;
+  if (pool_) munmap(pool_, size_);
+}
 
-    if ((ptrdiff_t)prev_size == (char*)return_ptr - prev)
+void huge_page_allocator::map(parameters const &p)
+{
+  page_size_ = default_page_size();
+  size_ = (p.size + page_size_ - 1) / page_size_ * page_size_;
+  fallback_ = p.fallback;
+  source_ = p.source;
+  pool_ = 0;
+  if (size_)
+  {
+    switch (source_)
     {
-      // Merge with prev.
-      *(char**)(prev) = *(char**)return_ptr;
-      ((std::size_t*)(prev))[1] = size + ((std::size_t*)(return_ptr))[1];
+      case hugetlbfs: pool_ = map_hugetlbfs(p.file, size_, page_size_); break;
+      case anonymous: pool_ = map_anonymous(size_); break;
+      case transparent: pool_ = map_transparent(size_, page_size_); break;
+      case none: break;
     }
-    else
-      // No merge with prev.
-      *(char**)(prev) = (char*)return_ptr;
+    if (!pool_ && fallback_ && source_ != none)
+    {
+      source_ = transparent;
+      pool_ = map_transparent(size_, page_size_);
+    }
+  }
+  if (!pool_)
+  {
+    if (!fallback_) OVXX_DO_THROW(std::bad_alloc());
+    source_ = none;
+    size_ = 0;
+  }
+  // Arenas start on huge page boundaries if they are large enough.
+  num_arenas_ = std::max(p.arenas, 1u);
+  if (size_ / num_arenas_ < 2 * align) num_arenas_ = 1;
+  arena_size_ = size_ / num_arenas_;
+  if (arena_size_ >= page_size_) arena_size_ = arena_size_ / page_size_ * page_size_;
+  else arena_size_ = arena_size_ / align * align;
+  arenas_ = new arena[num_arenas_];
+  for (unsigned int i = 0; i != num_arenas_; ++i)
+  {
+    size_t const extent = i + 1 == num_arenas_ ? size_ - i * arena_size_ : arena_size_;
+    arenas_[i].initialize(pool_ + i * arena_size_, extent);
+  }
+}
+
+size_t huge_page_allocator::total_avail() const
+{
+  size_t avail = 0;
+  for (unsigned int i = 0; i != num_arenas_; ++i)
+  {
+    std::lock_guard<std::mutex> lock(arenas_[i].mutex);
+    avail += arenas_[i].avail;
   }
+  return avail;
+}
+
+void *huge_page_allocator::allocate(size_t size)
+{
+  // If size == 0, allocate 1 byte.
+  if (size == 0) size = 1;
+  if (size < size_)
+  {
+    // Start with the calling thread's arena, then try the others.
+    unsigned int const first = num_arenas_ == 1 ? 0 :
+      std::hash<std::thread::id>()(std::this_thread::get_id()) % num_arenas_;
+    for (unsigned int i = 0; i != num_arenas_; ++i)
+      if (void *ptr = arenas_[(first + i) % num_arenas_].allocate(size))
+	return ptr;
+  }
+  if (!fallback_) OVXX_DO_THROW(std::bad_alloc());
+  ++fallbacks_;
+  return alloc_align<char>(align, size);
+}
 
-  total_avail_ += size;
+void huge_page_allocator::deallocate(void *ptr, size_t /*size*/)
+{
+  char *p = static_cast<char *>(ptr);
+  if (p < pool_ || p >= pool_ + size_)
+  {
+    free_align(ptr);
+    return;
+  }
+  unsigned int const i = std::min<size_t>((p - pool_) / arena_size_, num_arenas_ - 1);
+  arenas_[i].deallocate(ptr);
 }
 
 } // namespace ovxx
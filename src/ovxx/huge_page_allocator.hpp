@@ -11,31 +11,95 @@
 
 #include <ovxx/allocator.hpp>
 #include <ovxx/aligned_allocator.hpp>
+#include <atomic>
 #include <limits>
 #include <cstdlib>
 
 namespace ovxx
 {
 
-#if OVXX_ENABLE_HUGE_PAGE_ALLOCATOR
+#if OVXX_ENABLE_HUGE_PAGE_POOL
+/// An allocator serving requests from memory backed by huge pages.
+///
+/// The memory is mapped once, up front, and split into one or more
+/// arenas, each guarded by its own lock. Threads are spread across
+/// the arenas. Within an arena, free blocks are kept in size-segregated
+/// lists indexed by a two-level bitmap, so allocation and deallocation
+/// take constant time, and neighbouring free blocks are merged as
+/// soon as they are released.
+///
+/// Requests the arenas can't satisfy are passed on to normal pages,
+/// unless fallback is disabled, in which case std::bad_alloc is thrown.
 class huge_page_allocator : public allocator
 {
 public:
   static size_t const align = 128;
 
+  enum source_type
+  {
+    /// A file in a mounted hugetlbfs.
+    hugetlbfs,
+    /// Anonymous memory mapped with MAP_HUGETLB.
+    anonymous,
+    /// Anonymous memory advised with MADV_HUGEPAGE.
+    transparent,
+    /// Nothing could be mapped; all requests fall back to normal pages.
+    none
+  };
+
+  struct parameters
+  {
+    parameters()
+      : source(anonymous), file(0), size(size_t(1) << 30), arenas(1), fallback(true)
+    {}
+    /// Where to obtain the memory from. If that fails and
+    /// `fallback` is set, transparent huge pages are used instead.
+    source_type source;
+    /// The file to map, if `source == hugetlbfs`.
+    char const *file;
+    /// The size of the pool in bytes, rounded up to whole huge pages.
+    size_t size;
+    /// The number of arenas the pool is split into.
+    unsigned int arenas;
+    /// Whether to fall back to normal pages when the pool runs dry.
+    bool fallback;
+  };
+
+  explicit huge_page_allocator(parameters const &p = parameters());
+  /// Map `pages` huge pages from the hugetlbfs file `file`,
+  /// without fallback.
   huge_page_allocator(char const *file, int pages);
+  ~huge_page_allocator();
+
+  /// The source the memory was actually obtained from.
+  source_type source() const { return source_;}
+  size_t page_size() const { return page_size_;}
+  /// The size of the pool in bytes.
+  size_t size() const { return size_;}
+  /// The number of bytes available in the pool.
+  size_t total_avail() const;
+  /// The number of requests that were passed on to normal pages.
+  size_t fallbacks() const { return fallbacks_;}
 
-  size_t total_avail() { return total_avail_;}
+  /// Return the system's default huge page size.
+  static size_t default_page_size();
 
 private:
+  struct arena;
+
+  void map(parameters const &p);
   void *allocate(size_t size);
   void deallocate(void *ptr, size_t size);
 
+  source_type source_;
+  size_t page_size_;
   char *pool_;
   size_t size_;
-  char *free_;
-
-  size_t total_avail_;
+  bool fallback_;
+  arena *arenas_;
+  unsigned int num_arenas_;
+  size_t arena_size_;
+  std::atomic<size_t> fallbacks_;
 };
 #else
 typedef aligned_allocator huge_page_allocator;
@@ -10,6 +10,9 @@
 #include <ovxx/allocator.hpp>
 #include <ovxx/chrono.hpp>
 #include <ovxx/thread.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/profile.hpp>
+#include <ovxx/signal/window.hpp>
 #if defined(OVXX_HAVE_OPENCL)
 # include <ovxx/opencl/library.hpp>
 #endif
@@ -24,8 +27,8 @@ extern "C" {
 # include <vsip.h>
 }
 #endif
-#if defined(OVXX_FFTW_THREADS)
-# include <fftw3.h>
+#if defined(OVXX_FFTW)
+# include <ovxx/fftw/fft.hpp>
 #endif
 
 using namespace ovxx;
@@ -48,7 +51,7 @@ thread_local library *omp_library = 0;
 unsigned int thread_local_count = 0;
 #endif
 
-void initialize(int &argc, char **&argv)
+void initialize(int &argc, char **&argv, thread_pool::parameters params)
 {
   {
 #if defined(OVXX_ENABLE_THREADING)
@@ -69,21 +72,19 @@ void initialize(int &argc, char **&argv)
 #if (OVXX_HAVE_CVSIP)
     vsip_init(0);
 #endif
-#if defined(OVXX_FFTW_THREADS)
-    int status = 0;
-# ifdef OVXX_FFTW_HAVE_FLOAT
-    status = fftwf_init_threads();
-    if (!status)
-      OVXX_DO_THROW(std::runtime_error("Error during FFTW initialization"));
-    fftwf_plan_with_nthreads(4);
-# endif
-# ifdef OVXX_FFTW_HAVE_DOUBLE
-    status = fftw_init_threads();
-    if (!status)
-      OVXX_DO_THROW(std::runtime_error("Error during FFTW initialization"));
-    fftw_plan_with_nthreads(4);
-# endif
-#endif // OVXX_FFTW_THREADS
+#if defined(OVXX_FFTW)
+    fftw::initialize(argc, argv);
+#endif
+    // Worker threads set up their allocators as they start,
+    // so the choice has to be made before the pool is created.
+    allocator::parse_options(argc, argv);
+    profile::parse_options(argc, argv);
+    // Thread pool options are accepted (and ignored) even
+    // without threading support.
+    thread_pool::parse_options(argc, argv, params);
+#if OVXX_ENABLE_THREADING
+    thread_pool::set_default(new thread_pool(params));
+#endif
   }
   if (thread_local_count == 1)
   {
@@ -129,6 +130,8 @@ void finalize()
   --thread_local_count;
   if (!thread_local_count)
   {
+    // Release cached windows while their allocator is still around.
+    if (!global_count) signal::clear_window_cache();
 #if OVXX_HAVE_MPI
     mpi::finalize(global_count == 0);
     allocator::finalize();
@@ -136,6 +139,14 @@ void finalize()
   }
   if (!global_count)
   {
+    profile::finalize();
+#if OVXX_ENABLE_THREADING
+    delete thread_pool::get_default();
+    thread_pool::set_default(0);
+#endif
+#if defined(OVXX_FFTW)
+    fftw::finalize();
+#endif
 #if (OVXX_HAVE_CVSIP)
     vsip_finalize(0);
 #endif
@@ -160,12 +171,29 @@ library::library()
   argv[0] = (char*) "program-name";
   argv[1] = NULL;
 
-  initialize(argc, argv);
+  initialize(argc, argv, thread_pool::parameters());
 }
 
 library::library(int &argc, char **&argv)
 {
-  initialize(argc, argv);
+  initialize(argc, argv, thread_pool::parameters());
+}
+
+library::library(thread_pool::parameters const &params)
+{
+  int argc = 1;
+  char *argv_storage[2];
+  char **argv = argv_storage;
+
+  argv[0] = (char*) "program-name";
+  argv[1] = NULL;
+
+  initialize(argc, argv, params);
+}
+
+library::library(int &argc, char **&argv, thread_pool::parameters const &params)
+{
+  initialize(argc, argv, params);
 }
 
 library::~library()
@@ -9,6 +9,7 @@
 #define ovxx_library_hpp_
 
 #include <ovxx/detail/noncopyable.hpp>
+#include <ovxx/thread_pool.hpp>
 
 namespace ovxx
 {
@@ -18,6 +19,10 @@ class library : detail::noncopyable
 public:
   library();
   library(int& argc, char**& argv);
+  /// Configure the library's thread pool. Command-line options
+  /// override the given parameters.
+  explicit library(thread_pool::parameters const &);
+  library(int& argc, char**& argv, thread_pool::parameters const &);
   ~library();
 };
 
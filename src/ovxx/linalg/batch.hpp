@@ -0,0 +1,903 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_linalg_batch_hpp_
+#define ovxx_linalg_batch_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/tensor.hpp>
+#include <vsip/impl/math_enum.hpp>
+#include <vsip/impl/solver/common.hpp>
+#include <ovxx/linalg/gemm.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/detail/noncopyable.hpp>
+#include <ovxx/math/scalar.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace ovxx
+{
+namespace linalg
+{
+/// The number of problems factored together by the batched solvers.
+length_type const batch_width = 8;
+
+namespace detail
+{
+
+/// Operations on one matrix element of `batch_width` interleaved
+/// problems. Real values are stored as `batch_width` consecutive
+/// scalars, so each operation is a loop over the problems that
+/// the compiler can vectorize. Operands never overlap.
+template <typename T>
+struct lanes
+{
+  typedef T scalar_type;
+  static length_type const size = batch_width;
+
+  static T get(T const *e, index_type l) { return e[l];}
+  static void put(T *e, index_type l, T v) { e[l] = v;}
+  static T magsq(T const *e, index_type l) { return e[l] * e[l];}
+  static void swap(T *a, T *b, index_type l) { std::swap(a[l], b[l]);}
+
+  /// c -= conj(a) * b, if `J` is set, c -= a * b otherwise.
+  template <bool J>
+  static void nmadd(T *OVXX_RESTRICT c, T const *OVXX_RESTRICT a,
+		    T const *OVXX_RESTRICT b)
+  {
+    PRAGMA_IVDEP
+    for (index_type l = 0; l != batch_width; ++l) c[l] -= a[l] * b[l];
+  }
+  /// c *= s, with a real `s` per problem.
+  static void scale(T *OVXX_RESTRICT c, T const *OVXX_RESTRICT s)
+  {
+    PRAGMA_IVDEP
+    for (index_type l = 0; l != batch_width; ++l) c[l] *= s[l];
+  }
+  /// c /= conj(a), if `J` is set, c /= a otherwise.
+  template <bool J>
+  static void div(T *OVXX_RESTRICT c, T const *OVXX_RESTRICT a)
+  {
+    PRAGMA_IVDEP
+    for (index_type l = 0; l != batch_width; ++l) c[l] /= a[l];
+  }
+  /// c *= 1 / a
+  static void mul_recip(T *OVXX_RESTRICT c, T const *OVXX_RESTRICT a)
+  {
+    T r[batch_width];
+    for (index_type l = 0; l != batch_width; ++l) r[l] = T(1) / a[l];
+    scale(c, r);
+  }
+};
+
+/// Complex values are stored as `batch_width` real parts
+/// followed by `batch_width` imaginary parts.
+template <typename T>
+struct lanes<complex<T> >
+{
+  typedef T scalar_type;
+  static length_type const size = 2 * batch_width;
+
+  static complex<T> get(T const *e, index_type l)
+  { return complex<T>(e[l], e[batch_width + l]);}
+  static void put(T *e, index_type l, complex<T> v)
+  { e[l] = v.real(); e[batch_width + l] = v.imag();}
+  static T magsq(T const *e, index_type l)
+  { return e[l] * e[l] + e[batch_width + l] * e[batch_width + l];}
+  static void swap(T *a, T *b, index_type l)
+  {
+    std::swap(a[l], b[l]);
+    std::swap(a[batch_width + l], b[batch_width + l]);
+  }
+
+  template <bool J>
+  static void nmadd(T *OVXX_RESTRICT c, T const *OVXX_RESTRICT a,
+		    T const *OVXX_RESTRICT b)
+  {
+    T const *ai = a + batch_width;
+    T const *bi = b + batch_width;
+    T *ci = c + batch_width;
+    PRAGMA_IVDEP
+    for (index_type l = 0; l != batch_width; ++l)
+    {
+      T const ar = a[l], aj = J ? -ai[l] : ai[l];
+      c[l] -= ar * b[l] - aj * bi[l];
+      ci[l] -= ar * bi[l] + aj * b[l];
+    }
+  }
+  static void scale(T *OVXX_RESTRICT c, T const *OVXX_RESTRICT s)
+  {
+    T *ci = c + batch_width;
+    PRAGMA_IVDEP
+    for (index_type l = 0; l != batch_width; ++l)
+    {
+      c[l] *= s[l];
+      ci[l] *= s[l];
+    }
+  }
+  template <bool J>
+  static void div(T *OVXX_RESTRICT c, T const *OVXX_RESTRICT a)
+  {
+    T const *ai = a + batch_width;
+    T *ci = c + batch_width;
+    PRAGMA_IVDEP
+    for (index_type l = 0; l != batch_width; ++l)
+    {
+      T const ar = a[l], aj = J ? -ai[l] : ai[l];
+      T const s = T(1) / (ar * ar + aj * aj);
+      T const cr = c[l];
+      c[l] = (cr * ar + ci[l] * aj) * s;
+      ci[l] = (ci[l] * ar - cr * aj) * s;
+    }
+  }
+  static void mul_recip(T *OVXX_RESTRICT c, T const *OVXX_RESTRICT a)
+  {
+    T r[size];
+    T *ri = r + batch_width;
+    T const *ai = a + batch_width;
+    T *ci = c + batch_width;
+    for (index_type l = 0; l != batch_width; ++l)
+    {
+      T const s = T(1) / (a[l] * a[l] + ai[l] * ai[l]);
+      r[l] = a[l] * s;
+      ri[l] = -ai[l] * s;
+    }
+    PRAGMA_IVDEP
+    for (index_type l = 0; l != batch_width; ++l)
+    {
+      T const cr = c[l];
+      c[l] = cr * r[l] - ci[l] * ri[l];
+      ci[l] = cr * ri[l] + ci[l] * r[l];
+    }
+  }
+};
+
+/// Strided access to a stack of matrices stored in format `F`.
+template <typename T, storage_format_type F, typename P>
+struct batch_ref
+{
+  typedef storage_traits<T, F> traits;
+
+  batch_ref(P p, stride_type k, stride_type r, stride_type c)
+    : ptr(p), s0(k), s1(r), s2(c) {}
+  T get(index_type k, index_type i, index_type j) const
+  { return traits::get(ptr, k*s0 + i*s1 + j*s2);}
+  void put(index_type k, index_type i, index_type j, T v) const
+  { traits::put(ptr, k*s0 + i*s1 + j*s2, v);}
+
+  P ptr;
+  stride_type s0, s1, s2;
+};
+
+template <typename T, storage_format_type F, typename P>
+batch_ref<T, F, P> make_batch_ref(P ptr, stride_type k, stride_type r, stride_type c)
+{ return batch_ref<T, F, P>(ptr, k, r, c);}
+
+} // namespace ovxx::linalg::detail
+
+/// Base class of the batched solvers.
+///
+/// The problems are stored in groups of `batch_width`, with the
+/// elements of all problems in a group interleaved, such that a
+/// single factorization of the group operates on all of its problems
+/// at once. Groups are processed in parallel on the default thread
+/// pool. Problems are passed either as a tensor of size
+/// `batch x rows x cols`, or as a matrix of size `batch*rows x cols`
+/// with the problems stacked on top of each other.
+template <typename T>
+class batch_solver : ovxx::detail::noncopyable
+{
+protected:
+  typedef detail::lanes<T> lanes;
+  typedef typename lanes::scalar_type scalar_type;
+  static length_type const esize = lanes::size;
+
+  /// Hold `batch` factored matrices of size `length x cols`
+  /// (`length x length` by default).
+  batch_solver(length_type length, length_type batch, length_type cols = 0)
+    : length_(length),
+      cols_(cols ? cols : length),
+      batch_(batch),
+      groups_((batch + batch_width - 1) / batch_width),
+      data_(groups_ * length_ * cols_ * esize),
+      valid_(groups_ * batch_width)
+  {
+    OVXX_PRECONDITION(length_ > 0 && cols_ > 0 && batch_ > 0);
+  }
+
+public:
+  length_type length() const VSIP_NOTHROW { return length_;}
+  length_type batch() const VSIP_NOTHROW { return batch_;}
+  /// Return whether problem `k` was successfully factored by
+  /// the last call to `decompose`.
+  bool valid(index_type k) const VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(k < batch_);
+    return valid_[k];
+  }
+
+protected:
+  /// Element `(i, j)` of the factored matrices in `group`.
+  scalar_type *at(index_type group, index_type i, index_type j)
+  { return data_.get() + ((group * cols_ + j) * length_ + i) * esize;}
+
+  /// Run `f(group)` for all groups, in parallel if `flops`, the
+  /// amount of work per problem, warrants it.
+  template <typename F>
+  void for_each_group(length_type flops, F f)
+  {
+    thread_pool *pool = thread_pool::get_default();
+    if (pool && pool->concurrency() > 1 && groups_ > 1 &&
+	batch_ * flops >= threaded_prod_threshold())
+      pool->parallel_for(groups_, f);
+    else
+      for (index_type g = 0; g != groups_; ++g) f(g);
+  }
+
+  /// Interleave `rows x cols` elements of the problems in `group`
+  /// into `dst`. Unused problems in the last group are taken from `pad`.
+  template <typename R, typename P>
+  void pack(R const &ref, index_type group, length_type rows, length_type cols,
+	    scalar_type *dst, P pad) const
+  {
+    for (index_type j = 0; j != cols; ++j)
+      for (index_type i = 0; i != rows; ++i, dst += esize)
+	for (index_type l = 0; l != batch_width; ++l)
+	{
+	  index_type const k = group * batch_width + l;
+	  lanes::put(dst, l, k < batch_ ? ref(k, i, j) : pad(i, j));
+	}
+  }
+
+  template <typename R>
+  void unpack(scalar_type const *src, index_type group,
+	      length_type rows, length_type cols, R const &ref) const
+  {
+    for (index_type j = 0; j != cols; ++j)
+      for (index_type i = 0; i != rows; ++i, src += esize)
+	for (index_type l = 0; l != batch_width; ++l)
+	{
+	  index_type const k = group * batch_width + l;
+	  if (k < batch_) ref.put(k, i, j, lanes::get(src, l));
+	}
+  }
+
+  template <typename B>
+  static detail::batch_ref<T, get_block_layout<B>::storage_format,
+			   typename dda::Data<B, dda::in>::ptr_type>
+  make_ref(dda::Data<B, dda::in> &data, length_type rows, bool stacked)
+  {
+    if (stacked)
+      return detail::make_batch_ref<T, get_block_layout<B>::storage_format>
+	(data.ptr(), rows * data.stride(0), data.stride(0), data.stride(1));
+    else
+      return detail::make_batch_ref<T, get_block_layout<B>::storage_format>
+	(data.ptr(), data.stride(0), data.stride(1), data.stride(2));
+  }
+  template <typename B>
+  static detail::batch_ref<T, get_block_layout<B>::storage_format,
+			   typename dda::Data<B, dda::out>::ptr_type>
+  make_ref(dda::Data<B, dda::out> &data, length_type rows, bool stacked)
+  {
+    if (stacked)
+      return detail::make_batch_ref<T, get_block_layout<B>::storage_format>
+	(data.ptr(), rows * data.stride(0), data.stride(0), data.stride(1));
+    else
+      return detail::make_batch_ref<T, get_block_layout<B>::storage_format>
+	(data.ptr(), data.stride(0), data.stride(1), data.stride(2));
+  }
+
+  /// Record the problems in `group` for which `ok` is false.
+  void set_valid(index_type group, bool const *ok)
+  {
+    for (index_type l = 0; l != batch_width; ++l)
+      valid_[group * batch_width + l] = ok[l];
+  }
+  bool all_valid() const
+  {
+    for (index_type k = 0; k != batch_; ++k)
+      if (!valid_[k]) return false;
+    return true;
+  }
+
+  length_type length_;
+  length_type cols_;
+  length_type batch_;
+  length_type groups_;
+  aligned_array<scalar_type> data_;
+  aligned_array<bool> valid_;
+};
+
+/// Batched Cholesky decomposition, A = L L^H, of `batch`
+/// Hermitian positive definite matrices of size `length`.
+template <typename T>
+class batch_chold : public batch_solver<T>
+{
+  typedef batch_solver<T> base_type;
+  typedef typename base_type::lanes lanes;
+  typedef typename base_type::scalar_type scalar_type;
+  using base_type::esize;
+  using base_type::length_;
+  using base_type::batch_;
+
+public:
+  batch_chold(mat_uplo uplo, length_type length, length_type batch)
+    VSIP_THROW((std::bad_alloc))
+    : base_type(length, batch), uplo_(uplo)
+  {
+    OVXX_PRECONDITION(uplo_ == upper || uplo_ == lower);
+  }
+
+  mat_uplo uplo() const VSIP_NOTHROW { return uplo_;}
+
+  /// Factor the `batch x length x length` matrices in `a`.
+  /// Return false if any of them is not positive definite.
+  template <typename B>
+  bool decompose(Tensor<T, B> a) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(a.size(0) == batch_ &&
+		      a.size(1) == length_ && a.size(2) == length_);
+    return decompose(a.block(), false);
+  }
+  /// Factor the `batch*length x length` stacked matrices in `a`.
+  template <typename B>
+  bool decompose(Matrix<T, B> a) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(a.size(0) == batch_ * length_ && a.size(1) == length_);
+    return decompose(a.block(), true);
+  }
+
+  /// Solve A X = B for each problem.
+  template <typename B0, typename B1>
+  bool solve(const_Tensor<T, B0> b, Tensor<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == batch_ && b.size(1) == length_);
+    OVXX_PRECONDITION(x.size(0) == batch_ && x.size(1) == length_ &&
+		      x.size(2) == b.size(2));
+    solve(b.block(), x.block(), b.size(2), false);
+    return true;
+  }
+  template <typename B0, typename B1>
+  bool solve(const_Matrix<T, B0> b, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == batch_ * length_);
+    OVXX_PRECONDITION(x.size(0) == b.size(0) && x.size(1) == b.size(1));
+    solve(b.block(), x.block(), b.size(1), true);
+    return true;
+  }
+
+private:
+  template <typename B>
+  bool decompose(B const &block, bool stacked)
+  {
+    dda::Data<B, dda::in> data(block);
+    length_type const n = length_;
+    mat_uplo const uplo = uplo_;
+    auto ref = this->make_ref(data, n, stacked);
+    auto get = [&](index_type k, index_type i, index_type j) -> T
+    {
+      if (i < j) return T(0);
+      return uplo == lower ? ref.get(k, i, j) : math::impl_conj(ref.get(k, j, i));
+    };
+    auto pad = [](index_type i, index_type j) { return T(i == j ? 1 : 0);};
+    this->for_each_group(n * n * n / 3 + 1, [&](index_type g)
+    {
+      this->pack(get, g, n, n, this->at(g, 0, 0), pad);
+      factor(g);
+    });
+    return this->all_valid();
+  }
+
+  void factor(index_type g)
+  {
+    length_type const n = length_;
+    bool ok[batch_width];
+    std::fill(ok, ok + batch_width, true);
+    for (index_type k = 0; k != n; ++k)
+    {
+      scalar_type *akk = this->at(g, k, k);
+      scalar_type r[batch_width];
+      for (index_type l = 0; l != batch_width; ++l)
+      {
+	scalar_type d = math::impl_real(lanes::get(akk, l));
+	if (!(d > scalar_type(0)))
+	{
+	  ok[l] = false;
+	  d = 1;
+	}
+	d = std::sqrt(d);
+	lanes::put(akk, l, T(d));
+	r[l] = scalar_type(1) / d;
+      }
+      for (index_type i = k + 1; i != n; ++i)
+	lanes::scale(this->at(g, i, k), r);
+      for (index_type j = k + 1; j != n; ++j)
+      {
+	scalar_type const *ajk = this->at(g, j, k);
+	for (index_type i = j; i != n; ++i)
+	  lanes::template nmadd<true>(this->at(g, i, j), ajk, this->at(g, i, k));
+      }
+    }
+    this->set_valid(g, ok);
+  }
+
+  template <typename B0, typename B1>
+  void solve(B0 const &b_block, B1 &x_block, length_type p, bool stacked)
+  {
+    dda::Data<B0, dda::in> b_data(b_block);
+    dda::Data<B1, dda::out> x_data(x_block);
+    length_type const n = length_;
+    auto b_ref = this->make_ref(b_data, n, stacked);
+    auto x_ref = this->make_ref(x_data, n, stacked);
+    auto get = [&](index_type k, index_type i, index_type j) { return b_ref.get(k, i, j);};
+    auto pad = [](index_type, index_type) { return T(0);};
+    this->for_each_group(2 * n * n * p + 1, [&](index_type g)
+    {
+      aligned_array<scalar_type> buffer(n * p * esize);
+      this->pack(get, g, n, p, buffer.get(), pad);
+      for (index_type j = 0; j != p; ++j)
+      {
+	scalar_type *x = buffer.get() + j * n * esize;
+	// L Y = B
+	for (index_type c = 0; c != n; ++c)
+	{
+	  lanes::template div<false>(x + c * esize, this->at(g, c, c));
+	  for (index_type i = c + 1; i < n; ++i)
+	    lanes::template nmadd<false>(x + i * esize, this->at(g, i, c), x + c * esize);
+	}
+	// L^H X = Y
+	for (index_type c = n; c-- > 0;)
+	{
+	  for (index_type i = c + 1; i < n; ++i)
+	    lanes::template nmadd<true>(x + c * esize, this->at(g, i, c), x + i * esize);
+	  lanes::template div<true>(x + c * esize, this->at(g, c, c));
+	}
+      }
+      this->unpack(buffer.get(), g, n, p, x_ref);
+    });
+  }
+
+  mat_uplo uplo_;
+};
+
+/// Batched LU decomposition with partial pivoting, P A = L U, of
+/// `batch` matrices of size `length`.
+template <typename T>
+class batch_lud : public batch_solver<T>
+{
+  typedef batch_solver<T> base_type;
+  typedef typename base_type::lanes lanes;
+  typedef typename base_type::scalar_type scalar_type;
+  using base_type::esize;
+  using base_type::length_;
+  using base_type::batch_;
+  using base_type::groups_;
+
+public:
+  batch_lud(length_type length, length_type batch) VSIP_THROW((std::bad_alloc))
+    : base_type(length, batch),
+      ipiv_(groups_ * length * batch_width)
+  {}
+
+  /// Factor the `batch x length x length` matrices in `a`.
+  /// Return false if any of them is singular.
+  template <typename B>
+  bool decompose(Tensor<T, B> a) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(a.size(0) == batch_ &&
+		      a.size(1) == length_ && a.size(2) == length_);
+    return decompose(a.block(), false);
+  }
+  /// Factor the `batch*length x length` stacked matrices in `a`.
+  template <typename B>
+  bool decompose(Matrix<T, B> a) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(a.size(0) == batch_ * length_ && a.size(1) == length_);
+    return decompose(a.block(), true);
+  }
+
+  /// Solve op(A) X = B for each problem.
+  template <mat_op_type tr, typename B0, typename B1>
+  bool solve(const_Tensor<T, B0> b, Tensor<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == batch_ && b.size(1) == length_);
+    OVXX_PRECONDITION(x.size(0) == batch_ && x.size(1) == length_ &&
+		      x.size(2) == b.size(2));
+    solve<tr>(b.block(), x.block(), b.size(2), false);
+    return true;
+  }
+  template <mat_op_type tr, typename B0, typename B1>
+  bool solve(const_Matrix<T, B0> b, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == batch_ * length_);
+    OVXX_PRECONDITION(x.size(0) == b.size(0) && x.size(1) == b.size(1));
+    solve<tr>(b.block(), x.block(), b.size(1), true);
+    return true;
+  }
+
+private:
+  template <typename B>
+  bool decompose(B const &block, bool stacked)
+  {
+    dda::Data<B, dda::in> data(block);
+    length_type const n = length_;
+    auto ref = this->make_ref(data, n, stacked);
+    auto get = [&](index_type k, index_type i, index_type j) { return ref.get(k, i, j);};
+    auto pad = [](index_type i, index_type j) { return T(i == j ? 1 : 0);};
+    this->for_each_group(2 * n * n * n / 3 + 1, [&](index_type g)
+    {
+      this->pack(get, g, n, n, this->at(g, 0, 0), pad);
+      factor(g);
+    });
+    return this->all_valid();
+  }
+
+  void factor(index_type g)
+  {
+    length_type const n = length_;
+    index_type *ipiv = ipiv_.get() + g * n * batch_width;
+    bool ok[batch_width];
+    std::fill(ok, ok + batch_width, true);
+    for (index_type k = 0; k != n; ++k)
+    {
+      for (index_type l = 0; l != batch_width; ++l)
+      {
+	index_type p = k;
+	scalar_type max = lanes::magsq(this->at(g, k, k), l);
+	for (index_type i = k + 1; i < n; ++i)
+	{
+	  scalar_type const m = lanes::magsq(this->at(g, i, k), l);
+	  if (m > max) max = m, p = i;
+	}
+	ipiv[k * batch_width + l] = p;
+	if (max == scalar_type(0))
+	{
+	  // Keep going with a unit pivot, so the other problems
+	  // are unaffected.
+	  ok[l] = false;
+	  lanes::put(this->at(g, k, k), l, T(1));
+	}
+	else if (p != k)
+	  for (index_type j = 0; j != n; ++j)
+	    lanes::swap(this->at(g, k, j), this->at(g, p, j), l);
+      }
+      scalar_type const *akk = this->at(g, k, k);
+      for (index_type i = k + 1; i < n; ++i)
+	lanes::mul_recip(this->at(g, i, k), akk);
+      for (index_type j = k + 1; j < n; ++j)
+      {
+	scalar_type const *akj = this->at(g, k, j);
+	for (index_type i = k + 1; i < n; ++i)
+	  lanes::template nmadd<false>(this->at(g, i, j), this->at(g, i, k), akj);
+      }
+    }
+    this->set_valid(g, ok);
+  }
+
+  /// Apply the row interchanges of `group` to `x`,
+  /// in reverse order if `inverse` is set.
+  void permute(index_type g, scalar_type *x, bool inverse)
+  {
+    length_type const n = length_;
+    index_type const *ipiv = ipiv_.get() + g * n * batch_width;
+    for (index_type s = 0; s != n; ++s)
+    {
+      index_type const k = inverse ? n - 1 - s : s;
+      for (index_type l = 0; l != batch_width; ++l)
+      {
+	index_type const p = ipiv[k * batch_width + l];
+	if (p != k) lanes::swap(x + k * esize, x + p * esize, l);
+      }
+    }
+  }
+
+  template <mat_op_type tr, typename B0, typename B1>
+  void solve(B0 const &b_block, B1 &x_block, length_type p, bool stacked)
+  {
+    OVXX_PRECONDITION(tr != mat_herm || is_complex<T>::value);
+    bool const J = tr == mat_herm;
+    dda::Data<B0, dda::in> b_data(b_block);
+    dda::Data<B1, dda::out> x_data(x_block);
+    length_type const n = length_;
+    auto b_ref = this->make_ref(b_data, n, stacked);
+    auto x_ref = this->make_ref(x_data, n, stacked);
+    auto get = [&](index_type k, index_type i, index_type j) { return b_ref.get(k, i, j);};
+    auto pad = [](index_type, index_type) { return T(0);};
+    this->for_each_group(2 * n * n * p + 1, [&](index_type g)
+    {
+      aligned_array<scalar_type> buffer(n * p * esize);
+      this->pack(get, g, n, p, buffer.get(), pad);
+      for (index_type j = 0; j != p; ++j)
+      {
+	scalar_type *x = buffer.get() + j * n * esize;
+	if (tr == mat_ntrans)
+	{
+	  // L U X = P B
+	  permute(g, x, false);
+	  for (index_type c = 0; c != n; ++c)
+	    for (index_type i = c + 1; i < n; ++i)
+	      lanes::template nmadd<false>(x + i * esize, this->at(g, i, c), x + c * esize);
+	  for (index_type c = n; c-- > 0;)
+	  {
+	    lanes::template div<false>(x + c * esize, this->at(g, c, c));
+	    for (index_type i = 0; i != c; ++i)
+	      lanes::template nmadd<false>(x + i * esize, this->at(g, i, c), x + c * esize);
+	  }
+	}
+	else
+	{
+	  // op(U) op(L) P X = B
+	  for (index_type c = 0; c != n; ++c)
+	  {
+	    for (index_type i = 0; i != c; ++i)
+	      nmadd(J, x + c * esize, this->at(g, i, c), x + i * esize);
+	    if (J) lanes::template div<true>(x + c * esize, this->at(g, c, c));
+	    else lanes::template div<false>(x + c * esize, this->at(g, c, c));
+	  }
+	  for (index_type c = n; c-- > 0;)
+	    for (index_type i = c + 1; i < n; ++i)
+	      nmadd(J, x + c * esize, this->at(g, i, c), x + i * esize);
+	  permute(g, x, true);
+	}
+      }
+      this->unpack(buffer.get(), g, n, p, x_ref);
+    });
+  }
+
+  static void nmadd(bool J, scalar_type *c, scalar_type const *a, scalar_type const *b)
+  {
+    if (J) lanes::template nmadd<true>(c, a, b);
+    else lanes::template nmadd<false>(c, a, b);
+  }
+
+  aligned_array<index_type> ipiv_;
+};
+
+/// Batched Householder QR decomposition, A = Q R, of `batch`
+/// matrices of size `rows x cols`, with `rows >= cols`.
+/// Q is kept in factored form, as one reflector per column.
+template <typename T>
+class batch_qrd : public batch_solver<T>
+{
+  typedef batch_solver<T> base_type;
+  typedef typename base_type::lanes lanes;
+  typedef typename base_type::scalar_type scalar_type;
+  using base_type::esize;
+  using base_type::length_;
+  using base_type::cols_;
+  using base_type::batch_;
+  using base_type::groups_;
+
+public:
+  batch_qrd(length_type rows, length_type cols, length_type batch)
+    VSIP_THROW((std::bad_alloc))
+    : base_type(rows, batch, cols),
+      tau_(groups_ * cols * esize)
+  {
+    OVXX_PRECONDITION(rows >= cols);
+  }
+
+  length_type rows() const VSIP_NOTHROW { return length_;}
+  length_type columns() const VSIP_NOTHROW { return cols_;}
+
+  /// Factor the `batch x rows x cols` matrices in `a`.
+  /// Return false if any of them doesn't have full rank.
+  template <typename B>
+  bool decompose(Tensor<T, B> a) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(a.size(0) == batch_ &&
+		      a.size(1) == length_ && a.size(2) == cols_);
+    return decompose(a.block(), false);
+  }
+  /// Factor the `batch*rows x cols` stacked matrices in `a`.
+  template <typename B>
+  bool decompose(Matrix<T, B> a) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(a.size(0) == batch_ * length_ && a.size(1) == cols_);
+    return decompose(a.block(), true);
+  }
+
+  /// Solve the least-squares problems min_x norm-2(A x - b), with
+  /// `b` of size `batch x rows x p` and `x` of size `batch x cols x p`.
+  template <typename B0, typename B1>
+  bool lsqsol(const_Tensor<T, B0> b, Tensor<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == batch_ && b.size(1) == length_);
+    OVXX_PRECONDITION(x.size(0) == batch_ && x.size(1) == cols_ &&
+		      x.size(2) == b.size(2));
+    solve<false>(b.block(), x.block(), b.size(2), false);
+    return true;
+  }
+  template <typename B0, typename B1>
+  bool lsqsol(const_Matrix<T, B0> b, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == batch_ * length_);
+    OVXX_PRECONDITION(x.size(0) == batch_ * cols_ && x.size(1) == b.size(1));
+    solve<false>(b.block(), x.block(), b.size(1), true);
+    return true;
+  }
+
+  /// Solve the covariance systems A^H A x = b, with `b` and `x`
+  /// of size `batch x cols x p`.
+  template <typename B0, typename B1>
+  bool covsol(const_Tensor<T, B0> b, Tensor<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == batch_ && b.size(1) == cols_);
+    OVXX_PRECONDITION(x.size(0) == batch_ && x.size(1) == cols_ &&
+		      x.size(2) == b.size(2));
+    solve<true>(b.block(), x.block(), b.size(2), false);
+    return true;
+  }
+  template <typename B0, typename B1>
+  bool covsol(const_Matrix<T, B0> b, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == batch_ * cols_);
+    OVXX_PRECONDITION(x.size(0) == b.size(0) && x.size(1) == b.size(1));
+    solve<true>(b.block(), x.block(), b.size(1), true);
+    return true;
+  }
+
+private:
+  template <typename B>
+  bool decompose(B const &block, bool stacked)
+  {
+    dda::Data<B, dda::in> data(block);
+    length_type const m = length_, n = cols_;
+    auto ref = this->make_ref(data, m, stacked);
+    auto get = [&](index_type k, index_type i, index_type j) { return ref.get(k, i, j);};
+    auto pad = [](index_type i, index_type j) { return T(i == j ? 1 : 0);};
+    this->for_each_group(2 * n * n * m + 1, [&](index_type g)
+    {
+      this->pack(get, g, m, n, this->at(g, 0, 0), pad);
+      factor(g);
+    });
+    return this->all_valid();
+  }
+
+  scalar_type *tau(index_type g, index_type k)
+  { return tau_.get() + (g * cols_ + k) * esize;}
+
+  void factor(index_type g)
+  {
+    length_type const m = length_, n = cols_;
+    bool ok[batch_width];
+    std::fill(ok, ok + batch_width, true);
+    for (index_type k = 0; k != n; ++k)
+    {
+      // Build the reflector H = I - tau v v^H, with v[k] = 1, that
+      // maps column k onto (beta, 0, ..., 0).
+      scalar_type *akk = this->at(g, k, k);
+      scalar_type d[esize];
+      for (index_type l = 0; l != batch_width; ++l)
+      {
+	T const alpha = lanes::get(akk, l);
+	scalar_type norm = 0;
+	for (index_type i = k + 1; i < m; ++i)
+	  norm += lanes::magsq(this->at(g, i, k), l);
+	if (norm == scalar_type(0) && math::impl_imag(alpha) == scalar_type(0))
+	{
+	  // Nothing to eliminate.
+	  lanes::put(tau(g, k), l, T(0));
+	  lanes::put(d, l, T(1));
+	  if (alpha == T(0))
+	  {
+	    // Keep going with a unit diagonal, so the other problems
+	    // are unaffected.
+	    ok[l] = false;
+	    lanes::put(akk, l, T(1));
+	  }
+	  continue;
+	}
+	scalar_type beta = std::sqrt(math::impl_real(alpha * math::impl_conj(alpha)) + norm);
+	if (math::impl_real(alpha) > scalar_type(0)) beta = -beta;
+	lanes::put(tau(g, k), l, (T(beta) - alpha) / T(beta));
+	lanes::put(d, l, alpha - T(beta));
+	lanes::put(akk, l, T(beta));
+      }
+      for (index_type i = k + 1; i < m; ++i)
+	lanes::mul_recip(this->at(g, i, k), d);
+      for (index_type j = k + 1; j < n; ++j)
+	reflect(g, k, this->at(g, 0, j));
+    }
+    this->set_valid(g, ok);
+  }
+
+  /// Apply H^H of reflector `k` to the column `x` of `rows()` elements.
+  void reflect(index_type g, index_type k, scalar_type *x)
+  {
+    length_type const m = length_;
+    scalar_type const *t = tau(g, k);
+    // w = x[k] + v^H x[k+1:], accumulated negated.
+    scalar_type w[esize];
+    for (index_type l = 0; l != batch_width; ++l)
+      lanes::put(w, l, -lanes::get(x + k * esize, l));
+    for (index_type i = k + 1; i < m; ++i)
+      lanes::template nmadd<true>(w, this->at(g, i, k), x + i * esize);
+    // x -= conj(tau) w v
+    for (index_type l = 0; l != batch_width; ++l)
+    {
+      T const s = -math::impl_conj(lanes::get(t, l)) * lanes::get(w, l);
+      lanes::put(w, l, s);
+      lanes::put(x + k * esize, l, lanes::get(x + k * esize, l) - s);
+    }
+    for (index_type i = k + 1; i < m; ++i)
+      lanes::template nmadd<false>(x + i * esize, this->at(g, i, k), w);
+  }
+
+  /// Solve R^H R X = B if `Cov` is set, and least-squares problems
+  /// A X = B otherwise.
+  template <bool Cov, typename B0, typename B1>
+  void solve(B0 const &b_block, B1 &x_block, length_type p, bool stacked)
+  {
+    dda::Data<B0, dda::in> b_data(b_block);
+    dda::Data<B1, dda::out> x_data(x_block);
+    length_type const m = length_, n = cols_;
+    length_type const rows = Cov ? n : m;
+    auto b_ref = this->make_ref(b_data, rows, stacked);
+    auto x_ref = this->make_ref(x_data, n, stacked);
+    auto get = [&](index_type k, index_type i, index_type j) { return b_ref.get(k, i, j);};
+    auto pad = [](index_type, index_type) { return T(0);};
+    this->for_each_group(2 * n * (Cov ? n : m) * p + 1, [&](index_type g)
+    {
+      aligned_array<scalar_type> buffer(rows * p * esize);
+      aligned_array<scalar_type> result(n * p * esize);
+      this->pack(get, g, rows, p, buffer.get(), pad);
+      for (index_type j = 0; j != p; ++j)
+      {
+	scalar_type *b = buffer.get() + j * rows * esize;
+	scalar_type *x = result.get() + j * n * esize;
+	if (Cov)
+	{
+	  // R^H Y = B
+	  for (index_type c = 0; c != n; ++c)
+	  {
+	    for (index_type i = 0; i != c; ++i)
+	      lanes::template nmadd<true>(b + c * esize, this->at(g, i, c), b + i * esize);
+	    lanes::template div<true>(b + c * esize, this->at(g, c, c));
+	  }
+	}
+	else
+	  // Q^H B
+	  for (index_type k = 0; k != n; ++k)
+	    reflect(g, k, b);
+	std::copy(b, b + n * esize, x);
+	// R X = Y
+	for (index_type c = n; c-- > 0;)
+	{
+	  lanes::template div<false>(x + c * esize, this->at(g, c, c));
+	  for (index_type i = 0; i != c; ++i)
+	    lanes::template nmadd<false>(x + i * esize, this->at(g, i, c), x + c * esize);
+	}
+      }
+      this->unpack(result.get(), g, n, p, x_ref);
+    });
+  }
+
+  aligned_array<scalar_type> tau_;
+};
+
+/// Solve the least-squares problems min_x norm-2(A x - b) for each
+/// of the `batch x m x n` matrices in `a` (`m >= n`, full rank), with
+/// `b` of size `batch x m x p` and `x` of size `batch x n x p`.
+template <typename T, typename B0, typename B1, typename B2>
+Tensor<T, B2>
+batch_llsqsol(Tensor<T, B0> a, const_Tensor<T, B1> b, Tensor<T, B2> x)
+  VSIP_THROW((std::bad_alloc, computation_error))
+{
+  batch_qrd<T> qr(a.size(1), a.size(2), a.size(0));
+  if (!qr.decompose(a))
+    OVXX_DO_THROW(computation_error("batch_llsqsol - decompose failed"));
+  qr.lsqsol(b, x);
+  return x;
+}
+
+} // namespace ovxx::linalg
+} // namespace ovxx
+
+#endif
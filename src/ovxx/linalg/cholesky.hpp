@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_linalg_cholesky_hpp_
+#define ovxx_linalg_cholesky_hpp_
+
+#include <ovxx/linalg/solver.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/dispatch.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace ovxx
+{
+namespace linalg
+{
+
+/// Cholesky decomposition, A = L L^H.
+///
+/// Only the triangle of A named by `uplo` is referenced. The factor
+/// is always held as the lower triangular L, so for `upper` we
+/// factor the conjugate transpose of the given triangle.
+template <typename T>
+class chold
+{
+  typedef solver_traits<T> traits;
+  typedef typename traits::block_type data_block_type;
+  typedef typename scalar_of<T>::type scalar_type;
+
+public:
+  chold(mat_uplo uplo, length_type length)
+  : uplo_(uplo),
+    length_(length),
+    data_(length_, length_)
+  {
+    OVXX_PRECONDITION(length_ > 0);
+    OVXX_PRECONDITION(uplo_ == upper || uplo_ == lower);
+  }
+  chold(chold const &other)
+  : uplo_(other.uplo_),
+    length_(other.length_),
+    data_(length_, length_)
+  {
+    data_ = other.data_;
+  }
+  chold &operator=(chold const &other) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(length_ == other.length_);
+    uplo_ = other.uplo_;
+    data_ = other.data_;
+    return *this;
+  }
+
+  length_type length() const { return length_;}
+  mat_uplo uplo() const { return uplo_;}
+
+  template <typename B>
+  bool decompose(Matrix<T, B> m) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(m.size(0) == length_ && m.size(1) == length_);
+    length_type const n = length_;
+    dda::Data<data_block_type, dda::inout> data(data_.block());
+    T *a = data.ptr();
+    stride_type const lda = data.stride(1);
+    for (index_type j = 0; j != n; ++j)
+      for (index_type i = j; i != n; ++i)
+	a[i + j * lda] = uplo_ == lower ? m.get(i, j) : math::impl_conj(m.get(j, i));
+
+    for (index_type k0 = 0; k0 < n; k0 += panel_size)
+    {
+      length_type const kb = std::min(panel_size, n - k0);
+      // Factor the panel, including the rows below the diagonal block.
+      for (index_type k = k0; k != k0 + kb; ++k)
+      {
+	T *col = a + k * lda;
+	scalar_type const d = math::impl_real(col[k]);
+	if (!(d > scalar_type(0))) return false;
+	scalar_type const l = std::sqrt(d);
+	col[k] = l;
+	for (index_type i = k + 1; i < n; ++i) col[i] /= l;
+	for (index_type j = k + 1; j < k0 + kb; ++j)
+	{
+	  T *cj = a + j * lda;
+	  T const ljk = math::impl_conj(col[j]);
+	  for (index_type i = j; i < n; ++i) cj[i] -= col[i] * ljk;
+	}
+      }
+      index_type const j0 = k0 + kb;
+      if (j0 == n) break;
+      // A22 -= L21 L21^H, one block column of the lower triangle
+      // at a time.
+      length_type const blocks = (n - j0 + panel_size - 1) / panel_size;
+      auto update = [&](index_type b)
+      {
+	index_type const j = j0 + b * panel_size;
+	length_type const jb = std::min(panel_size, n - j);
+	gemm<true>(n - j, jb, kb, T(-1),
+		   traits::ref(a, lda, j, k0), traits::tref(a, lda, j, k0),
+		   T(1), traits::ref(a, lda, j, j));
+      };
+      thread_pool *pool = thread_pool::get_default();
+      if (pool && pool->concurrency() > 1 &&
+	  (n - j0) * (n - j0) * kb >= threaded_prod_threshold())
+	pool->parallel_for(blocks, update);
+      else
+	for (index_type b = 0; b != blocks; ++b) update(b);
+    }
+    return true;
+  }
+
+  template <typename B0, typename B1>
+  bool solve(const_Matrix<T, B0> b, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == length_);
+    OVXX_PRECONDITION(b.size(0) == x.size(0) && b.size(1) == x.size(1));
+    Matrix<T, data_block_type> b_clone(b.size(0), b.size(1));
+    b_clone = b;
+    {
+      dda::Data<data_block_type, dda::inout> b_data(b_clone.block());
+      dda::Data<data_block_type, dda::in> a_data(data_.block());
+      // L L^H X = B
+      trsm(lower, mat_ntrans, false, length_, b.size(1), T(1),
+	   a_data.ptr(), a_data.stride(1), b_data.ptr(), b_data.stride(1));
+      trsm(lower, mat_herm, false, length_, b.size(1), T(1),
+	   a_data.ptr(), a_data.stride(1), b_data.ptr(), b_data.stride(1));
+    }
+    x = b_clone;
+    return true;
+  }
+
+private:
+  mat_uplo uplo_;
+  length_type length_;
+  Matrix<T, data_block_type> data_;
+};
+
+} // namespace ovxx::linalg
+
+namespace dispatcher
+{
+template <typename T>
+struct Evaluator<op::chold, be::opt, T>
+{
+  static bool const ct_valid = linalg::is_supported<T>::value;
+  typedef linalg::chold<T> backend_type;
+};
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
@@ -0,0 +1,606 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_linalg_gemm_hpp_
+#define ovxx_linalg_gemm_hpp_
+
+#include <vsip/dda.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/complex_traits.hpp>
+#include <ovxx/math/scalar.hpp>
+#include <ovxx/storage/traits.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/dispatch.hpp>
+#include <algorithm>
+
+namespace ovxx
+{
+namespace linalg
+{
+
+/// Products with fewer multiply-adds than this are left to the
+/// generic evaluators.
+inline length_type &prod_threshold()
+{
+  static length_type threshold = 4096;
+  return threshold;
+}
+
+/// Products with fewer multiply-adds than this are computed serially.
+inline length_type &threaded_prod_threshold()
+{
+  static length_type threshold = 1 << 21;
+  return threshold;
+}
+
+template <typename T>
+struct is_supported
+{
+  static bool const value =
+    is_floating_point<typename scalar_of<T>::type>::value;
+};
+
+/// Strided access to a matrix stored in format `F`.
+template <typename T, storage_format_type F, typename P>
+struct matrix_ref
+{
+  typedef storage_traits<T, F> traits;
+
+  matrix_ref(P p, stride_type r, stride_type c) : ptr(p), s0(r), s1(c) {}
+  T get(index_type i, index_type j) const { return traits::get(ptr, i*s0 + j*s1);}
+  void put(index_type i, index_type j, T v) const { traits::put(ptr, i*s0 + j*s1, v);}
+  /// Return a pointer to element `(i, j)`, for formats storing
+  /// values contiguously.
+  T const *at(index_type i, index_type j) const
+  { return reinterpret_cast<T const*>(&traits::at(ptr, i*s0 + j*s1));}
+
+  P ptr;
+  stride_type s0, s1;
+};
+
+/// Strided access to a vector stored in format `F`.
+template <typename T, storage_format_type F, typename P>
+struct vector_ref
+{
+  typedef storage_traits<T, F> traits;
+
+  vector_ref(P p, stride_type s) : ptr(p), s0(s) {}
+  T get(index_type i) const { return traits::get(ptr, i*s0);}
+  void put(index_type i, T v) const { traits::put(ptr, i*s0, v);}
+
+  P ptr;
+  stride_type s0;
+};
+
+template <typename T, storage_format_type F, typename P>
+matrix_ref<T, F, P> make_matrix_ref(P ptr, stride_type s0, stride_type s1)
+{ return matrix_ref<T, F, P>(ptr, s0, s1);}
+
+template <typename T, storage_format_type F, typename P>
+vector_ref<T, F, P> make_vector_ref(P ptr, stride_type s0)
+{ return vector_ref<T, F, P>(ptr, s0);}
+
+namespace detail
+{
+/// Packed operands hold complex values as separate real and imaginary
+/// rows of `W` scalars each, so the micro-kernels only ever operate
+/// on scalar arrays.
+template <typename T>
+struct packed
+{
+  typedef T scalar_type;
+  static length_type const width = 1;
+  static void put(T *p, index_type i, length_type, T v) { p[i] = v;}
+  static T get(T const *p, index_type i, length_type) { return p[i];}
+};
+
+template <typename T>
+struct packed<complex<T> >
+{
+  typedef T scalar_type;
+  static length_type const width = 2;
+  static void put(T *p, index_type i, length_type w, complex<T> v)
+  { p[i] = v.real(); p[w + i] = v.imag();}
+  static complex<T> get(T const *p, index_type i, length_type w)
+  { return complex<T>(p[i], p[w + i]);}
+};
+
+/// Register block sizes: each micro-kernel call updates an
+/// `mr` x `nr` tile of the result held in registers. They are
+/// chosen to fit the sixteen vector registers of common targets.
+template <typename T> struct block_size;
+template <> struct block_size<float>
+{ static length_type const mr = 4, nr = 8;};
+template <> struct block_size<double>
+{ static length_type const mr = 4, nr = 4;};
+template <> struct block_size<complex<float> >
+{ static length_type const mr = 4, nr = 4;};
+template <> struct block_size<complex<double> >
+{ static length_type const mr = 2, nr = 4;};
+
+/// Cache block sizes: a `kc` x `nc` panel of B is packed to stay
+/// in the second-level cache, an `mc` x `kc` block of A to stay
+/// in the first-level cache as it is swept across the panel.
+length_type const kc = 256;
+length_type const mc = 64;
+length_type const nc = 512;
+
+template <typename T, bool C = is_complex<T>::value>
+struct micro_kernel;
+
+/// c = a * b, for an `mr` x `kc` sliver of A and a `kc` x `nr`
+/// sliver of B. The inner loops have constant trip counts, so the
+/// compiler unrolls them and keeps `c` in vector registers.
+template <typename T>
+struct micro_kernel<T, false>
+{
+  static length_type const mr = block_size<T>::mr;
+  static length_type const nr = block_size<T>::nr;
+
+  static void apply(length_type k, T const *a, T const *b, T *c)
+  {
+    T acc[mr][nr] = {};
+    for (index_type p = 0; p != k; ++p, a += mr, b += nr)
+      for (index_type i = 0; i != mr; ++i)
+	for (index_type j = 0; j != nr; ++j)
+	  acc[i][j] += a[i] * b[j];
+    for (index_type i = 0; i != mr; ++i)
+      for (index_type j = 0; j != nr; ++j)
+	c[i * nr + j] = acc[i][j];
+  }
+};
+
+template <typename T>
+struct micro_kernel<T, true>
+{
+  typedef typename scalar_of<T>::type S;
+  static length_type const mr = block_size<T>::mr;
+  static length_type const nr = block_size<T>::nr;
+
+  static void apply(length_type k, S const *a, S const *b, S *c)
+  {
+    S re[mr][nr] = {};
+    S im[mr][nr] = {};
+    for (index_type p = 0; p != k; ++p, a += 2*mr, b += 2*nr)
+      for (index_type i = 0; i != mr; ++i)
+	for (index_type j = 0; j != nr; ++j)
+	{
+	  re[i][j] += a[i] * b[j] - a[mr + i] * b[nr + j];
+	  im[i][j] += a[i] * b[nr + j] + a[mr + i] * b[j];
+	}
+    for (index_type i = 0; i != mr; ++i)
+      for (index_type j = 0; j != nr; ++j)
+      {
+	c[i * nr + j] = re[i][j];
+	c[mr * nr + i * nr + j] = im[i][j];
+      }
+  }
+};
+
+/// Pack an `m` x `k` block of A into slivers of `mr` rows,
+/// padding the last sliver with zeros.
+template <typename T, typename A>
+void pack_a(A const &a, index_type i0, index_type k0, length_type m, length_type k,
+	    typename scalar_of<T>::type *p)
+{
+  length_type const mr = block_size<T>::mr;
+  for (index_type s = 0; s < m; s += mr)
+    for (index_type l = 0; l != k; ++l, p += packed<T>::width * mr)
+      for (index_type r = 0; r != mr; ++r)
+	packed<T>::put(p, r, mr, s + r < m ? a.get(i0 + s + r, k0 + l) : T());
+}
+
+/// Pack a `k` x `n` panel of B into slivers of `nr` columns,
+/// conjugating if `J` is set.
+template <bool J, typename T, typename B>
+void pack_b(B const &b, index_type k0, index_type j0, length_type k, length_type n,
+	    typename scalar_of<T>::type *p)
+{
+  length_type const nr = block_size<T>::nr;
+  for (index_type s = 0; s < n; s += nr)
+    for (index_type l = 0; l != k; ++l, p += packed<T>::width * nr)
+      for (index_type c = 0; c != nr; ++c)
+      {
+	T v = s + c < n ? b.get(k0 + l, j0 + s + c) : T();
+	packed<T>::put(p, c, nr, J ? math::impl_conj(v) : v);
+      }
+}
+
+/// Compute the `m` x `n` tile of C at `(i0, j0)`.
+template <bool J, typename T, typename C, typename A, typename B>
+void gemm_tile(C const &c, T alpha, A const &a, B const &b, T beta,
+	       index_type i0, index_type j0, length_type m, length_type n,
+	       length_type k)
+{
+  typedef typename scalar_of<T>::type S;
+  typedef micro_kernel<T> kernel;
+  length_type const w = packed<T>::width;
+  length_type const mr = kernel::mr;
+  length_type const nr = kernel::nr;
+
+  aligned_array<S> pa(w * (m + mr) * std::min(k, kc));
+  aligned_array<S> pb(w * (n + nr) * std::min(k, kc));
+  S tile[w * mr * nr];
+
+  for (index_type pc = 0; pc < k; pc += kc)
+  {
+    length_type const kb = std::min(kc, k - pc);
+    pack_b<J, T>(b, pc, j0, kb, n, pb.get());
+    for (index_type ic = 0; ic < m; ic += mc)
+    {
+      length_type const mb = std::min(mc, m - ic);
+      pack_a<T>(a, i0 + ic, pc, mb, kb, pa.get());
+      for (index_type jr = 0; jr < n; jr += nr)
+	for (index_type ir = 0; ir < mb; ir += mr)
+	{
+	  kernel::apply(kb, pa.get() + ir * w * kb, pb.get() + jr * w * kb, tile);
+	  length_type const rows = std::min(mr, mb - ir);
+	  length_type const cols = std::min(nr, n - jr);
+	  for (index_type i = 0; i != rows; ++i)
+	    for (index_type j = 0; j != cols; ++j)
+	    {
+	      index_type const ci = i0 + ic + ir + i, cj = j0 + jr + j;
+	      T v = alpha * packed<T>::get(tile, i * nr + j, mr * nr);
+	      if (pc) v += c.get(ci, cj);
+	      else if (beta != T()) v += beta * c.get(ci, cj);
+	      c.put(ci, cj, v);
+	    }
+	}
+    }
+  }
+}
+
+/// y = a * x, for a row `a` and a contiguous vector `x` of `n` values.
+template <typename T>
+struct dot
+{
+  static T apply(T const *a, T const *x, length_type n)
+  {
+    // Independent partial sums allow vectorization
+    // without reassociation.
+    T sum[8] = {};
+    index_type i = 0;
+    for (; i + 8 <= n; i += 8)
+      for (index_type l = 0; l != 8; ++l)
+	sum[l] += a[i + l] * x[i + l];
+    T r = T();
+    for (; i != n; ++i) r += a[i] * x[i];
+    for (index_type l = 0; l != 8; ++l) r += sum[l];
+    return r;
+  }
+};
+
+template <typename T>
+struct dot<complex<T> >
+{
+  static complex<T> apply(complex<T> const *ca, complex<T> const *cx, length_type n)
+  {
+    T const *a = reinterpret_cast<T const*>(ca);
+    T const *x = reinterpret_cast<T const*>(cx);
+    T re[4] = {}, im[4] = {};
+    index_type i = 0;
+    for (; i + 4 <= n; i += 4)
+      for (index_type l = 0; l != 4; ++l)
+      {
+	T const ar = a[2*(i + l)], ai = a[2*(i + l) + 1];
+	T const xr = x[2*(i + l)], xi = x[2*(i + l) + 1];
+	re[l] += ar * xr - ai * xi;
+	im[l] += ar * xi + ai * xr;
+      }
+    complex<T> r;
+    for (; i != n; ++i) r += ca[i] * cx[i];
+    for (index_type l = 0; l != 4; ++l) r += complex<T>(re[l], im[l]);
+    return r;
+  }
+};
+
+/// y += a * x, for contiguous vectors of `n` values.
+template <typename T>
+struct axpy
+{
+  static void apply(T *y, T a, T const *x, length_type n)
+  {
+    PRAGMA_IVDEP
+    for (index_type i = 0; i < n; ++i)
+      y[i] += a * x[i];
+  }
+};
+
+template <typename T>
+struct axpy<complex<T> >
+{
+  static void apply(complex<T> *cy, complex<T> a, complex<T> const *cx, length_type n)
+  {
+    T *y = reinterpret_cast<T*>(cy);
+    T const *x = reinterpret_cast<T const*>(cx);
+    T const re = a.real(), im = a.imag();
+    PRAGMA_IVDEP
+    for (index_type i = 0; i < 2*n; i += 2)
+    {
+      y[i] += re * x[i] - im * x[i + 1];
+      y[i + 1] += re * x[i + 1] + im * x[i];
+    }
+  }
+};
+
+} // namespace ovxx::linalg::detail
+
+/// C = alpha * A * B + beta * C, with A of size `m` x `k` and
+/// B of size `k` x `n`. If `J` is set, B is conjugated.
+///
+/// B is packed panel by panel into a layout that the register-blocked
+/// micro-kernel streams through contiguously, and likewise blocks of A.
+/// Tiles of C are computed in parallel on the default thread pool.
+template <bool J, typename T, typename C, typename A, typename B>
+void gemm(length_type m, length_type n, length_type k,
+	  T alpha, A const &a, B const &b, T beta, C const &c)
+{
+  length_type const nr = detail::block_size<T>::nr;
+  length_type const mt = detail::mc * 4;
+  length_type tiles_m = (m + mt - 1) / mt;
+  length_type nt = detail::nc;
+
+  thread_pool *pool = thread_pool::get_default();
+  bool const threaded = pool && pool->concurrency() > 1 &&
+    !thread_pool::in_parallel_region() &&
+    m * n * k >= threaded_prod_threshold();
+  // Make sure there are enough tiles to keep all threads busy.
+  if (threaded && tiles_m < pool->concurrency())
+  {
+    length_type tiles_n = (pool->concurrency() + tiles_m - 1) / tiles_m;
+    nt = std::min(nt, std::max(nr, ((n + tiles_n - 1) / tiles_n + nr - 1) / nr * nr));
+  }
+  length_type tiles_n = (n + nt - 1) / nt;
+  auto task = [&](index_type t)
+  {
+    index_type const i0 = (t / tiles_n) * mt;
+    index_type const j0 = (t % tiles_n) * nt;
+    detail::gemm_tile<J>(c, alpha, a, b, beta, i0, j0,
+			 std::min(mt, m - i0), std::min(nt, n - j0), k);
+  };
+  if (threaded) pool->parallel_for(tiles_m * tiles_n, task);
+  else
+    for (index_type t = 0; t != tiles_m * tiles_n; ++t) task(t);
+}
+
+/// y = alpha * A * x + beta * y, with A of size `m` x `n`.
+/// A must have unit stride in one of its dimensions.
+template <typename T, typename Y, typename A, typename X>
+void gemv(length_type m, length_type n,
+	  T alpha, A const &a, X const &x, T beta, Y const &y)
+{
+  aligned_array<T> acc(m);
+  if (a.s0 == 1)
+  {
+    // Column-contiguous: accumulate scaled columns.
+    std::fill(acc.get(), acc.get() + m, T());
+    for (index_type j = 0; j != n; ++j)
+      detail::axpy<T>::apply(acc.get(), x.get(j), a.at(0, j), m);
+  }
+  else
+  {
+    // Row-contiguous: one dot product per row.
+    aligned_array<T> xc(n);
+    for (index_type j = 0; j != n; ++j) xc[j] = x.get(j);
+    for (index_type i = 0; i != m; ++i)
+      acc[i] = detail::dot<T>::apply(a.at(i, 0), xc.get(), n);
+  }
+  for (index_type i = 0; i != m; ++i)
+  {
+    T v = alpha * acc[i];
+    if (beta != T()) v += beta * y.get(i);
+    y.put(i, v);
+  }
+}
+
+} // namespace ovxx::linalg
+
+namespace dispatcher
+{
+
+/// Matrix-matrix product.
+template <typename B0, typename B1, typename B2>
+struct Evaluator<op::prod, be::opt,
+                 void(B0 &, B1 const &, B2 const &),
+		 typename enable_if<B1::dim == 2 && B2::dim == 2>::type>
+{
+  typedef typename B0::value_type T;
+
+  static bool const ct_valid =
+    linalg::is_supported<T>::value &&
+    is_same<T, typename B1::value_type>::value &&
+    is_same<T, typename B2::value_type>::value &&
+    dda::Data<B0, dda::out>::ct_cost == 0 &&
+    dda::Data<B1, dda::in>::ct_cost == 0 &&
+    dda::Data<B2, dda::in>::ct_cost == 0;
+
+  static bool rt_valid(B0 &r, B1 const &a, B2 const &)
+  {
+    return r.size(2, 0) * r.size(2, 1) * a.size(2, 1) >= linalg::prod_threshold() &&
+      a.size(2, 1) > 0;
+  }
+
+  static void exec(B0 &r, B1 const &a, B2 const &b)
+  {
+    dda::Data<B0, dda::out> data_r(r);
+    dda::Data<B1, dda::in> data_a(a);
+    dda::Data<B2, dda::in> data_b(b);
+    linalg::gemm<false>
+      (r.size(2, 0), r.size(2, 1), a.size(2, 1), T(1),
+       linalg::make_matrix_ref<T, get_block_layout<B1>::storage_format>
+       (data_a.ptr(), data_a.stride(0), data_a.stride(1)),
+       linalg::make_matrix_ref<T, get_block_layout<B2>::storage_format>
+       (data_b.ptr(), data_b.stride(0), data_b.stride(1)),
+       T(0),
+       linalg::make_matrix_ref<T, get_block_layout<B0>::storage_format>
+       (data_r.ptr(), data_r.stride(0), data_r.stride(1)));
+  }
+};
+
+/// Matrix-matrix conjugate product.
+template <typename B0, typename B1, typename B2>
+struct Evaluator<op::prodj, be::opt,
+                 void(B0 &, B1 const &, B2 const &)>
+{
+  typedef typename B0::value_type T;
+
+  static bool const ct_valid =
+    linalg::is_supported<T>::value &&
+    is_same<T, typename B1::value_type>::value &&
+    is_same<T, typename B2::value_type>::value &&
+    dda::Data<B0, dda::out>::ct_cost == 0 &&
+    dda::Data<B1, dda::in>::ct_cost == 0 &&
+    dda::Data<B2, dda::in>::ct_cost == 0;
+
+  static bool rt_valid(B0 &r, B1 const &a, B2 const &)
+  {
+    return r.size(2, 0) * r.size(2, 1) * a.size(2, 1) >= linalg::prod_threshold() &&
+      a.size(2, 1) > 0;
+  }
+
+  static void exec(B0 &r, B1 const &a, B2 const &b)
+  {
+    dda::Data<B0, dda::out> data_r(r);
+    dda::Data<B1, dda::in> data_a(a);
+    dda::Data<B2, dda::in> data_b(b);
+    linalg::gemm<true>
+      (r.size(2, 0), r.size(2, 1), a.size(2, 1), T(1),
+       linalg::make_matrix_ref<T, get_block_layout<B1>::storage_format>
+       (data_a.ptr(), data_a.stride(0), data_a.stride(1)),
+       linalg::make_matrix_ref<T, get_block_layout<B2>::storage_format>
+       (data_b.ptr(), data_b.stride(0), data_b.stride(1)),
+       T(0),
+       linalg::make_matrix_ref<T, get_block_layout<B0>::storage_format>
+       (data_r.ptr(), data_r.stride(0), data_r.stride(1)));
+  }
+};
+
+/// Matrix-vector product.
+template <typename B0, typename B1, typename B2>
+struct Evaluator<op::prod, be::opt,
+                 void(B0 &, B1 const &, B2 const &),
+		 typename enable_if<B1::dim == 2 && B2::dim == 1>::type>
+{
+  typedef typename B0::value_type T;
+
+  static bool const ct_valid =
+    linalg::is_supported<T>::value &&
+    is_same<T, typename B1::value_type>::value &&
+    is_same<T, typename B2::value_type>::value &&
+    dda::Data<B0, dda::out>::ct_cost == 0 &&
+    dda::Data<B1, dda::in>::ct_cost == 0 &&
+    dda::Data<B2, dda::in>::ct_cost == 0 &&
+    !is_split_block<B1>::value;
+
+  static bool rt_valid(B0 &, B1 const &a, B2 const &)
+  {
+    if (a.size(2, 0) * a.size(2, 1) < linalg::prod_threshold()) return false;
+    dda::Data<B1, dda::in> data_a(a);
+    return data_a.stride(0) == 1 || data_a.stride(1) == 1;
+  }
+
+  static void exec(B0 &r, B1 const &a, B2 const &b)
+  {
+    dda::Data<B0, dda::out> data_r(r);
+    dda::Data<B1, dda::in> data_a(a);
+    dda::Data<B2, dda::in> data_b(b);
+    linalg::gemv
+      (a.size(2, 0), a.size(2, 1), T(1),
+       linalg::make_matrix_ref<T, get_block_layout<B1>::storage_format>
+       (data_a.ptr(), data_a.stride(0), data_a.stride(1)),
+       linalg::make_vector_ref<T, get_block_layout<B2>::storage_format>
+       (data_b.ptr(), data_b.stride(0)),
+       T(0),
+       linalg::make_vector_ref<T, get_block_layout<B0>::storage_format>
+       (data_r.ptr(), data_r.stride(0)));
+  }
+};
+
+/// Vector-matrix product, computed as the product of the
+/// transposed matrix with the vector.
+template <typename B0, typename B1, typename B2>
+struct Evaluator<op::prod, be::opt,
+                 void(B0 &, B1 const &, B2 const &),
+		 typename enable_if<B1::dim == 1 && B2::dim == 2>::type>
+{
+  typedef typename B0::value_type T;
+
+  static bool const ct_valid =
+    linalg::is_supported<T>::value &&
+    is_same<T, typename B1::value_type>::value &&
+    is_same<T, typename B2::value_type>::value &&
+    dda::Data<B0, dda::out>::ct_cost == 0 &&
+    dda::Data<B1, dda::in>::ct_cost == 0 &&
+    dda::Data<B2, dda::in>::ct_cost == 0 &&
+    !is_split_block<B2>::value;
+
+  static bool rt_valid(B0 &, B1 const &, B2 const &b)
+  {
+    if (b.size(2, 0) * b.size(2, 1) < linalg::prod_threshold()) return false;
+    dda::Data<B2, dda::in> data_b(b);
+    return data_b.stride(0) == 1 || data_b.stride(1) == 1;
+  }
+
+  static void exec(B0 &r, B1 const &a, B2 const &b)
+  {
+    dda::Data<B0, dda::out> data_r(r);
+    dda::Data<B1, dda::in> data_a(a);
+    dda::Data<B2, dda::in> data_b(b);
+    linalg::gemv
+      (b.size(2, 1), b.size(2, 0), T(1),
+       linalg::make_matrix_ref<T, get_block_layout<B2>::storage_format>
+       (data_b.ptr(), data_b.stride(1), data_b.stride(0)),
+       linalg::make_vector_ref<T, get_block_layout<B1>::storage_format>
+       (data_a.ptr(), data_a.stride(0)),
+       T(0),
+       linalg::make_vector_ref<T, get_block_layout<B0>::storage_format>
+       (data_r.ptr(), data_r.stride(0)));
+  }
+};
+
+/// General matrix product.
+template <typename B0, typename T1, typename B1, typename B2, typename T2>
+struct Evaluator<op::gemp, be::opt,
+                 void(B0 &, T1, B1 const &, B2 const &, T2)>
+{
+  typedef typename B0::value_type T;
+
+  static bool const ct_valid =
+    linalg::is_supported<T>::value &&
+    is_same<T, typename B1::value_type>::value &&
+    is_same<T, typename B2::value_type>::value &&
+    dda::Data<B0, dda::inout>::ct_cost == 0 &&
+    dda::Data<B1, dda::in>::ct_cost == 0 &&
+    dda::Data<B2, dda::in>::ct_cost == 0;
+
+  static bool rt_valid(B0 &c, T1, B1 const &a, B2 const &, T2)
+  {
+    return c.size(2, 0) * c.size(2, 1) * a.size(2, 1) >= linalg::prod_threshold() &&
+      a.size(2, 1) > 0;
+  }
+
+  static void exec(B0 &c, T1 alpha, B1 const &a, B2 const &b, T2 beta)
+  {
+    dda::Data<B0, dda::inout> data_c(c);
+    dda::Data<B1, dda::in> data_a(a);
+    dda::Data<B2, dda::in> data_b(b);
+    linalg::gemm<false>
+      (c.size(2, 0), c.size(2, 1), a.size(2, 1), T(alpha),
+       linalg::make_matrix_ref<T, get_block_layout<B1>::storage_format>
+       (data_a.ptr(), data_a.stride(0), data_a.stride(1)),
+       linalg::make_matrix_ref<T, get_block_layout<B2>::storage_format>
+       (data_b.ptr(), data_b.stride(0), data_b.stride(1)),
+       T(beta),
+       linalg::make_matrix_ref<T, get_block_layout<B0>::storage_format>
+       (data_c.ptr(), data_c.stride(0), data_c.stride(1)));
+  }
+};
+
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_linalg_lu_hpp_
+#define ovxx_linalg_lu_hpp_
+
+#include <ovxx/linalg/solver.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/dispatch.hpp>
+#include <algorithm>
+
+namespace ovxx
+{
+namespace linalg
+{
+
+/// LU decomposition with partial pivoting, P A = L U.
+///
+/// The factorization is right-looking and blocked: each panel of
+/// columns is factored with row interchanges applied to the whole
+/// matrix, after which the trailing matrix is updated by a single
+/// matrix product.
+template <typename T>
+class lud
+{
+  typedef solver_traits<T> traits;
+  typedef typename traits::block_type data_block_type;
+
+public:
+  lud(length_type length) VSIP_THROW((std::bad_alloc))
+  : length_(length),
+    ipiv_(length_),
+    data_(length_, length_)
+  {
+    OVXX_PRECONDITION(length_ > 0);
+  }
+  lud(lud const &other) VSIP_THROW((std::bad_alloc))
+  : length_(other.length_),
+    ipiv_(length_),
+    data_(length_, length_)
+  {
+    data_ = other.data_;
+    std::copy(other.ipiv_.get(), other.ipiv_.get() + length_, ipiv_.get());
+  }
+  lud &operator=(lud const &other) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(length_ == other.length_);
+    data_ = other.data_;
+    std::copy(other.ipiv_.get(), other.ipiv_.get() + length_, ipiv_.get());
+    return *this;
+  }
+
+  length_type length() const VSIP_NOTHROW { return length_;}
+
+  template <typename B>
+  bool decompose(Matrix<T, B> m) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(m.size(0) == length_ && m.size(1) == length_);
+    parallel::assign_local(data_, m);
+    dda::Data<data_block_type, dda::inout> data(data_.block());
+    T *a = data.ptr();
+    stride_type const lda = data.stride(1);
+    length_type const n = length_;
+    bool success = true;
+
+    for (index_type k0 = 0; k0 < n; k0 += panel_size)
+    {
+      length_type const kb = std::min(panel_size, n - k0);
+      for (index_type k = k0; k != k0 + kb; ++k)
+      {
+	T *col = a + k * lda;
+	index_type p = k;
+	for (index_type i = k + 1; i < n; ++i)
+	  if (math::magsq(col[i]) > math::magsq(col[p])) p = i;
+	ipiv_[k] = p;
+	if (col[p] == T())
+	{
+	  success = false;
+	  continue;
+	}
+	if (p != k)
+	  for (index_type j = 0; j != n; ++j)
+	    std::swap(a[k + j * lda], a[p + j * lda]);
+	T const r = T(1) / col[k];
+	for (index_type i = k + 1; i < n; ++i) col[i] *= r;
+	// Update the remainder of the panel.
+	for (index_type j = k + 1; j < k0 + kb; ++j)
+	{
+	  T *cj = a + j * lda;
+	  T const akj = cj[k];
+	  for (index_type i = k + 1; i < n; ++i) cj[i] -= col[i] * akj;
+	}
+      }
+      index_type const j0 = k0 + kb;
+      if (j0 == n) break;
+      // U12 = L11^-1 A12
+      trsm(lower, mat_ntrans, true, kb, n - j0, T(1),
+	   a + k0 + k0 * lda, lda, a + k0 + j0 * lda, lda);
+      // A22 -= L21 U12
+      gemm<false>(n - j0, n - j0, kb, T(-1),
+		  traits::ref(a, lda, j0, k0), traits::ref(a, lda, k0, j0),
+		  T(1), traits::ref(a, lda, j0, j0));
+    }
+    return success;
+  }
+
+  template <mat_op_type tr, typename B0, typename B1>
+  bool solve(const_Matrix<T, B0> b, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == length_);
+    OVXX_PRECONDITION(b.size(0) == x.size(0) && b.size(1) == x.size(1));
+    OVXX_PRECONDITION(tr != mat_herm || is_complex<T>::value);
+    length_type const n = length_;
+    length_type const p = b.size(1);
+    Matrix<T, data_block_type> b_int(b.size(0), b.size(1));
+    parallel::assign_local(b_int, b);
+    {
+      dda::Data<data_block_type, dda::inout> b_data(b_int.block());
+      dda::Data<data_block_type, dda::in> a_data(data_.block());
+      T *c = b_data.ptr();
+      stride_type const ldc = b_data.stride(1);
+      if (tr == mat_ntrans)
+      {
+	// A X = P^T L U X = B
+	permute(c, ldc, p, false);
+	trsm(lower, mat_ntrans, true, n, p, T(1), a_data.ptr(), a_data.stride(1), c, ldc);
+	trsm(upper, mat_ntrans, false, n, p, T(1), a_data.ptr(), a_data.stride(1), c, ldc);
+      }
+      else
+      {
+	// op(A) X = op(U) op(L) P X = B
+	trsm(upper, tr, false, n, p, T(1), a_data.ptr(), a_data.stride(1), c, ldc);
+	trsm(lower, tr, true, n, p, T(1), a_data.ptr(), a_data.stride(1), c, ldc);
+	permute(c, ldc, p, true);
+      }
+    }
+    parallel::assign_local(x, b_int);
+    return true;
+  }
+
+private:
+  /// Apply the row interchanges to the `p` columns of `c`,
+  /// in reverse order if `inverse` is set.
+  void permute(T *c, stride_type ldc, length_type p, bool inverse)
+  {
+    for (index_type l = 0; l != length_; ++l)
+    {
+      index_type const k = inverse ? length_ - 1 - l : l;
+      if (ipiv_[k] != k)
+	for (index_type j = 0; j != p; ++j)
+	  std::swap(c[k + j * ldc], c[ipiv_[k] + j * ldc]);
+    }
+  }
+
+  length_type length_;
+  aligned_array<index_type> ipiv_;
+  Matrix<T, data_block_type> data_;
+};
+
+} // namespace ovxx::linalg
+
+namespace dispatcher
+{
+template <typename T>
+struct Evaluator<op::lud, be::opt, T>
+{
+  static bool const ct_valid = linalg::is_supported<T>::value;
+  typedef linalg::lud<T> backend_type;
+};
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
@@ -0,0 +1,321 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_linalg_qr_hpp_
+#define ovxx_linalg_qr_hpp_
+
+#include <ovxx/linalg/solver.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/dispatch.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace ovxx
+{
+namespace linalg
+{
+
+/// Householder QR decomposition, A = Q R.
+///
+/// Q = H(0) H(1) ... H(n-1) is kept in factored form, with
+/// H(k) = I - tau(k) v(k) v(k)^H, following the LAPACK conventions:
+/// the reflectors are stored below the diagonal of R, with an
+/// implicit unit leading element.
+/// Panels of reflectors are applied to the trailing matrix in
+/// compact WY form, I - V T V^H, using matrix products.
+template <typename T>
+class qrd
+{
+  typedef solver_traits<T> traits;
+  typedef typename traits::block_type data_block_type;
+  typedef typename scalar_of<T>::type scalar_type;
+
+public:
+  static bool const supports_qrd_saveq1  = true;
+  static bool const supports_qrd_saveq   = true;
+  static bool const supports_qrd_nosaveq = true;
+
+  qrd(length_type rows, length_type cols, storage_type s)
+    VSIP_THROW((std::bad_alloc))
+  : rows_(rows),
+    cols_(cols),
+    storage_(s),
+    data_(rows_, cols_),
+    tau_(cols_)
+  {
+    OVXX_PRECONDITION(rows_ > 0 && cols_ > 0 && rows_ >= cols_);
+    OVXX_PRECONDITION(storage_ == qrd_nosaveq ||
+		      storage_ == qrd_saveq ||
+		      storage_ == qrd_saveq1);
+  }
+  qrd(qrd const &other) VSIP_THROW((std::bad_alloc))
+  : rows_(other.rows_),
+    cols_(other.cols_),
+    storage_(other.storage_),
+    data_(rows_, cols_),
+    tau_(cols_)
+  {
+    data_ = other.data_;
+    std::copy(other.tau_.get(), other.tau_.get() + cols_, tau_.get());
+  }
+  qrd &operator=(qrd const &other) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(rows_ == other.rows_ && cols_ == other.cols_);
+    storage_ = other.storage_;
+    data_ = other.data_;
+    std::copy(other.tau_.get(), other.tau_.get() + cols_, tau_.get());
+    return *this;
+  }
+
+  length_type rows() const VSIP_NOTHROW { return rows_;}
+  length_type columns() const VSIP_NOTHROW { return cols_;}
+  storage_type qstorage() const VSIP_NOTHROW { return storage_;}
+
+  template <typename B>
+  bool decompose(Matrix<T, B> m) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(m.size(0) == rows_ && m.size(1) == cols_);
+    parallel::assign_local(data_, m);
+    dda::Data<data_block_type, dda::inout> data(data_.block());
+    T *a = data.ptr();
+    stride_type const lda = data.stride(1);
+    length_type const n = cols_;
+
+    aligned_array<T> v(rows_ * panel_size);
+    aligned_array<T> t(panel_size * panel_size);
+    aligned_array<T> w(2 * n * panel_size);
+    for (index_type k0 = 0; k0 < n; k0 += panel_size)
+    {
+      length_type const kb = std::min(panel_size, n - k0);
+      length_type const l = rows_ - k0;
+      for (index_type k = k0; k != k0 + kb; ++k)
+      {
+	generate(a + k + k * lda, rows_ - k, tau_[k]);
+	for (index_type j = k + 1; j < k0 + kb; ++j)
+	  reflect(a + k + k * lda, math::impl_conj(tau_[k]),
+		  a + k + j * lda, rows_ - k);
+      }
+      index_type const j0 = k0 + kb;
+      if (j0 == n) break;
+
+      // V, with explicit zeros and ones.
+      for (index_type j = 0; j != kb; ++j)
+	for (index_type i = 0; i != l; ++i)
+	  v[i + j * l] = i < j ? T(0) : i == j ? T(1) : a[k0 + i + (k0 + j) * lda];
+      // T, such that H(k0) ... H(k0+kb-1) = I - V T V^H
+      for (index_type i = 0; i != kb; ++i)
+      {
+	T const tau = tau_[k0 + i];
+	t[i + i * kb] = tau;
+	for (index_type j = 0; j != i; ++j)
+	{
+	  T z = T(0);
+	  for (index_type r = i; r != l; ++r)
+	    z += math::impl_conj(v[r + j * l]) * v[r + i * l];
+	  t[j + i * kb] = -tau * z;
+	}
+	// Multiply by the leading upper triangle of T, in place.
+	for (index_type j = 0; j != i; ++j)
+	{
+	  T s = T(0);
+	  for (index_type r = j; r != i; ++r)
+	    s += t[j + r * kb] * t[r + i * kb];
+	  t[j + i * kb] = s;
+	}
+	for (index_type j = i + 1; j != kb; ++j) t[j + i * kb] = T(0);
+      }
+      // A2 -= V T^H V^H A2, computed through the transposes
+      // W = A2^T conj(V) and W' = W conj(T).
+      length_type const n2 = n - j0;
+      T *w1 = w.get();
+      T *w2 = w.get() + n2 * kb;
+      typedef typename traits::ref_type ref_type;
+      gemm<true>(n2, kb, l, T(1),
+		 traits::tref(a, lda, k0, j0), ref_type(v.get(), 1, l),
+		 T(0), ref_type(w1, 1, n2));
+      gemm<true>(n2, kb, kb, T(1),
+		 ref_type(w1, 1, n2), ref_type(t.get(), 1, kb),
+		 T(0), ref_type(w2, 1, n2));
+      gemm<false>(l, n2, kb, T(-1),
+		  ref_type(v.get(), 1, l), ref_type(w2, n2, 1),
+		  T(1), traits::ref(a, lda, k0, j0));
+    }
+    return true;
+  }
+
+  template <mat_op_type tr, product_side_type ps, typename B0, typename B1>
+  bool prodq(const_Matrix<T, B0> b, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(storage_ == qrd_saveq1 || storage_ == qrd_saveq);
+    // Q is rows_ x q_cols.
+    length_type const q_cols = storage_ == qrd_saveq1 ? cols_ : rows_;
+    // Left-side products are computed on (a padded copy of) B itself,
+    // right-side products on its (conjugate) transpose. A transpose
+    // is computed as the conjugate of a conjugate transpose.
+    bool const lside = ps == mat_lside;
+    bool const herm = lside ? tr != mat_ntrans : tr == mat_ntrans;
+    bool const cj = is_complex<T>::value && (lside ? tr == mat_trans : tr != mat_trans);
+    length_type const p = lside ? b.size(1) : b.size(0);
+    length_type const in_rows = lside ? b.size(0) : b.size(1);
+    length_type const out_rows = lside ? x.size(0) : x.size(1);
+    OVXX_PRECONDITION(p == (lside ? x.size(1) : x.size(0)));
+    OVXX_PRECONDITION(in_rows == (herm ? rows_ : q_cols));
+    OVXX_PRECONDITION(out_rows == (herm ? q_cols : rows_));
+
+    Matrix<T, data_block_type> c(rows_, p, T(0));
+    if (lside) c(Domain<2>(in_rows, p)) = b;
+    else c(Domain<2>(in_rows, p)) = b.transpose();
+    {
+      dda::Data<data_block_type, dda::inout> c_data(c.block());
+      T *cp = c_data.ptr();
+      stride_type const ldc = c_data.stride(1);
+      if (cj) conjugate(cp, ldc, in_rows, p);
+      apply_q(herm, cp, ldc, p);
+      if (cj) conjugate(cp, ldc, out_rows, p);
+    }
+    if (lside) x = c(Domain<2>(out_rows, p));
+    else x = c(Domain<2>(out_rows, p)).transpose();
+    return true;
+  }
+
+  template <mat_op_type tr, typename B0, typename B1>
+  bool rsol(const_Matrix<T, B0> b, T alpha, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == cols_);
+    OVXX_PRECONDITION(b.size(0) == x.size(0));
+    OVXX_PRECONDITION(b.size(1) == x.size(1));
+    Matrix<T, data_block_type> b_int(b.size(0), b.size(1));
+    parallel::assign_local(b_int, b);
+    {
+      dda::Data<data_block_type, dda::in> a_data(data_.block());
+      dda::Data<data_block_type, dda::inout> b_data(b_int.block());
+      trsm(upper, tr, false, cols_, b.size(1), alpha,
+	   a_data.ptr(), a_data.stride(1), b_data.ptr(), b_data.stride(1));
+    }
+    parallel::assign_local(x, b_int);
+    return true;
+  }
+
+  template <typename B0, typename B1>
+  bool covsol(const_Matrix<T, B0> b, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(b.size(0) == cols_);
+    OVXX_PRECONDITION(b.size(0) == x.size(0) && b.size(1) == x.size(1));
+    // A^H A X = R^H R X = B
+    Matrix<T, data_block_type> b_int(b.size(0), b.size(1));
+    parallel::assign_local(b_int, b);
+    {
+      dda::Data<data_block_type, dda::inout> b_data(b_int.block());
+      dda::Data<data_block_type, dda::in> a_data(data_.block());
+      trsm(upper, mat_herm, false, cols_, b.size(1), T(1),
+	   a_data.ptr(), a_data.stride(1), b_data.ptr(), b_data.stride(1));
+      trsm(upper, mat_ntrans, false, cols_, b.size(1), T(1),
+	   a_data.ptr(), a_data.stride(1), b_data.ptr(), b_data.stride(1));
+    }
+    parallel::assign_local(x, b_int);
+    return true;
+  }
+
+  template <typename B0, typename B1>
+  bool lsqsol(const_Matrix<T, B0> b, Matrix<T, B1> x) VSIP_NOTHROW
+  {
+    length_type const p = b.size(1);
+    OVXX_PRECONDITION(b.size(0) == rows_);
+    OVXX_PRECONDITION(x.size(0) == cols_);
+    OVXX_PRECONDITION(x.size(1) == p);
+    // R X = Q^H B, using the leading cols_ rows of Q^H B.
+    Matrix<T, data_block_type> c(rows_, p);
+    parallel::assign_local(c, b);
+    {
+      dda::Data<data_block_type, dda::inout> c_data(c.block());
+      dda::Data<data_block_type, dda::in> a_data(data_.block());
+      apply_q(true, c_data.ptr(), c_data.stride(1), p);
+      trsm(upper, mat_ntrans, false, cols_, p, T(1),
+	   a_data.ptr(), a_data.stride(1), c_data.ptr(), c_data.stride(1));
+    }
+    parallel::assign_local(x, c(Domain<2>(cols_, p)));
+    return true;
+  }
+
+private:
+  /// Generate the reflector H such that H^H [alpha, x] = [beta, 0],
+  /// with `alpha` and `x` given by the `l` elements at `a`.
+  /// On return `a` holds [beta, v].
+  static void generate(T *a, length_type l, T &tau)
+  {
+    scalar_type xnorm2 = 0;
+    for (index_type i = 1; i < l; ++i) xnorm2 += math::magsq(a[i]);
+    T const alpha = a[0];
+    if (xnorm2 == scalar_type(0) && math::impl_imag(alpha) == scalar_type(0))
+    {
+      tau = T(0);
+      return;
+    }
+    scalar_type const beta =
+      -std::copysign(std::sqrt(math::magsq(alpha) + xnorm2), math::impl_real(alpha));
+    tau = (beta - alpha) / beta;
+    T const s = T(1) / (alpha - beta);
+    for (index_type i = 1; i < l; ++i) a[i] *= s;
+    a[0] = beta;
+  }
+
+  /// Apply I - tau v v^H to the `l` elements of `c`, where `v` holds
+  /// the reflector with its implicit leading one.
+  static void reflect(T const *v, T tau, T *c, length_type l)
+  {
+    if (tau == T(0)) return;
+    T w = c[0];
+    for (index_type i = 1; i < l; ++i) w += math::impl_conj(v[i]) * c[i];
+    w *= tau;
+    c[0] -= w;
+    for (index_type i = 1; i < l; ++i) c[i] -= v[i] * w;
+  }
+
+  /// Apply Q (or Q^H if `herm` is set) to the `p` columns of `c`.
+  void apply_q(bool herm, T *c, stride_type ldc, length_type p)
+  {
+    dda::Data<data_block_type, dda::in> a_data(data_.block());
+    T const *a = a_data.ptr();
+    stride_type const lda = a_data.stride(1);
+    for (index_type l = 0; l != cols_; ++l)
+    {
+      // Q = H(0) ... H(n-1), Q^H = H(n-1)^H ... H(0)^H
+      index_type const k = herm ? l : cols_ - 1 - l;
+      T const tau = herm ? math::impl_conj(tau_[k]) : tau_[k];
+      for (index_type j = 0; j != p; ++j)
+	reflect(a + k + k * lda, tau, c + k + j * ldc, rows_ - k);
+    }
+  }
+
+  static void conjugate(T *c, stride_type ldc, length_type rows, length_type cols)
+  {
+    for (index_type j = 0; j != cols; ++j)
+      for (index_type i = 0; i != rows; ++i)
+	c[i + j * ldc] = math::impl_conj(c[i + j * ldc]);
+  }
+
+  length_type rows_;
+  length_type cols_;
+  storage_type storage_;
+  Matrix<T, data_block_type> data_;
+  aligned_array<T> tau_;
+};
+
+} // namespace ovxx::linalg
+
+namespace dispatcher
+{
+template <typename T>
+struct Evaluator<op::qrd, be::opt, T>
+{
+  static bool const ct_valid = linalg::is_supported<T>::value;
+  typedef linalg::qrd<T> backend_type;
+};
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
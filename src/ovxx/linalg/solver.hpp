@@ -0,0 +1,106 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_linalg_solver_hpp_
+#define ovxx_linalg_solver_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/impl/math_enum.hpp>
+#include <vsip/impl/solver/common.hpp>
+#include <ovxx/linalg/gemm.hpp>
+#include <ovxx/math/scalar.hpp>
+
+namespace ovxx
+{
+namespace linalg
+{
+
+/// The number of columns factored per panel by the blocked
+/// factorizations. Updates of the trailing matrix are done
+/// in blocks of this many columns with `gemm`.
+length_type const panel_size = 32;
+
+/// The native solvers keep their factors in column-major matrices,
+/// and access them through raw pointers and leading dimensions.
+template <typename T>
+struct solver_traits
+{
+  typedef Layout<2, col2_type, dense, array> layout_type;
+  typedef Strided<2, T, layout_type> block_type;
+  typedef Matrix<T, block_type> matrix_type;
+  typedef matrix_ref<T, array, T *> ref_type;
+
+  /// Return a reference to the submatrix at `(i, j)`.
+  static ref_type ref(T *a, stride_type lda, index_type i, index_type j)
+  { return ref_type(a + i + j * lda, 1, lda);}
+  /// Return a reference to the transpose of the submatrix at `(i, j)`.
+  static ref_type tref(T *a, stride_type lda, index_type i, index_type j)
+  { return ref_type(a + i + j * lda, lda, 1);}
+};
+
+template <typename T>
+inline T conj_if(bool c, T v) { return c ? math::impl_conj(v) : v;}
+
+/// Solve op(A) X = alpha B in place for an `n` x `n` triangular
+/// matrix A, with B of size `n` x `p`. A and B are column-major.
+template <typename T>
+void trsm(mat_uplo uplo, mat_op_type op, bool unit,
+	  length_type n, length_type p, T alpha,
+	  T const *a, stride_type lda, T *b, stride_type ldb)
+{
+  bool const c = op == mat_herm;
+  for (index_type k = 0; k != p; ++k)
+  {
+    T *x = b + k * ldb;
+    if (alpha != T(1))
+      for (index_type i = 0; i != n; ++i) x[i] *= alpha;
+    if (op == mat_ntrans && uplo == lower)
+      // Forward substitution, subtracting each solved value
+      // times the contiguous column below it.
+      for (index_type j = 0; j != n; ++j)
+      {
+	T const *col = a + j * lda;
+	if (!unit) x[j] /= col[j];
+	T const xj = x[j];
+	for (index_type i = j + 1; i < n; ++i) x[i] -= col[i] * xj;
+      }
+    else if (op == mat_ntrans)
+      // Backward substitution.
+      for (index_type j = n; j-- > 0;)
+      {
+	T const *col = a + j * lda;
+	if (!unit) x[j] /= col[j];
+	T const xj = x[j];
+	for (index_type i = 0; i != j; ++i) x[i] -= col[i] * xj;
+      }
+    else if (uplo == upper)
+      // op(A) is lower triangular: forward substitution,
+      // taking dot products with the columns above the diagonal.
+      for (index_type j = 0; j != n; ++j)
+      {
+	T const *col = a + j * lda;
+	T sum = x[j];
+	for (index_type i = 0; i != j; ++i) sum -= conj_if(c, col[i]) * x[i];
+	x[j] = unit ? sum : sum / conj_if(c, col[j]);
+      }
+    else
+      // op(A) is upper triangular: backward substitution.
+      for (index_type j = n; j-- > 0;)
+      {
+	T const *col = a + j * lda;
+	T sum = x[j];
+	for (index_type i = j + 1; i < n; ++i) sum -= conj_if(c, col[i]) * x[i];
+	x[j] = unit ? sum : sum / conj_if(c, col[j]);
+      }
+  }
+}
+
+} // namespace ovxx::linalg
+} // namespace ovxx
+
+#endif
@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_linalg_toeplitz_hpp_
+#define ovxx_linalg_toeplitz_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <ovxx/linalg/gemm.hpp>
+#include <ovxx/adjust_layout.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/parallel/assign_local.hpp>
+#include <ovxx/math/scalar.hpp>
+#include <atomic>
+
+namespace ovxx
+{
+namespace linalg
+{
+
+/// Solve the Hermitian positive definite Toeplitz system T X = B
+/// with the Levinson-Durbin recursion.
+///
+/// `t` is the first row of T, `y` is workspace of length `n`.
+/// All arrays are strided. Return false if T is not full rank.
+template <typename T>
+bool levinson(length_type n,
+	      T const *t, stride_type ts, T const *b, stride_type bs,
+	      T *y, stride_type ys, T *x, stride_type xs)
+{
+  typedef typename scalar_of<T>::type scalar_type;
+
+  T const *r = t + ts;
+  scalar_type const scale = math::impl_real(t[0]);
+  x[0] = b[0] / scale;
+  if (n == 1) return true;
+
+  T alpha = math::impl_conj(-r[0] / scale);
+  y[0] = alpha;
+  scalar_type beta = 1;
+  for (index_type k = 1; k != n; ++k)
+  {
+    beta *= scalar_type(1) - math::magsq(alpha);
+    if (beta == scalar_type(0)) return false;
+    scalar_type const d = scale * beta;
+
+    // Both inner products run over the reversed solutions
+    // of the previous order.
+    T sx = T(0), sy = T(0);
+    for (index_type i = 0; i != k; ++i)
+    {
+      T const ri = math::impl_conj(r[i * ts]);
+      sx += ri * x[(k - 1 - i) * xs];
+      sy += ri * y[(k - 1 - i) * ys];
+    }
+    T const mu = (b[k * bs] - sx) / d;
+    for (index_type i = 0; i != k; ++i)
+      x[i * xs] += mu * math::impl_conj(y[(k - 1 - i) * ys]);
+    x[k * xs] = mu;
+
+    if (k + 1 < n)
+    {
+      alpha = -(sy + math::impl_conj(r[k * ts])) / d;
+      // y(i) += alpha * conj(y(k-1-i)), updating both ends at once
+      // so no temporary is needed.
+      index_type i = 0, j = k - 1;
+      for (; i < j; ++i, --j)
+      {
+	T const yi = y[i * ys], yj = y[j * ys];
+	y[i * ys] = yi + alpha * math::impl_conj(yj);
+	y[j * ys] = yj + alpha * math::impl_conj(yi);
+      }
+      if (i == j) y[i * ys] += alpha * math::impl_conj(y[i * ys]);
+      y[k * ys] = alpha;
+    }
+  }
+  return true;
+}
+
+/// Solve a Toeplitz system held in local views, operating
+/// directly on their data.
+template <typename T, typename B0, typename B1, typename B2, typename B3>
+void toepsol(const_Vector<T, B0> t, const_Vector<T, B1> b,
+	     Vector<T, B2> y, Vector<T, B3> x, integral_constant<bool, true>)
+{
+  typedef Layout<1, any_type, any_packing, array> req_layout;
+  typedef typename adjust_layout<req_layout, typename get_block_layout<B0>::type>::type
+    t_layout;
+  typedef typename adjust_layout<req_layout, typename get_block_layout<B1>::type>::type
+    b_layout;
+  typedef typename adjust_layout<req_layout, typename get_block_layout<B2>::type>::type
+    y_layout;
+  typedef typename adjust_layout<req_layout, typename get_block_layout<B3>::type>::type
+    x_layout;
+  dda::Data<B0, dda::in, t_layout> t_data(t.block());
+  dda::Data<B1, dda::in, b_layout> b_data(b.block());
+  dda::Data<B2, dda::inout, y_layout> y_data(y.block());
+  dda::Data<B3, dda::out, x_layout> x_data(x.block());
+  if (!levinson(t.size(),
+		t_data.ptr(), t_data.stride(0), b_data.ptr(), b_data.stride(0),
+		y_data.ptr(), y_data.stride(0), x_data.ptr(), x_data.stride(0)))
+    OVXX_DO_THROW(computation_error("TOEPSOL: not full rank"));
+}
+
+/// Solve a Toeplitz system held in distributed views,
+/// by way of local copies.
+template <typename T, typename B0, typename B1, typename B2, typename B3>
+void toepsol(const_Vector<T, B0> t, const_Vector<T, B1> b,
+	     Vector<T, B2> y, Vector<T, B3> x, integral_constant<bool, false>)
+{
+  length_type const n = t.size();
+  Vector<T> t_local(n), b_local(n), y_local(n), x_local(n);
+  parallel::assign_local(t_local, t);
+  parallel::assign_local(b_local, b);
+  toepsol(t_local, b_local, y_local, x_local, integral_constant<bool, true>());
+  parallel::assign_local(y, y_local);
+  parallel::assign_local(x, x_local);
+}
+
+/// Solve the Toeplitz systems given by the rows of `t` and `b`,
+/// using the rows of `y` as workspace and storing the solutions
+/// in the rows of `x`. The rows are solved in parallel on the
+/// default thread pool.
+///
+/// Throws:
+///   computation_error if any of the systems is not full rank.
+template <typename T, typename B0, typename B1, typename B2, typename B3>
+void batch_toepsol(const_Matrix<T, B0> t, const_Matrix<T, B1> b,
+		   Matrix<T, B2> y, Matrix<T, B3> x)
+  VSIP_THROW((std::bad_alloc, computation_error))
+{
+  OVXX_PRECONDITION(t.size(0) == b.size(0) && t.size(1) == b.size(1));
+  OVXX_PRECONDITION(t.size(0) == y.size(0) && t.size(1) == y.size(1));
+  OVXX_PRECONDITION(t.size(0) == x.size(0) && t.size(1) == x.size(1));
+
+  typedef Layout<2, any_type, any_packing, array> req_layout;
+  typedef typename adjust_layout<req_layout, typename get_block_layout<B0>::type>::type
+    t_layout;
+  typedef typename adjust_layout<req_layout, typename get_block_layout<B1>::type>::type
+    b_layout;
+  typedef typename adjust_layout<req_layout, typename get_block_layout<B2>::type>::type
+    y_layout;
+  typedef typename adjust_layout<req_layout, typename get_block_layout<B3>::type>::type
+    x_layout;
+  dda::Data<B0, dda::in, t_layout> t_data(t.block());
+  dda::Data<B1, dda::in, b_layout> b_data(b.block());
+  dda::Data<B2, dda::inout, y_layout> y_data(y.block());
+  dda::Data<B3, dda::out, x_layout> x_data(x.block());
+
+  length_type const rows = t.size(0);
+  length_type const n = t.size(1);
+  std::atomic<bool> failed(false);
+  auto solve = [&](index_type k)
+  {
+    if (!levinson(n,
+		  t_data.ptr() + k * t_data.stride(0), t_data.stride(1),
+		  b_data.ptr() + k * b_data.stride(0), b_data.stride(1),
+		  y_data.ptr() + k * y_data.stride(0), y_data.stride(1),
+		  x_data.ptr() + k * x_data.stride(0), x_data.stride(1)))
+      failed = true;
+  };
+  thread_pool *pool = thread_pool::get_default();
+  if (pool && pool->concurrency() > 1 && rows > 1 &&
+      2 * rows * n * n >= threaded_prod_threshold())
+    pool->parallel_for(rows, solve);
+  else
+    for (index_type k = 0; k != rows; ++k) solve(k);
+  if (failed)
+    OVXX_DO_THROW(computation_error("TOEPSOL: not full rank"));
+}
+
+} // namespace ovxx::linalg
+} // namespace ovxx
+
+#endif
@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#include <ovxx/numa.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+#if defined(__linux__)
+# include <sys/syscall.h>
+#endif
+
+namespace ovxx
+{
+namespace numa
+{
+namespace
+{
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_move_pages)
+# define OVXX_HAVE_NUMA_SYSCALLS 1
+// From <linux/mempolicy.h>, which isn't available everywhere.
+int const mpol_default = 0;
+int const mpol_bind = 2;
+int const mpol_interleave = 3;
+int const mpol_mf_move = 1 << 1;
+
+// A node mask large enough for all practical systems.
+unsigned int const max_nodes = 1024;
+typedef unsigned long node_mask[max_nodes / (8 * sizeof(unsigned long))];
+#endif
+
+// Round `ptr` down to a page boundary.
+char *page_of(void const *ptr)
+{
+  size_t const p = reinterpret_cast<size_t>(ptr);
+  return reinterpret_cast<char *>(p & ~(page_size() - 1));
+}
+} // namespace <unnamed>
+
+unsigned int nodes()
+{
+  static unsigned int count = 0;
+  if (!count)
+  {
+    unsigned int n = 0;
+    while (true)
+    {
+      std::ostringstream path;
+      path << "/sys/devices/system/node/node" << n << "/cpulist";
+      std::ifstream ifs(path.str().c_str());
+      if (!ifs) break;
+      ++n;
+    }
+    count = std::max(n, 1u);
+  }
+  return count;
+}
+
+size_t page_size()
+{
+  static size_t size = sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+bool set_policy(void *ptr, size_t size, policy_type policy, unsigned int node)
+{
+#if OVXX_HAVE_NUMA_SYSCALLS
+  node_mask mask = {};
+  int mode = mpol_default;
+  if (policy == interleave)
+  {
+    mode = mpol_interleave;
+    for (unsigned int n = 0; n != std::min(nodes(), max_nodes); ++n)
+      mask[n / (8 * sizeof(unsigned long))] |= 1ul << (n % (8 * sizeof(unsigned long)));
+  }
+  else if (policy == bind)
+  {
+    if (node >= max_nodes) return false;
+    mode = mpol_bind;
+    mask[node / (8 * sizeof(unsigned long))] |= 1ul << (node % (8 * sizeof(unsigned long)));
+  }
+  // The kernel expects one more than the number of bits in the mask.
+  return syscall(SYS_mbind, ptr, size, mode,
+		 mode == mpol_default ? 0 : mask, max_nodes + 1, 0) == 0;
+#else
+  return policy == local || policy == first_touch;
+#endif
+}
+
+void touch(void *ptr, size_t size)
+{
+  char *begin = page_of(ptr);
+  char *end = static_cast<char *>(ptr) + size;
+  size_t const page = page_size();
+  length_type const pages = (end - begin + page - 1) / page;
+  // The pool initially hands each thread a contiguous share of the
+  // iteration space. Parallel loops over the data later do the same.
+  thread_pool *pool = thread_pool::get_default();
+  auto touch_page = [&](index_type i)
+  {
+    volatile char *p = begin + i * page;
+    *p = *p;
+  };
+  if (pool && pool->concurrency() > 1 && !thread_pool::in_parallel_region())
+    pool->parallel_for(pages, touch_page);
+  else
+    for (index_type i = 0; i != pages; ++i) touch_page(i);
+}
+
+bool migrate(void const *ptr, size_t size, unsigned int node)
+{
+  if (!size) return true;
+#if OVXX_HAVE_NUMA_SYSCALLS
+  char *begin = page_of(ptr);
+  char const *end = static_cast<char const *>(ptr) + size;
+  size_t const page = page_size();
+  length_type const pages = (end - begin + page - 1) / page;
+  std::vector<void *> addrs(pages);
+  std::vector<int> targets(pages, node);
+  std::vector<int> status(pages);
+  for (index_type i = 0; i != pages; ++i) addrs[i] = begin + i * page;
+  long result = syscall(SYS_move_pages, 0, pages, &addrs[0], &targets[0],
+			&status[0], mpol_mf_move);
+  if (result != 0) return false;
+  for (index_type i = 0; i != pages; ++i)
+    // Pages that aren't present yet are fine; they will be placed
+    // according to policy when first touched.
+    if (status[i] < 0 && status[i] != -ENOENT) return false;
+  return true;
+#else
+  return nodes() == 1 && node == 0;
+#endif
+}
+
+int node_of(void const *ptr)
+{
+#if OVXX_HAVE_NUMA_SYSCALLS
+  void *page = page_of(ptr);
+  int status = -1;
+  if (syscall(SYS_move_pages, 0, 1, &page, 0, &status, 0) != 0)
+    return -1;
+  return status >= 0 ? status : -1;
+#else
+  return nodes() == 1 ? 0 : -1;
+#endif
+}
+
+} // namespace ovxx::numa
+} // namespace ovxx
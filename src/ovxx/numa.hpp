@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_numa_hpp_
+#define ovxx_numa_hpp_
+
+#include <ovxx/support.hpp>
+#include <ovxx/ct_assert.hpp>
+#include <vsip/dda.hpp>
+#include <utility>
+
+namespace ovxx
+{
+namespace numa
+{
+
+/// How the pages of a memory range are placed on NUMA nodes.
+enum policy_type
+{
+  /// On the node of the thread that first touches them.
+  local,
+  /// Round-robin over all nodes.
+  interleave,
+  /// On a single, given node.
+  bind,
+  /// On the nodes of the default thread pool's threads, in the
+  /// proportions in which the pool splits parallel loops.
+  first_touch
+};
+
+/// The number of NUMA nodes in the system.
+unsigned int nodes();
+/// The size of a (normal) page.
+size_t page_size();
+
+/// Set the placement policy for the pages in `[ptr, ptr + size)`.
+/// This only affects pages that have not been touched yet.
+/// `ptr` must be page-aligned. `first_touch` is equivalent to `local`
+/// here; it is the caller's job to touch the pages.
+///
+/// Return false if the system doesn't support the request.
+bool set_policy(void *ptr, size_t size, policy_type policy, unsigned int node = 0);
+
+/// Touch the pages in `[ptr, ptr + size)` from the threads of the
+/// default thread pool, if there is one, so that their first touch
+/// places them on the pool's nodes.
+void touch(void *ptr, size_t size);
+
+/// Move the pages overlapping `[ptr, ptr + size)` to `node`.
+///
+/// Return false if not all pages could be moved.
+bool migrate(void const *ptr, size_t size, unsigned int node);
+
+/// Return the node holding the page containing `ptr`,
+/// or -1 if that can't be determined (e.g. because it hasn't been
+/// touched yet).
+int node_of(void const *ptr);
+
+namespace detail
+{
+template <typename T>
+bool migrate(T const *ptr, length_type size, unsigned int node)
+{ return numa::migrate(ptr, size * sizeof(T), node);}
+
+template <typename T>
+bool migrate(std::pair<T const *, T const *> const &ptr, length_type size,
+	     unsigned int node)
+{
+  return numa::migrate(ptr.first, size * sizeof(T), node) &&
+    numa::migrate(ptr.second, size * sizeof(T), node);
+}
+} // namespace ovxx::numa::detail
+
+/// Move the data of `block` to `node`.
+/// The block has to support direct data access.
+template <typename B>
+bool migrate(B const &block, unsigned int node)
+{
+  typedef vsip::dda::Data<B, vsip::dda::in> data_type;
+  OVXX_CT_ASSERT(data_type::ct_cost == 0);
+  data_type data(block);
+  return detail::migrate(data.ptr(), data.storage_size(), node);
+}
+
+} // namespace ovxx::numa
+} // namespace ovxx
+
+#endif
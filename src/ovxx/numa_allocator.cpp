@@ -0,0 +1,46 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#include <ovxx/numa_allocator.hpp>
+#include <sys/mman.h>
+
+namespace ovxx
+{
+namespace
+{
+size_t round_to_pages(size_t size)
+{
+  size_t const page = numa::page_size();
+  return (size + page - 1) / page * page;
+}
+} // namespace <unnamed>
+
+void *numa_allocator::allocate(size_t size)
+{
+  if (size == 0 || size < threshold_)
+    return static_cast<allocator &>(small_).allocate<char>(size);
+
+  size_t const bytes = round_to_pages(size);
+  void *ptr = mmap(0, bytes, PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) OVXX_DO_THROW(std::bad_alloc());
+  // Placement is best-effort: without NUMA support in the
+  // system, the pages simply stay where they are.
+  numa::set_policy(ptr, bytes, policy_, node_);
+  if (policy_ == numa::first_touch) numa::touch(ptr, bytes);
+  return ptr;
+}
+
+void numa_allocator::deallocate(void *ptr, size_t size)
+{
+  if (size == 0 || size < threshold_)
+    static_cast<allocator &>(small_).deallocate(static_cast<char *>(ptr), size);
+  else
+    munmap(ptr, round_to_pages(size));
+}
+
+} // namespace ovxx
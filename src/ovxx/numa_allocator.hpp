@@ -0,0 +1,51 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_numa_allocator_hpp_
+#define ovxx_numa_allocator_hpp_
+
+#include <ovxx/allocator.hpp>
+#include <ovxx/aligned_allocator.hpp>
+#include <ovxx/numa.hpp>
+
+namespace ovxx
+{
+
+/// An allocator that places large blocks on NUMA nodes according
+/// to a policy.
+///
+/// Requests of at least `threshold` bytes are served with fresh pages
+/// from the system, whose placement is set before they are first
+/// touched. Smaller requests are passed on to an aligned_allocator.
+class numa_allocator : public allocator
+{
+public:
+  static size_t const align = OVXX_ALLOC_ALIGNMENT;
+
+  explicit numa_allocator(numa::policy_type policy = numa::first_touch,
+			  unsigned int node = 0,
+			  size_t threshold = size_t(1) << 20)
+    : policy_(policy), node_(node), threshold_(threshold) {}
+
+  numa::policy_type policy() const { return policy_;}
+  /// The node pages are bound to, if `policy() == numa::bind`.
+  unsigned int node() const { return node_;}
+  size_t threshold() const { return threshold_;}
+
+private:
+  void *allocate(size_t size);
+  void deallocate(void *ptr, size_t size);
+
+  numa::policy_type policy_;
+  unsigned int node_;
+  size_t threshold_;
+  aligned_allocator small_;
+};
+
+} // namespace ovxx
+
+#endif
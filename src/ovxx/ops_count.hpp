@@ -12,6 +12,7 @@
 #include <vsip/complex.hpp>
 #include <vsip/domain.hpp>
 #include <ovxx/length.hpp>
+#include <ovxx/ops_count_traits.hpp>
 #include <string>
 #include <sstream>
 
@@ -20,41 +21,6 @@ namespace ovxx
 namespace ops_count
 {
 
-template <typename T>
-struct traits
-{
-  static unsigned int const div = 1;
-  static unsigned int const sqr = 1;
-  static unsigned int const mul = 1;
-  static unsigned int const add = 1;
-  static unsigned int const mag = 1;
-};
-
-template <typename T>
-struct traits<std::complex<T> >
-{
-  static unsigned int const div = 6 + 3 + 2; // mul + add + div
-  static unsigned int const sqr = 2 + 1;     // mul + add
-  static unsigned int const mul = 4 + 2;     // mul + add
-  static unsigned int const add = 2;
-  static unsigned int const mag = 2 + 1 + 1; // 2*mul + add + sqroot
-};
-
-
-template <typename T> 
-struct datatype { static char const *value() { return "I";}};
-
-#define OVXX_DATATYPE(T, VALUE)		\
-template <>					\
-struct datatype<T> { static char const *value() { return VALUE;}};
-
-OVXX_DATATYPE(float,                "S");
-OVXX_DATATYPE(double,               "D");
-OVXX_DATATYPE(std::complex<float>,  "C");
-OVXX_DATATYPE(std::complex<double>, "Z");
-
-#undef OVXX_DATATYPE
-
 namespace signal
 {
 
@@ -119,7 +85,8 @@ struct description
 
     st << len_kernel[0];
     if (D == 2) 
-      st << "x" << len_kernel[1] << " ";
+      st << "x" << len_kernel[1];
+    st << " ";
 
     st << len_output[0];
     if (D == 2) 
@@ -337,6 +304,45 @@ struct description
   } 
 };
 
+namespace solver
+{
+/// The cost of `n` multiply-add pairs.
+template <typename T>
+inline double madd(double n) { return n * (traits<T>::mul + traits<T>::add);}
+
+template <typename T>
+struct lud
+{
+  static double decompose(length_type n) { return madd<T>(double(n) * n * n / 3);}
+  static double solve(length_type n, length_type p) { return madd<T>(double(n) * n * p);}
+};
+
+template <typename T>
+struct chold
+{
+  static double decompose(length_type n) { return madd<T>(double(n) * n * n / 6);}
+  static double solve(length_type n, length_type p) { return madd<T>(double(n) * n * p);}
+};
+
+/// Householder QR of an `m` x `n` matrix, `m >= n`.
+template <typename T>
+struct qrd
+{
+  static double decompose(length_type m, length_type n)
+  { return madd<T>(double(n) * n * (m - n / 3.));}
+};
+
+/// Singular values of an `m` x `n` matrix, `m >= n`, dominated
+/// by the bidiagonalization.
+template <typename T>
+struct svd
+{
+  static double decompose(length_type m, length_type n)
+  { return madd<T>(2. * n * n * (m - n / 3.));}
+};
+
+} // namespace ovxx::ops_count::solver
+
 template <typename I, typename O>
 struct fft
 { 
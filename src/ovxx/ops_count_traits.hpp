@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_ops_count_traits_hpp_
+#define ovxx_ops_count_traits_hpp_
+
+#include <complex>
+
+/// Operation counts per value type. These are kept apart from
+/// ovxx/ops_count.hpp so that low-level headers (assignment,
+/// reductions) can use them in profiling events.
+namespace ovxx
+{
+namespace ops_count
+{
+
+template <typename T>
+struct traits
+{
+  static unsigned int const div = 1;
+  static unsigned int const sqr = 1;
+  static unsigned int const mul = 1;
+  static unsigned int const add = 1;
+  static unsigned int const mag = 1;
+};
+
+template <typename T>
+struct traits<std::complex<T> >
+{
+  static unsigned int const div = 6 + 3 + 2; // mul + add + div
+  static unsigned int const sqr = 2 + 1;     // mul + add
+  static unsigned int const mul = 4 + 2;     // mul + add
+  static unsigned int const add = 2;
+  static unsigned int const mag = 2 + 1 + 1; // 2*mul + add + sqroot
+};
+
+
+template <typename T> 
+struct datatype { static char const *value() { return "I";}};
+
+#define OVXX_DATATYPE(T, VALUE)		\
+template <>					\
+struct datatype<T> { static char const *value() { return VALUE;}};
+
+OVXX_DATATYPE(float,                "S");
+OVXX_DATATYPE(double,               "D");
+OVXX_DATATYPE(std::complex<float>,  "C");
+OVXX_DATATYPE(std::complex<double>, "Z");
+
+#undef OVXX_DATATYPE
+
+} // namespace ovxx::ops_count
+} // namespace ovxx
+
+#endif
@@ -0,0 +1,206 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#include <ovxx/pool_allocator.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/thread.hpp>
+#include <algorithm>
+
+namespace ovxx
+{
+namespace
+{
+std::atomic<size_t> next_id(1);
+
+// The cache used by the calling thread, and the allocator it belongs to.
+thread_local size_t cache_owner = 0;
+thread_local void *current_cache = 0;
+
+/// Return the size class for a request of `size` bytes, relative
+/// to the smallest class. Requests that are too large for any class
+/// yield the number of classes.
+inline unsigned int size_class(size_t size)
+{
+  unsigned int const classes =
+    pool_allocator::max_class - pool_allocator::min_class + 1;
+  unsigned int c = 0;
+  for (size_t s = size_t(1) << pool_allocator::min_class; s < size && c != classes; s <<= 1)
+    ++c;
+  return c;
+}
+
+inline size_t class_size(unsigned int c)
+{ return size_t(1) << (pool_allocator::min_class + c);}
+
+} // namespace <unnamed>
+
+struct pool_allocator::cache
+{
+  std::thread::id thread;
+  unsigned int count[max_cached_class - min_class + 1];
+  void *blocks[max_cached_class - min_class + 1][cache_depth];
+};
+
+pool_allocator::pool_allocator()
+  : id_(next_id++),
+    hits_(0),
+    misses_(0),
+    in_use_(0),
+    high_water_mark_(0),
+    cached_(0)
+{
+  std::fill(free_, free_ + classes, static_cast<void*>(0));
+}
+
+pool_allocator::~pool_allocator()
+{
+  for (unsigned int c = 0; c != classes; ++c) drain(c);
+  for (std::vector<cache *>::iterator k = caches_.begin(); k != caches_.end(); ++k)
+  {
+    drain(*k);
+    delete *k;
+  }
+}
+
+pool_allocator::statistics pool_allocator::stats() const
+{
+  statistics s;
+  s.hits = hits_;
+  s.misses = misses_;
+  s.in_use = in_use_;
+  s.high_water_mark = high_water_mark_;
+  s.cached = cached_;
+  return s;
+}
+
+void pool_allocator::release()
+{
+  drain(thread_cache());
+  for (unsigned int c = 0; c != classes; ++c) drain(c);
+}
+
+void *pool_allocator::allocate(size_t size)
+{
+  // If size == 0, allocate 1 byte.
+  if (size == 0) size = 1;
+  unsigned int const c = size_class(size);
+  size_t const bytes = c == classes ? size : class_size(c);
+  void *ptr = 0;
+  if (c <= max_cached_class - min_class)
+  {
+    cache *k = thread_cache();
+    if (k->count[c]) ptr = k->blocks[c][--k->count[c]];
+  }
+  if (!ptr && c != classes) ptr = pop(c);
+  if (ptr)
+  {
+    ++hits_;
+    cached_ -= bytes;
+  }
+  else
+  {
+    ++misses_;
+    ptr = alloc_align<char>(align, bytes);
+    if (ptr == 0) OVXX_DO_THROW(std::bad_alloc());
+  }
+  size_t const used = in_use_ += bytes;
+  size_t high = high_water_mark_;
+  while (used > high && !high_water_mark_.compare_exchange_weak(high, used));
+  return ptr;
+}
+
+void pool_allocator::deallocate(void *ptr, size_t size)
+{
+  if (size == 0) size = 1;
+  unsigned int const c = size_class(size);
+  size_t const bytes = c == classes ? size : class_size(c);
+  in_use_ -= bytes;
+  if (c == classes)
+  {
+    free_align(ptr);
+    return;
+  }
+  cached_ += bytes;
+  if (c <= max_cached_class - min_class)
+  {
+    cache *k = thread_cache();
+    if (k->count[c] != cache_depth)
+    {
+      k->blocks[c][k->count[c]++] = ptr;
+      return;
+    }
+  }
+  push(c, ptr);
+}
+
+pool_allocator::cache *pool_allocator::thread_cache()
+{
+  if (cache_owner == id_) return static_cast<cache *>(current_cache);
+
+  std::lock_guard<std::mutex> lock(caches_mutex_);
+  std::thread::id const thread = std::this_thread::get_id();
+  cache *k = 0;
+  for (std::vector<cache *>::iterator i = caches_.begin(); i != caches_.end(); ++i)
+    if ((*i)->thread == thread) k = *i;
+  if (!k)
+  {
+    // Threads that have exited leave their caches behind, to be
+    // picked up by a new thread with the same id.
+    k = new cache;
+    k->thread = thread;
+    std::fill(k->count, k->count + max_cached_class - min_class + 1, 0);
+    caches_.push_back(k);
+  }
+  cache_owner = id_;
+  current_cache = k;
+  return k;
+}
+
+void pool_allocator::push(unsigned int c, void *block)
+{
+  std::lock_guard<std::mutex> lock(mutex_[c]);
+  *static_cast<void **>(block) = free_[c];
+  free_[c] = block;
+}
+
+void *pool_allocator::pop(unsigned int c)
+{
+  std::lock_guard<std::mutex> lock(mutex_[c]);
+  void *block = free_[c];
+  if (block) free_[c] = *static_cast<void **>(block);
+  return block;
+}
+
+void pool_allocator::drain(unsigned int c)
+{
+  void *block;
+  {
+    std::lock_guard<std::mutex> lock(mutex_[c]);
+    block = free_[c];
+    free_[c] = 0;
+  }
+  while (block)
+  {
+    void *next = *static_cast<void **>(block);
+    free_align(block);
+    cached_ -= class_size(c);
+    block = next;
+  }
+}
+
+void pool_allocator::drain(cache *k)
+{
+  for (unsigned int c = 0; c <= max_cached_class - min_class; ++c)
+  {
+    for (unsigned int i = 0; i != k->count[c]; ++i)
+      free_align(k->blocks[c][i]);
+    cached_ -= k->count[c] * class_size(c);
+    k->count[c] = 0;
+  }
+}
+
+} // namespace ovxx
@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_pool_allocator_hpp_
+#define ovxx_pool_allocator_hpp_
+
+#include <ovxx/config.hpp>
+#include <ovxx/allocator.hpp>
+#include <ovxx/support.hpp>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace ovxx
+{
+
+/// An allocator that recycles memory in power-of-two size classes.
+///
+/// Requests are rounded up to the next size class. Freed blocks are
+/// kept on per-class free lists and handed out again to the next
+/// request of the same class, first from a small cache local to the
+/// calling thread, then from lists shared by all threads. Requests
+/// larger than the largest class go straight to the system.
+///
+/// Blocks in the cache of a thread that has exited are only returned
+/// to the system when the allocator is destroyed.
+class pool_allocator : public allocator
+{
+public:
+  static size_t const align = OVXX_ALLOC_ALIGNMENT;
+  /// The smallest and the largest size class, as powers of two.
+  static unsigned int const min_class = 6;
+  static unsigned int const max_class = 26;
+  /// The number of blocks per class in each thread's cache.
+  static unsigned int const cache_depth = 8;
+  /// Only classes up to this one are cached per thread.
+  static unsigned int const max_cached_class = 20;
+
+  struct statistics
+  {
+    /// Requests served from a free list.
+    size_t hits;
+    /// Requests that had to be passed on to the system.
+    size_t misses;
+    /// Bytes currently handed out, in units of size classes.
+    size_t in_use;
+    /// The maximum of `in_use` over the allocator's lifetime.
+    size_t high_water_mark;
+    /// Bytes held on free lists.
+    size_t cached;
+  };
+
+  pool_allocator();
+  ~pool_allocator();
+
+  statistics stats() const;
+  /// Return the blocks on the shared free lists, as well as those
+  /// in the calling thread's cache, to the system.
+  void release();
+
+private:
+  struct cache;
+  static unsigned int const classes = max_class - min_class + 1;
+
+  void *allocate(size_t size);
+  void deallocate(void *ptr, size_t size);
+
+  cache *thread_cache();
+  void push(unsigned int c, void *block);
+  void *pop(unsigned int c);
+  void drain(unsigned int c);
+  void drain(cache *k);
+
+  /// Distinguishes this allocator from earlier ones at the same address.
+  size_t id_;
+  std::mutex mutex_[classes];
+  /// Singly-linked lists threaded through the free blocks.
+  void *free_[classes];
+  std::mutex caches_mutex_;
+  std::vector<cache *> caches_;
+
+  std::atomic<size_t> hits_;
+  std::atomic<size_t> misses_;
+  std::atomic<size_t> in_use_;
+  std::atomic<size_t> high_water_mark_;
+  std::atomic<size_t> cached_;
+};
+
+} // namespace ovxx
+
+#endif
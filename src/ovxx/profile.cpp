@@ -0,0 +1,219 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#include <ovxx/profile.hpp>
+#include <ovxx/thread.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace ovxx
+{
+namespace profile
+{
+namespace detail
+{
+std::atomic<mode_type> mode(off);
+}
+
+namespace
+{
+struct accumulator
+{
+  accumulator() : calls(0), total(0), ops(0) {}
+  unsigned long calls;
+  int64_type total; // ns
+  double ops;
+};
+
+struct record_type
+{
+  std::string name;
+  double ops;
+  int64_type start; // ns
+  int64_type end;   // ns
+  unsigned tid;
+};
+
+std::mutex guard;
+std::map<std::string, accumulator> summary_;
+std::vector<record_type> trace_;
+// Small per-thread ids, to keep traces readable.
+unsigned thread_count = 0;
+thread_local unsigned thread_id = 0;
+
+// What was asked for on the command line.
+mode_type requested = off;
+std::string output;
+
+void escape(std::ostream &os, std::string const &s)
+{
+  for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+    switch (*i)
+    {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\t': os << "\\t"; break;
+      default:
+	if (static_cast<unsigned char>(*i) < 0x20)
+	  os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+	     << int(*i) << std::dec << std::setfill(' ');
+	else os << *i;
+    }
+}
+
+bool longer(entry const &a, entry const &b)
+{
+  return a.seconds > b.seconds;
+}
+} // namespace <unnamed>
+
+void set_mode(mode_type m) { detail::mode = m;}
+mode_type mode() { return detail::mode;}
+
+void clear()
+{
+  std::lock_guard<std::mutex> lock(guard);
+  summary_.clear();
+  trace_.clear();
+}
+
+void detail::record(std::string const &name, double ops,
+		    int64_type start, int64_type end)
+{
+  std::lock_guard<std::mutex> lock(guard);
+  accumulator &a = summary_[name];
+  ++a.calls;
+  a.total += end - start;
+  a.ops += ops;
+  if (detail::mode.load(std::memory_order_relaxed) == trace)
+  {
+    if (!thread_id) thread_id = ++thread_count;
+    record_type r = { name, ops, start, end, thread_id};
+    trace_.push_back(r);
+  }
+}
+
+std::vector<entry> entries()
+{
+  std::vector<entry> result;
+  {
+    std::lock_guard<std::mutex> lock(guard);
+    for (std::map<std::string, accumulator>::const_iterator i = summary_.begin();
+	 i != summary_.end(); ++i)
+    {
+      entry e = { i->first, i->second.calls, i->second.total * 1e-9, i->second.ops};
+      result.push_back(e);
+    }
+  }
+  std::stable_sort(result.begin(), result.end(), longer);
+  return result;
+}
+
+void dump_summary(std::ostream &os)
+{
+  std::vector<entry> all = entries();
+  std::ios::fmtflags flags = os.flags();
+  os << std::left << std::setw(48) << "# event" << std::right
+     << std::setw(10) << "calls"
+     << std::setw(14) << "total (s)"
+     << std::setw(14) << "avg (us)"
+     << std::setw(12) << "mflop/s" << '\n';
+  for (std::vector<entry>::const_iterator i = all.begin(); i != all.end(); ++i)
+    os << std::left << std::setw(48) << i->name << std::right
+       << std::setw(10) << i->calls
+       << std::setw(14) << std::fixed << std::setprecision(6) << i->seconds
+       << std::setw(14) << std::setprecision(3) << i->seconds * 1e6 / i->calls
+       << std::setw(12) << std::setprecision(1)
+       << (i->seconds > 0. ? i->ops / i->seconds * 1e-6 : 0.) << '\n';
+  os.flags(flags);
+}
+
+void dump_trace(std::ostream &os)
+{
+  std::lock_guard<std::mutex> lock(guard);
+  std::ios::fmtflags flags = os.flags();
+  os << std::fixed << std::setprecision(3);
+  os << "{\"traceEvents\":[";
+  for (std::vector<record_type>::const_iterator i = trace_.begin();
+       i != trace_.end(); ++i)
+  {
+    if (i != trace_.begin()) os << ',';
+    os << "\n{\"name\":\"";
+    escape(os, i->name);
+    os << "\",\"cat\":\"ovxx\",\"ph\":\"X\""
+       << ",\"ts\":" << i->start * 1e-3
+       << ",\"dur\":" << (i->end - i->start) * 1e-3
+       << ",\"pid\":0,\"tid\":" << i->tid
+       << ",\"args\":{\"ops\":" << std::setprecision(0) << i->ops
+       << std::setprecision(3) << "}}";
+  }
+  os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  os.flags(flags);
+}
+
+void parse_options(int &argc, char **&argv)
+{
+  char const *name = "--ovxx-profile=";
+  char const *out = "--ovxx-profile-output=";
+  size_t const len = std::strlen(name);
+  size_t const out_len = std::strlen(out);
+  int i = 1;
+  while (i < argc)
+  {
+    if (!std::strncmp(argv[i], name, len))
+    {
+      char const *value = argv[i] + len;
+      if (!std::strcmp(value, "summary")) requested = summary;
+      else if (!std::strcmp(value, "trace")) requested = trace;
+      else if (!std::strcmp(value, "off")) requested = off;
+      else
+	OVXX_DO_THROW(std::invalid_argument("invalid --ovxx-profile value"));
+    }
+    else if (!std::strncmp(argv[i], out, out_len))
+      output = argv[i] + out_len;
+    else
+    {
+      ++i;
+      continue;
+    }
+    // Remove the recognized option.
+    for (int j = i; j < argc; ++j) argv[j] = argv[j + 1];
+    --argc;
+  }
+  if (requested != off) set_mode(requested);
+}
+
+void finalize()
+{
+  if (requested == summary)
+  {
+    if (output.empty()) dump_summary(std::cout);
+    else
+    {
+      std::ofstream ofs(output.c_str());
+      dump_summary(ofs);
+    }
+  }
+  else if (requested == trace)
+  {
+    std::ofstream ofs(output.empty() ? "ovxx-trace.json" : output.c_str());
+    dump_trace(ofs);
+  }
+  requested = off;
+  set_mode(off);
+  clear();
+}
+
+} // namespace ovxx::profile
+} // namespace ovxx
@@ -0,0 +1,164 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_profile_hpp_
+#define ovxx_profile_hpp_
+
+#include <ovxx/support.hpp>
+#include <ovxx/chrono.hpp>
+#include <ovxx/inttypes.hpp>
+#include <ovxx/ops_count_traits.hpp>
+#include <atomic>
+#include <iosfwd>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// Profiling support.
+///
+/// With profiling compiled in (`--enable-profiling`, or by defining
+/// `OVXX_PROFILE` to 1 before including any OpenVSIP header), Fft and
+/// Fftm transforms, convolutions, correlations, FIR filters, reductions,
+/// solvers and expression assignments record a scoped event each time
+/// they run, tagged with the backend used, the problem size and the
+/// operation count. Without it, the instrumentation compiles to nothing.
+///
+/// Recording itself is switched on at runtime, either with
+/// `profile::set_mode()` or with the `--ovxx-profile=summary|trace`
+/// command-line option (with `--ovxx-profile-output=<file>` to choose
+/// where the results are written when the library finalizes).
+/// In `summary` mode, events with the same tag are accumulated into
+/// one line of a table (calls, total and average time, MFLOP/s).
+/// In `trace` mode every event is kept as well, to be written in the
+/// Chrome trace format (viewable with chrome://tracing or Perfetto).
+///
+/// Events nest: the time of an Fft used by a fast convolution is
+/// included in that of the convolution, too.
+namespace ovxx
+{
+namespace profile
+{
+enum mode_type { off, summary, trace};
+
+/// Events accumulated under a common tag.
+struct entry
+{
+  std::string name;
+  unsigned long calls;
+  double seconds;
+  double ops;
+};
+
+/// Start (or stop) recording events.
+void set_mode(mode_type);
+mode_type mode();
+/// Discard all recorded events.
+void clear();
+/// Return the accumulated events, sorted by total time.
+std::vector<entry> entries();
+/// Write a table of accumulated events, sorted by total time.
+void dump_summary(std::ostream &);
+/// Write the recorded events in Chrome trace (JSON) format.
+void dump_trace(std::ostream &);
+
+namespace detail
+{
+/// Read by any thread recording an event.
+extern std::atomic<mode_type> mode;
+
+void record(std::string const &name, double ops, int64_type start, int64_type end);
+
+inline int64_type now()
+{
+#ifdef OVXX_TIMER_SYSTEM
+  return chrono::duration_cast<chrono::nanoseconds>
+    (clock::now().time_since_epoch()).count();
+#else
+  return clock::now().time_since_epoch().count();
+#endif
+}
+
+inline void append(std::ostream &) {}
+template <typename A, typename ...R>
+inline void append(std::ostream &os, A const &a, R const &...r)
+{
+  os << ' ' << a;
+  append(os, r...);
+}
+} // namespace ovxx::profile::detail
+
+inline bool enabled()
+{ return detail::mode.load(std::memory_order_relaxed) != off;}
+
+/// Build an event tag from `op` and the remaining arguments,
+/// separated by spaces.
+template <typename ...A>
+std::string tag(char const *op, A const &...args)
+{
+  std::ostringstream oss;
+  oss << op;
+  detail::append(oss, args...);
+  return oss.str();
+}
+
+/// A scoped event, timing its own lifetime.
+/// The tag and the operation count are computed by the given
+/// functions, which are only called when events are recorded.
+class event
+{
+public:
+  template <typename N, typename O>
+  event(N name, O ops) : event(true, name, ops) {}
+  /// Only record the event if `record` is true.
+  template <typename N, typename O>
+  event(bool record, N name, O ops)
+    : active_(record && enabled())
+  {
+    if (!active_) return;
+    name_ = name();
+    ops_ = ops();
+    start_ = detail::now();
+  }
+  ~event()
+  {
+    if (active_) detail::record(name_, ops_, start_, detail::now());
+  }
+
+private:
+  event(event const &);
+  event &operator=(event const &);
+
+  bool active_;
+  std::string name_;
+  double ops_;
+  int64_type start_;
+};
+
+/// Parse and remove `--ovxx-profile` options.
+void parse_options(int &argc, char **&argv);
+/// Write the results requested on the command line.
+void finalize();
+
+} // namespace ovxx::profile
+} // namespace ovxx
+
+#define OVXX_PROFILE_CAT_(a, b) a##b
+#define OVXX_PROFILE_CAT(a, b) OVXX_PROFILE_CAT_(a, b)
+
+/// Record a scoped event. `name` (a std::string) and `ops` are only
+/// evaluated when events are recorded. Arguments containing
+/// top-level commas need to be parenthesized.
+#if OVXX_PROFILE
+# define OVXX_PROFILE_EVENT(name, ops)			      \
+  ovxx::profile::event OVXX_PROFILE_CAT(ovxx_event_, __LINE__) \
+  ([&]() -> std::string { return name;},		      \
+   [&]() -> double { return ops;})
+#else
+# define OVXX_PROFILE_EVENT(name, ops)
+#endif
+
+#endif
@@ -0,0 +1,379 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_reductions_multi_hpp_
+#define ovxx_reductions_multi_hpp_
+
+#include <vsip/support.hpp>
+#include <ovxx/reductions/threaded.hpp>
+#include <ovxx/expr/evaluate.hpp>
+#include <tuple>
+#include <vector>
+
+namespace ovxx
+{
+namespace reduction
+{
+
+/// Element access by linear index, in the traversal order of the
+/// block, for multi-dimensional blocks that can't be accessed densely.
+template <typename B, dimension_type D = B::dim>
+class nd_reader
+{
+  typedef typename get_block_layout<B>::order_type order_type;
+
+public:
+  typedef typename B::value_type value_type;
+
+  nd_reader(B const &block) : block_(block) {}
+  length_type size() const { return block_.size();}
+  value_type operator()(index_type i) const
+  {
+    index_type idx[3] = { 0, 0, 0};
+    dimension_type const order[3] =
+      { order_type::impl_dim0, order_type::impl_dim1, order_type::impl_dim2};
+    for (dimension_type d = D; d-- > 1;)
+    {
+      length_type const size = block_.size(D, order[d]);
+      idx[order[d]] = i % size;
+      i /= size;
+    }
+    idx[order[0]] = i;
+    return get(idx, integral_constant<dimension_type, D>());
+  }
+
+private:
+  value_type get(index_type const *idx, integral_constant<dimension_type, 2>) const
+  { return block_.get(idx[0], idx[1]);}
+  value_type get(index_type const *idx, integral_constant<dimension_type, 3>) const
+  { return block_.get(idx[0], idx[1], idx[2]);}
+
+  B const &block_;
+};
+
+namespace multi
+{
+template <typename T>
+struct has_rtype
+{
+  template <typename U> static char test(int (*)[sizeof(U::rtype) ? 1 : 1]);
+  template <typename U> static long test(...);
+  static bool const value = sizeof(test<T>(0)) == 1;
+};
+
+/// Adapts a reduction functor to a common interface. Value reductions
+/// (with `initial()`, `update()` and `value()`) accumulate in `lanes`
+/// interleaved lanes, like the threaded summation.
+template <template <typename> class R, typename T,
+	  bool V = has_rtype<R<T> >::value>
+struct adaptor
+{
+  typedef R<T> reduction_type;
+  typedef typename reduction_type::accum_type accum_type;
+  typedef typename reduction_type::result_type result_type;
+  struct state { accum_type s[lanes];};
+
+  static state initial(T const &)
+  {
+    state s;
+    for (index_type l = 0; l != lanes; ++l) s.s[l] = reduction_type::initial();
+    return s;
+  }
+  static void update(state &s, T const *v, length_type n, index_type)
+  {
+    for (index_type l = 0; l != n; ++l)
+      s.s[l] = reduction_type::update(s.s[l], v[l]);
+  }
+  static void finish(state &s)
+  {
+    for (length_type w = lanes / 2; w; w /= 2)
+      for (index_type l = 0; l != w; ++l)
+	s.s[l] = combine(s.s[l], s.s[l + w]);
+  }
+  static void merge(state &a, state const &b) { a.s[0] = combine(a.s[0], b.s[0]);}
+  static result_type result(state const &s, length_type size)
+  { return reduction_type::value(s.s[0], size);}
+  static index_type index(state const &) { return 0;}
+
+private:
+  static accum_type combine(accum_type a, accum_type b)
+  {
+    return reduction_type::rtype == reduce_sum ? a + b : reduction_type::update(a, b);
+  }
+};
+
+/// Index reductions (with `next_value()`) are scanned serially
+/// against the first element, and merged in order, so the first
+/// occurrence is found.
+template <template <typename> class R, typename T>
+struct adaptor<R, T, false>
+{
+  typedef R<T> reduction_type;
+  typedef typename reduction_type::result_type result_type;
+  struct state
+  {
+    state(T const &first) : r(first), best(first), idx(0), found(false) {}
+    reduction_type r;
+    T best;
+    index_type idx;
+    bool found;
+  };
+
+  static state initial(T const &first) { return state(first);}
+  static void update(state &s, T const *v, length_type n, index_type base)
+  {
+    for (index_type l = 0; l != n; ++l)
+      if (s.r.next_value(v[l]))
+      {
+	s.best = v[l];
+	s.idx = base + l;
+	s.found = true;
+      }
+  }
+  static void finish(state &) {}
+  static void merge(state &a, state const &b)
+  {
+    if (b.found && a.r.next_value(b.best))
+    {
+      a.best = b.best;
+      a.idx = b.idx;
+      a.found = true;
+    }
+  }
+  static result_type result(state const &s, length_type)
+  {
+    reduction_type r(s.r);
+    return r.value();
+  }
+  static index_type index(state const &s) { return s.idx;}
+};
+
+/// Apply an operation to all adaptors and their states.
+template <std::size_t I, typename T, template <typename> class... R>
+struct each;
+
+template <std::size_t I, typename T>
+struct each<I, T>
+{
+  template <typename S> static void initial(S &, T const &) {}
+  template <typename S> static void update(S &, T const *, length_type, index_type) {}
+  template <typename S> static void finish(S &) {}
+  template <typename S> static void merge(S &, S const &) {}
+  template <typename S, typename V, typename X>
+  static void result(S const &, length_type, V &, X *) {}
+};
+
+template <std::size_t I, typename T,
+	  template <typename> class R, template <typename> class... Rs>
+struct each<I, T, R, Rs...>
+{
+  typedef adaptor<R, T> a;
+  typedef each<I + 1, T, Rs...> next;
+
+  template <typename S> static void initial(S &s, T const &first)
+  {
+    std::get<I>(s) = a::initial(first);
+    next::initial(s, first);
+  }
+  template <typename S>
+  static void update(S &s, T const *v, length_type n, index_type base)
+  {
+    a::update(std::get<I>(s), v, n, base);
+    next::update(s, v, n, base);
+  }
+  template <typename S> static void finish(S &s)
+  {
+    a::finish(std::get<I>(s));
+    next::finish(s);
+  }
+  template <typename S> static void merge(S &s, S const &o)
+  {
+    a::merge(std::get<I>(s), std::get<I>(o));
+    next::merge(s, o);
+  }
+  template <typename S, typename V, typename X>
+  static void result(S const &s, length_type size, V &values, X *indices)
+  {
+    std::get<I>(values) = a::result(std::get<I>(s), size);
+    indices[I] = a::index(std::get<I>(s));
+    next::result(s, size, values, indices);
+  }
+};
+
+/// Evaluate all reductions R over `a` in a single pass.
+template <template <typename> class... R, typename A, typename V>
+void reduce(A const &a, bool threadable, V &values, index_type *indices)
+{
+  typedef typename A::value_type T;
+  typedef std::tuple<typename adaptor<R, T>::state...> state_type;
+  typedef each<0, T, R...> ops;
+
+  length_type const size = a.size();
+  T const first = a(0);
+  state_type init(adaptor<R, T>::initial(first)...);
+  length_type const chunks = (size + chunk_size - 1) / chunk_size;
+  std::vector<state_type> partial(chunks, init);
+  auto run = [&](index_type c)
+  {
+    state_type &s = partial[c];
+    index_type const end = std::min(size, (c + 1) * chunk_size);
+    T v[lanes];
+    index_type i = c * chunk_size;
+    for (; i + lanes <= end; i += lanes)
+    {
+      for (index_type l = 0; l != lanes; ++l) v[l] = a(i + l);
+      ops::update(s, v, lanes, i);
+    }
+    for (index_type l = 0; i + l != end; ++l) v[l] = a(i + l);
+    ops::update(s, v, end - i, i);
+    ops::finish(s);
+  };
+  if (threadable) for_each_chunk(size, run);
+  else for (index_type c = 0; c != chunks; ++c) run(c);
+  // Merge pairwise, always keeping the earlier range on the left.
+  for (length_type n = chunks; n > 1; n = (n + 1) / 2)
+  {
+    for (index_type i = 0; i != n / 2; ++i)
+    {
+      partial[i] = partial[2 * i];
+      ops::merge(partial[i], partial[2 * i + 1]);
+    }
+    if (n % 2) partial[n / 2] = partial[n - 1];
+  }
+  ops::result(partial[0], size, values, indices);
+}
+
+/// Like `reduce()`, but take the fast path for unit-stride data.
+template <template <typename> class... R, typename A, typename V>
+void reduce_linear(A const &a, bool threadable, V &values, index_type *indices)
+{
+  if (a.is_unit()) multi::reduce<R...>(a.unit(), threadable, values, indices);
+  else multi::reduce<R...>(a, threadable, values, indices);
+}
+
+/// Traverse the block by whichever reader fits it best: by linear
+/// index for vectors, in storage order for dense data, and by
+/// computing each index otherwise.
+template <typename B,
+	  bool Linear = B::dim == 1,
+	  bool Direct = vsip::dda::Data<B, vsip::dda::in>::ct_cost == 0>
+struct traversal
+{
+  template <template <typename> class... R, typename V>
+  static void exec(B const &block, V &values, index_type *indices)
+  {
+    reader<B> in(block);
+    multi::reduce_linear<R...>(in, assignment::is_threadable<B>::value, values, indices);
+  }
+};
+
+template <typename B>
+struct traversal<B, false, true>
+{
+  template <template <typename> class... R, typename V>
+  static void exec(B const &block, V &values, index_type *indices)
+  {
+    bool const threadable = assignment::is_threadable<B>::value;
+    reader<B> in(block);
+    if (in.is_dense())
+      multi::reduce_linear<R...>(in, threadable, values, indices);
+    else
+      multi::reduce<R...>(nd_reader<B>(block), threadable, values, indices);
+  }
+};
+
+template <typename B>
+struct traversal<B, false, false>
+{
+  template <template <typename> class... R, typename V>
+  static void exec(B const &block, V &values, index_type *indices)
+  {
+    multi::reduce<R...>(nd_reader<B>(block), assignment::is_threadable<B>::value,
+			values, indices);
+  }
+};
+
+} // namespace ovxx::reduction::multi
+} // namespace ovxx::reduction
+
+/// The results of a fused multi-reduction over a `D`-dimensional view
+/// of value type `T`.
+template <dimension_type D, typename T, template <typename> class... R>
+class multi_reduction
+{
+public:
+  typedef std::tuple<typename reduction::multi::adaptor<R, T>::result_type...>
+    values_type;
+
+  /// The result of the `I`th reduction.
+  template <std::size_t I>
+  typename std::tuple_element<I, values_type>::type get() const
+  { return std::get<I>(values_);}
+  /// The index of the element selected by the `I`th reduction,
+  /// if that is an index reduction such as `Max_value`.
+  template <std::size_t I>
+  Index<D> index() const { return indices_[I];}
+
+  values_type values_;
+  Index<D> indices_[sizeof...(R)];
+};
+
+/// Evaluate the reductions R over `view` in a single pass, reading
+/// each element only once. `view` may be an element-wise expression,
+/// such as `magsq(x)`, which is then evaluated on the fly.
+///
+/// R may be any mix of value reductions (e.g. `Sum_value`,
+/// `Sum_sq_value`, `Mean_value`) and index reductions (e.g.
+/// `Max_value`, `Min_mag_value`). Sums are formed by chunks, combined
+/// pairwise, like those of the threaded reduction backend, so they
+/// don't depend on the number of threads. Unless a C-VSIPL or CUDA
+/// backend is configured (those take precedence), that backend
+/// handles the individual reductions of vectors and of dense data at
+/// all sizes (its `threaded_threshold()` only decides whether the
+/// chunks run on the thread pool), so for such views the results are
+/// bitwise identical. For non-dense matrix and tensor subviews, or
+/// with those other backends, the summation order differs, and so may
+/// the rounding.
+///
+/// Example:
+///   multi_reduction<1, float, Sum_value, Max_value> r =
+///     multi_reduce<Sum_value, Max_value>(magsq(x));
+///   float total = r.get<0>();
+///   index_type peak = r.index<1>()[0];
+template <template <typename> class... R, typename V>
+multi_reduction<V::dim, typename V::value_type, R...>
+multi_reduce(V view)
+{
+  typedef typename V::block_type block_type;
+  dimension_type const dim = V::dim;
+  typedef typename get_block_layout<block_type>::order_type order_type;
+
+  OVXX_PRECONDITION(view.size() > 0);
+  multi_reduction<dim, typename V::value_type, R...> r;
+  index_type indices[sizeof...(R)];
+  expr::evaluate(view.block());
+  reduction::multi::traversal<block_type>::template exec<R...>
+    (view.block(), r.values_, indices);
+  // Map positions in traversal order back to indices.
+  dimension_type const order[3] =
+    { order_type::impl_dim0, order_type::impl_dim1, order_type::impl_dim2};
+  for (index_type k = 0; k != sizeof...(R); ++k)
+  {
+    index_type i = indices[k];
+    for (dimension_type d = dim; d-- > 0;)
+    {
+      length_type const size = view.block().size(dim, order[d]);
+      r.indices_[k][order[d]] = i % size;
+      i /= size;
+    }
+  }
+  return r;
+}
+
+} // namespace ovxx
+
+#endif
@@ -15,9 +15,14 @@
 #include <vsip/tensor.hpp>
 #include <vsip/dda.hpp>
 #include <ovxx/reductions/functors.hpp>
+#include <ovxx/reductions/threaded.hpp>
 #include <ovxx/parallel/service.hpp>
 #include <ovxx/dispatch.hpp>
 #include <ovxx/length.hpp>
+#if OVXX_PROFILE
+# include <ovxx/profile.hpp>
+# include <ovxx/type_name.hpp>
+#endif
 #if OVXX_HAVE_CVSIP
 # include <ovxx/cvsip/reductions.hpp>
 #endif
@@ -59,6 +64,7 @@ struct dispatcher
       be::parallel,
       be::cuda,
       be::cvsip,
+      be::threaded,
       be::generic>::type list_type;
 
     Dispatcher<op::reduce<R>, 
@@ -68,6 +74,40 @@ struct dispatcher
     return r;
   }
 };
+#if OVXX_PROFILE
+} // namespace ovxx::reduction
+
+namespace dispatcher
+{
+/// Record reductions, tagged with the reduction and the backend
+/// evaluating it.
+template <template <typename> class R, typename E>
+struct Event<op::reduce<R>, E>
+{
+  template <typename T, typename B, typename O, typename D>
+  Event(T &, B const &block, O, D)
+    : event_([&]()
+	     {
+	       std::string name = type_name<R<typename B::value_type> >();
+	       std::string::size_type i;
+	       while ((i = name.find("ovxx::")) != std::string::npos)
+		 name.erase(i, 6);
+	       return profile::tag("reduce", name, detail::backend_of<E>::name(),
+				   block.size());
+	     },
+	     [&]()
+	     {
+	       return double(block.size()) *
+		 ops_count::traits<typename B::value_type>::add;
+	     })
+  {}
+  profile::event event_;
+};
+} // namespace ovxx::dispatcher
+
+namespace reduction
+{
+#endif
 // FIXME: Reimplement block redimension
 #if 0
 /// This handles the case where the input is either 2- or 3-D view that 
@@ -231,6 +271,7 @@ struct List<op::reduce<R> >
   typedef make_type_list<be::user,
 			 be::cuda,
 			 be::cvsip,
+			 be::threaded,
 			 be::generic>::type type;
 };
 
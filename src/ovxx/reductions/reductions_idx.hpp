@@ -14,6 +14,7 @@
 #include <vsip/matrix.hpp>
 #include <vsip/tensor.hpp>
 #include <ovxx/reductions/functors.hpp>
+#include <ovxx/reductions/threaded.hpp>
 #include <ovxx/dispatch.hpp>
 #if OVXX_HAVE_CVSIP
 # include <ovxx/cvsip/reductions_idx.hpp>
@@ -27,7 +28,8 @@ namespace dispatcher
 template<template <typename> class R>
 struct List<op::reduce_idx<R> >
 {
-  typedef make_type_list<be::parallel, be::cvsip, be::cuda, be::generic>::type type;
+  typedef make_type_list<be::parallel, be::cvsip, be::cuda, be::threaded,
+			 be::generic>::type type;
 };
 
 /// Generic evaluator for vector reductions.
@@ -0,0 +1,341 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_reductions_threaded_hpp_
+#define ovxx_reductions_threaded_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/dda.hpp>
+#include <ovxx/reductions/functors.hpp>
+#include <ovxx/assign/threaded.hpp>
+#include <ovxx/expr/evaluate.hpp>
+#include <ovxx/storage/traits.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/dispatch.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace ovxx
+{
+namespace reduction
+{
+
+/// Reductions with fewer elements than this are evaluated serially.
+inline length_type &threaded_threshold()
+{
+  static length_type threshold = 32768;
+  return threshold;
+}
+
+/// Reductions are split into chunks of this many elements, and the
+/// results of the chunks are combined pairwise. The split doesn't
+/// depend on the number of threads, so neither do the results.
+length_type const chunk_size = 4096;
+
+/// Within a chunk, sums are accumulated in this many interleaved lanes,
+/// which are then combined pairwise.
+length_type const lanes = 8;
+
+/// Element access to contiguous data.
+template <typename T>
+class unit_reader
+{
+public:
+  typedef T value_type;
+
+  unit_reader(T const *data, length_type size) : data_(data), size_(size) {}
+  length_type size() const { return size_;}
+  T operator()(index_type i) const { return data_[i];}
+
+private:
+  T const *data_;
+  length_type size_;
+};
+
+/// Element access by linear index, through direct data access if
+/// the block supports it. Multi-dimensional blocks are accessed in
+/// the order of their storage, which must be dense.
+template <typename B,
+	  bool Direct = vsip::dda::Data<B, vsip::dda::in>::ct_cost == 0>
+class reader
+{
+public:
+  typedef typename B::value_type value_type;
+
+  reader(B const &block) : block_(block) {}
+  length_type size() const { return block_.size();}
+  value_type operator()(index_type i) const { return block_.get(i);}
+  bool is_unit() const { return false;}
+  reader const &unit() const { return *this;}
+
+private:
+  B const &block_;
+};
+
+template <typename B>
+class reader<B, true>
+{
+  typedef vsip::dda::Data<B, vsip::dda::in> data_type;
+  typedef typename get_block_layout<B>::order_type order_type;
+  static dimension_type const dim = B::dim;
+  static dimension_type const inner =
+    dim == 1 ? 0 : dim == 2 ? order_type::impl_dim1 : order_type::impl_dim2;
+  typedef storage_traits<typename B::value_type,
+			 get_block_layout<B>::storage_format> traits;
+
+  // Only data in array format can be accessed as such.
+  template <bool A = is_same<typename traits::const_ptr_type,
+			     typename B::value_type const *>::value,
+	    typename D = void>
+  struct unit_access
+  {
+    static bool const valid = true;
+    typedef unit_reader<typename B::value_type> type;
+    static type make(reader const &r) { return type(r.data_.ptr(), r.size());}
+  };
+  template <typename D>
+  struct unit_access<false, D>
+  {
+    static bool const valid = false;
+    typedef reader const &type;
+    static type make(reader const &r) { return r;}
+  };
+  typedef unit_access<> unit_helper;
+
+public:
+  typedef typename B::value_type value_type;
+
+  reader(B const &block) : data_(block), stride_(data_.stride(inner)) {}
+  length_type size() const { return data_.size();}
+  value_type operator()(index_type i) const
+  { return traits::get(data_.ptr(), i * stride_);}
+  /// Whether the data may be accessed through `unit()`.
+  bool is_unit() const { return unit_helper::valid && stride_ == 1;}
+  typename unit_helper::type unit() const { return unit_helper::make(*this);}
+
+  /// Whether the data is laid out densely, so it may be
+  /// traversed by linear index.
+  bool is_dense() const
+  {
+    if (dim == 1) return true;
+    stride_type stride = 1;
+    for (dimension_type d = dim; d-- > 0;)
+    {
+      dimension_type const o = d == 0 ? order_type::impl_dim0 :
+	d == 1 ? order_type::impl_dim1 : order_type::impl_dim2;
+      if (data_.size(o) > 1 && data_.stride(o) != stride) return false;
+      stride *= data_.size(o);
+    }
+    return true;
+  }
+
+private:
+  data_type data_;
+  stride_type stride_;
+};
+
+/// Run `f(c)` for all chunks `c` of a reduction over `size` elements,
+/// in parallel if that's worthwhile.
+template <typename F>
+void for_each_chunk(length_type size, F f)
+{
+  length_type const chunks = (size + chunk_size - 1) / chunk_size;
+  thread_pool *pool = thread_pool::get_default();
+  if (pool && pool->concurrency() > 1 && chunks > 1 && size >= threaded_threshold())
+    pool->parallel_for(chunks, f);
+  else
+    for (index_type c = 0; c != chunks; ++c) f(c);
+}
+
+/// Sum `a(i)` for `i` in `[begin, end)`.
+template <template <typename> class R, typename A>
+typename R<typename A::value_type>::accum_type
+chunk_sum(A const &a, index_type begin, index_type end)
+{
+  typedef R<typename A::value_type> reduction_type;
+  typename reduction_type::accum_type s[lanes];
+  for (index_type l = 0; l != lanes; ++l) s[l] = reduction_type::initial();
+  index_type i = begin;
+  for (; i + lanes <= end; i += lanes)
+    for (index_type l = 0; l != lanes; ++l)
+      s[l] = reduction_type::update(s[l], a(i + l));
+  for (index_type l = 0; i != end; ++i, ++l)
+    s[l] = reduction_type::update(s[l], a(i));
+  for (length_type w = lanes / 2; w; w /= 2)
+    for (index_type l = 0; l != w; ++l)
+      s[l] = s[l] + s[l + w];
+  return s[0];
+}
+
+/// Sum all elements of `a`, chunk by chunk.
+template <template <typename> class R, typename A>
+typename R<typename A::value_type>::accum_type
+chunked_sum(A const &a)
+{
+  typedef typename R<typename A::value_type>::accum_type accum_type;
+  length_type const size = a.size();
+  if (size <= chunk_size) return chunk_sum<R>(a, 0, size);
+
+  std::vector<accum_type> partial((size + chunk_size - 1) / chunk_size);
+  for_each_chunk(size, [&](index_type c)
+  {
+    partial[c] = chunk_sum<R>(a, c * chunk_size, std::min(size, (c + 1) * chunk_size));
+  });
+  for (length_type n = partial.size(); n > 1; n = (n + 1) / 2)
+  {
+    for (index_type i = 0; i != n / 2; ++i)
+      partial[i] = partial[2 * i] + partial[2 * i + 1];
+    if (n % 2) partial[n / 2] = partial[n - 1];
+  }
+  return partial[0];
+}
+
+/// Return the index of the element of `a` selected by R.
+/// Like a serial scan, this finds the first occurrence.
+template <template <typename> class R, typename A>
+index_type chunked_find(A const &a)
+{
+  typedef typename A::value_type value_type;
+  length_type const size = a.size();
+  value_type const first = a(0);
+  // Each chunk is scanned for elements preferred over the first one.
+  // `size` marks chunks without any.
+  length_type const chunks = (size + chunk_size - 1) / chunk_size;
+  std::vector<index_type> best(chunks, size);
+  for_each_chunk(size, [&](index_type c)
+  {
+    R<value_type> r(first);
+    index_type const end = std::min(size, (c + 1) * chunk_size);
+    for (index_type i = c * chunk_size; i != end; ++i)
+      if (r.next_value(a(i))) best[c] = i;
+  });
+  // Combining the chunks in order preserves the serial semantics.
+  R<value_type> r(first);
+  index_type idx = 0;
+  for (index_type c = 0; c != chunks; ++c)
+    if (best[c] != size && r.next_value(a(best[c]))) idx = best[c];
+  return idx;
+}
+
+/// Sum all elements of `a`.
+template <template <typename> class R, typename A>
+typename R<typename A::value_type>::accum_type
+sum(A const &a)
+{ return a.is_unit() ? chunked_sum<R>(a.unit()) : chunked_sum<R>(a);}
+
+/// Return the index of the element of `a` selected by R.
+template <template <typename> class R, typename A>
+index_type find(A const &a)
+{ return a.is_unit() ? chunked_find<R>(a.unit()) : chunked_find<R>(a);}
+
+/// Whether R is a summation, whose partial results may be added.
+template <template <typename> class R, typename T>
+struct is_threadable_sum
+{
+  static bool const value = R<T>::rtype == reduce_sum;
+};
+
+} // namespace ovxx::reduction
+
+namespace dispatcher
+{
+
+template <template <typename> class R,
+	  typename T, typename B>
+struct Evaluator<op::reduce<R>, be::threaded,
+  void(T&, B const&, row1_type, integral_constant<dimension_type, 1>)>
+{
+  static char const* name() { return "threaded";}
+
+  static bool const ct_valid =
+    reduction::is_threadable_sum<R, typename B::value_type>::value &&
+    assignment::is_threadable<B>::value;
+  static bool rt_valid(T&, B const&, row1_type, integral_constant<dimension_type, 1>)
+  { return true;}
+
+  static void exec(T& r, B const& a, row1_type, integral_constant<dimension_type, 1>)
+  {
+    // Non-elementwise sub-expressions are evaluated up-front, rather
+    // than by whichever worker first touches them.
+    expr::evaluate(a);
+    reduction::reader<B> in(a);
+    r = R<typename B::value_type>::value(reduction::sum<R>(in), in.size());
+  }
+};
+
+template <template <typename> class R,
+	  typename T, typename B, dimension_type D,
+	  dimension_type D0, dimension_type D1, dimension_type D2>
+struct Evaluator<op::reduce<R>, be::threaded,
+  void(T&, B const&, tuple<D0, D1, D2>, integral_constant<dimension_type, D>)>
+{
+  static char const* name() { return "threaded";}
+
+  static bool const ct_valid =
+    D > 1 &&
+    reduction::is_threadable_sum<R, typename B::value_type>::value &&
+    vsip::dda::Data<B, vsip::dda::in>::ct_cost == 0;
+  static bool rt_valid(T&, B const &a, tuple<D0, D1, D2>, integral_constant<dimension_type, D>)
+  { return reduction::reader<B>(a).is_dense();}
+
+  static void exec(T& r, B const& a, tuple<D0, D1, D2>, integral_constant<dimension_type, D>)
+  {
+    reduction::reader<B> in(a);
+    r = R<typename B::value_type>::value(reduction::sum<R>(in), in.size());
+  }
+};
+
+template <template <typename> class R,
+	  typename T, typename B>
+struct Evaluator<op::reduce_idx<R>, be::threaded,
+		 void(T&, B const&, Index<1>&, row1_type)>
+{
+  static bool const ct_valid = assignment::is_threadable<B>::value;
+  static bool rt_valid(T&, B const&, Index<1>&, row1_type)
+  { return true;}
+
+  static void exec(T& r, B const& a, Index<1>& idx, row1_type)
+  {
+    expr::evaluate(a);
+    reduction::reader<B> in(a);
+    index_type i = reduction::find<R>(in);
+    idx = Index<1>(i);
+    r = R<typename B::value_type>(in(i)).value();
+  }
+};
+
+template <template <typename> class R,
+	  typename T, typename B, dimension_type D,
+	  dimension_type D0, dimension_type D1, dimension_type D2>
+struct Evaluator<op::reduce_idx<R>, be::threaded,
+		 void(T&, B const&, Index<D>&, tuple<D0, D1, D2>)>
+{
+  static bool const ct_valid =
+    D > 1 && vsip::dda::Data<B, vsip::dda::in>::ct_cost == 0;
+  static bool rt_valid(T&, B const &a, Index<D>&, tuple<D0, D1, D2>)
+  { return reduction::reader<B>(a).is_dense();}
+
+  static void exec(T& r, B const& a, Index<D>& idx, tuple<D0, D1, D2>)
+  {
+    reduction::reader<B> in(a);
+    index_type i = reduction::find<R>(in);
+    r = R<typename B::value_type>(in(i)).value();
+    // Map the position in storage order back to an index.
+    dimension_type const order[3] = { D0, D1, D2};
+    for (dimension_type d = D; d-- > 0;)
+    {
+      length_type const size = a.size(D, order[d]);
+      idx[order[d]] = i % size;
+      i /= size;
+    }
+  }
+};
+
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
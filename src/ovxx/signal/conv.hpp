@@ -971,6 +971,7 @@ class Convolution
 {
   static dimension_type const dim = dim_of_view<V>::dim;
 
+protected:
   typedef typename view_of<Dense<dim, T> >::type coeff_view_type;
 
 public:
@@ -1007,6 +1008,9 @@ protected:
   template <typename B1, typename B2>
   void convolve(const_Matrix<T, B1>, Matrix<T, B2>) VSIP_NOTHROW;
 
+  /// The full (unfolded) kernel.
+  coeff_view_type const &kernel() const VSIP_NOTHROW { return coeff_;}
+
 private:
   coeff_view_type coeff_;
   Domain<dim>     kernel_size_;
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_signal_czt_hpp_
+#define ovxx_signal_czt_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/vector.hpp>
+#include <ovxx/signal/fft.hpp>
+#include <ovxx/signal/fft/bluestein.hpp>
+
+namespace ovxx
+{
+namespace signal
+{
+
+/// Chirp-z transform: evaluate the z-transform of an input of
+/// `input_size` points at `output_size` points on the unit circle,
+/// `z_k = exp(i (start + k * step))`:
+///
+///   X_k = sum_j x_j z_k^-j
+///
+/// With `start = 0` and `step = 2 pi / input_size`, this is the forward
+/// DFT. A zoom FFT, resolving the band `[f0, f1)` of a signal sampled
+/// at `fs` into `M` bins, uses `start = 2 pi f0 / fs` and
+/// `step = 2 pi (f1 - f0) / (M fs)`.
+///
+/// The transform is computed with three FFTs of a power-of-two size
+/// not less than `input_size + output_size - 1`.
+///
+/// Example:
+///   Czt<float> zoom(N, M, 2 * OVXX_PI * f0 / fs, 2 * OVXX_PI * (f1 - f0) / (M * fs));
+///   Vector<complex<float> > spectrum = zoom(signal);
+template <typename T>
+class Czt
+{
+  typedef complex<T> ctype;
+
+public:
+  Czt(length_type input_size, length_type output_size, T start, T step)
+    VSIP_THROW((std::bad_alloc))
+    : engine_(std::make_shared<fft::bluestein::chirp<T> const>
+	      (input_size, output_size, start, step)),
+      start_(start),
+      step_(step)
+  {}
+
+  length_type input_size() const VSIP_NOTHROW { return engine_.input_size();}
+  length_type output_size() const VSIP_NOTHROW { return engine_.output_size();}
+  /// The angle of the first output point.
+  T start() const VSIP_NOTHROW { return start_;}
+  /// The angle between successive output points.
+  T step() const VSIP_NOTHROW { return step_;}
+
+  /// Transform `in`, which may be real or complex, into `out`.
+  template <typename T1, typename B1, typename B2>
+  Vector<ctype, B2>
+  operator()(const_Vector<T1, B1> in, Vector<ctype, B2> out) VSIP_NOTHROW
+  {
+    OVXX_PRECONDITION(in.size() == input_size());
+    OVXX_PRECONDITION(out.size() == output_size());
+    engine_([&](index_type j) { return ctype(in.get(j));},
+	    [&](index_type k, ctype const &v) { out.put(k, v);});
+    return out;
+  }
+
+  /// Return the transform of `in`, which may be real or complex.
+  template <typename T1, typename B>
+  Vector<ctype>
+  operator()(const_Vector<T1, B> in) VSIP_THROW((std::bad_alloc))
+  {
+    Vector<ctype> out(output_size());
+    (*this)(in, out);
+    return out;
+  }
+
+private:
+  fft::bluestein::engine<T> engine_;
+  T start_;
+  T step_;
+};
+
+} // namespace ovxx::signal
+} // namespace ovxx
+
+#endif
@@ -0,0 +1,520 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_signal_fast_conv_hpp_
+#define ovxx_signal_fast_conv_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/domain.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/impl/signal/fft.hpp>
+#include <ovxx/signal/conv.hpp>
+#include <ovxx/signal/corr.hpp>
+#include <ovxx/complex_traits.hpp>
+#include <ovxx/math/scalar.hpp>
+#include <ovxx/dda.hpp>
+#include <algorithm>
+#include <memory>
+
+namespace ovxx
+{
+namespace signal
+{
+
+/// Kernels with at least this many coefficients are applied
+/// using FFTs instead of direct summation. The threshold is
+/// read when Convolution and Correlation objects are created.
+inline length_type &fast_conv_threshold()
+{
+  // Without a proper FFT backend the FFT path would be slower
+  // than direct summation, so it is disabled by default.
+#if defined(OVXX_FFTW) || defined(OVXX_SAL_FFT) || defined(OVXX_IPP_FFT) || \
+    defined(OVXX_CVSIP_FFT) || defined(OVXX_CUDA_FFT) || defined(OVXX_BUILTIN_FFT)
+  static length_type threshold = 64;
+#else
+  static length_type threshold = length_type(-1);
+#endif
+  return threshold;
+}
+
+namespace fast_conv
+{
+/// Real signals are transformed two blocks at a time, one
+/// in the real and one in the imaginary part of the FFT input.
+template <typename T>
+struct lanes
+{
+  static length_type const value = 2;
+  static complex<T> pack(T a, T b) { return complex<T>(a, b);}
+  static T unpack(complex<T> const &v, index_type l) { return l ? v.imag() : v.real();}
+};
+
+template <typename T>
+struct lanes<complex<T> >
+{
+  static length_type const value = 1;
+  static complex<T> pack(complex<T> const &a, complex<T> const &) { return a;}
+  static complex<T> unpack(complex<T> const &v, index_type) { return v;}
+};
+
+/// Compute linear convolutions of a 1-D input with a kernel
+/// using FFT overlap-save.
+template <typename T, unsigned N>
+class overlap_save
+{
+  typedef typename scalar_of<T>::type scalar_type;
+  typedef complex<scalar_type> C;
+  typedef vsip::Fft<const_Vector, C, C, fft_fwd, by_reference, N> fwd_type;
+  typedef vsip::Fft<const_Vector, C, C, fft_inv, by_reference, N> inv_type;
+
+public:
+  overlap_save(Domain<1> const &kernel_size, Domain<1> const &input_size)
+    : M_(kernel_size.size()),
+      N_(input_size.size()),
+      // Blocks four times the kernel size keep the overlap small
+      // without making the transforms needlessly large.
+      L_(std::min(fft::pow2(4 * M_), fft::pow2(N_ + M_ - 1))),
+      fwd_(Domain<1>(L_), scalar_type(1)),
+      inv_(Domain<1>(L_), scalar_type(1) / L_),
+      kernel_(L_),
+      buffer_(L_)
+  {}
+
+  /// Set the kernel to `h(k)`, `k` in `[0, M)`.
+  template <typename F>
+  void kernel(F h)
+  {
+    kernel_ = C();
+    for (index_type k = 0; k != M_; ++k)
+      kernel_.put(k, C(h(k)));
+    fwd_(kernel_);
+  }
+
+  /// Call `out(n, y[offset + n * step])` for `n` in `[0, P)`, where `y`
+  /// is the full convolution of the kernel with the input `x(i)`,
+  /// `i` in `[0, N)`.
+  template <typename X, typename O>
+  void apply(X x, index_type offset, length_type step, length_type P, O out)
+  {
+    // Each transform yields B valid outputs, y[start, start + B).
+    length_type const B = L_ - M_ + 1;
+    index_type n = 0;
+    while (n < P)
+    {
+      index_type first[2], last[2];
+      index_type start[2] = {0, 0};
+      length_type used = 0;
+      for (; used != lanes<T>::value && n < P; ++used)
+      {
+	first[used] = n;
+	start[used] = offset + n * step;
+	while (n < P && offset + n * step < start[used] + B) ++n;
+	last[used] = n;
+      }
+      for (index_type i = 0; i != L_; ++i)
+      {
+	T v[2] = {T(), T()};
+	for (index_type l = 0; l != used; ++l)
+	{
+	  // The block's input starts M-1 samples before its first output.
+	  stride_type j = stride_type(start[l] + i) - stride_type(M_ - 1);
+	  if (j >= 0 && j < stride_type(N_)) v[l] = x(j);
+	}
+	buffer_.put(i, lanes<T>::pack(v[0], v[1]));
+      }
+      fwd_(buffer_);
+      buffer_ *= kernel_;
+      inv_(buffer_);
+      for (index_type l = 0; l != used; ++l)
+	for (index_type m = first[l]; m != last[l]; ++m)
+	  out(m, lanes<T>::unpack(buffer_.get(offset + m * step - start[l] + M_ - 1), l));
+    }
+  }
+
+private:
+  length_type M_;
+  length_type N_;
+  length_type L_;
+  fwd_type fwd_;
+  inv_type inv_;
+  Vector<C> kernel_;
+  Vector<C> buffer_;
+};
+
+/// Compute linear convolutions of a 2-D input with a kernel
+/// using a single 2-D FFT large enough to avoid wrap-around.
+template <typename T, unsigned N>
+class fft_conv2
+{
+  typedef typename scalar_of<T>::type scalar_type;
+  typedef complex<scalar_type> C;
+  typedef vsip::Fft<const_Matrix, C, C, fft_fwd, by_reference, N> fwd_type;
+  typedef vsip::Fft<const_Matrix, C, C, fft_inv, by_reference, N> inv_type;
+
+public:
+  fft_conv2(Domain<2> const &kernel_size, Domain<2> const &input_size)
+    : Mr_(kernel_size[0].size()),
+      Mc_(kernel_size[1].size()),
+      Nr_(input_size[0].size()),
+      Nc_(input_size[1].size()),
+      Lr_(fft::pow2(Nr_ + Mr_ - 1)),
+      Lc_(fft::pow2(Nc_ + Mc_ - 1)),
+      fwd_(Domain<2>(Lr_, Lc_), scalar_type(1)),
+      inv_(Domain<2>(Lr_, Lc_), scalar_type(1) / (Lr_ * Lc_)),
+      kernel_(Lr_, Lc_),
+      buffer_(Lr_, Lc_)
+  {}
+
+  /// Set the kernel to `h(r, c)`.
+  template <typename F>
+  void kernel(F h)
+  {
+    kernel_ = C();
+    for (index_type r = 0; r != Mr_; ++r)
+      for (index_type c = 0; c != Mc_; ++c)
+	kernel_.put(r, c, C(h(r, c)));
+    fwd_(kernel_);
+  }
+
+  /// Call `out(r, c, y[row_offset + r * step, col_offset + c * step])`
+  /// for all `r` in `[0, Pr)`, `c` in `[0, Pc)`, where `y` is the full
+  /// convolution of the kernel with the input `x(i, j)`.
+  template <typename X, typename O>
+  void apply(X x, index_type row_offset, index_type col_offset,
+	     length_type step, length_type Pr, length_type Pc, O out)
+  {
+    buffer_ = C();
+    for (index_type i = 0; i != Nr_; ++i)
+      for (index_type j = 0; j != Nc_; ++j)
+	buffer_.put(i, j, C(x(i, j)));
+    fwd_(buffer_);
+    buffer_ *= kernel_;
+    inv_(buffer_);
+    for (index_type r = 0; r != Pr; ++r)
+      for (index_type c = 0; c != Pc; ++c)
+	out(r, c, buffer_.get(row_offset + r * step, col_offset + c * step));
+  }
+
+private:
+  length_type Mr_, Mc_;
+  length_type Nr_, Nc_;
+  length_type Lr_, Lc_;
+  fwd_type fwd_;
+  inv_type inv_;
+  Matrix<C> kernel_;
+  Matrix<C> buffer_;
+};
+
+/// The offset of the first output of a convolution within the full
+/// convolution result.
+inline index_type conv_offset(support_region_type R, length_type M)
+{
+  return R == support_full ? 0 : R == support_same ? M / 2 : M - 1;
+}
+
+/// The offset of the first output of a correlation within the full
+/// convolution of the input with the reversed reference.
+inline index_type corr_offset(support_region_type R, length_type M)
+{
+  return R == support_full ? 0 : R == support_same ? M - 1 - M / 2 : M - 1;
+}
+
+/// The number of terms contributing to the `n`-th output of a 1-D
+/// correlation, used for unbiased scaling. This matches corr_full(),
+/// corr_same() and corr_min().
+inline length_type corr_terms(support_region_type R, index_type n,
+			      length_type M, length_type N)
+{
+  if (R == support_full)
+  {
+    if (n < M - 1) return n + 1;
+    else if (n >= N) return N + M - 1 - n;
+    else return M;
+  }
+  else if (R == support_same)
+  {
+    if (n < M / 2) return n + (M + 1) / 2;
+    else if (n >= N - M / 2)
+    {
+#if VSIP_IMPL_CORR_CORRECT_SAME_SUPPORT_SCALING
+      return N + M / 2 - n;
+#else
+      return N - 1 + (M + 1) / 2 - n;
+#endif
+    }
+    else return M;
+  }
+  else return M;
+}
+
+/// The number of terms along one dimension contributing to an output
+/// of a 2-D correlation. This matches corr_base().
+inline length_type corr_terms2(support_region_type R, index_type n,
+			       length_type M, length_type N)
+{
+  length_type const shift = R == support_full ? M - 1 : R == support_same ? M / 2 : 0;
+  length_type const edge = R == support_same ? M / 2 : 0;
+  if (n < shift) return n + M - shift;
+  else if (n >= N - edge) return N + shift - n;
+  else return M;
+}
+
+template <dimension_type D, typename T, unsigned N> struct engine;
+template <typename T, unsigned N> struct engine<1, T, N>
+{ typedef overlap_save<T, N> type;};
+template <typename T, unsigned N> struct engine<2, T, N>
+{ typedef fft_conv2<T, N> type;};
+
+} // namespace ovxx::signal::fast_conv
+
+/// Convolution backend using FFTs for large kernels, and direct
+/// summation (inherited from the generic backend) for small ones.
+template <template <typename, typename> class V,
+	  symmetry_type                       S,
+	  support_region_type                 R,
+	  typename                            T,
+	  unsigned                            N,
+          alg_hint_type                       H>
+class Fast_convolution : public Convolution<V, S, R, T, N, H>
+{
+  typedef Convolution<V, S, R, T, N, H> base_type;
+  static dimension_type const dim = dim_of_view<V>::dim;
+  typedef typename fast_conv::engine<dim, T, N>::type engine_type;
+
+public:
+  template <typename B>
+  Fast_convolution(V<T, B> filter_coeffs, Domain<dim> const &input_size,
+		   length_type d)
+    VSIP_THROW((std::bad_alloc))
+  : base_type(filter_coeffs, input_size, d)
+  {
+    if (this->kernel_size().size() < fast_conv_threshold()) return;
+    engine_.reset(new engine_type(this->kernel_size(), input_size));
+    set_kernel(this->kernel());
+  }
+
+protected:
+  template <typename B1, typename B2>
+  void convolve(const_Vector<T, B1> in, Vector<T, B2> out) VSIP_NOTHROW
+  {
+    if (!engine_) return base_type::convolve(in, out);
+
+    typedef Layout<1, any_type, any_packing, array> req_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B1>::type>::type
+      in_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B2>::type>::type
+      out_layout;
+    dda::Data<B1, dda::in, in_layout> in_data(in.block());
+    dda::Data<B2, dda::out, out_layout> out_data(out.block());
+    T const *x = in_data.ptr();
+    stride_type const xs = in_data.stride(0);
+    T *y = out_data.ptr();
+    stride_type const ys = out_data.stride(0);
+
+    engine_->apply([=](index_type i) { return x[i * xs];},
+		   fast_conv::conv_offset(R, this->kernel_size().size()),
+		   this->decimation(), out.size(),
+		   [=](index_type n, T v) { y[n * ys] = v;});
+  }
+
+  template <typename B1, typename B2>
+  void convolve(const_Matrix<T, B1> in, Matrix<T, B2> out) VSIP_NOTHROW
+  {
+    if (!engine_) return base_type::convolve(in, out);
+
+    typedef Layout<2, any_type, any_packing, array> req_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B1>::type>::type
+      in_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B2>::type>::type
+      out_layout;
+    dda::Data<B1, dda::in, in_layout> in_data(in.block());
+    dda::Data<B2, dda::out, out_layout> out_data(out.block());
+    T const *x = in_data.ptr();
+    stride_type const xs0 = in_data.stride(0), xs1 = in_data.stride(1);
+    T *y = out_data.ptr();
+    stride_type const ys0 = out_data.stride(0), ys1 = out_data.stride(1);
+
+    typedef complex<typename scalar_of<T>::type> C;
+    engine_->apply([=](index_type i, index_type j) { return x[i * xs0 + j * xs1];},
+		   fast_conv::conv_offset(R, this->kernel_size()[0].size()),
+		   fast_conv::conv_offset(R, this->kernel_size()[1].size()),
+		   this->decimation(), out.size(0), out.size(1),
+		   [=](index_type r, index_type c, C const &v)
+		   { y[r * ys0 + c * ys1] = fast_conv::lanes<T>::unpack(v, 0);});
+  }
+
+private:
+  template <typename B>
+  void set_kernel(const_Vector<T, B> h)
+  { engine_->kernel([&](index_type k) { return h.get(k);});}
+  template <typename B>
+  void set_kernel(const_Matrix<T, B> h)
+  { engine_->kernel([&](index_type r, index_type c) { return h.get(r, c);});}
+
+  std::unique_ptr<engine_type> engine_;
+};
+
+/// Correlation backend using FFTs for large references, and direct
+/// summation (inherited from the generic backend) for small ones.
+template <dimension_type      D,
+	  support_region_type R,
+	  typename            T,
+	  unsigned            N,
+          alg_hint_type       H>
+class Fast_correlation : public Correlation<D, R, T, N, H>
+{
+  typedef Correlation<D, R, T, N, H> base_type;
+  typedef typename fast_conv::engine<D, T, N>::type engine_type;
+
+public:
+  Fast_correlation(Domain<D> const &ref_size, Domain<D> const &input_size)
+    VSIP_THROW((std::bad_alloc))
+  : base_type(ref_size, input_size)
+  {
+    if (this->reference_size().size() >= fast_conv_threshold())
+      engine_.reset(new engine_type(this->reference_size(), this->input_size()));
+  }
+
+  template <typename B1, typename B2, typename B3>
+  void correlate(bias_type bias, const_Vector<T, B1> ref,
+		 const_Vector<T, B2> in, Vector<T, B3> out)
+    VSIP_NOTHROW
+  {
+    if (!engine_) return base_type::correlate(bias, ref, in, out);
+
+    length_type const M = this->reference_size().size();
+    length_type const Nin = this->input_size().size();
+
+    typedef Layout<1, any_type, any_packing, array> req_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B1>::type>::type
+      ref_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B2>::type>::type
+      in_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B3>::type>::type
+      out_layout;
+    dda::Data<B1, dda::in, ref_layout> ref_data(ref.block());
+    dda::Data<B2, dda::in, in_layout> in_data(in.block());
+    dda::Data<B3, dda::out, out_layout> out_data(out.block());
+    T const *h = ref_data.ptr();
+    stride_type const hs = ref_data.stride(0);
+    T const *x = in_data.ptr();
+    stride_type const xs = in_data.stride(0);
+    T *y = out_data.ptr();
+    stride_type const ys = out_data.stride(0);
+
+    // Correlating with `ref` is convolving the conjugated input
+    // with the reversed reference.
+    engine_->kernel([=](index_type k) { return h[(M - 1 - k) * hs];});
+    engine_->apply([=](index_type i) { return math::impl_conj(x[i * xs]);},
+		   fast_conv::corr_offset(R, M), 1, out.size(),
+		   [=](index_type n, T v)
+		   {
+		     if (bias == unbiased)
+		       v /= T(fast_conv::corr_terms(R, n, M, Nin));
+		     y[n * ys] = v;
+		   });
+  }
+
+  template <typename B1, typename B2, typename B3>
+  void correlate(bias_type bias, const_Matrix<T, B1> ref,
+		 const_Matrix<T, B2> in, Matrix<T, B3> out)
+    VSIP_NOTHROW
+  {
+    if (!engine_) return base_type::correlate(bias, ref, in, out);
+
+    length_type const Mr = this->reference_size()[0].size();
+    length_type const Mc = this->reference_size()[1].size();
+    length_type const Nr = this->input_size()[0].size();
+    length_type const Nc = this->input_size()[1].size();
+
+    typedef Layout<2, any_type, any_packing, array> req_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B1>::type>::type
+      ref_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B2>::type>::type
+      in_layout;
+    typedef typename adjust_layout<req_layout, typename get_block_layout<B3>::type>::type
+      out_layout;
+    dda::Data<B1, dda::in, ref_layout> ref_data(ref.block());
+    dda::Data<B2, dda::in, in_layout> in_data(in.block());
+    dda::Data<B3, dda::out, out_layout> out_data(out.block());
+    T const *h = ref_data.ptr();
+    stride_type const hs0 = ref_data.stride(0), hs1 = ref_data.stride(1);
+    T const *x = in_data.ptr();
+    stride_type const xs0 = in_data.stride(0), xs1 = in_data.stride(1);
+    T *y = out_data.ptr();
+    stride_type const ys0 = out_data.stride(0), ys1 = out_data.stride(1);
+
+    typedef complex<typename scalar_of<T>::type> C;
+    engine_->kernel([=](index_type r, index_type c)
+		    { return h[(Mr - 1 - r) * hs0 + (Mc - 1 - c) * hs1];});
+    engine_->apply([=](index_type i, index_type j)
+		   { return math::impl_conj(x[i * xs0 + j * xs1]);},
+		   fast_conv::corr_offset(R, Mr), fast_conv::corr_offset(R, Mc),
+		   1, out.size(0), out.size(1),
+		   [=](index_type r, index_type c, C const &v)
+		   {
+		     T value = fast_conv::lanes<T>::unpack(v, 0);
+		     if (bias == unbiased)
+		       value /= T(fast_conv::corr_terms2(R, r, Mr, Nr) *
+				  fast_conv::corr_terms2(R, c, Mc, Nc));
+		     y[r * ys0 + c * ys1] = value;
+		   });
+  }
+
+private:
+  std::unique_ptr<engine_type> engine_;
+};
+
+/// Fast_convolution and Fast_correlation handle real and complex
+/// floating-point values.
+template <typename T>
+struct is_fast_conv_type
+{
+  static bool const value =
+    is_same<typename scalar_of<T>::type, float>::value ||
+    is_same<typename scalar_of<T>::type, double>::value;
+};
+
+} // namespace ovxx::signal
+
+namespace dispatcher
+{
+template <symmetry_type       S,
+	  support_region_type R,
+          typename            T,
+	  unsigned            N,
+          alg_hint_type       H>
+struct Evaluator<op::conv<1, S, R, T, N, H>, be::opt>
+{
+  static bool const ct_valid = signal::is_fast_conv_type<T>::value;
+  typedef signal::Fast_convolution<const_Vector, S, R, T, N, H> backend_type;
+};
+template <symmetry_type       S,
+	  support_region_type R,
+          typename            T,
+	  unsigned            N,
+          alg_hint_type       H>
+struct Evaluator<op::conv<2, S, R, T, N, H>, be::opt>
+{
+  static bool const ct_valid = signal::is_fast_conv_type<T>::value;
+  typedef signal::Fast_convolution<const_Matrix, S, R, T, N, H> backend_type;
+};
+template <dimension_type      D,
+          support_region_type R,
+          typename            T,
+	  unsigned            N,
+          alg_hint_type       H>
+struct Evaluator<op::corr<D, R, T, N, H>, be::opt>
+{
+  static bool const ct_valid = signal::is_fast_conv_type<T>::value;
+  typedef signal::Fast_correlation<D, R, T, N, H> backend_type;
+};
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
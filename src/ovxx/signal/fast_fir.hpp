@@ -0,0 +1,256 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_signal_fast_fir_hpp_
+#define ovxx_signal_fast_fir_hpp_
+
+#include <ovxx/signal/fir.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/complex_traits.hpp>
+#include <algorithm>
+
+namespace ovxx
+{
+namespace signal
+{
+namespace fast_fir
+{
+/// Number of outputs accumulated per block. A block of accumulators
+/// together with the input window it reads should stay in L1.
+length_type const block_size = 256;
+
+/// Multiply-accumulate kernels. The loops run across consecutive
+/// outputs (rather than across taps), so they vectorize without
+/// requiring the compiler to reassociate the sum.
+template <typename T>
+struct mac
+{
+  // acc[j] += a * x[j]
+  static void apply(T *acc, T a, T const *x, length_type n)
+  {
+    PRAGMA_IVDEP
+    for (index_type j = 0; j < n; ++j)
+      acc[j] += a * x[j];
+  }
+  // acc[j] += a * (x[j] + y[j])
+  static void apply(T *acc, T a, T const *x, T const *y, length_type n)
+  {
+    PRAGMA_IVDEP
+    for (index_type j = 0; j < n; ++j)
+      acc[j] += a * (x[j] + y[j]);
+  }
+};
+
+/// Complex values are processed as interleaved pairs of scalars,
+/// which avoids the out-of-line special-value handling compilers
+/// emit for complex multiplication.
+template <typename T>
+struct mac<complex<T> >
+{
+  static void apply(complex<T> *a, complex<T> c, complex<T> const *x, length_type n)
+  {
+    T *acc = reinterpret_cast<T*>(a);
+    T const *in = reinterpret_cast<T const*>(x);
+    T const re = c.real(), im = c.imag();
+    PRAGMA_IVDEP
+    for (index_type j = 0; j < 2*n; j += 2)
+    {
+      acc[j] += re * in[j] - im * in[j + 1];
+      acc[j + 1] += re * in[j + 1] + im * in[j];
+    }
+  }
+  static void apply(complex<T> *a, complex<T> c,
+		    complex<T> const *x, complex<T> const *y, length_type n)
+  {
+    T *acc = reinterpret_cast<T*>(a);
+    T const *in1 = reinterpret_cast<T const*>(x);
+    T const *in2 = reinterpret_cast<T const*>(y);
+    T const re = c.real(), im = c.imag();
+    PRAGMA_IVDEP
+    for (index_type j = 0; j < 2*n; j += 2)
+    {
+      T const r = in1[j] + in2[j];
+      T const i = in1[j + 1] + in2[j + 1];
+      acc[j] += re * r - im * i;
+      acc[j + 1] += re * i + im * r;
+    }
+  }
+};
+
+template <typename T>
+struct is_supported
+{
+  static bool const value =
+    is_floating_point<typename scalar_of<T>::type>::value;
+};
+
+} // namespace ovxx::signal::fast_fir
+
+/// FIR filter backend using a contiguous history buffer.
+///
+/// The last `M-1` input samples are kept in front of the current
+/// input, so every output is a dot product over contiguous memory.
+/// With decimation `D > 1` the buffer is split into `D` phases and
+/// the kernel into `D` sub-filters (a polyphase decomposition), so
+/// only the kept outputs are computed, each tap again streaming
+/// through contiguous memory. Symmetric kernels add the two inputs
+/// sharing a coefficient before multiplying, halving the number
+/// of multiplications.
+template <typename T, symmetry_type S, obj_state C>
+class Fast_fir : public Fir_backend<T, S, C>
+{
+  typedef Fir_backend<T, S, C> base;
+  typedef fast_fir::mac<T> mac;
+public:
+  Fast_fir(aligned_array<T> kernel, length_type k, length_type i, length_type d)
+    : base(i, k, d),
+      phase_(0),
+      kernel_(this->kernel_size()),
+      buffer_(this->order_ + this->input_size_),
+      phases_(d > 1 ? d * phase_length() : 0),
+      acc_(fast_fir::block_size)
+  {
+    OVXX_PRECONDITION(k > (S == nonsym));
+    // Store the kernel reversed, as the generic backend does.
+    length_type const m = this->order_;
+    for (index_type j = 0; j != k; ++j)
+    {
+      kernel_[m - j] = kernel[j];
+      if (S != nonsym) kernel_[j] = kernel[j];
+    }
+    std::fill(buffer_.get(), buffer_.get() + m, T(0));
+  }
+
+  Fast_fir(Fast_fir const &fir)
+    : base(fir),
+      phase_(fir.phase_),
+      kernel_(OVXX_ALLOC_ALIGNMENT, fir.kernel_.size(), fir.kernel_.get()),
+      buffer_(OVXX_ALLOC_ALIGNMENT, fir.buffer_.size(), fir.buffer_.get()),
+      phases_(fir.phases_.size()),
+      acc_(fast_fir::block_size)
+  {}
+  virtual Fast_fir *clone() { return new Fast_fir(*this);}
+
+  length_type apply(T const *in, stride_type in_stride, length_type,
+                    T *out, stride_type out_stride, length_type)
+  {
+    length_type const m = this->order_;
+    length_type const d = this->decimation_;
+    length_type const n = this->input_size_;
+    T *history = buffer_.get();
+    T *input = history + m;
+    for (index_type i = 0; i != n; ++i, in += in_stride)
+      input[i] = *in;
+
+    // Outputs fall on input positions phase_, phase_ + d, ...
+    length_type const outputs = phase_ < n ? (n - phase_ + d - 1) / d : 0;
+    if (d > 1) split_phases();
+
+    T *acc = acc_.get();
+    for (index_type o = 0; o < outputs; o += fast_fir::block_size)
+    {
+      length_type const size = std::min(fast_fir::block_size, outputs - o);
+      std::fill(acc, acc + size, T(0));
+      if (S == nonsym)
+        for (index_type i = 0; i <= m; ++i)
+          mac::apply(acc, kernel_[i], tap(i) + o, size);
+      else
+      {
+        for (index_type i = 0; i < (m + 1) / 2; ++i)
+          mac::apply(acc, kernel_[i], tap(i) + o, tap(m - i) + o, size);
+        if (m % 2 == 0)
+          mac::apply(acc, kernel_[m / 2], tap(m / 2) + o, size);
+      }
+      for (index_type j = 0; j != size; ++j, out += out_stride)
+        *out = acc[j];
+    }
+
+    if (C == state_save)
+    {
+      // n >= m, so the ranges don't overlap.
+      std::copy(input + n - m, input + n, history);
+      phase_ = phase_ + outputs * d - n;
+    }
+    return outputs;
+  }
+
+  virtual void reset() VSIP_NOTHROW
+  {
+    phase_ = 0;
+    std::fill(buffer_.get(), buffer_.get() + this->order_, T(0));
+  }
+
+  virtual char const* name() { return "fast-fir";}
+
+private:
+  /// The number of samples in each phase.
+  length_type phase_length() const
+  { return this->output_size_ + this->order_ / this->decimation_ + 1;}
+
+  /// Split the buffer into `d` phases, starting at the first output
+  /// position, so phase `p` holds samples `phase_ + p + q*d`.
+  void split_phases()
+  {
+    length_type const d = this->decimation_;
+    length_type const size = this->order_ + this->input_size_;
+    length_type const length = phase_length();
+    T const *buffer = buffer_.get();
+    for (index_type p = 0; p != d; ++p)
+    {
+      T *phase = phases_.get() + p * length;
+      index_type q = 0;
+      for (index_type i = phase_ + p; i < size; i += d, ++q)
+        phase[q] = buffer[i];
+      std::fill(phase + q, phase + length, T(0));
+    }
+  }
+
+  /// Return the samples the reversed kernel's tap `i` multiplies
+  /// with, such that output `j` uses `tap(i)[j]`.
+  T const *tap(index_type i) const
+  {
+    length_type const d = this->decimation_;
+    if (d == 1) return buffer_.get() + phase_ + i;
+    return phases_.get() + (i % d) * phase_length() + i / d;
+  }
+
+  length_type phase_;
+  aligned_array<T> kernel_;
+  aligned_array<T> buffer_;
+  aligned_array<T> phases_;
+  aligned_array<T> acc_;
+};
+
+} // namespace ovxx::signal
+
+namespace dispatcher
+{
+template <typename T, symmetry_type S, obj_state C>
+struct Evaluator<op::fir, be::opt,
+                 std::shared_ptr<signal::Fir_backend<T, S, C> >
+                 (aligned_array<T>,
+                  length_type, length_type, length_type,
+                  unsigned, alg_hint_type)>
+{
+  static bool const ct_valid = signal::fast_fir::is_supported<T>::value;
+  typedef std::shared_ptr<signal::Fir_backend<T, S, C> > return_type;
+  static bool rt_valid(aligned_array<T> const &,
+                       length_type, length_type, length_type,
+                       unsigned, alg_hint_type)
+  { return true;}
+  static return_type exec(aligned_array<T> k, length_type ks,
+                          length_type is, length_type d,
+                          unsigned, alg_hint_type)
+  {
+    return return_type(new signal::Fast_fir<T, S, C>(k, ks, is, d));
+  }
+};
+
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
@@ -13,6 +13,7 @@
 #include <ovxx/signal/fft/backend.hpp>
 #include <ovxx/signal/fft/util.hpp>
 #include <ovxx/signal/fft/workspace.hpp>
+#include <ovxx/signal/fft/threaded.hpp>
 #include <ovxx/dispatch.hpp>
 #if OVXX_FFTW
 # include <ovxx/fftw/fft.hpp>
@@ -20,6 +21,14 @@
 #if OVXX_CVSIP_FFT
 # include <ovxx/cvsip/fft.hpp>
 #endif
+#if OVXX_BUILTIN_FFT
+# include <ovxx/signal/fft/builtin.hpp>
+#endif
+#if OVXX_FFTW || OVXX_SAL_FFT || OVXX_IPP_FFT || OVXX_CVSIP_FFT || \
+    OVXX_CUDA_FFT || OVXX_BUILTIN_FFT
+// The chirp-z transform only pays off with a fast power-of-two FFT.
+# include <ovxx/signal/fft/bluestein.hpp>
+#endif
 #if OVXX_DFT_FFT
 # include <ovxx/signal/fft/dft.hpp>
 #endif
@@ -43,7 +52,9 @@ struct List<op::fft<D, I, O, S, R, N> >
   typedef make_type_list<be::user,
 			 be::cuda,
 			 be::fftw,
+			 be::bluestein,
 			 be::cvsip,
+			 be::builtin,
 			 be::generic,
 			 be::no_fft>::type type;
 };
@@ -58,7 +69,9 @@ struct List<op::fftm<I, O, A, D, R, N> >
 {
   typedef make_type_list<be::user,
 			 be::fftw,
+			 be::bluestein,
 			 be::cvsip,
+			 be::builtin,
 			 be::generic,
 			 be::no_fft>::type type;
 };
@@ -166,13 +179,29 @@ public:
     std::unique_ptr<backend_type>(Domain<D> const &, typename base::scalar_type), L>
     dispatcher_type;
 
-  Fft(Domain<D> const& dom, typename base::scalar_type scale)
+  Fft(Domain<D> const& dom, typename base::scalar_type scale,
+      unsigned int threads = 0)
     VSIP_THROW((std::bad_alloc))
     : base(dom, scale, false, S, by_value),
-      backend_(dispatcher_type::dispatch(dom, scale)),
+      backend_(fft::create<backend_type, dispatcher_type>(dom, scale, threads)),
       workspace_(backend_.get(), this->input_size(), this->output_size(), scale)
   {}
 
+  /// Create an Fft object that multiplies its input by `window`.
+  template <typename B>
+  Fft(Domain<D> const& dom, typename base::scalar_type scale,
+      const_Vector<typename base::scalar_type, B> window,
+      unsigned int threads = 0)
+    VSIP_THROW((std::bad_alloc))
+    : base(dom, scale, false, S, by_value),
+      backend_(fft::create<backend_type, dispatcher_type>(dom, scale, threads)),
+      workspace_(backend_.get(), this->input_size(), this->output_size(), scale)
+  {
+    OVXX_CT_ASSERT(D == 1);
+    OVXX_PRECONDITION(window.size() == this->input_size().size());
+    workspace_.window(window);
+  }
+
 #ifdef VSIP_IMPL_REF_IMPL
   /// Returns the Fast Fourier Transform of :literal:`in`.
   template <typename ViewT>
@@ -232,13 +261,29 @@ public:
     std::unique_ptr<backend_type>(Domain<D> const &, typename base::scalar_type), L>
     dispatcher_type;
 
-  Fft(Domain<D> const& dom, typename base::scalar_type scale)
+  Fft(Domain<D> const& dom, typename base::scalar_type scale,
+      unsigned int threads = 0)
     VSIP_THROW((std::bad_alloc))
     : base(dom, scale, false, S, by_reference),
-      backend_(dispatcher_type::dispatch(dom, scale)),
+      backend_(fft::create<backend_type, dispatcher_type>(dom, scale, threads)),
       workspace_(backend_.get(), this->input_size(), this->output_size(), scale)
   {}
 
+  /// Create an Fft object that multiplies its input by `window`.
+  template <typename B>
+  Fft(Domain<D> const& dom, typename base::scalar_type scale,
+      const_Vector<typename base::scalar_type, B> window,
+      unsigned int threads = 0)
+    VSIP_THROW((std::bad_alloc))
+    : base(dom, scale, false, S, by_reference),
+      backend_(fft::create<backend_type, dispatcher_type>(dom, scale, threads)),
+      workspace_(backend_.get(), this->input_size(), this->output_size(), scale)
+  {
+    OVXX_CT_ASSERT(D == 1);
+    OVXX_PRECONDITION(window.size() == this->input_size().size());
+    workspace_.window(window);
+  }
+
   /// Computes the Fast Fourier Transform of :literal:`in` and stores the result
   /// in :literal:`out`.
   template <typename Block0, typename Block1,
@@ -301,13 +346,29 @@ class Fftm<I, O, L, A, D, by_value, N, H>
     std::unique_ptr<backend_type>(Domain<2> const &, typename base::scalar_type), L>
     dispatcher_type;
 public:
-  Fftm(Domain<2> const& dom, typename base::scalar_type scale)
+  Fftm(Domain<2> const& dom, typename base::scalar_type scale,
+       unsigned int threads = 0)
     VSIP_THROW((std::bad_alloc))
     : base(dom, scale, true, D, by_value),
-      backend_(dispatcher_type::dispatch(dom, scale)),
+      backend_(fft::create_fftm<I, O, A, D, dispatcher_type>(dom, scale, threads)),
       workspace_(backend_.get(), this->input_size(), this->output_size(), scale)
   {}
 
+  /// Create an Fftm object that multiplies each input row (or column)
+  /// by `window`.
+  template <typename B>
+  Fftm(Domain<2> const& dom, typename base::scalar_type scale,
+       const_Vector<typename base::scalar_type, B> window,
+       unsigned int threads = 0)
+    VSIP_THROW((std::bad_alloc))
+    : base(dom, scale, true, D, by_value),
+      backend_(fft::create_fftm<I, O, A, D, dispatcher_type>(dom, scale, threads)),
+      workspace_(backend_.get(), this->input_size(), this->output_size(), scale)
+  {
+    OVXX_PRECONDITION(window.size() == this->input_size()[axis].size());
+    workspace_.window(window, axis);
+  }
+
 #ifdef VSIP_IMPL_REF_IMPL
   /// Returns the Fast Fourier Transform of :literal:`in`.
   template <typename BlockT>
@@ -385,13 +446,29 @@ class Fftm<I, O, L, A, D, vsip::by_reference, N, H>
     std::unique_ptr<backend_type>(Domain<2> const &, typename base::scalar_type), L>
     dispatcher_type;
 public:
-  Fftm(Domain<2> const& dom, typename base::scalar_type scale)
+  Fftm(Domain<2> const& dom, typename base::scalar_type scale,
+       unsigned int threads = 0)
     VSIP_THROW((std::bad_alloc))
     : base(dom, scale, true, D, by_reference),
-      backend_(dispatcher_type::dispatch(dom, scale)),
+      backend_(fft::create_fftm<I, O, A, D, dispatcher_type>(dom, scale, threads)),
       workspace_(backend_.get(), this->input_size(), this->output_size(), scale)
   {}
 
+  /// Create an Fftm object that multiplies each input row (or column)
+  /// by `window`.
+  template <typename B>
+  Fftm(Domain<2> const& dom, typename base::scalar_type scale,
+       const_Vector<typename base::scalar_type, B> window,
+       unsigned int threads = 0)
+    VSIP_THROW((std::bad_alloc))
+    : base(dom, scale, true, D, by_reference),
+      backend_(fft::create_fftm<I, O, A, D, dispatcher_type>(dom, scale, threads)),
+      workspace_(backend_.get(), this->input_size(), this->output_size(), scale)
+  {
+    OVXX_PRECONDITION(window.size() == this->input_size()[axis].size());
+    workspace_.window(window, axis);
+  }
+
   /// Computes the Fast Fourier Transform of :literal:`in` and stores the result
   /// in :literal:`out`.
   template <typename Block0, typename Block1>
@@ -59,6 +59,7 @@ public:
   typedef complex<T> output_value_type;
 
   virtual ~fft_backend() {}
+  virtual char const* name() { return "fft";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<1> &rtl_in, Rt_layout<1> &rtl_out)
@@ -98,6 +99,7 @@ public:
   typedef T output_value_type;
 
   virtual ~fft_backend() {}
+  virtual char const* name() { return "fft";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<1> &rtl_in, Rt_layout<1> &rtl_out)
@@ -138,6 +140,7 @@ public:
   typedef complex<T> output_value_type;
 
   virtual ~fft_backend() {}
+  virtual char const* name() { return "fft";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<1> &rtl_inout)
@@ -213,6 +216,7 @@ public:
   typedef complex<T> output_value_type;
 
   virtual ~fft_backend() {}
+  virtual char const* name() { return "fft";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
@@ -257,6 +261,7 @@ public:
   typedef T output_value_type;
 
   virtual ~fft_backend() {}
+  virtual char const* name() { return "fft";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
@@ -301,6 +306,7 @@ public:
   typedef complex<T> output_value_type;
 
   virtual ~fft_backend() {}
+  virtual char const* name() { return "fft";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<2> &rtl_inout)
@@ -384,6 +390,7 @@ public:
   typedef complex<T> output_value_type;
 
   virtual ~fft_backend() {}
+  virtual char const* name() { return "fft";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<3> &rtl_in, Rt_layout<3> &rtl_out)
@@ -440,6 +447,7 @@ public:
   typedef T output_value_type;
 
   virtual ~fft_backend() {}
+  virtual char const* name() { return "fft";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<3> &rtl_in, Rt_layout<3> &rtl_out)
@@ -496,6 +504,7 @@ public:
   typedef complex<T> output_value_type;
 
   virtual ~fft_backend() {}
+  virtual char const* name() { return "fft";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<3> &rtl_inout)
@@ -607,6 +616,7 @@ public:
   typedef complex<T> output_value_type;
 
   virtual ~fftm_backend() {}
+  virtual char const* name() { return "fftm";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
@@ -655,6 +665,7 @@ public:
   typedef T output_value_type;
 
   virtual ~fftm_backend() {}
+  virtual char const* name() { return "fftm";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
@@ -703,6 +714,7 @@ public:
   typedef complex<T> output_value_type;
 
   virtual ~fftm_backend() {}
+  virtual char const* name() { return "fftm";}
   virtual bool supports_scale() { return false;}
   virtual bool supports_cuda_memory() { return false;}
   virtual void query_layout(Rt_layout<2> &rtl_inout)
@@ -0,0 +1,536 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_signal_fft_bluestein_hpp_
+#define ovxx_signal_fft_bluestein_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/domain.hpp>
+#include <vsip/vector.hpp>
+#include <ovxx/dispatch.hpp>
+#include <ovxx/signal/fft/util.hpp>
+#include <ovxx/signal/fft/workspace.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/dda.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+namespace ovxx
+{
+namespace signal
+{
+namespace fft
+{
+
+/// Transforms whose size has a prime factor larger than this are
+/// computed as chirp-z transforms by the bluestein backend.
+/// The threshold is read when Fft and Fftm objects are created.
+inline length_type &bluestein_threshold()
+{
+  static length_type threshold = 16;
+  return threshold;
+}
+
+/// Return the largest prime factor of `n`.
+inline length_type largest_prime_factor(length_type n)
+{
+  length_type p = 1;
+  for (length_type f = 2; f * f <= n; ++f)
+    for (; n % f == 0; n /= f) p = f;
+  return n > 1 ? n : p;
+}
+
+/// Whether a transform of size `n` should use the bluestein backend.
+/// Powers of two never do, as the chirp-z transform itself relies on them.
+inline bool use_bluestein(length_type n)
+{
+  return largest_prime_factor(n) > std::max<length_type>(bluestein_threshold(), 2);
+}
+
+/// Chirp-z transforms, computed by Bluestein's algorithm.
+///
+/// The transform of `n` points `x_j` into `m` points `X_k`, evaluated
+/// at `z_k = exp(i (start + k * step))`, is
+///
+///   X_k = sum_j x_j z_k^-j = c_k sum_j (x_j a_j c_j) conj(c_(k-j))
+///
+/// with `a_j = exp(-i start j)` and `c_j = exp(-i step j^2 / 2)`. The
+/// sum is a linear convolution, which is computed with FFTs of a
+/// power-of-two size, using whichever backend is available for those.
+/// With `start = 0` and `step = -sign * 2 pi / n` this is a DFT of any
+/// size `n`, at the cost of three power-of-two FFTs.
+namespace bluestein
+{
+
+typedef Layout<1, row1_type, dense, array> layout_type;
+
+/// An in-place complex FFT of a power-of-two size, through the backend
+/// the dispatcher selects for it.
+template <typename T, int S>
+class transform
+{
+  typedef complex<T> ctype;
+  typedef fft_backend<1, ctype, ctype, S> backend_type;
+  typedef dispatcher::Dispatcher<
+    dispatcher::op::fft<1, ctype, ctype, S, by_reference, 1>,
+    std::unique_ptr<backend_type>(Domain<1> const &, T)>
+    dispatcher_type;
+
+public:
+  typedef Strided<1, ctype, layout_type> block_type;
+
+  transform(length_type size)
+    : backend_(dispatcher_type::dispatch(Domain<1>(size), T(1))),
+      workspace_(backend_.get(), Domain<1>(size), Domain<1>(size), T(1))
+  {}
+
+  void operator()(block_type &data) { workspace_.in_place(*backend_, data);}
+
+private:
+  std::unique_ptr<backend_type> backend_;
+  workspace<1, ctype, ctype> workspace_;
+};
+
+/// The precomputed sequences of a chirp-z transform.
+template <typename T>
+struct chirp
+{
+  typedef complex<T> ctype;
+
+  /// A transform of `n` into `m` points, as described above.
+  chirp(length_type n, length_type m, double start, double step)
+    : input_size(n), output_size(m), size(pow2(n + m - 1)),
+      pre(n), post(m), filter(size)
+  {
+    init(start, [=](index_type j) { return -step * (double(j) * j) / 2;});
+  }
+  /// A DFT of size `n` with exponent `sign`. The chirp's phase is
+  /// reduced modulo `2 pi` exactly, to keep large sizes accurate.
+  chirp(length_type n, int sign)
+    : input_size(n), output_size(n), size(pow2(2 * n - 1)),
+      pre(n), post(n), filter(size)
+  {
+    init(0., [=](index_type j) { return sign * OVXX_PI * ((j * j) % (2 * n)) / n;});
+  }
+
+  length_type input_size;
+  length_type output_size;
+  /// The size of the FFTs computing the convolution.
+  length_type size;
+  /// `a_j c_j`, `j` in `[0, n)`
+  aligned_array<ctype> pre;
+  /// `c_k`, `k` in `[0, m)`
+  aligned_array<ctype> post;
+  /// The transform of `conj(c_d) / size`, `d` in `(-n, m)`,
+  /// with negative `d` wrapped around.
+  aligned_array<ctype> filter;
+
+private:
+  template <typename F>
+  void init(double start, F phase)
+  {
+    typedef typename transform<T, fft_fwd>::block_type block_type;
+    length_type const n = input_size, m = output_size;
+    for (index_type j = 0; j != n; ++j)
+      pre[j] = ctype(std::polar(1., phase(j) - start * j));
+    for (index_type k = 0; k != m; ++k)
+      post[k] = ctype(std::polar(1., phase(k)));
+
+    Vector<ctype, block_type> h(size, ctype());
+    for (index_type d = 0; d < std::max(n, m); ++d)
+    {
+      ctype const v = ctype(std::polar(1. / size, -phase(d)));
+      if (d < m) h.put(d, v);
+      if (d > 0 && d < n) h.put(size - d, v);
+    }
+    transform<T, fft_fwd> fwd(size);
+    fwd(h.block());
+    for (index_type i = 0; i != size; ++i) filter[i] = h.get(i);
+  }
+};
+
+/// Evaluates chirp-z transforms.
+template <typename T>
+class engine
+{
+  typedef complex<T> ctype;
+  typedef typename transform<T, fft_fwd>::block_type block_type;
+
+public:
+  engine(std::shared_ptr<chirp<T> const> c)
+    : chirp_(c), fwd_(c->size), inv_(c->size), buffer_(Domain<1>(c->size))
+  {}
+
+  length_type input_size() const { return chirp_->input_size;}
+  length_type output_size() const { return chirp_->output_size;}
+
+  /// Transform `x(j)`, `j` in `[0, n)`, and call `out(k, X_k)` for
+  /// all `k` in `[0, m)`. All of `x` is read before `out` is called,
+  /// so they may refer to the same data.
+  template <typename X, typename O>
+  void operator()(X x, O out)
+  {
+    chirp<T> const &c = *chirp_;
+    {
+      dda::Data<block_type, dda::out> data(buffer_);
+      ctype *y = data.ptr();
+      for (index_type j = 0; j != c.input_size; ++j) y[j] = ctype(x(j)) * c.pre[j];
+      for (index_type j = c.input_size; j != c.size; ++j) y[j] = ctype();
+    }
+    fwd_(buffer_);
+    {
+      dda::Data<block_type, dda::inout> data(buffer_);
+      ctype *OVXX_RESTRICT y = data.ptr();
+      ctype const *OVXX_RESTRICT f = c.filter.get();
+      for (index_type i = 0; i != c.size; ++i) y[i] *= f[i];
+    }
+    inv_(buffer_);
+    dda::Data<block_type, dda::in> data(buffer_);
+    ctype const *y = data.ptr();
+    for (index_type k = 0; k != c.output_size; ++k) out(k, y[k] * c.post[k]);
+  }
+
+private:
+  std::shared_ptr<chirp<T> const> chirp_;
+  transform<T, fft_fwd> fwd_;
+  transform<T, fft_inv> inv_;
+  block_type buffer_;
+};
+
+template <typename T>
+inline complex<T> get(complex<T> const *p, stride_type s, index_type i)
+{ return p[i * s];}
+template <typename T>
+inline complex<T> get(std::pair<T*, T*> const &p, stride_type s, index_type i)
+{ return complex<T>(p.first[i * s], p.second[i * s]);}
+
+template <typename T>
+inline void put(complex<T> *p, stride_type s, index_type i, complex<T> const &v)
+{ p[i * s] = v;}
+template <typename T>
+inline void put(std::pair<T*, T*> const &p, stride_type s, index_type i,
+		complex<T> const &v)
+{
+  p.first[i * s] = v.real();
+  p.second[i * s] = v.imag();
+}
+
+template <typename T>
+inline T *offset(T *ptr, stride_type o) { return ptr + o;}
+template <typename T>
+inline std::pair<T*, T*> offset(std::pair<T*, T*> const &ptr, stride_type o)
+{ return std::make_pair(ptr.first + o, ptr.second + o);}
+
+/// Transform the complex sequence `in` of length `n`.
+template <typename T, typename P1, typename P2>
+void c2c(engine<T> &e, P1 in, stride_type is, P2 out, stride_type os)
+{
+  e([&](index_type j) { return get(in, is, j);},
+    [&](index_type k, complex<T> const &v) { put(out, os, k, v);});
+}
+
+/// Transform the real sequence `in` of length `n`, storing
+/// the first `n / 2 + 1` values.
+template <typename T, typename P>
+void r2c(engine<T> &e, T const *in, stride_type is, P out, stride_type os)
+{
+  length_type const h = e.input_size() / 2;
+  e([&](index_type j) { return in[j * is];},
+    [&](index_type k, complex<T> const &v) { if (k <= h) put(out, os, k, v);});
+}
+
+/// Transform the Hermitian sequence of which `in` holds the
+/// first `n / 2 + 1` values, storing the real part of the result.
+template <typename T, typename P>
+void c2r(engine<T> &e, P in, stride_type is, T *out, stride_type os)
+{
+  length_type const n = e.input_size();
+  e([&](index_type j) { return j <= n / 2 ? get(in, is, j) : conj(get(in, is, n - j));},
+    [&](index_type k, complex<T> const &v) { out[k * os] = v.real();});
+}
+
+template <dimension_type D, typename I, typename O, int S> class fft;
+template <typename I, typename O, int A, int D> class fftm;
+
+// complex -> complex FFT
+template <typename T, int S>
+class fft<1, complex<T>, complex<T>, S>
+  : public fft_backend<1, complex<T>, complex<T>, S>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<1> const &dom)
+    : engine_(cached<chirp<T> >(dom.size(), S == fft_fwd ? -1 : 1)) {}
+
+  virtual char const* name() { return "bluestein<1,complex,complex>";}
+  virtual void query_layout(Rt_layout<1> &) {}
+  virtual void query_layout(Rt_layout<1> &rtl_in, Rt_layout<1> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void in_place(ctype *inout, stride_type s, length_type)
+  { c2c(engine_, inout, s, inout, s);}
+  virtual void in_place(ztype inout, stride_type s, length_type)
+  { c2c(engine_, inout, s, inout, s);}
+  virtual void out_of_place(ctype *in, stride_type in_s,
+			    ctype *out, stride_type out_s, length_type)
+  { c2c(engine_, in, in_s, out, out_s);}
+  virtual void out_of_place(ztype in, stride_type in_s,
+			    ztype out, stride_type out_s, length_type)
+  { c2c(engine_, in, in_s, out, out_s);}
+
+private:
+  engine<T> engine_;
+};
+
+// real -> complex FFT
+template <typename T>
+class fft<1, T, complex<T>, 0> : public fft_backend<1, T, complex<T>, 0>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<1> const &dom) : engine_(cached<chirp<T> >(dom.size(), -1)) {}
+
+  virtual char const* name() { return "bluestein<1,real,complex>";}
+  virtual void query_layout(Rt_layout<1> &rtl_in, Rt_layout<1> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(T *in, stride_type in_s,
+			    ctype *out, stride_type out_s, length_type)
+  { r2c(engine_, in, in_s, out, out_s);}
+  virtual void out_of_place(T *in, stride_type in_s,
+			    ztype out, stride_type out_s, length_type)
+  { r2c(engine_, in, in_s, out, out_s);}
+
+private:
+  engine<T> engine_;
+};
+
+// complex -> real FFT
+template <typename T>
+class fft<1, complex<T>, T, 0> : public fft_backend<1, complex<T>, T, 0>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<1> const &dom) : engine_(cached<chirp<T> >(dom.size(), 1)) {}
+
+  virtual char const* name() { return "bluestein<1,complex,real>";}
+  virtual void query_layout(Rt_layout<1> &rtl_in, Rt_layout<1> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(ctype *in, stride_type in_s,
+			    T *out, stride_type out_s, length_type)
+  { c2r(engine_, in, in_s, out, out_s);}
+  virtual void out_of_place(ztype in, stride_type in_s,
+			    T *out, stride_type out_s, length_type)
+  { c2r(engine_, in, in_s, out, out_s);}
+
+private:
+  engine<T> engine_;
+};
+
+/// Common logic of the Fftm backends: run `f(in, out)` for each line.
+template <typename I, typename O, int A, int D>
+class fftm_base : public fftm_backend<I, O, A, D>
+{
+protected:
+  static dimension_type const axis = A == vsip::col ? 0 : 1;
+
+  fftm_base(Domain<2> const &dom, int sign)
+    : engine_(cached<chirp<typename scalar_of<I>::type> >(dom[axis].size(), sign))
+  {}
+
+  template <typename P1, typename P2, typename F>
+  void lines(P1 in, stride_type in_r_s, stride_type in_c_s,
+	     P2 out, stride_type out_r_s, stride_type out_c_s,
+	     length_type rows, length_type cols, F f)
+  {
+    length_type const mult = axis == 0 ? cols : rows;
+    stride_type const is = axis == 0 ? in_c_s : in_r_s;
+    stride_type const os = axis == 0 ? out_c_s : out_r_s;
+    for (index_type i = 0; i != mult; ++i)
+      f(offset(in, i * is), offset(out, i * os));
+  }
+
+  engine<typename scalar_of<I>::type> engine_;
+};
+
+// real -> complex FFTM
+template <typename T, int A>
+class fftm<T, complex<T>, A, fft_fwd>
+  : public fftm_base<T, complex<T>, A, fft_fwd>
+{
+  typedef fftm_base<T, complex<T>, A, fft_fwd> base_type;
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fftm(Domain<2> const &dom) : base_type(dom, -1) {}
+
+  virtual char const* name() { return "bluestein_m<real,complex>";}
+  virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(T *in, stride_type in_r_s, stride_type in_c_s,
+			    ctype *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+  virtual void out_of_place(T *in, stride_type in_r_s, stride_type in_c_s,
+			    ztype out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+
+private:
+  template <typename P>
+  void out_of_place_(T *in, stride_type in_r_s, stride_type in_c_s,
+		     P out, stride_type out_r_s, stride_type out_c_s,
+		     length_type rows, length_type cols)
+  {
+    stride_type const is = this->axis == 0 ? in_r_s : in_c_s;
+    stride_type const os = this->axis == 0 ? out_r_s : out_c_s;
+    this->lines(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols,
+		[&](T *i, P o) { r2c(this->engine_, i, is, o, os);});
+  }
+};
+
+// complex -> real FFTM
+template <typename T, int A>
+class fftm<complex<T>, T, A, fft_inv>
+  : public fftm_base<complex<T>, T, A, fft_inv>
+{
+  typedef fftm_base<complex<T>, T, A, fft_inv> base_type;
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fftm(Domain<2> const &dom) : base_type(dom, 1) {}
+
+  virtual char const* name() { return "bluestein_m<complex,real>";}
+  virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(ctype *in, stride_type in_r_s, stride_type in_c_s,
+			    T *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+  virtual void out_of_place(ztype in, stride_type in_r_s, stride_type in_c_s,
+			    T *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+
+private:
+  template <typename P>
+  void out_of_place_(P in, stride_type in_r_s, stride_type in_c_s,
+		     T *out, stride_type out_r_s, stride_type out_c_s,
+		     length_type rows, length_type cols)
+  {
+    stride_type const is = this->axis == 0 ? in_r_s : in_c_s;
+    stride_type const os = this->axis == 0 ? out_r_s : out_c_s;
+    this->lines(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols,
+		[&](P i, T *o) { c2r(this->engine_, i, is, o, os);});
+  }
+};
+
+// complex -> complex FFTM
+template <typename T, int A, int D>
+class fftm<complex<T>, complex<T>, A, D>
+  : public fftm_base<complex<T>, complex<T>, A, D>
+{
+  typedef fftm_base<complex<T>, complex<T>, A, D> base_type;
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fftm(Domain<2> const &dom) : base_type(dom, D == fft_fwd ? -1 : 1) {}
+
+  virtual char const* name() { return "bluestein_m<complex,complex>";}
+  virtual void query_layout(Rt_layout<2> &) {}
+  virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void in_place(ctype *inout, stride_type r_s, stride_type c_s,
+			length_type rows, length_type cols)
+  { out_of_place_(inout, r_s, c_s, inout, r_s, c_s, rows, cols);}
+  virtual void in_place(ztype inout, stride_type r_s, stride_type c_s,
+			length_type rows, length_type cols)
+  { out_of_place_(inout, r_s, c_s, inout, r_s, c_s, rows, cols);}
+  virtual void out_of_place(ctype *in, stride_type in_r_s, stride_type in_c_s,
+			    ctype *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+  virtual void out_of_place(ztype in, stride_type in_r_s, stride_type in_c_s,
+			    ztype out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+
+private:
+  template <typename P>
+  void out_of_place_(P in, stride_type in_r_s, stride_type in_c_s,
+		     P out, stride_type out_r_s, stride_type out_c_s,
+		     length_type rows, length_type cols)
+  {
+    stride_type const is = this->axis == 0 ? in_r_s : in_c_s;
+    stride_type const os = this->axis == 0 ? out_r_s : out_c_s;
+    this->lines(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols,
+		[&](P i, P o) { c2c(this->engine_, i, is, o, os);});
+  }
+};
+
+} // namespace ovxx::signal::fft::bluestein
+} // namespace ovxx::signal::fft
+} // namespace ovxx::signal
+
+namespace dispatcher
+{
+
+template <typename I,
+	  typename O,
+	  int S,
+	  vsip::return_mechanism_type R,
+	  unsigned N>
+struct Evaluator<op::fft<1, I, O, S, R, N>, be::bluestein,
+  std::unique_ptr<signal::fft::fft_backend<1, I, O, S> >
+  (Domain<1> const &, typename scalar_of<I>::type)>
+{
+  typedef typename scalar_of<I>::type scalar_type;
+  static bool const ct_valid = true;
+  static bool rt_valid(Domain<1> const &dom, scalar_type)
+  { return signal::fft::use_bluestein(dom.size());}
+  static std::unique_ptr<signal::fft::fft_backend<1, I, O, S> >
+  exec(Domain<1> const &dom, scalar_type)
+  {
+    return std::unique_ptr<signal::fft::fft_backend<1, I, O, S> >
+      (new signal::fft::bluestein::fft<1, I, O, S>(dom));
+  }
+};
+
+template <typename I,
+	  typename O,
+	  int A,
+	  int D,
+	  return_mechanism_type R,
+	  unsigned N>
+struct Evaluator<op::fftm<I, O, A, D, R, N>, be::bluestein,
+  std::unique_ptr<signal::fft::fftm_backend<I, O, A, D> >
+  (Domain<2> const &, typename scalar_of<I>::type)>
+{
+  typedef typename scalar_of<I>::type scalar_type;
+  static bool const ct_valid = true;
+  static bool rt_valid(Domain<2> const &dom, scalar_type)
+  { return signal::fft::use_bluestein(dom[A == vsip::col ? 0 : 1].size());}
+  static std::unique_ptr<signal::fft::fftm_backend<I, O, A, D> >
+  exec(Domain<2> const &dom, scalar_type)
+  {
+    return std::unique_ptr<signal::fft::fftm_backend<I, O, A, D> >
+      (new signal::fft::bluestein::fftm<I, O, A, D>(dom));
+  }
+};
+
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
@@ -0,0 +1,1203 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_signal_fft_builtin_hpp_
+#define ovxx_signal_fft_builtin_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/domain.hpp>
+#include <ovxx/dispatch.hpp>
+#include <ovxx/signal/fft/util.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace ovxx
+{
+namespace signal
+{
+namespace fft
+{
+/// A self-contained FFT implementation, for platforms without FFTW.
+///
+/// Transforms of any size are factored into passes of radix 8, 4, 2, 3
+/// and 5, and any remaining prime factors, and computed by a Stockham
+/// autosort algorithm, which needs no bit-reversal permutation.
+/// Data is processed in split-complex form, with the innermost loops
+/// running over contiguous, independent butterflies, so the compiler
+/// can vectorize them. Real transforms of even size are packed into
+/// complex transforms of half the size.
+namespace builtin
+{
+
+/// One pass of the transform: `m` groups of `s` butterflies of radix `p`.
+struct pass
+{
+  length_type p, m, s;
+  /// Offset of the pass' twiddle factors, `(p - 1) * m` of them.
+  index_type twiddles;
+  /// Offset of the `p` roots of unity used by generic-radix butterflies.
+  index_type roots;
+};
+
+/// The passes and twiddle factors of a complex transform of size `n`.
+template <typename T>
+class plan
+{
+public:
+  plan(length_type n, int sign) : size(n), sign(sign)
+  {
+    length_type const radices[] = { 8, 4, 2, 3, 5};
+    length_type rest = n, s = 1;
+    auto add = [&](length_type p)
+    {
+      length_type const m = rest / p;
+      pass ps = { p, m, s, re.size(), 0};
+      for (index_type k = 1; k != p; ++k)
+	for (index_type q = 0; q != m; ++q)
+	  push(double(q * k) / (p * m));
+      ps.roots = re.size();
+      if (p > 5 && p != 8)
+	for (index_type k = 0; k != p; ++k)
+	  push(double(k) / p);
+      passes.push_back(ps);
+      rest = m;
+      s *= p;
+    };
+    for (length_type p : radices)
+      while (rest > 1 && rest % p == 0) add(p);
+    for (length_type p = 7; rest > 1; p += 2)
+      while (rest % p == 0) add(p);
+  }
+
+  length_type size;
+  int sign;
+  std::vector<pass> passes;
+  std::vector<T> re, im;
+
+private:
+  /// Append `exp(sign * 2 pi i * f)`.
+  void push(double f)
+  {
+    double const phi = sign * 2 * OVXX_PI * f;
+    re.push_back(std::cos(phi));
+    im.push_back(std::sin(phi));
+  }
+};
+
+/// The twiddle factors `exp(sign * 2 pi i * k / n)`, `k` in `[0, n/2]`,
+/// which separate the halves of a packed real transform.
+template <typename T>
+class real_plan
+{
+public:
+  real_plan(length_type n, int sign)
+  {
+    for (index_type k = 0; k <= n / 2; ++k)
+    {
+      double const phi = sign * 2 * OVXX_PI * double(k) / n;
+      re.push_back(std::cos(phi));
+      im.push_back(std::sin(phi));
+    }
+  }
+  std::vector<T> re, im;
+};
+
+/// Radix-P butterflies, transforming `P` values in place.
+template <typename T, length_type P> struct butterfly;
+
+template <typename T>
+struct butterfly<T, 2>
+{
+  static void apply(T *r, T *i, int)
+  {
+    T const r0 = r[0], i0 = i[0];
+    r[0] = r0 + r[1]; i[0] = i0 + i[1];
+    r[1] = r0 - r[1]; i[1] = i0 - i[1];
+  }
+};
+
+template <typename T>
+struct butterfly<T, 3>
+{
+  static void apply(T *r, T *i, int sign)
+  {
+    T const c = T(-0.5), s = T(sign * 0.86602540378443864676);
+    T const sr = r[1] + r[2], si = i[1] + i[2];
+    T const dr = s * (r[1] - r[2]), di = s * (i[1] - i[2]);
+    T const mr = r[0] + c * sr, mi = i[0] + c * si;
+    r[0] += sr; i[0] += si;
+    r[1] = mr - di; i[1] = mi + dr;
+    r[2] = mr + di; i[2] = mi - dr;
+  }
+};
+
+template <typename T>
+struct butterfly<T, 4>
+{
+  static void apply(T *r, T *i, int sign)
+  {
+    T const ar = r[0] + r[2], ai = i[0] + i[2];
+    T const br = r[0] - r[2], bi = i[0] - i[2];
+    T const cr = r[1] + r[3], ci = i[1] + i[3];
+    // (r[1] - r[3]) * sign * i
+    T const dr = -sign * (i[1] - i[3]), di = sign * (r[1] - r[3]);
+    r[0] = ar + cr; i[0] = ai + ci;
+    r[2] = ar - cr; i[2] = ai - ci;
+    r[1] = br + dr; i[1] = bi + di;
+    r[3] = br - dr; i[3] = bi - di;
+  }
+};
+
+template <typename T>
+struct butterfly<T, 5>
+{
+  static void apply(T *r, T *i, int sign)
+  {
+    T const c1 = T(0.30901699437494742410), c2 = T(-0.80901699437494742410);
+    T const s1 = T(sign * 0.95105651629515357212);
+    T const s2 = T(sign * 0.58778525229247312917);
+    T const b1r = r[1] + r[4], b1i = i[1] + i[4];
+    T const b2r = r[2] + r[3], b2i = i[2] + i[3];
+    T const d1r = r[1] - r[4], d1i = i[1] - i[4];
+    T const d2r = r[2] - r[3], d2i = i[2] - i[3];
+    T const u1r = r[0] + c1 * b1r + c2 * b2r, u1i = i[0] + c1 * b1i + c2 * b2i;
+    T const u2r = r[0] + c2 * b1r + c1 * b2r, u2i = i[0] + c2 * b1i + c1 * b2i;
+    T const v1r = s1 * d1r + s2 * d2r, v1i = s1 * d1i + s2 * d2i;
+    T const v2r = s2 * d1r - s1 * d2r, v2i = s2 * d1i - s1 * d2i;
+    r[0] += b1r + b2r; i[0] += b1i + b2i;
+    r[1] = u1r - v1i; i[1] = u1i + v1r;
+    r[4] = u1r + v1i; i[4] = u1i - v1r;
+    r[2] = u2r - v2i; i[2] = u2i + v2r;
+    r[3] = u2r + v2i; i[3] = u2i - v2r;
+  }
+};
+
+template <typename T>
+struct butterfly<T, 8>
+{
+  static void apply(T *r, T *i, int sign)
+  {
+    T const h = T(0.70710678118654752440);
+    T er[4] = { r[0], r[2], r[4], r[6]}, ei[4] = { i[0], i[2], i[4], i[6]};
+    T or_[4] = { r[1], r[3], r[5], r[7]}, oi[4] = { i[1], i[3], i[5], i[7]};
+    butterfly<T, 4>::apply(er, ei, sign);
+    butterfly<T, 4>::apply(or_, oi, sign);
+    // Multiply the odd half by exp(sign * 2 pi i * k / 8).
+    T const t1r = h * (or_[1] - sign * oi[1]), t1i = h * (oi[1] + sign * or_[1]);
+    T const t2r = -sign * oi[2], t2i = sign * or_[2];
+    T const t3r = -h * (or_[3] + sign * oi[3]), t3i = h * (sign * or_[3] - oi[3]);
+    r[0] = er[0] + or_[0]; i[0] = ei[0] + oi[0];
+    r[4] = er[0] - or_[0]; i[4] = ei[0] - oi[0];
+    r[1] = er[1] + t1r; i[1] = ei[1] + t1i;
+    r[5] = er[1] - t1r; i[5] = ei[1] - t1i;
+    r[2] = er[2] + t2r; i[2] = ei[2] + t2i;
+    r[6] = er[2] - t2r; i[6] = ei[2] - t2i;
+    r[3] = er[3] + t3r; i[3] = ei[3] + t3i;
+    r[7] = er[3] - t3r; i[7] = ei[3] - t3i;
+  }
+};
+
+/// Run one pass of radix `P`, from `x` to `y`:
+///
+///   y[j + s*(p*q + k)] = w^(q*k) * sum_t x[j + s*(q + m*t)] * exp(sign 2 pi i t*k / p)
+///
+/// with `w = exp(sign * 2 pi i / (p * m))`.
+template <typename T, length_type P>
+void run_pass(plan<T> const &pl, pass const &ps,
+	      T const *OVXX_RESTRICT xr, T const *OVXX_RESTRICT xi,
+	      T *OVXX_RESTRICT yr, T *OVXX_RESTRICT yi)
+{
+  length_type const m = ps.m, s = ps.s;
+  int const sign = pl.sign;
+  T const *wr = &pl.re[0] + ps.twiddles;
+  T const *wi = &pl.im[0] + ps.twiddles;
+  auto step = [&](index_type q, index_type j)
+  {
+    T ar[P], ai[P];
+    for (index_type t = 0; t != P; ++t)
+    {
+      ar[t] = xr[j + s * (q + m * t)];
+      ai[t] = xi[j + s * (q + m * t)];
+    }
+    butterfly<T, P>::apply(ar, ai, sign);
+    index_type const o = j + s * P * q;
+    yr[o] = ar[0];
+    yi[o] = ai[0];
+    for (index_type k = 1; k != P; ++k)
+    {
+      T const tr = wr[(k - 1) * m + q], ti = wi[(k - 1) * m + q];
+      yr[o + s * k] = ar[k] * tr - ai[k] * ti;
+      yi[o + s * k] = ar[k] * ti + ai[k] * tr;
+    }
+  };
+  // The innermost loop runs over contiguous data: over `q` in the first
+  // pass, where `s` is 1, and over `j` otherwise.
+  if (s == 1)
+    for (index_type q = 0; q != m; ++q) step(q, 0);
+  else if (m == 1)
+    // The last pass needs no twiddle factors.
+    for (index_type j = 0; j != s; ++j)
+    {
+      T ar[P], ai[P];
+      for (index_type t = 0; t != P; ++t)
+      {
+	ar[t] = xr[j + s * t];
+	ai[t] = xi[j + s * t];
+      }
+      butterfly<T, P>::apply(ar, ai, sign);
+      for (index_type k = 0; k != P; ++k)
+      {
+	yr[j + s * k] = ar[k];
+	yi[j + s * k] = ai[k];
+      }
+    }
+  else
+    for (index_type q = 0; q != m; ++q)
+      for (index_type j = 0; j != s; ++j) step(q, j);
+}
+
+/// Run one pass of any (prime) radix, in O(p^2) operations per butterfly.
+template <typename T>
+void run_generic_pass(plan<T> const &pl, pass const &ps,
+		      T const *xr, T const *xi, T *yr, T *yi)
+{
+  length_type const p = ps.p, m = ps.m, s = ps.s;
+  T const *wr = &pl.re[0] + ps.twiddles;
+  T const *wi = &pl.im[0] + ps.twiddles;
+  T const *rr = &pl.re[0] + ps.roots;
+  T const *ri = &pl.im[0] + ps.roots;
+  std::vector<T> ar(p), ai(p);
+  for (index_type q = 0; q != m; ++q)
+    for (index_type j = 0; j != s; ++j)
+    {
+      for (index_type t = 0; t != p; ++t)
+      {
+	ar[t] = xr[j + s * (q + m * t)];
+	ai[t] = xi[j + s * (q + m * t)];
+      }
+      index_type const o = j + s * p * q;
+      for (index_type k = 0; k != p; ++k)
+      {
+	T sr = ar[0], si = ai[0];
+	for (index_type t = 1, e = k; t != p; ++t, e = (e + k) % p)
+	{
+	  sr += ar[t] * rr[e] - ai[t] * ri[e];
+	  si += ar[t] * ri[e] + ai[t] * rr[e];
+	}
+	if (k && m > 1)
+	{
+	  T const tr = wr[(k - 1) * m + q], ti = wi[(k - 1) * m + q];
+	  yr[o + s * k] = sr * tr - si * ti;
+	  yi[o + s * k] = sr * ti + si * tr;
+	}
+	else
+	{
+	  yr[o + s * k] = sr;
+	  yi[o + s * k] = si;
+	}
+      }
+    }
+}
+
+template <typename T>
+inline void load(complex<T> const *in, stride_type s, length_type n, T *r, T *i)
+{
+  for (index_type k = 0; k != n; ++k)
+  {
+    r[k] = in[k * s].real();
+    i[k] = in[k * s].imag();
+  }
+}
+
+template <typename T>
+inline void load(std::pair<T*, T*> const &in, stride_type s, length_type n, T *r, T *i)
+{
+  for (index_type k = 0; k != n; ++k)
+  {
+    r[k] = in.first[k * s];
+    i[k] = in.second[k * s];
+  }
+}
+
+template <typename T>
+inline void store(T const *r, T const *i, length_type n, complex<T> *out, stride_type s)
+{
+  for (index_type k = 0; k != n; ++k) out[k * s] = complex<T>(r[k], i[k]);
+}
+
+template <typename T>
+inline void store(T const *r, T const *i, length_type n,
+		  std::pair<T*, T*> const &out, stride_type s)
+{
+  for (index_type k = 0; k != n; ++k)
+  {
+    out.first[k * s] = r[k];
+    out.second[k * s] = i[k];
+  }
+}
+
+/// A complex transform of a given size and direction, with the
+/// working storage to compute it.
+template <typename T>
+class engine
+{
+public:
+  engine(length_type n, int sign)
+    : plan_(cached<plan<T> >(n, sign)), buffer_(4 * n) {}
+
+  length_type size() const { return plan_->size;}
+  /// The real and imaginary parts of the input.
+  T *in_re() { return buffer_.get();}
+  T *in_im() { return buffer_.get() + size();}
+  /// Transform the input, returning the buffer holding the result,
+  /// with the imaginary parts following the real parts.
+  T *run()
+  {
+    length_type const n = size();
+    T *x = buffer_.get(), *y = buffer_.get() + 2 * n;
+    for (pass const &ps : plan_->passes)
+    {
+      switch (ps.p)
+      {
+	case 2: run_pass<T, 2>(*plan_, ps, x, x + n, y, y + n); break;
+	case 3: run_pass<T, 3>(*plan_, ps, x, x + n, y, y + n); break;
+	case 4: run_pass<T, 4>(*plan_, ps, x, x + n, y, y + n); break;
+	case 5: run_pass<T, 5>(*plan_, ps, x, x + n, y, y + n); break;
+	case 8: run_pass<T, 8>(*plan_, ps, x, x + n, y, y + n); break;
+	default: run_generic_pass(*plan_, ps, x, x + n, y, y + n); break;
+      }
+      std::swap(x, y);
+    }
+    return x;
+  }
+  /// Transform `n` values read from `in` with stride `is`, writing them
+  /// to `out` with stride `os`. `in` and `out` may refer to the same data.
+  template <typename P1, typename P2>
+  void operator()(P1 const &in, stride_type is, P2 const &out, stride_type os)
+  {
+    length_type const n = size();
+    load(in, is, n, in_re(), in_im());
+    T *result = run();
+    store(result, result + n, n, out, os);
+  }
+
+private:
+  std::shared_ptr<plan<T> const> plan_;
+  aligned_array<T> buffer_;
+};
+
+/// A real transform of size `n`: real -> complex for `sign == -1`,
+/// complex -> real for `sign == 1`. Only the `n/2 + 1` non-redundant
+/// complex values are read or written.
+template <typename T>
+class real_engine
+{
+public:
+  real_engine(length_type n, int sign)
+    : size_(n),
+      packed_(n % 2 == 0),
+      engine_(packed_ ? n / 2 : n, sign),
+      plan_(cached<real_plan<T> >(n, sign)),
+      tmp_(packed_ ? 2 * (n / 2 + 1) : 0)
+  {}
+
+  template <typename P>
+  void r2c(T const *in, stride_type is, P const &out, stride_type os)
+  {
+    T *xr = engine_.in_re(), *xi = engine_.in_im();
+    if (!packed_)
+    {
+      for (index_type k = 0; k != size_; ++k)
+      {
+	xr[k] = in[k * is];
+	xi[k] = T(0);
+      }
+      T *z = engine_.run();
+      store(z, z + size_, size_ / 2 + 1, out, os);
+      return;
+    }
+    // Transform the even and odd elements as real and imaginary parts
+    // of one complex sequence, then separate their spectra.
+    length_type const h = size_ / 2;
+    for (index_type k = 0; k != h; ++k)
+    {
+      xr[k] = in[2 * k * is];
+      xi[k] = in[(2 * k + 1) * is];
+    }
+    T const *zr = engine_.run();
+    T const *zi = zr + h;
+    T *yr = tmp_.get(), *yi = tmp_.get() + h + 1;
+    for (index_type k = 0; k <= h; ++k)
+    {
+      index_type const a = k % h, b = (h - k) % h;
+      T const er = (zr[a] + zr[b]) / 2, ei = (zi[a] - zi[b]) / 2;
+      T const or_ = (zi[a] + zi[b]) / 2, oi = (zr[b] - zr[a]) / 2;
+      T const wr = plan_->re[k], wi = plan_->im[k];
+      yr[k] = er + or_ * wr - oi * wi;
+      yi[k] = ei + or_ * wi + oi * wr;
+    }
+    store(yr, yi, h + 1, out, os);
+  }
+
+  template <typename P>
+  void c2r(P const &in, stride_type is, T *out, stride_type os)
+  {
+    T *xr = engine_.in_re(), *xi = engine_.in_im();
+    length_type const h = size_ / 2;
+    if (!packed_)
+    {
+      // Restore the redundant half of the spectrum.
+      load(in, is, h + 1, xr, xi);
+      xi[0] = T(0);
+      for (index_type k = 1; k <= h; ++k)
+      {
+	xr[size_ - k] = xr[k];
+	xi[size_ - k] = -xi[k];
+      }
+      T const *z = engine_.run();
+      for (index_type k = 0; k != size_; ++k) out[k * os] = z[k];
+      return;
+    }
+    // The reverse of r2c(): combine the spectra of the even and odd
+    // elements, and transform them as one complex sequence.
+    T *ar = tmp_.get(), *ai = tmp_.get() + h + 1;
+    load(in, is, h + 1, ar, ai);
+    ai[0] = ai[h] = T(0);
+    for (index_type k = 0; k != h; ++k)
+    {
+      T const er = ar[k] + ar[h - k], ei = ai[k] - ai[h - k];
+      T const dr = ar[k] - ar[h - k], di = ai[k] + ai[h - k];
+      T const wr = plan_->re[k], wi = plan_->im[k];
+      T const or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+      xr[k] = er - oi;
+      xi[k] = ei + or_;
+    }
+    T const *z = engine_.run();
+    for (index_type k = 0; k != h; ++k)
+    {
+      out[2 * k * os] = z[k];
+      out[(2 * k + 1) * os] = z[h + k];
+    }
+  }
+
+private:
+  length_type size_;
+  bool packed_;
+  engine<T> engine_;
+  std::shared_ptr<real_plan<T> const> plan_;
+  /// The non-redundant half of the spectrum, for packed transforms.
+  aligned_array<T> tmp_;
+};
+
+template <typename T>
+inline T *offset(T *ptr, stride_type o) { return ptr + o;}
+template <typename T>
+inline std::pair<T*, T*> offset(std::pair<T*, T*> const &ptr, stride_type o)
+{ return std::make_pair(ptr.first + o, ptr.second + o);}
+
+/// Call `f(i, o)` with the offsets `i` and `o` of each line along
+/// dimension `axis` of a `D`-dimensional array of extents `size`,
+/// with input strides `is` and output strides `os`.
+template <dimension_type D, typename F>
+void for_each_line(length_type const *size,
+		   stride_type const *is, stride_type const *os,
+		   dimension_type axis, F f)
+{
+  index_type idx[D] = {};
+  length_type lines = 1;
+  for (dimension_type d = 0; d != D; ++d)
+    if (d != axis) lines *= size[d];
+  for (index_type l = 0; l != lines; ++l)
+  {
+    stride_type i = 0, o = 0;
+    for (dimension_type d = 0; d != D; ++d)
+    {
+      i += idx[d] * is[d];
+      o += idx[d] * os[d];
+    }
+    f(i, o);
+    for (dimension_type d = D; d-- > 0;)
+    {
+      if (d == axis) continue;
+      if (++idx[d] != size[d]) break;
+      idx[d] = 0;
+    }
+  }
+}
+
+template <dimension_type D, typename I, typename O, int S> class fft;
+template <typename I, typename O, int A, int D> class fftm;
+
+/// Complex transforms of any dimension, computed along each dimension
+/// in turn.
+template <dimension_type D, typename T, int S>
+class cfft
+{
+public:
+  static int const sign = S == fft_fwd ? -1 : 1;
+
+  cfft(Domain<D> const &dom)
+  {
+    for (dimension_type d = 0; d != D; ++d)
+      engines_.emplace_back(new engine<T>(dom[d].size(), sign));
+  }
+  template <typename P>
+  void in_place(P inout, stride_type const *s, length_type const *size)
+  {
+    for (dimension_type d = 0; d != D; ++d)
+      along(d, inout, s, inout, s, size);
+  }
+  template <typename P>
+  void out_of_place(P in, stride_type const *is, P out, stride_type const *os,
+		    length_type const *size)
+  {
+    along(D - 1, in, is, out, os, size);
+    for (dimension_type d = 0; d != D - 1; ++d)
+      along(d, out, os, out, os, size);
+  }
+  /// Transform all lines along dimension `d`.
+  template <typename P1, typename P2>
+  void along(dimension_type d, P1 in, stride_type const *is,
+	     P2 out, stride_type const *os, length_type const *size)
+  {
+    engine<T> &e = *engines_[d];
+    for_each_line<D>(size, is, os, d, [&](stride_type i, stride_type o)
+    { e(offset(in, i), is[d], offset(out, o), os[d]);});
+  }
+
+private:
+  std::vector<std::unique_ptr<engine<T> > > engines_;
+};
+
+/// Real -> complex transforms of any dimension: real transforms along
+/// dimension `A`, followed by complex ones along the other dimensions.
+template <dimension_type D, typename T, int A>
+class rfft
+{
+public:
+  rfft(Domain<D> const &dom) : real_(dom[A].size(), -1), complex_(half(dom)) {}
+
+  template <typename P>
+  void out_of_place(T *in, stride_type const *is, P out, stride_type const *os,
+		    length_type const *size)
+  {
+    length_type out_size[D];
+    std::copy(size, size + D, out_size);
+    out_size[A] = size[A] / 2 + 1;
+    for_each_line<D>(size, is, os, A, [&](stride_type i, stride_type o)
+    { real_.r2c(in + i, is[A], offset(out, o), os[A]);});
+    for (dimension_type d = 0; d != D; ++d)
+      if (d != A) complex_.along(d, out, os, out, os, out_size);
+  }
+
+private:
+  static Domain<D> half(Domain<D> const &dom)
+  {
+    Domain<D> h(dom);
+    h.impl_at(A) = Domain<1>(dom[A].size() / 2 + 1);
+    return h;
+  }
+
+  real_engine<T> real_;
+  cfft<D, T, fft_fwd> complex_;
+};
+
+/// Complex -> real transforms of any dimension: complex transforms
+/// along all dimensions but `A`, followed by real ones along `A`.
+template <dimension_type D, typename T, int A>
+class irfft
+{
+public:
+  irfft(Domain<D> const &dom)
+    : real_(dom[A].size(), 1), complex_(half(dom)), tmp_(half(dom).size()) {}
+
+  template <typename P>
+  void out_of_place(P in, stride_type const *is, T *out, stride_type const *os,
+		    length_type const *size)
+  {
+    length_type in_size[D];
+    std::copy(size, size + D, in_size);
+    in_size[A] = size[A] / 2 + 1;
+    // The input must be preserved, so the complex transforms go to a
+    // temporary array of the input's extents, in row-major order.
+    stride_type ts[D];
+    for (dimension_type d = D, total = 1; d-- > 0; total *= in_size[d])
+      ts[d] = total;
+    complex<T> *tmp = tmp_.get();
+    bool first = true;
+    for (dimension_type d = 0; d != D; ++d)
+    {
+      if (d == A) continue;
+      if (first) complex_.along(d, in, is, tmp, ts, in_size);
+      else complex_.along(d, tmp, ts, tmp, ts, in_size);
+      first = false;
+    }
+    for_each_line<D>(size, ts, os, A, [&](stride_type i, stride_type o)
+    { real_.c2r(tmp + i, ts[A], out + o, os[A]);});
+  }
+
+private:
+  static Domain<D> half(Domain<D> const &dom)
+  {
+    Domain<D> h(dom);
+    h.impl_at(A) = Domain<1>(dom[A].size() / 2 + 1);
+    return h;
+  }
+
+  real_engine<T> real_;
+  cfft<D, T, fft_inv> complex_;
+  aligned_array<complex<T> > tmp_;
+};
+
+// 1D complex -> complex FFT
+template <typename T, int S>
+class fft<1, complex<T>, complex<T>, S>
+  : public fft_backend<1, complex<T>, complex<T>, S>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<1> const &dom) : engine_(dom.size(), S == fft_fwd ? -1 : 1) {}
+
+  virtual char const* name() { return "builtin<1,complex,complex>";}
+  virtual void query_layout(Rt_layout<1> &) {}
+  virtual void query_layout(Rt_layout<1> &rtl_in, Rt_layout<1> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void in_place(ctype *inout, stride_type s, length_type)
+  { engine_(inout, s, inout, s);}
+  virtual void in_place(ztype inout, stride_type s, length_type)
+  { engine_(inout, s, inout, s);}
+  virtual void out_of_place(ctype *in, stride_type in_s,
+			    ctype *out, stride_type out_s, length_type)
+  { engine_(in, in_s, out, out_s);}
+  virtual void out_of_place(ztype in, stride_type in_s,
+			    ztype out, stride_type out_s, length_type)
+  { engine_(in, in_s, out, out_s);}
+
+private:
+  engine<T> engine_;
+};
+
+// 1D real -> complex FFT
+template <typename T>
+class fft<1, T, complex<T>, 0> : public fft_backend<1, T, complex<T>, 0>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<1> const &dom) : engine_(dom.size(), -1) {}
+
+  virtual char const* name() { return "builtin<1,real,complex>";}
+  virtual void query_layout(Rt_layout<1> &rtl_in, Rt_layout<1> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(T *in, stride_type in_s,
+			    ctype *out, stride_type out_s, length_type)
+  { engine_.r2c(in, in_s, out, out_s);}
+  virtual void out_of_place(T *in, stride_type in_s,
+			    ztype out, stride_type out_s, length_type)
+  { engine_.r2c(in, in_s, out, out_s);}
+
+private:
+  real_engine<T> engine_;
+};
+
+// 1D complex -> real FFT
+template <typename T>
+class fft<1, complex<T>, T, 0> : public fft_backend<1, complex<T>, T, 0>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<1> const &dom) : engine_(dom.size(), 1) {}
+
+  virtual char const* name() { return "builtin<1,complex,real>";}
+  virtual void query_layout(Rt_layout<1> &rtl_in, Rt_layout<1> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(ctype *in, stride_type in_s,
+			    T *out, stride_type out_s, length_type)
+  { engine_.c2r(in, in_s, out, out_s);}
+  virtual void out_of_place(ztype in, stride_type in_s,
+			    T *out, stride_type out_s, length_type)
+  { engine_.c2r(in, in_s, out, out_s);}
+
+private:
+  real_engine<T> engine_;
+};
+
+// 2D complex -> complex FFT
+template <typename T, int S>
+class fft<2, complex<T>, complex<T>, S>
+  : public fft_backend<2, complex<T>, complex<T>, S>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<2> const &dom) : impl_(dom) {}
+
+  virtual char const* name() { return "builtin<2,complex,complex>";}
+  virtual void query_layout(Rt_layout<2> &) {}
+  virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void in_place(ctype *inout, stride_type r_s, stride_type c_s,
+			length_type rows, length_type cols)
+  { in_place_(inout, r_s, c_s, rows, cols);}
+  virtual void in_place(ztype inout, stride_type r_s, stride_type c_s,
+			length_type rows, length_type cols)
+  { in_place_(inout, r_s, c_s, rows, cols);}
+  virtual void out_of_place(ctype *in, stride_type in_r_s, stride_type in_c_s,
+			    ctype *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+  virtual void out_of_place(ztype in, stride_type in_r_s, stride_type in_c_s,
+			    ztype out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+
+private:
+  template <typename P>
+  void in_place_(P inout, stride_type r_s, stride_type c_s,
+		 length_type rows, length_type cols)
+  {
+    stride_type const s[] = { r_s, c_s};
+    length_type const size[] = { rows, cols};
+    impl_.in_place(inout, s, size);
+  }
+  template <typename P>
+  void out_of_place_(P in, stride_type in_r_s, stride_type in_c_s,
+		     P out, stride_type out_r_s, stride_type out_c_s,
+		     length_type rows, length_type cols)
+  {
+    stride_type const is[] = { in_r_s, in_c_s};
+    stride_type const os[] = { out_r_s, out_c_s};
+    length_type const size[] = { rows, cols};
+    impl_.out_of_place(in, is, out, os, size);
+  }
+
+  cfft<2, T, S> impl_;
+};
+
+// 2D real -> complex FFT
+template <typename T, int S>
+class fft<2, T, complex<T>, S> : public fft_backend<2, T, complex<T>, S>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<2> const &dom) : impl_(dom) {}
+
+  virtual char const* name() { return "builtin<2,real,complex>";}
+  virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(T *in, stride_type in_r_s, stride_type in_c_s,
+			    ctype *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+  virtual void out_of_place(T *in, stride_type in_r_s, stride_type in_c_s,
+			    ztype out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+
+private:
+  template <typename P>
+  void out_of_place_(T *in, stride_type in_r_s, stride_type in_c_s,
+		     P out, stride_type out_r_s, stride_type out_c_s,
+		     length_type rows, length_type cols)
+  {
+    stride_type const is[] = { in_r_s, in_c_s};
+    stride_type const os[] = { out_r_s, out_c_s};
+    length_type const size[] = { rows, cols};
+    impl_.out_of_place(in, is, out, os, size);
+  }
+
+  rfft<2, T, S> impl_;
+};
+
+// 2D complex -> real FFT
+template <typename T, int S>
+class fft<2, complex<T>, T, S> : public fft_backend<2, complex<T>, T, S>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<2> const &dom) : impl_(dom) {}
+
+  virtual char const* name() { return "builtin<2,complex,real>";}
+  virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(ctype *in, stride_type in_r_s, stride_type in_c_s,
+			    T *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+  virtual void out_of_place(ztype in, stride_type in_r_s, stride_type in_c_s,
+			    T *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+
+private:
+  template <typename P>
+  void out_of_place_(P in, stride_type in_r_s, stride_type in_c_s,
+		     T *out, stride_type out_r_s, stride_type out_c_s,
+		     length_type rows, length_type cols)
+  {
+    stride_type const is[] = { in_r_s, in_c_s};
+    stride_type const os[] = { out_r_s, out_c_s};
+    length_type const size[] = { rows, cols};
+    impl_.out_of_place(in, is, out, os, size);
+  }
+
+  irfft<2, T, S> impl_;
+};
+
+// 3D complex -> complex FFT
+template <typename T, int S>
+class fft<3, complex<T>, complex<T>, S>
+  : public fft_backend<3, complex<T>, complex<T>, S>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<3> const &dom) : impl_(dom) {}
+
+  virtual char const* name() { return "builtin<3,complex,complex>";}
+  virtual void query_layout(Rt_layout<3> &) {}
+  virtual void query_layout(Rt_layout<3> &rtl_in, Rt_layout<3> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void in_place(ctype *inout,
+			stride_type x_s, stride_type y_s, stride_type z_s,
+			length_type x, length_type y, length_type z)
+  { in_place_(inout, x_s, y_s, z_s, x, y, z);}
+  virtual void in_place(ztype inout,
+			stride_type x_s, stride_type y_s, stride_type z_s,
+			length_type x, length_type y, length_type z)
+  { in_place_(inout, x_s, y_s, z_s, x, y, z);}
+  virtual void out_of_place(ctype *in,
+			    stride_type in_x_s, stride_type in_y_s, stride_type in_z_s,
+			    ctype *out,
+			    stride_type out_x_s, stride_type out_y_s, stride_type out_z_s,
+			    length_type x, length_type y, length_type z)
+  {
+    out_of_place_(in, in_x_s, in_y_s, in_z_s,
+		  out, out_x_s, out_y_s, out_z_s, x, y, z);
+  }
+  virtual void out_of_place(ztype in,
+			    stride_type in_x_s, stride_type in_y_s, stride_type in_z_s,
+			    ztype out,
+			    stride_type out_x_s, stride_type out_y_s, stride_type out_z_s,
+			    length_type x, length_type y, length_type z)
+  {
+    out_of_place_(in, in_x_s, in_y_s, in_z_s,
+		  out, out_x_s, out_y_s, out_z_s, x, y, z);
+  }
+
+private:
+  template <typename P>
+  void in_place_(P inout, stride_type x_s, stride_type y_s, stride_type z_s,
+		 length_type x, length_type y, length_type z)
+  {
+    stride_type const s[] = { x_s, y_s, z_s};
+    length_type const size[] = { x, y, z};
+    impl_.in_place(inout, s, size);
+  }
+  template <typename P>
+  void out_of_place_(P in, stride_type in_x_s, stride_type in_y_s, stride_type in_z_s,
+		     P out, stride_type out_x_s, stride_type out_y_s, stride_type out_z_s,
+		     length_type x, length_type y, length_type z)
+  {
+    stride_type const is[] = { in_x_s, in_y_s, in_z_s};
+    stride_type const os[] = { out_x_s, out_y_s, out_z_s};
+    length_type const size[] = { x, y, z};
+    impl_.out_of_place(in, is, out, os, size);
+  }
+
+  cfft<3, T, S> impl_;
+};
+
+// 3D real -> complex FFT
+template <typename T, int S>
+class fft<3, T, complex<T>, S> : public fft_backend<3, T, complex<T>, S>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<3> const &dom) : impl_(dom) {}
+
+  virtual char const* name() { return "builtin<3,real,complex>";}
+  virtual void query_layout(Rt_layout<3> &rtl_in, Rt_layout<3> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(T *in,
+			    stride_type in_x_s, stride_type in_y_s, stride_type in_z_s,
+			    ctype *out,
+			    stride_type out_x_s, stride_type out_y_s, stride_type out_z_s,
+			    length_type x, length_type y, length_type z)
+  {
+    out_of_place_(in, in_x_s, in_y_s, in_z_s,
+		  out, out_x_s, out_y_s, out_z_s, x, y, z);
+  }
+  virtual void out_of_place(T *in,
+			    stride_type in_x_s, stride_type in_y_s, stride_type in_z_s,
+			    ztype out,
+			    stride_type out_x_s, stride_type out_y_s, stride_type out_z_s,
+			    length_type x, length_type y, length_type z)
+  {
+    out_of_place_(in, in_x_s, in_y_s, in_z_s,
+		  out, out_x_s, out_y_s, out_z_s, x, y, z);
+  }
+
+private:
+  template <typename P>
+  void out_of_place_(T *in, stride_type in_x_s, stride_type in_y_s, stride_type in_z_s,
+		     P out, stride_type out_x_s, stride_type out_y_s, stride_type out_z_s,
+		     length_type x, length_type y, length_type z)
+  {
+    stride_type const is[] = { in_x_s, in_y_s, in_z_s};
+    stride_type const os[] = { out_x_s, out_y_s, out_z_s};
+    length_type const size[] = { x, y, z};
+    impl_.out_of_place(in, is, out, os, size);
+  }
+
+  rfft<3, T, S> impl_;
+};
+
+// 3D complex -> real FFT
+template <typename T, int S>
+class fft<3, complex<T>, T, S> : public fft_backend<3, complex<T>, T, S>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  fft(Domain<3> const &dom) : impl_(dom) {}
+
+  virtual char const* name() { return "builtin<3,complex,real>";}
+  virtual void query_layout(Rt_layout<3> &rtl_in, Rt_layout<3> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(ctype *in,
+			    stride_type in_x_s, stride_type in_y_s, stride_type in_z_s,
+			    T *out,
+			    stride_type out_x_s, stride_type out_y_s, stride_type out_z_s,
+			    length_type x, length_type y, length_type z)
+  {
+    out_of_place_(in, in_x_s, in_y_s, in_z_s,
+		  out, out_x_s, out_y_s, out_z_s, x, y, z);
+  }
+  virtual void out_of_place(ztype in,
+			    stride_type in_x_s, stride_type in_y_s, stride_type in_z_s,
+			    T *out,
+			    stride_type out_x_s, stride_type out_y_s, stride_type out_z_s,
+			    length_type x, length_type y, length_type z)
+  {
+    out_of_place_(in, in_x_s, in_y_s, in_z_s,
+		  out, out_x_s, out_y_s, out_z_s, x, y, z);
+  }
+
+private:
+  template <typename P>
+  void out_of_place_(P in, stride_type in_x_s, stride_type in_y_s, stride_type in_z_s,
+		     T *out, stride_type out_x_s, stride_type out_y_s, stride_type out_z_s,
+		     length_type x, length_type y, length_type z)
+  {
+    stride_type const is[] = { in_x_s, in_y_s, in_z_s};
+    stride_type const os[] = { out_x_s, out_y_s, out_z_s};
+    length_type const size[] = { x, y, z};
+    impl_.out_of_place(in, is, out, os, size);
+  }
+
+  irfft<3, T, S> impl_;
+};
+
+// real -> complex FFTM
+template <typename T, int A>
+class fftm<T, complex<T>, A, fft_fwd>
+  : public fftm_backend<T, complex<T>, A, fft_fwd>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+  static dimension_type const axis = A == vsip::col ? 0 : 1;
+
+public:
+  fftm(Domain<2> const &dom) : engine_(dom[axis].size(), -1) {}
+
+  virtual char const* name() { return "builtin_m<real,complex>";}
+  virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(T *in, stride_type in_r_s, stride_type in_c_s,
+			    ctype *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+  virtual void out_of_place(T *in, stride_type in_r_s, stride_type in_c_s,
+			    ztype out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+
+private:
+  template <typename P>
+  void out_of_place_(T *in, stride_type in_r_s, stride_type in_c_s,
+		     P out, stride_type out_r_s, stride_type out_c_s,
+		     length_type rows, length_type cols)
+  {
+    stride_type const is[] = { in_r_s, in_c_s};
+    stride_type const os[] = { out_r_s, out_c_s};
+    length_type const size[] = { rows, cols};
+    for_each_line<2>(size, is, os, axis, [&](stride_type i, stride_type o)
+    { engine_.r2c(in + i, is[axis], offset(out, o), os[axis]);});
+  }
+
+  real_engine<T> engine_;
+};
+
+// complex -> real FFTM
+template <typename T, int A>
+class fftm<complex<T>, T, A, fft_inv>
+  : public fftm_backend<complex<T>, T, A, fft_inv>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+  static dimension_type const axis = A == vsip::col ? 0 : 1;
+
+public:
+  fftm(Domain<2> const &dom) : engine_(dom[axis].size(), 1) {}
+
+  virtual char const* name() { return "builtin_m<complex,real>";}
+  virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void out_of_place(ctype *in, stride_type in_r_s, stride_type in_c_s,
+			    T *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+  virtual void out_of_place(ztype in, stride_type in_r_s, stride_type in_c_s,
+			    T *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+
+private:
+  template <typename P>
+  void out_of_place_(P in, stride_type in_r_s, stride_type in_c_s,
+		     T *out, stride_type out_r_s, stride_type out_c_s,
+		     length_type rows, length_type cols)
+  {
+    stride_type const is[] = { in_r_s, in_c_s};
+    stride_type const os[] = { out_r_s, out_c_s};
+    length_type const size[] = { rows, cols};
+    for_each_line<2>(size, is, os, axis, [&](stride_type i, stride_type o)
+    { engine_.c2r(offset(in, i), is[axis], out + o, os[axis]);});
+  }
+
+  real_engine<T> engine_;
+};
+
+// complex -> complex FFTM
+template <typename T, int A, int D>
+class fftm<complex<T>, complex<T>, A, D>
+  : public fftm_backend<complex<T>, complex<T>, A, D>
+{
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+  static dimension_type const axis = A == vsip::col ? 0 : 1;
+
+public:
+  fftm(Domain<2> const &dom) : engine_(dom[axis].size(), D == fft_fwd ? -1 : 1) {}
+
+  virtual char const* name() { return "builtin_m<complex,complex>";}
+  virtual void query_layout(Rt_layout<2> &) {}
+  virtual void query_layout(Rt_layout<2> &rtl_in, Rt_layout<2> &rtl_out)
+  { rtl_in.storage_format = rtl_out.storage_format;}
+  virtual void in_place(ctype *inout, stride_type r_s, stride_type c_s,
+			length_type rows, length_type cols)
+  { out_of_place_(inout, r_s, c_s, inout, r_s, c_s, rows, cols);}
+  virtual void in_place(ztype inout, stride_type r_s, stride_type c_s,
+			length_type rows, length_type cols)
+  { out_of_place_(inout, r_s, c_s, inout, r_s, c_s, rows, cols);}
+  virtual void out_of_place(ctype *in, stride_type in_r_s, stride_type in_c_s,
+			    ctype *out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+  virtual void out_of_place(ztype in, stride_type in_r_s, stride_type in_c_s,
+			    ztype out, stride_type out_r_s, stride_type out_c_s,
+			    length_type rows, length_type cols)
+  { out_of_place_(in, in_r_s, in_c_s, out, out_r_s, out_c_s, rows, cols);}
+
+private:
+  template <typename P>
+  void out_of_place_(P in, stride_type in_r_s, stride_type in_c_s,
+		     P out, stride_type out_r_s, stride_type out_c_s,
+		     length_type rows, length_type cols)
+  {
+    stride_type const is[] = { in_r_s, in_c_s};
+    stride_type const os[] = { out_r_s, out_c_s};
+    length_type const size[] = { rows, cols};
+    for_each_line<2>(size, is, os, axis, [&](stride_type i, stride_type o)
+    { engine_(offset(in, i), is[axis], offset(out, o), os[axis]);});
+  }
+
+  engine<T> engine_;
+};
+
+} // namespace ovxx::signal::fft::builtin
+} // namespace ovxx::signal::fft
+} // namespace ovxx::signal
+
+namespace dispatcher
+{
+
+template <dimension_type D,
+	  typename I,
+	  typename O,
+	  int S,
+	  vsip::return_mechanism_type R,
+	  unsigned N>
+struct Evaluator<op::fft<D, I, O, S, R, N>, be::builtin,
+  std::unique_ptr<signal::fft::fft_backend<D, I, O, S> >
+  (Domain<D> const &, typename scalar_of<I>::type)>
+{
+  typedef typename scalar_of<I>::type scalar_type;
+  static bool const ct_valid = true;
+  static bool rt_valid(Domain<D> const &, scalar_type)
+  { return true;}
+  static std::unique_ptr<signal::fft::fft_backend<D, I, O, S> >
+  exec(Domain<D> const &dom, scalar_type)
+  {
+    return std::unique_ptr<signal::fft::fft_backend<D, I, O, S> >
+      (new signal::fft::builtin::fft<D, I, O, S>(dom));
+  }
+};
+
+template <typename I,
+	  typename O,
+	  int A,
+	  int D,
+	  return_mechanism_type R,
+	  unsigned N>
+struct Evaluator<op::fftm<I, O, A, D, R, N>, be::builtin,
+  std::unique_ptr<signal::fft::fftm_backend<I, O, A, D> >
+  (Domain<2> const &, typename scalar_of<I>::type)>
+{
+  typedef typename scalar_of<I>::type scalar_type;
+  static bool const ct_valid = true;
+  static bool rt_valid(Domain<2> const &, scalar_type)
+  { return true;}
+  static std::unique_ptr<signal::fft::fftm_backend<I, O, A, D> >
+  exec(Domain<2> const &dom, scalar_type)
+  {
+    return std::unique_ptr<signal::fft::fftm_backend<I, O, A, D> >
+      (new signal::fft::builtin::fftm<I, O, A, D>(dom));
+  }
+};
+
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
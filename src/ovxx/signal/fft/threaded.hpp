@@ -0,0 +1,264 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_signal_fft_threaded_hpp_
+#define ovxx_signal_fft_threaded_hpp_
+
+#include <ovxx/signal/fft/backend.hpp>
+#include <ovxx/signal/fft/util.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/numa.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace ovxx
+{
+namespace signal
+{
+namespace fft
+{
+
+/// Return the number of transforms per batch when `mult` transforms
+/// of `bytes` bytes each are split over `workers` threads.
+///
+/// Where whole transforms fit into a page, batches are rounded up to
+/// whole pages, so no two threads write to the same page (or cache line),
+/// and pages placed by first touch stay with the thread working on them.
+inline length_type
+batch_size(length_type mult, length_type bytes, unsigned int workers)
+{
+  length_type batch = (mult + workers - 1) / workers;
+  length_type const page = numa::page_size();
+  if (bytes && bytes < page && page % bytes == 0)
+  {
+    length_type const per_page = page / bytes;
+    batch = (batch + per_page - 1) / per_page * per_page;
+  }
+  return batch;
+}
+
+/// Common logic of threaded_fftm.
+template <typename I, typename O, int A, int D>
+class threaded_fftm_base : public fftm_backend<I, O, A, D>
+{
+protected:
+  typedef fftm_backend<I, O, A, D> backend_type;
+  typedef std::vector<std::unique_ptr<backend_type> > backends_type;
+  static bool const by_col = A == vsip::col;
+
+public:
+  threaded_fftm_base(backends_type &backends, length_type batch)
+    : backends_(std::move(backends)), batch_(batch)
+  {}
+
+  virtual char const* name() { return backends_[0]->name();}
+  virtual bool supports_scale() { return backends_[0]->supports_scale();}
+  virtual void query_layout(Rt_layout<2> &in, Rt_layout<2> &out)
+  { backends_[0]->query_layout(in, out);}
+  virtual bool requires_copy(Rt_layout<2> &l) { return backends_[0]->requires_copy(l);}
+  // The backends' buffers only hold a batch, so input_buffer() and
+  // output_buffer() aren't forwarded.
+
+protected:
+  template <typename T>
+  static T *offset(T *ptr, stride_type stride, index_type i)
+  { return ptr + i * stride;}
+  template <typename T>
+  static std::pair<T*, T*>
+  offset(std::pair<T*, T*> const &ptr, stride_type stride, index_type i)
+  { return std::make_pair(ptr.first + i * stride, ptr.second + i * stride);}
+
+  /// Call `f(backend, in, out, rows, cols)` for each batch of the
+  /// transforms of a `rows` x `cols` matrix, in parallel if possible.
+  /// There may be fewer transforms than planned for, but not more.
+  template <typename P1, typename P2, typename F>
+  void batches(P1 in, stride_type in_stride_0, stride_type in_stride_1,
+	       P2 out, stride_type out_stride_0, stride_type out_stride_1,
+	       length_type rows, length_type cols, F f)
+  {
+    length_type const mult = by_col ? cols : rows;
+    stride_type const in_stride = by_col ? in_stride_1 : in_stride_0;
+    stride_type const out_stride = by_col ? out_stride_1 : out_stride_0;
+    length_type const batches = (mult + batch_ - 1) / batch_;
+    OVXX_PRECONDITION(batches <= backends_.size());
+    auto task = [&](index_type b)
+    {
+      index_type const begin = b * batch_;
+      length_type const size = std::min(batch_, mult - begin);
+      f(*backends_[b],
+	offset(in, in_stride, begin), offset(out, out_stride, begin),
+	by_col ? rows : size, by_col ? size : cols);
+    };
+    thread_pool *pool = thread_pool::get_default();
+    if (pool && batches > 1) pool->parallel_for(batches, task);
+    else for (index_type b = 0; b != batches; ++b) task(b);
+  }
+
+  backends_type backends_;
+  length_type batch_;
+};
+
+/// An Fftm backend splitting the transforms into contiguous batches,
+/// one per thread. Each batch is handled by a backend of its own, with
+/// its own plan and buffers, which runs single-threaded on one thread
+/// of the library's thread pool.
+template <typename I, typename O, int A, int D>
+class threaded_fftm;
+
+/// real -> complex
+template <typename T, int A>
+class threaded_fftm<T, complex<T>, A, fft_fwd>
+  : public threaded_fftm_base<T, complex<T>, A, fft_fwd>
+{
+  typedef threaded_fftm_base<T, complex<T>, A, fft_fwd> base_type;
+  typedef typename base_type::backend_type backend_type;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  threaded_fftm(typename base_type::backends_type &b, length_type batch)
+    : base_type(b, batch) {}
+
+  virtual void out_of_place(T *in, stride_type is0, stride_type is1,
+			    complex<T> *out, stride_type os0, stride_type os1,
+			    length_type rows, length_type cols)
+  {
+    this->batches(in, is0, is1, out, os0, os1, rows, cols,
+      [&](backend_type &b, T *i, complex<T> *o, length_type r, length_type c)
+      { b.out_of_place(i, is0, is1, o, os0, os1, r, c);});
+  }
+  virtual void out_of_place(T *in, stride_type is0, stride_type is1,
+			    ztype out, stride_type os0, stride_type os1,
+			    length_type rows, length_type cols)
+  {
+    this->batches(in, is0, is1, out, os0, os1, rows, cols,
+      [&](backend_type &b, T *i, ztype o, length_type r, length_type c)
+      { b.out_of_place(i, is0, is1, o, os0, os1, r, c);});
+  }
+};
+
+/// complex -> real
+template <typename T, int A>
+class threaded_fftm<complex<T>, T, A, fft_inv>
+  : public threaded_fftm_base<complex<T>, T, A, fft_inv>
+{
+  typedef threaded_fftm_base<complex<T>, T, A, fft_inv> base_type;
+  typedef typename base_type::backend_type backend_type;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  threaded_fftm(typename base_type::backends_type &b, length_type batch)
+    : base_type(b, batch) {}
+
+  virtual void out_of_place(complex<T> *in, stride_type is0, stride_type is1,
+			    T *out, stride_type os0, stride_type os1,
+			    length_type rows, length_type cols)
+  {
+    this->batches(in, is0, is1, out, os0, os1, rows, cols,
+      [&](backend_type &b, complex<T> *i, T *o, length_type r, length_type c)
+      { b.out_of_place(i, is0, is1, o, os0, os1, r, c);});
+  }
+  virtual void out_of_place(ztype in, stride_type is0, stride_type is1,
+			    T *out, stride_type os0, stride_type os1,
+			    length_type rows, length_type cols)
+  {
+    this->batches(in, is0, is1, out, os0, os1, rows, cols,
+      [&](backend_type &b, ztype i, T *o, length_type r, length_type c)
+      { b.out_of_place(i, is0, is1, o, os0, os1, r, c);});
+  }
+};
+
+/// complex -> complex
+template <typename T, int A, int D>
+class threaded_fftm<complex<T>, complex<T>, A, D>
+  : public threaded_fftm_base<complex<T>, complex<T>, A, D>
+{
+  typedef threaded_fftm_base<complex<T>, complex<T>, A, D> base_type;
+  typedef typename base_type::backend_type backend_type;
+  typedef complex<T> ctype;
+  typedef std::pair<T*, T*> ztype;
+
+public:
+  threaded_fftm(typename base_type::backends_type &b, length_type batch)
+    : base_type(b, batch) {}
+
+  virtual void query_layout(Rt_layout<2> &inout)
+  { this->backends_[0]->query_layout(inout);}
+  virtual void query_layout(Rt_layout<2> &in, Rt_layout<2> &out)
+  { base_type::query_layout(in, out);}
+  virtual void in_place(ctype *inout, stride_type s0, stride_type s1,
+			length_type rows, length_type cols)
+  {
+    this->batches(inout, s0, s1, inout, s0, s1, rows, cols,
+      [&](backend_type &b, ctype *io, ctype *, length_type r, length_type c)
+      { b.in_place(io, s0, s1, r, c);});
+  }
+  virtual void in_place(ztype inout, stride_type s0, stride_type s1,
+			length_type rows, length_type cols)
+  {
+    this->batches(inout, s0, s1, inout, s0, s1, rows, cols,
+      [&](backend_type &b, ztype io, ztype, length_type r, length_type c)
+      { b.in_place(io, s0, s1, r, c);});
+  }
+  virtual void out_of_place(ctype *in, stride_type is0, stride_type is1,
+			    ctype *out, stride_type os0, stride_type os1,
+			    length_type rows, length_type cols)
+  {
+    this->batches(in, is0, is1, out, os0, os1, rows, cols,
+      [&](backend_type &b, ctype *i, ctype *o, length_type r, length_type c)
+      { b.out_of_place(i, is0, is1, o, os0, os1, r, c);});
+  }
+  virtual void out_of_place(ztype in, stride_type is0, stride_type is1,
+			    ztype out, stride_type os0, stride_type os1,
+			    length_type rows, length_type cols)
+  {
+    this->batches(in, is0, is1, out, os0, os1, rows, cols,
+      [&](backend_type &b, ztype i, ztype o, length_type r, length_type c)
+      { b.out_of_place(i, is0, is1, o, os0, os1, r, c);});
+  }
+};
+
+/// Create an Fftm backend through the dispatcher `Disp`, with `threads`
+/// as the requested thread count (see planning_threads()).
+///
+/// If more than one thread is to be used, the transforms are split into
+/// batches, one per thread, and a single-threaded backend is created for
+/// each. Otherwise this is equivalent to create().
+template <typename I, typename O, int A, int D, typename Disp>
+std::unique_ptr<fftm_backend<I, O, A, D> >
+create_fftm(Domain<2> const &dom, typename scalar_of<I>::type scale,
+	    unsigned int threads)
+{
+  typedef fftm_backend<I, O, A, D> backend_type;
+  thread_request request(threads);
+  // The dimension enumerating the transforms.
+  dimension_type const m = A == vsip::col ? 1 : 0;
+  length_type const mult = dom[m].size();
+  unsigned int workers = std::min<length_type>(planning_threads(dom.size()), mult);
+  length_type batch = mult;
+  if (workers > 1)
+  {
+    batch = batch_size(mult, dom[1 - m].size() * sizeof(I), workers);
+    workers = (mult + batch - 1) / batch;
+  }
+  if (workers < 2) return Disp::dispatch(dom, scale);
+
+  std::vector<std::unique_ptr<backend_type> > backends;
+  {
+    thread_request single(1);
+    Domain<2> sub = m == 0 ? Domain<2>(batch, dom[1]) : Domain<2>(dom[0], batch);
+    for (unsigned int w = 0; w != workers; ++w)
+      backends.push_back(Disp::dispatch(sub, scale));
+  }
+  return std::unique_ptr<backend_type>(new threaded_fftm<I, O, A, D>(backends, batch));
+}
+
+} // namespace ovxx::signal::fft
+} // namespace ovxx::signal
+} // namespace ovxx
+
+#endif
@@ -16,6 +16,11 @@
 #include <ovxx/view/traits.hpp>
 #include <ovxx/expr.hpp>
 #include <ovxx/view/utils.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace ovxx
 {
@@ -38,6 +43,82 @@ is_power_of_two(Domain<D> const &dom)
   return true;
 }
 
+/// Return the smallest power of two not less than `n`.
+inline length_type pow2(length_type n)
+{
+  length_type p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+/// Return the plan of type `P` for transforms of size `n` in the
+/// direction `sign`, sharing it with all other users of that plan.
+template <typename P>
+std::shared_ptr<P const> cached(length_type n, int sign)
+{
+  typedef std::map<std::pair<length_type, int>, std::weak_ptr<P const> > cache_type;
+  static std::mutex mutex;
+  static cache_type cache;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::weak_ptr<P const> &entry = cache[std::make_pair(n, sign)];
+  std::shared_ptr<P const> plan = entry.lock();
+  if (!plan)
+  {
+    plan.reset(new P(n, sign));
+    entry = plan;
+  }
+  return plan;
+}
+
+/// Below this many points per thread, splitting an FFT
+/// costs more than it gains.
+length_type const points_per_thread = 1 << 16;
+
+/// The thread count requested by the Fft or Fftm object whose
+/// backend is currently being created, or 0 if none was requested.
+/// (It can't be passed as a dispatch argument without breaking
+/// existing backend evaluators.)
+inline unsigned int &requested_threads()
+{
+  static thread_local unsigned int threads = 0;
+  return threads;
+}
+
+/// Set the requested thread count during backend creation.
+class thread_request
+{
+public:
+  explicit thread_request(unsigned int threads)
+    : previous_(requested_threads())
+  { requested_threads() = threads;}
+  ~thread_request() { requested_threads() = previous_;}
+
+private:
+  unsigned int previous_;
+};
+
+/// Return the number of threads a backend should use for a
+/// transform of the given number of points: the requested
+/// count if there is one, or else one thread per `points_per_thread`
+/// points, up to the concurrency of the library's thread pool.
+inline unsigned int planning_threads(length_type points)
+{
+  if (requested_threads()) return requested_threads();
+  thread_pool *pool = thread_pool::get_default();
+  length_type max = pool ? pool->concurrency() : 1;
+  return std::max<length_type>(1, std::min(max, points / points_per_thread));
+}
+
+/// Create a backend through the dispatcher `D`, with `threads` as
+/// the requested thread count.
+template <typename B, typename D, dimension_type Dim, typename T>
+std::unique_ptr<B>
+create(Domain<Dim> const &dom, T scale, unsigned int threads)
+{
+  thread_request request(threads);
+  return D::dispatch(dom, scale);
+}
+
 /// Determine the exponent (forward or inverse) of a given Fft
 /// from its parameters.
 template <typename I, typename O, int sD> struct exponent;
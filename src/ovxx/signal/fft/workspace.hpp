@@ -10,12 +10,19 @@
 #define ovxx_signal_fft_workspace_hpp_
 
 #include <ovxx/support.hpp>
+#include <ovxx/c++11.hpp>
 #include <ovxx/layout.hpp>
 #include <ovxx/signal/fft/backend.hpp>
 #include <ovxx/view/traits.hpp>
 #include <ovxx/adjust_layout.hpp>
 #include <ovxx/equal.hpp>
 #include <ovxx/dda.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/profile.hpp>
+#if OVXX_PROFILE
+# include <ovxx/ops_count.hpp>
+# include <algorithm>
+#endif
 
 namespace ovxx
 {
@@ -60,7 +67,7 @@ void in_place(fft_backend<1, T, T, S> &backend,
 template <typename T, int S, typename B1, typename B2>
 void out_of_place(fft_backend<1, T, T, S> &backend,
 		  storage_format_type storage_format,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -77,7 +84,7 @@ void out_of_place(fft_backend<1, T, T, S> &backend,
 template <typename T, int S, typename B1, typename B2>
 void out_of_place(fft_backend<1, T, complex<T>, S>  &backend,
 		  storage_format_type,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type storage_format,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -94,7 +101,7 @@ void out_of_place(fft_backend<1, T, complex<T>, S>  &backend,
 template <typename T, int S, typename B1, typename B2>
 void out_of_place(fft_backend<1, complex<T>, T, S>  &backend,
 		  storage_format_type storage_format,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -126,7 +133,7 @@ void in_place(fft_backend<2, T, T, S>  &backend,
 template <typename T, int S, typename B1, typename B2>
 void out_of_place(fft_backend<2, T, T, S>  &backend,
 		  storage_format_type storage_format,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -147,7 +154,7 @@ void out_of_place(fft_backend<2, T, T, S>  &backend,
 template <typename T, int S, typename B1, typename B2>
 void out_of_place(fft_backend<2, T, complex<T>, S>  &backend,
 		  storage_format_type,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type storage_format,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -168,7 +175,7 @@ void out_of_place(fft_backend<2, T, complex<T>, S>  &backend,
 template <typename T, int S, typename B1, typename B2>
 void out_of_place(fft_backend<2, complex<T>, T, S>  &backend,
 		  storage_format_type storage_format,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -212,7 +219,7 @@ void in_place(fft_backend<3, T, T, S>  &backend,
 template <typename T, int S, typename B1, typename B2>
 void out_of_place(fft_backend<3, T, T, S>  &backend,
 		  storage_format_type storage_format,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -245,7 +252,7 @@ void out_of_place(fft_backend<3, T, T, S>  &backend,
 template <typename T, int S, typename B1, typename B2>
 void out_of_place(fft_backend<3, T, complex<T>, S>  &backend,
 		  storage_format_type,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type storage_format,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -278,7 +285,7 @@ void out_of_place(fft_backend<3, T, complex<T>, S>  &backend,
 template <typename T, int S, typename B1, typename B2>
 void out_of_place(fft_backend<3, complex<T>, T, S>  &backend,
 		  storage_format_type storage_format,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -326,7 +333,7 @@ void in_place(fftm_backend<T, T, A, D>  &backend,
 template <typename T, int A, int D, typename B1, typename B2>
 void out_of_place(fftm_backend<T, T, A, D>  &backend,
 		  storage_format_type storage_format,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -347,7 +354,7 @@ void out_of_place(fftm_backend<T, T, A, D>  &backend,
 template <typename T, int A, int D, typename B1, typename B2>
 void out_of_place(fftm_backend<T, complex<T>, A, D>  &backend,
 		  storage_format_type,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type storage_format,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -368,7 +375,7 @@ void out_of_place(fftm_backend<T, complex<T>, A, D>  &backend,
 template <typename T, int A, int D, typename B1, typename B2>
 void out_of_place(fftm_backend<complex<T>, T, A, D>  &backend,
 		  storage_format_type storage_format,
-		  dda::Rt_data<B1, dda::in> &in_data,
+		  B1 &in_data,
 		  storage_format_type,
 		  dda::Rt_data<B2, dda::out> &out_data)
 {
@@ -386,6 +393,183 @@ void out_of_place(fftm_backend<complex<T>, T, A, D>  &backend,
 			 out_data.size(0), out_data.size(1));
 } 
 
+/// Windows are applied to inputs in array format (split
+/// complex ones are converted first).
+template <typename T>
+inline T const *array_ptr(T const *ptr) { return ptr;}
+template <typename T>
+inline complex<T> const *array_ptr(const_pointer<complex<T> > ptr)
+{ return ptr.template as<array>();}
+
+template <typename T>
+inline void put(T *ptr, index_type i, T value) { ptr[i] = value;}
+template <typename T>
+inline void put(std::pair<T *, T *> const &ptr, index_type i, complex<T> value)
+{
+  ptr.first[i] = value.real();
+  ptr.second[i] = value.imag();
+}
+
+/// Copy the `rows` x `cols` array at `src` to `dst`, multiplying
+/// each element by `w[c]` (if `axis` is 1) or `w[r]` (if it is 0).
+template <typename T, typename P, typename S>
+void window_copy(T const *src, stride_type s0, stride_type s1,
+		 P dst, stride_type d0, stride_type d1,
+		 length_type rows, length_type cols,
+		 S const *w, dimension_type axis)
+{
+  // Traverse the destination contiguously.
+  if (d1 <= d0)
+    for (index_type r = 0; r != rows; ++r)
+      for (index_type c = 0; c != cols; ++c)
+	put(dst, r * d0 + c * d1, src[r * s0 + c * s1] * w[axis ? c : r]);
+  else
+    for (index_type c = 0; c != cols; ++c)
+      for (index_type r = 0; r != rows; ++r)
+	put(dst, r * d0 + c * d1, src[r * s0 + c * s1] * w[axis ? c : r]);
+}
+
+/// Input data the workspace has placed in the layout a backend
+/// asked for, presented like the dda::Rt_data objects above.
+template <dimension_type D, typename T>
+class prepared_input
+{
+public:
+  typedef typename conditional<is_complex<T>::value,
+			       pointer<T>, T *>::type ptr_type;
+
+  prepared_input(ptr_type ptr, Applied_layout<Rt_layout<D> > const &layout)
+    : ptr_(ptr), layout_(layout) {}
+
+  ptr_type non_const_ptr() const { return ptr_;}
+  stride_type stride(dimension_type d) const { return layout_.stride(d);}
+  length_type size(dimension_type d) const { return layout_.size(d);}
+
+private:
+  ptr_type ptr_;
+  Applied_layout<Rt_layout<D> > layout_;
+};
+
+/// Store the windowed input in `buffer` if there is one, or else
+/// in `scratch`.
+template <dimension_type D, typename T, typename B>
+prepared_input<D, T>
+window_input(B const &in, Applied_layout<Rt_layout<D> > const &layout,
+	     T *buffer, aligned_array<T> &scratch, T const *w, dimension_type axis,
+	     T const *src, stride_type s0, stride_type s1)
+{
+  T *dst = buffer;
+  if (!dst)
+  {
+    if (scratch.size() != layout.total_size())
+    {
+      aligned_array<T> a(layout.total_size());
+      scratch = a;
+    }
+    dst = scratch.get();
+  }
+  window_copy(src, s0, s1, dst, layout.stride(0), layout.stride(D - 1),
+	      D == 1 ? 1 : in.size(D, 0), in.size(D, D - 1), w, axis);
+  return prepared_input<D, T>(dst, layout);
+}
+
+template <dimension_type D, typename T, typename B>
+prepared_input<D, complex<T> >
+window_input(B const &in, Applied_layout<Rt_layout<D> > const &layout,
+	     complex<T> *buffer, aligned_array<T> &scratch, T const *w,
+	     dimension_type axis,
+	     complex<T> const *src, stride_type s0, stride_type s1)
+{
+  length_type const total = layout.total_size();
+  bool const split = layout.storage_format() == split_complex;
+  if ((split || !buffer) && scratch.size() != 2 * total)
+  {
+    aligned_array<T> a(2 * total);
+    scratch = a;
+  }
+  stride_type const d0 = layout.stride(0), d1 = layout.stride(D - 1);
+  length_type const rows = D == 1 ? 1 : in.size(D, 0);
+  length_type const cols = in.size(D, D - 1);
+  if (split)
+  {
+    std::pair<T *, T *> dst(scratch.get(), scratch.get() + total);
+    window_copy(src, s0, s1, dst, d0, d1, rows, cols, w, axis);
+    return prepared_input<D, complex<T> >(dst, layout);
+  }
+  complex<T> *dst = buffer ? buffer : reinterpret_cast<complex<T> *>(scratch.get());
+  window_copy(src, s0, s1, dst, d0, d1, rows, cols, w, axis);
+  return prepared_input<D, complex<T> >(dst, layout);
+}
+
+/// Multiply `in` by the window `w` (along dimension `axis`) as
+/// it is copied into `rtl`, the layout the backend asked for.
+/// That copy takes the place of the one the backend would make
+/// anyway, so the window costs no extra pass over the data.
+template <dimension_type D, typename T, typename S, typename B>
+prepared_input<D, T>
+apply_window(B const &in, Rt_layout<D> const &rtl,
+	     T *buffer, aligned_array<S> &scratch, S const *w, dimension_type axis)
+{
+  Applied_layout<Rt_layout<D> > layout(rtl, extent<D>(in), sizeof(T));
+  Rt_layout<D> rtl_src = block_layout<D>(in);
+  if (rtl_src.storage_format == split_complex) rtl_src.storage_format = array;
+  dda::Rt_data<B, dda::in> src(in, rtl_src);
+  // A 1D input is a single row.
+  return window_input(in, layout, buffer, scratch, w, axis == D - 1 ? 1 : 0,
+		      array_ptr(src.ptr()), src.stride(0), src.stride(D - 1));
+}
+
+#if OVXX_PROFILE
+template <dimension_type D, typename B>
+std::string extent_tag(B const &block)
+{
+  std::ostringstream oss;
+  oss << block.size(D, 0);
+  for (dimension_type d = 1; d != D; ++d) oss << 'x' << block.size(D, d);
+  return oss.str();
+}
+
+template <typename I, typename O>
+std::string type_tag()
+{
+  return std::string(ops_count::datatype<I>::value()) + '-' +
+    ops_count::datatype<O>::value();
+}
+
+/// Tag the transforms `backend` performs for profiling.
+template <dimension_type D, typename I, typename O, int S, typename B>
+std::string event_tag(fft_backend<D, I, O, S> &backend, B const &in)
+{
+  return profile::tag(S == fft_inv ? "Fft inv" : "Fft fwd", backend.name(),
+		      type_tag<I, O>(), extent_tag<D>(in));
+}
+
+template <typename I, typename O, int A, int S, typename B>
+std::string event_tag(fftm_backend<I, O, A, S> &backend, B const &in)
+{
+  return profile::tag(S == fft_inv ? "Fftm inv" : "Fftm fwd", backend.name(),
+		      type_tag<I, O>(), extent_tag<2>(in));
+}
+
+/// Count the operations of the transforms `backend` performs.
+/// For real transforms, the larger of the input and output gives
+/// the transform size.
+template <dimension_type D, typename I, typename O, int S,
+	  typename B1, typename B2>
+double event_ops(fft_backend<D, I, O, S> &, B1 const &in, B2 const &out)
+{
+  return ops_count::fft<I, O>::value(std::max(in.size(), out.size()));
+}
+
+template <typename I, typename O, int A, int S, typename B1, typename B2>
+double event_ops(fftm_backend<I, O, A, S> &, B1 const &in, B2 const &out)
+{
+  // Fftm transforms each row (A == 0) or each column.
+  length_type const size = std::max(in.size(2, 1 - A), out.size(2, 1 - A));
+  return double(in.size(2, A)) * ops_count::fft<I, O>::value(size);
+}
+#endif
+
 } // namespace ovxx::fft::detail
 template <typename I, typename O>
 inline length_type
@@ -406,16 +590,62 @@ public:
     : scale_(scale)
   {
   }
-  
+
+  /// Multiply the input by `w` as it is copied into the layout
+  /// the backend asks for, instead of in a separate pass ahead of
+  /// the transform.
+  template <typename V>
+  void window(V w)
+  {
+    aligned_array<scalar_type> window(w.size());
+    for (index_type i = 0; i != w.size(); ++i)
+      window[i] = w.get(i);
+    window_ = window;
+  }
+
   template <typename BE, typename B1, typename B2>
   void out_of_place(BE &backend, B1 const &in, B2 &out)
   {
-    Rt_layout<1> rtl_in = block_layout<1>(in); 
-    Rt_layout<1> rtl_out = block_layout<1>(out); 
+    OVXX_PROFILE_EVENT(detail::event_tag(backend, in),
+		       detail::event_ops(backend, in, out));
+    if (window_.get()) windowed(backend, in, out);
+    else transform(backend, in, out);
+  }
+
+  template <typename BE, typename B>
+  void in_place(BE &backend, B &inout)
+  {
+    OVXX_PROFILE_EVENT(detail::event_tag(backend, inout),
+		       detail::event_ops(backend, inout, inout));
+    if (window_.get())
+    {
+      windowed(backend, inout, inout);
+      return;
+    }
+    Rt_layout<1> rtl_inout = block_layout<1>(inout); 
+    backend.query_layout(rtl_inout);
+    {
+      dda::Rt_data<B, dda::inout> data(inout, rtl_inout, backend.input_buffer());
+      detail::in_place(backend, rtl_inout.storage_format, data);
+    }
+    if (!backend.supports_scale() && scale_ != scalar_type(1.))
+    {
+      typename view_of<B>::type view(inout);
+      view *= scale_;
+    }
+  }
+
+private:
+  template <typename BE, typename B1, typename B2>
+  void windowed(BE &backend, B1 const &in, B2 &out)
+  {
+    Rt_layout<1> rtl_in = block_layout<1>(in);
+    Rt_layout<1> rtl_out = block_layout<1>(out);
     backend.query_layout(rtl_in, rtl_out);
-    bool force_copy = backend.requires_copy(rtl_in);
     {
-      dda::Rt_data<B1, dda::in> in_data(in, force_copy, rtl_in, backend.input_buffer());
+      detail::prepared_input<1, I> in_data =
+	detail::apply_window(in, rtl_in, backend.input_buffer(), scratch_,
+			     window_.get(), 0);
       dda::Rt_data<B2, dda::out> out_data(out, rtl_out, backend.output_buffer());
       detail::out_of_place(backend, rtl_in.storage_format, in_data, rtl_out.storage_format, out_data);
     }
@@ -426,24 +656,29 @@ public:
     }
   }
 
-  template <typename BE, typename B>
-  void in_place(BE &backend, B &inout)
+  template <typename BE, typename B1, typename B2>
+  void transform(BE &backend, B1 const &in, B2 &out)
   {
-    Rt_layout<1> rtl_inout = block_layout<1>(inout); 
-    backend.query_layout(rtl_inout);
+    Rt_layout<1> rtl_in = block_layout<1>(in); 
+    Rt_layout<1> rtl_out = block_layout<1>(out); 
+    backend.query_layout(rtl_in, rtl_out);
+    bool force_copy = backend.requires_copy(rtl_in);
     {
-      dda::Rt_data<B, dda::inout> data(inout, rtl_inout, backend.input_buffer());
-      detail::in_place(backend, rtl_inout.storage_format, data);
+      dda::Rt_data<B1, dda::in> in_data(in, force_copy, rtl_in, backend.input_buffer());
+      dda::Rt_data<B2, dda::out> out_data(out, rtl_out, backend.output_buffer());
+      detail::out_of_place(backend, rtl_in.storage_format, in_data, rtl_out.storage_format, out_data);
     }
     if (!backend.supports_scale() && scale_ != scalar_type(1.))
     {
-      typename view_of<B>::type view(inout);
+      typename view_of<B2>::type view(out);
       view *= scale_;
     }
   }
 
-private:
   scalar_type scale_;
+  aligned_array<scalar_type> window_;
+  // The windowed input, if the backend has no buffer of its own.
+  aligned_array<scalar_type> scratch_;
 };
 
 template <typename I, typename O>
@@ -455,19 +690,67 @@ public:
   template <typename BE>
   workspace(BE* /*backend*/, Domain<2> const &in, Domain<2> const &out,
 	    scalar_type scale)
-    : scale_(scale)
+    : scale_(scale),
+      axis_(0)
   {
   }
-  
+
+  /// Multiply the input by `w` along dimension `axis` as it is
+  /// copied into the layout the backend asks for, instead of in a
+  /// separate pass ahead of the transforms.
+  template <typename V>
+  void window(V w, dimension_type axis)
+  {
+    aligned_array<scalar_type> window(w.size());
+    for (index_type i = 0; i != w.size(); ++i)
+      window[i] = w.get(i);
+    window_ = window;
+    axis_ = axis;
+  }
+
   template <typename BE, typename B1, typename B2>
   void out_of_place(BE &backend, B1 const &in, B2 &out)
   {
-    Rt_layout<2> rtl_in = block_layout<2>(in); 
-    Rt_layout<2> rtl_out = block_layout<2>(out); 
+    OVXX_PROFILE_EVENT(detail::event_tag(backend, in),
+		       detail::event_ops(backend, in, out));
+    if (window_.get()) windowed(backend, in, out);
+    else transform(backend, in, out);
+  }
+
+  template <typename BE, typename B>
+  void in_place(BE &backend, B &inout)
+  {
+    OVXX_PROFILE_EVENT(detail::event_tag(backend, inout),
+		       detail::event_ops(backend, inout, inout));
+    if (window_.get())
+    {
+      windowed(backend, inout, inout);
+      return;
+    }
+    Rt_layout<2> rtl_inout = block_layout<2>(inout); 
+    backend.query_layout(rtl_inout);
+    {
+      dda::Rt_data<B, dda::inout> inout_data(inout, rtl_inout, backend.input_buffer());
+      detail::in_place(backend, rtl_inout.storage_format, inout_data);
+    }
+    if (!backend.supports_scale() && scale_ != scalar_type(1.))
+    {
+      typename view_of<B>::type view(inout);
+      view *= scale_;
+    }
+  }
+
+private:
+  template <typename BE, typename B1, typename B2>
+  void windowed(BE &backend, B1 const &in, B2 &out)
+  {
+    Rt_layout<2> rtl_in = block_layout<2>(in);
+    Rt_layout<2> rtl_out = block_layout<2>(out);
     backend.query_layout(rtl_in, rtl_out);
-    bool force_copy = backend.requires_copy(rtl_in);
     {
-      dda::Rt_data<B1, dda::in> in_data(in, force_copy, rtl_in, backend.input_buffer());
+      detail::prepared_input<2, I> in_data =
+	detail::apply_window(in, rtl_in, backend.input_buffer(), scratch_,
+			     window_.get(), axis_);
       dda::Rt_data<B2, dda::out> out_data(out, rtl_out, backend.output_buffer());
       detail::out_of_place(backend, rtl_in.storage_format, in_data, rtl_out.storage_format, out_data);
     }
@@ -478,24 +761,30 @@ public:
     }
   }
 
-  template <typename BE, typename B>
-  void in_place(BE &backend, B &inout)
+  template <typename BE, typename B1, typename B2>
+  void transform(BE &backend, B1 const &in, B2 &out)
   {
-    Rt_layout<2> rtl_inout = block_layout<2>(inout); 
-    backend.query_layout(rtl_inout);
+    Rt_layout<2> rtl_in = block_layout<2>(in); 
+    Rt_layout<2> rtl_out = block_layout<2>(out); 
+    backend.query_layout(rtl_in, rtl_out);
+    bool force_copy = backend.requires_copy(rtl_in);
     {
-      dda::Rt_data<B, dda::inout> inout_data(inout, rtl_inout, backend.input_buffer());
-      detail::in_place(backend, rtl_inout.storage_format, inout_data);
+      dda::Rt_data<B1, dda::in> in_data(in, force_copy, rtl_in, backend.input_buffer());
+      dda::Rt_data<B2, dda::out> out_data(out, rtl_out, backend.output_buffer());
+      detail::out_of_place(backend, rtl_in.storage_format, in_data, rtl_out.storage_format, out_data);
     }
     if (!backend.supports_scale() && scale_ != scalar_type(1.))
     {
-      typename view_of<B>::type view(inout);
+      typename view_of<B2>::type view(out);
       view *= scale_;
     }
   }
 
-private:
   scalar_type scale_;
+  aligned_array<scalar_type> window_;
+  dimension_type axis_;
+  // The windowed input, if the backend has no buffer of its own.
+  aligned_array<scalar_type> scratch_;
 };
 
 template <typename I, typename O>
@@ -514,6 +803,8 @@ public:
   template <typename BE, typename B1, typename B2>
   void out_of_place(BE &backend, B1 const &in, B2 &out)
   {
+    OVXX_PROFILE_EVENT(detail::event_tag(backend, in),
+		       detail::event_ops(backend, in, out));
     Rt_layout<3> rtl_in = block_layout<3>(in); 
     Rt_layout<3> rtl_out = block_layout<3>(out); 
     backend.query_layout(rtl_in, rtl_out);
@@ -533,6 +824,8 @@ public:
   template <typename BE, typename B>
   void in_place(BE &backend, B &inout)
   {
+    OVXX_PROFILE_EVENT(detail::event_tag(backend, inout),
+		       detail::event_ops(backend, inout, inout));
     Rt_layout<3> rtl_inout = block_layout<3>(inout); 
     backend.query_layout(rtl_inout);
     {
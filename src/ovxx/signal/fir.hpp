@@ -96,6 +96,7 @@ public:
       state_saved_(fir.state_saved_)
   {}
   virtual Fir *clone() { return new Fir(*this);}
+  virtual char const* name() { return "generic";}
 
   length_type apply(T const *in, stride_type in_stride, length_type in_length,
                     T *out, stride_type out_stride, length_type out_length)
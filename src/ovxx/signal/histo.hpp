@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_signal_histo_hpp_
+#define ovxx_signal_histo_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/dda.hpp>
+#include <ovxx/dispatch.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/detail/noncopyable.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace ovxx
+{
+namespace signal
+{
+namespace histo
+{
+/// Inputs with fewer values than this are histogrammed serially.
+inline length_type &threaded_threshold()
+{
+  static length_type threshold = 1 << 16;
+  return threshold;
+}
+
+/// Number of values whose bins are computed at once.
+length_type const block_size = 256;
+
+/// Number of interleaved copies of the histogram each thread counts
+/// into, so runs of values falling into the same bin (common in
+/// images) don't serialize on a single counter.
+length_type const copies = 4;
+
+template <typename T>
+struct is_supported
+{
+  static bool const value = is_arithmetic<T>::value;
+};
+
+/// The bin of an in-range `value`, between 1 and `last - 1`.
+/// The quotient is clamped before it is converted, as out-of-range
+/// values (and NaN) may not fit an `int`.
+template <typename T,
+	  bool I = is_integral<T>::value && sizeof(T) <= 4>
+struct bin
+{
+  static int compute(T min, T delta, int last, T value)
+  {
+    T const q = (value - min) / delta;
+    T const top = static_cast<T>(last - 2);
+    return static_cast<int>(q >= T(0) ? (q < top ? q : top) : T(0)) + 1;
+  }
+};
+
+/// There is no SIMD integer division. For integers of up to 32 bits,
+/// the truncated quotient of their conversions to double is exact.
+template <typename T>
+struct bin<T, true>
+{
+  static int compute(T min, T delta, int last, T value)
+  {
+    double const q = (double(value) - double(min)) / double(delta);
+    double const top = last - 2;
+    return static_cast<int>(q >= 0. ? (q < top ? q : top) : 0.) + 1;
+  }
+};
+
+/// Compute the bins of `n` values, spaced `stride` apart, the way
+/// vsip::impl::hist_bin() does. The loop has no branches, so the
+/// compiler can vectorize it.
+template <typename T>
+void bins(T min, T max, T delta, int last,
+	  T const *in, stride_type stride, length_type n, int *OVXX_RESTRICT out)
+{
+  if (stride == 1)
+  {
+    PRAGMA_IVDEP
+    for (index_type i = 0; i < n; ++i)
+    {
+      T const v = in[i];
+      int const b = bin<T>::compute(min, delta, last, v);
+      out[i] = !(v >= min) ? 0 : v >= max ? last : b;
+    }
+  }
+  else
+    for (index_type i = 0; i < n; ++i, in += stride)
+    {
+      T const v = *in;
+      int const b = bin<T>::compute(min, delta, last, v);
+      out[i] = !(v >= min) ? 0 : v >= max ? last : b;
+    }
+}
+
+/// A private histogram, made of `copies` interleaved copies, each
+/// padded to a whole number of cache lines so that histograms of
+/// different threads never share one.
+class counter : ovxx::detail::noncopyable
+{
+  // Counters per (64-byte) cache line.
+  static length_type const line = 64 / sizeof(int);
+
+public:
+  counter(length_type bins)
+    : bins_(bins),
+      stride_((bins + line - 1) / line * line),
+      counts_(copies * stride_)
+  {
+    std::fill(counts_.get(), counts_.get() + counts_.size(), 0);
+  }
+
+  /// Count the `n` given bins.
+  void add(int const *bin, length_type n)
+  {
+    int *c0 = counts_.get();
+    int *c1 = c0 + stride_;
+    int *c2 = c1 + stride_;
+    int *c3 = c2 + stride_;
+    index_type i = 0;
+    for (; i + copies <= n; i += copies)
+    {
+      ++c0[bin[i]];
+      ++c1[bin[i + 1]];
+      ++c2[bin[i + 2]];
+      ++c3[bin[i + 3]];
+    }
+    for (; i < n; ++i) ++c0[bin[i]];
+  }
+
+  /// Add the counts to `hist`.
+  void merge(int *hist, stride_type stride) const
+  {
+    int const *c = counts_.get();
+    for (index_type b = 0; b != bins_; ++b, hist += stride)
+      *hist += c[b] + c[stride_ + b] + c[2 * stride_ + b] + c[3 * stride_ + b];
+  }
+
+private:
+  length_type bins_;
+  length_type stride_;
+  aligned_array<int> counts_;
+};
+
+/// Histogram `rows x cols` values, `ptr[i * row_stride + j * col_stride]`,
+/// adding the counts to the `num` bins of `hist`.
+/// The values are split evenly among the threads of the default pool,
+/// each counting into its own histogram; these are summed at the end.
+template <typename T>
+void histogram(T min, T max, T const *ptr,
+	       length_type rows, stride_type row_stride,
+	       length_type cols, stride_type col_stride,
+	       int *hist, stride_type hist_stride, length_type num)
+{
+  // Visit the values in memory order, as one row if they are dense.
+  if (rows > 1 && std::abs(row_stride) < std::abs(col_stride))
+  {
+    std::swap(rows, cols);
+    std::swap(row_stride, col_stride);
+  }
+  if (rows > 1 && row_stride == static_cast<stride_type>(cols) * col_stride)
+  {
+    cols *= rows;
+    rows = 1;
+  }
+
+  T const delta = (max - min) / static_cast<T>(num - 2);
+  length_type const size = rows * cols;
+
+  // Histogram values [begin, end) into `c`.
+  auto count = [&](index_type begin, index_type end, counter &c)
+  {
+    int bin[block_size];
+    while (begin < end)
+    {
+      index_type const r = begin / cols, j = begin % cols;
+      length_type const n = std::min(std::min(end - begin, cols - j), block_size);
+      bins(min, max, delta, static_cast<int>(num - 1),
+	   ptr + r * row_stride + j * col_stride, col_stride, n, bin);
+      c.add(bin, n);
+      begin += n;
+    }
+  };
+
+  thread_pool *pool = thread_pool::get_default();
+  length_type tasks = 1;
+  if (pool && pool->concurrency() > 1 && size >= threaded_threshold())
+    tasks = std::min<length_type>(pool->concurrency(), size / std::max<length_type>(threaded_threshold() / 4, 1));
+  if (tasks > 1)
+  {
+    // Each histogram is allocated by the thread filling it.
+    std::vector<std::unique_ptr<counter> > counters(tasks);
+    pool->parallel_for(tasks, [&](index_type t)
+    {
+      counters[t].reset(new counter(num));
+      count(t * size / tasks, (t + 1) * size / tasks, *counters[t]);
+    });
+    for (index_type t = 0; t != tasks; ++t)
+      counters[t]->merge(hist, hist_stride);
+  }
+  else
+  {
+    counter c(num);
+    count(0, size, c);
+    c.merge(hist, hist_stride);
+  }
+}
+
+} // namespace ovxx::signal::histo
+} // namespace ovxx::signal
+
+namespace dispatcher
+{
+/// Histograms of directly accessible data.
+template <typename T, typename HBlock, typename DBlock>
+struct Evaluator<op::hist, be::opt, void(T, T, HBlock &, DBlock const &)>
+{
+  static bool const ct_valid =
+    signal::histo::is_supported<T>::value &&
+    is_same<typename HBlock::value_type, int>::value &&
+    dda::Data<HBlock, dda::inout>::ct_cost == 0 &&
+    dda::Data<DBlock, dda::in>::ct_cost == 0;
+  static bool rt_valid(T, T, HBlock &, DBlock const &) { return true;}
+
+  static void exec(T min, T max, HBlock &hist, DBlock const &input)
+  {
+    dda::Data<HBlock, dda::inout> h(hist);
+    dda::Data<DBlock, dda::in> data(input);
+    if (DBlock::dim == 1)
+      signal::histo::histogram(min, max, data.ptr(),
+			       1, 0, data.size(0), data.stride(0),
+			       h.ptr(), h.stride(0), h.size(0));
+    else
+      signal::histo::histogram(min, max, data.ptr(),
+			       data.size(0), data.stride(0),
+			       data.size(1), data.stride(1),
+			       h.ptr(), h.stride(0), h.size(0));
+  }
+};
+
+} // namespace ovxx::dispatcher
+} // namespace ovxx
+
+#endif
@@ -0,0 +1,279 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_signal_iir_hpp_
+#define ovxx_signal_iir_hpp_
+
+#include <vsip/support.hpp>
+#include <vsip/impl/signal/types.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/dda.hpp>
+#include <ovxx/aligned_array.hpp>
+#include <ovxx/adjust_layout.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/profile.hpp>
+#if OVXX_PROFILE
+# include <ovxx/ops_count.hpp>
+#endif
+#include <algorithm>
+
+namespace ovxx
+{
+namespace signal
+{
+namespace iir
+{
+/// The coefficients of a biquad section, as stored contiguously
+/// (section after section) by the IIR filters.
+enum { b0, b1, b2, a1, a2, coefficients};
+
+/// Number of samples run through all sections at once. A block
+/// stays in L1 while it passes through the cascade.
+length_type const block_size = 256;
+
+/// Number of channels filtered together by `Iirm`.
+length_type const width = 8;
+
+/// Filters with less work (in multiply-adds) than this are
+/// run serially by `Iirm`.
+inline length_type &threaded_threshold()
+{
+  static length_type threshold = 1 << 18;
+  return threshold;
+}
+
+/// Copy the `b` (sections x 3) and `a` (sections x 2) coefficient
+/// matrices into `c`.
+template <typename T, typename B1, typename B2>
+void pack_coefficients(const_Matrix<T, B1> b, const_Matrix<T, B2> a, T *c)
+{
+  for (index_type m = 0; m != a.size(0); ++m, c += coefficients)
+  {
+    c[b0] = b.get(m, 0);
+    c[b1] = b.get(m, 1);
+    c[b2] = b.get(m, 2);
+    c[a1] = a.get(m, 0);
+    c[a2] = a.get(m, 1);
+  }
+}
+
+/// Run `n` samples through the section with coefficients `c` and
+/// state `w` (`w[0]` the last, `w[1]` the second to last internal
+/// value). `in` and `out` may be the same.
+/// The coefficients and state are held in locals, so the recursion
+/// runs in registers.
+template <typename T>
+void section(T const *c, T *w,
+	     T const *in, stride_type in_stride,
+	     T *out, stride_type out_stride, length_type n)
+{
+  T const c_b0 = c[b0], c_b1 = c[b1], c_b2 = c[b2];
+  T const c_a1 = c[a1], c_a2 = c[a2];
+  T w1 = w[0], w2 = w[1];
+  for (index_type i = 0; i != n; ++i, in += in_stride, out += out_stride)
+  {
+    T const w0 = *in - c_a1 * w1 - c_a2 * w2;
+    *out = c_b0 * w0 + c_b1 * w1 + c_b2 * w2;
+    w2 = w1;
+    w1 = w0;
+  }
+  w[0] = w1;
+  w[1] = w2;
+}
+
+/// Run `n` samples of `sections` cascaded sections, block by block:
+/// the first section reads `in`, and all write to (and the later ones
+/// read from) `out`.
+template <typename T>
+void cascade(T const *c, T *w, length_type sections,
+	     T const *in, stride_type in_stride,
+	     T *out, stride_type out_stride, length_type n)
+{
+  for (index_type i = 0; i < n; i += block_size)
+  {
+    length_type const size = std::min(block_size, n - i);
+    T *o = out + i * out_stride;
+    section(c, w, in + i * in_stride, in_stride, o, out_stride, size);
+    for (index_type m = 1; m < sections; ++m)
+      section(c + m * coefficients, w + 2 * m, o, out_stride, o, out_stride, size);
+  }
+}
+
+/// Run `n` samples of `width` interleaved channels in `x` through
+/// one section, in place. The state `w` holds `width` last values
+/// followed by `width` second to last values. Each step of the
+/// recursion is a loop across the channels, which the compiler
+/// vectorizes.
+template <typename T>
+void lanes_section(T const *c, T *w, T *OVXX_RESTRICT x, length_type n)
+{
+  T const c_b0 = c[b0], c_b1 = c[b1], c_b2 = c[b2];
+  T const c_a1 = c[a1], c_a2 = c[a2];
+  T w1[width], w2[width];
+  std::copy(w, w + width, w1);
+  std::copy(w + width, w + 2 * width, w2);
+  for (index_type i = 0; i != n; ++i, x += width)
+  {
+    PRAGMA_IVDEP
+    for (index_type l = 0; l != width; ++l)
+    {
+      T const w0 = x[l] - c_a1 * w1[l] - c_a2 * w2[l];
+      x[l] = c_b0 * w0 + c_b1 * w1[l] + c_b2 * w2[l];
+      w2[l] = w1[l];
+      w1[l] = w0;
+    }
+  }
+  std::copy(w1, w1 + width, w);
+  std::copy(w2, w2 + width, w + width);
+}
+
+} // namespace ovxx::signal::iir
+
+/// A bank of identical IIR filters (cascades of biquad sections, as
+/// `vsip::Iir`), applied to many independent channels at once.
+///
+/// Input and output are `channels x input_size` matrices, one channel
+/// per row; every channel has its own filter state.
+/// Channels are filtered in groups of `iir::width`, interleaved such
+/// that each step of the recursion runs across a group's channels
+/// (in SIMD lanes, where the compiler vectorizes the loop). Groups
+/// are processed in parallel on the default thread pool.
+template <typename T = VSIP_DEFAULT_VALUE_TYPE,
+	  obj_state C = state_save>
+class Iirm
+{
+public:
+  static obj_state const continuous_filtering = C;
+
+  template <typename B1, typename B2>
+  Iirm(const_Matrix<T, B1> b, const_Matrix<T, B2> a,
+       length_type channels, length_type input_size)
+    VSIP_THROW((std::bad_alloc))
+    : sections_(a.size(0)),
+      channels_(channels),
+      groups_((channels + iir::width - 1) / iir::width),
+      input_size_(input_size),
+      coefficients_(sections_ * iir::coefficients),
+      state_(groups_ * sections_ * 2 * iir::width)
+  {
+    OVXX_PRECONDITION(b.size(0) == a.size(0));
+    OVXX_PRECONDITION(b.size(1) == 3);
+    OVXX_PRECONDITION(a.size(1) == 2);
+    OVXX_PRECONDITION(sections_ > 0 && channels_ > 0);
+    iir::pack_coefficients(b, a, coefficients_.get());
+    reset();
+  }
+
+  Iirm(Iirm const &iir) VSIP_THROW((std::bad_alloc))
+    : sections_(iir.sections_),
+      channels_(iir.channels_),
+      groups_(iir.groups_),
+      input_size_(iir.input_size_),
+      coefficients_(OVXX_ALLOC_ALIGNMENT, iir.coefficients_.size(),
+		    iir.coefficients_.get()),
+      state_(OVXX_ALLOC_ALIGNMENT, iir.state_.size(), iir.state_.get())
+  {}
+
+  Iirm &operator=(Iirm const &iir) VSIP_THROW((std::bad_alloc))
+  {
+    OVXX_PRECONDITION(sections_ == iir.sections_ && channels_ == iir.channels_);
+    std::copy(iir.coefficients_.get(), iir.coefficients_.get() + coefficients_.size(),
+	      coefficients_.get());
+    std::copy(iir.state_.get(), iir.state_.get() + state_.size(), state_.get());
+    input_size_ = iir.input_size_;
+    return *this;
+  }
+
+  length_type kernel_size()  const VSIP_NOTHROW { return 2 * sections_;}
+  length_type filter_order() const VSIP_NOTHROW { return 2 * sections_;}
+  length_type channels()     const VSIP_NOTHROW { return channels_;}
+  length_type input_size()   const VSIP_NOTHROW { return input_size_;}
+  length_type output_size()  const VSIP_NOTHROW { return input_size_;}
+
+  template <typename B1, typename B2>
+  Matrix<T, B2>
+  operator()(const_Matrix<T, B1> data, Matrix<T, B2> out) VSIP_NOTHROW
+  {
+    typedef typename get_block_layout<B1>::type LP1;
+    typedef typename get_block_layout<B2>::type LP2;
+    typedef typename adjust_layout_storage_format<array, LP1>::type use_LP1;
+    typedef typename adjust_layout_storage_format<array, LP2>::type use_LP2;
+
+    OVXX_PRECONDITION(data.size(0) == channels_ && data.size(1) == input_size_);
+    OVXX_PRECONDITION(out.size(0) == channels_ && out.size(1) == input_size_);
+
+    OVXX_PROFILE_EVENT
+      (profile::tag("Iirm", ops_count::datatype<T>::value(),
+		    channels_, sections_, input_size_),
+       (channels_ * ops_count::signal::iir<T>::value(input_size_, sections_)));
+
+    dda::Data<B1, dda::in, use_LP1> in_data(data.block());
+    dda::Data<B2, dda::out, use_LP2> out_data(out.block());
+    T const *in = in_data.ptr();
+    T *o = out_data.ptr();
+    stride_type const in_channel = in_data.stride(0), in_sample = in_data.stride(1);
+    stride_type const out_channel = out_data.stride(0), out_sample = out_data.stride(1);
+
+    auto filter = [&](index_type g)
+    {
+      aligned_array<T> buffer(iir::block_size * iir::width);
+      T *x = buffer.get();
+      T *w = state_.get() + g * sections_ * 2 * iir::width;
+      index_type const first = g * iir::width;
+      length_type const lanes = std::min(iir::width, channels_ - first);
+      for (index_type i = 0; i < input_size_; i += iir::block_size)
+      {
+	length_type const size = std::min(iir::block_size, input_size_ - i);
+	for (index_type l = 0; l != lanes; ++l)
+	{
+	  T const *src = in + (first + l) * in_channel + i * in_sample;
+	  for (index_type j = 0; j != size; ++j, src += in_sample)
+	    x[j * iir::width + l] = *src;
+	}
+	for (index_type l = lanes; l != iir::width; ++l)
+	  for (index_type j = 0; j != size; ++j)
+	    x[j * iir::width + l] = T();
+	for (index_type m = 0; m != sections_; ++m)
+	  iir::lanes_section(coefficients_.get() + m * iir::coefficients,
+			     w + m * 2 * iir::width, x, size);
+	for (index_type l = 0; l != lanes; ++l)
+	{
+	  T *dst = o + (first + l) * out_channel + i * out_sample;
+	  for (index_type j = 0; j != size; ++j, dst += out_sample)
+	    *dst = x[j * iir::width + l];
+	}
+      }
+    };
+
+    thread_pool *pool = thread_pool::get_default();
+    if (pool && pool->concurrency() > 1 && groups_ > 1 &&
+	channels_ * input_size_ * sections_ >= iir::threaded_threshold())
+      pool->parallel_for(groups_, filter);
+    else
+      for (index_type g = 0; g != groups_; ++g) filter(g);
+
+    if (C == state_no_save)
+      reset();
+    return out;
+  }
+
+  void reset() VSIP_NOTHROW
+  { std::fill(state_.get(), state_.get() + state_.size(), T());}
+
+private:
+  length_type sections_;
+  length_type channels_;
+  length_type groups_;
+  length_type input_size_;
+  aligned_array<T> coefficients_;
+  aligned_array<T> state_;
+};
+
+} // namespace ovxx::signal
+} // namespace ovxx
+
+#endif
@@ -13,6 +13,9 @@
 #include <ovxx/signal/window.hpp>
 #include <vsip/parallel.hpp>
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 namespace ovxx
 {
@@ -225,6 +228,53 @@ kaiser(length_type len, T beta) VSIP_THROW((std::bad_alloc))
   return v;
 }
 
+namespace
+{
+std::mutex cache_mutex;
+
+template <typename T>
+struct window_cache
+{
+  typedef std::tuple<window_type, length_type, T> key_type;
+  static std::map<key_type, const_Vector<T> > windows;
+};
+
+template <typename T>
+std::map<typename window_cache<T>::key_type, const_Vector<T> >
+window_cache<T>::windows;
+
+} // namespace <unnamed>
+
+template <typename T>
+const_Vector<T>
+cached_window(window_type w, length_type len, T param)
+  VSIP_THROW((std::bad_alloc))
+{
+  OVXX_PRECONDITION(len > 1);
+  if (w != cheby_window && w != kaiser_window) param = T();
+  typename window_cache<T>::key_type key(w, len, param);
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto i = window_cache<T>::windows.find(key);
+    if (i != window_cache<T>::windows.end()) return i->second;
+  }
+  // Compute outside the lock: Chebyshev windows run an Fft.
+  const_Vector<T> v = 
+    w == blackman_window ? blackman<T>(len) :
+    w == cheby_window ? cheby<T>(len, param) :
+    w == hanning_window ? hanning<T>(len) :
+    kaiser<T>(len, param);
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return window_cache<T>::windows.insert(std::make_pair(key, v)).first->second;
+}
+
+void clear_window_cache()
+{
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  window_cache<float>::windows.clear();
+  window_cache<double>::windows.clear();
+}
+
 template
 const_Vector<float>
 blackman(length_type len) VSIP_THROW((std::bad_alloc));
@@ -253,6 +303,13 @@ template
 const_Vector<double>
 kaiser(length_type len, double beta) VSIP_THROW((std::bad_alloc));
 
+template
+const_Vector<float>
+cached_window(window_type, length_type, float) VSIP_THROW((std::bad_alloc));
+template
+const_Vector<double>
+cached_window(window_type, length_type, double) VSIP_THROW((std::bad_alloc));
+
 } // namespace ovxx::signal
 } // namespace ovxx
 
@@ -33,6 +33,20 @@ template <typename T>
 const_Vector<T>
 kaiser(length_type len, T beta) VSIP_THROW((std::bad_alloc));
 
+enum window_type { blackman_window, cheby_window, hanning_window, kaiser_window};
+
+/// Return a window of type `w` and length `len`, computed on first
+/// request and shared by all later ones.
+/// `param` is the ripple of Chebyshev windows and the beta of Kaiser
+/// windows, and ignored for the others.
+template <typename T>
+const_Vector<T>
+cached_window(window_type w, length_type len, T param = T())
+  VSIP_THROW((std::bad_alloc));
+
+/// Release all cached windows.
+void clear_window_cache();
+
 } // namespace ovxx::signal
 } // namespace ovxx
 
@@ -67,6 +67,13 @@ extern "C"
 #  define PRAGMA_VECTOR_ALWAYS
 #endif
 
+/// Pointer aliasing qualifier.
+#if __GNUC__
+#  define OVXX_RESTRICT __restrict__
+#else
+#  define OVXX_RESTRICT
+#endif
+
 #if VSIP_HAS_EXCEPTIONS
 #  define OVXX_DO_THROW(x) throw x      ///< Wraps throw statements
 #else
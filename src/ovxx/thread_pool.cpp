@@ -0,0 +1,399 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#include <ovxx/thread_pool.hpp>
+#include <ovxx/allocator.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#if defined(__linux__)
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+namespace ovxx
+{
+namespace
+{
+// Set while the current thread executes tasks.
+thread_local bool in_region = false;
+
+// Mark the current thread as executing tasks for the
+// guard's lifetime.
+struct region_guard
+{
+  region_guard() : outer(!in_region) { in_region = true;}
+  ~region_guard() { if (outer) in_region = false;}
+  bool outer;
+};
+
+struct cpu
+{
+  cpu(int i, unsigned int n) : id(i), node(n) {}
+  int id;
+  unsigned int node;
+};
+
+#if defined(__linux__)
+// Parse a sysfs CPU list such as "0-3,8-11".
+std::vector<int> parse_cpu_list(std::string const &list)
+{
+  std::vector<int> cpus;
+  std::istringstream iss(list);
+  std::string range;
+  while (std::getline(iss, range, ','))
+  {
+    if (range.empty()) continue;
+    int first = std::atoi(range.c_str());
+    int last = first;
+    std::string::size_type dash = range.find('-');
+    if (dash != std::string::npos) last = std::atoi(range.c_str() + dash + 1);
+    for (int c = first; c <= last; ++c) cpus.push_back(c);
+  }
+  return cpus;
+}
+#endif
+
+// Return the CPUs this process may run on, together with
+// the NUMA node they belong to.
+std::vector<cpu> available_cpus()
+{
+  std::vector<cpu> cpus;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0)
+  {
+    std::vector<unsigned int> node_of(CPU_SETSIZE, 0);
+    for (unsigned int n = 0; ; ++n)
+    {
+      std::ostringstream path;
+      path << "/sys/devices/system/node/node" << n << "/cpulist";
+      std::ifstream ifs(path.str().c_str());
+      if (!ifs) break;
+      std::string list;
+      std::getline(ifs, list);
+      std::vector<int> node_cpus = parse_cpu_list(list);
+      for (std::vector<int>::iterator c = node_cpus.begin(); c != node_cpus.end(); ++c)
+	if (*c < CPU_SETSIZE) node_of[*c] = n;
+    }
+    for (int c = 0; c != CPU_SETSIZE; ++c)
+      if (CPU_ISSET(c, &set)) cpus.push_back(cpu(c, node_of[c]));
+  }
+#endif
+  if (cpus.empty())
+  {
+    unsigned int count = std::thread::hardware_concurrency();
+    for (unsigned int c = 0; c < std::max(count, 1u); ++c)
+      cpus.push_back(cpu(c, 0));
+  }
+  return cpus;
+}
+
+// Order CPUs such that consecutive entries alternate between nodes.
+std::vector<cpu> interleave_nodes(std::vector<cpu> const &cpus)
+{
+  unsigned int nodes = 0;
+  for (std::vector<cpu>::const_iterator c = cpus.begin(); c != cpus.end(); ++c)
+    nodes = std::max(nodes, c->node + 1);
+  std::vector<std::vector<cpu> > by_node(nodes);
+  for (std::vector<cpu>::const_iterator c = cpus.begin(); c != cpus.end(); ++c)
+    by_node[c->node].push_back(*c);
+  std::vector<cpu> result;
+  for (index_type i = 0; result.size() != cpus.size(); ++i)
+    for (unsigned int n = 0; n != nodes; ++n)
+      if (i < by_node[n].size()) result.push_back(by_node[n][i]);
+  return result;
+}
+
+void bind_to_cpu(int id)
+{
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(id, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+// Bind the current thread to a CPU (unless `id` is negative) for the
+// binding's lifetime, restoring the thread's affinity afterwards.
+class cpu_binding
+{
+public:
+  explicit cpu_binding(int id) : bound_(false)
+  {
+#if defined(__linux__)
+    if (id >= 0 &&
+	pthread_getaffinity_np(pthread_self(), sizeof(saved_), &saved_) == 0)
+    {
+      bind_to_cpu(id);
+      bound_ = true;
+    }
+#endif
+  }
+  ~cpu_binding()
+  {
+#if defined(__linux__)
+    if (bound_) pthread_setaffinity_np(pthread_self(), sizeof(saved_), &saved_);
+#endif
+  }
+
+private:
+  bool bound_;
+#if defined(__linux__)
+  cpu_set_t saved_;
+#endif
+};
+
+bool match_option(char const *arg, char const *name, char const *&value)
+{
+  size_t len = std::strlen(name);
+  if (std::strncmp(arg, name, len) || arg[len] != '=') return false;
+  value = arg + len + 1;
+  return true;
+}
+} // namespace <unnamed>
+
+thread_pool *thread_pool::default_ = 0;
+
+void thread_pool::parse_options(int &argc, char **&argv, parameters &p)
+{
+  int i = 1;
+  while (i < argc)
+  {
+    char const *value;
+    if (match_option(argv[i], "--ovxx-threads", value))
+    {
+      char *end;
+      long threads = std::strtol(value, &end, 10);
+      if (*end || threads < 0)
+	OVXX_DO_THROW(std::invalid_argument("invalid --ovxx-threads value"));
+      p.threads = threads;
+    }
+    else if (match_option(argv[i], "--ovxx-affinity", value))
+    {
+      if (!std::strcmp(value, "none")) p.affinity = none;
+      else if (!std::strcmp(value, "compact")) p.affinity = compact;
+      else if (!std::strcmp(value, "scatter")) p.affinity = scatter;
+      else
+	OVXX_DO_THROW(std::invalid_argument("invalid --ovxx-affinity value"));
+    }
+    else
+    {
+      ++i;
+      continue;
+    }
+    // Remove the recognized option.
+    for (int j = i; j < argc; ++j) argv[j] = argv[j + 1];
+    --argc;
+  }
+}
+
+thread_pool::thread_pool(parameters const &p)
+  : nodes_(1),
+    caller_cpu_(-1),
+    task_(0),
+    active_(0),
+    generation_(0),
+    stop_(false)
+{
+  std::vector<cpu> cpus = available_cpus();
+  if (p.affinity == scatter) cpus = interleave_nodes(cpus);
+  unsigned int threads = p.threads ? p.threads : cpus.size();
+#if !OVXX_ENABLE_THREADING
+  // Without threading support, the per-thread state of tasks and
+  // allocators is shared, so the calling thread has to run alone.
+  threads = 1;
+#endif
+
+  for (unsigned int s = 0; s != threads; ++s)
+  {
+    slots_.push_back(new slot);
+    if (p.affinity != none) slots_[s]->node = cpus[s % cpus.size()].node;
+  }
+  // Visit victims on the same node first, then all others,
+  // starting with the next slot in both cases.
+  std::vector<unsigned int> nodes;
+  for (unsigned int s = 0; s != threads; ++s)
+  {
+    slot &own = *slots_[s];
+    for (unsigned int i = 1; i != threads; ++i)
+      if (slots_[(s + i) % threads]->node == own.node)
+	own.victims.push_back((s + i) % threads);
+    for (unsigned int i = 1; i != threads; ++i)
+      if (slots_[(s + i) % threads]->node != own.node)
+	own.victims.push_back((s + i) % threads);
+    if (std::find(nodes.begin(), nodes.end(), own.node) == nodes.end())
+      nodes.push_back(own.node);
+  }
+  nodes_ = nodes.size();
+  if (p.affinity != none) caller_cpu_ = cpus[0].id;
+  for (unsigned int s = 1; s < threads; ++s)
+  {
+    int id = p.affinity == none ? -1 : cpus[s % cpus.size()].id;
+    workers_.push_back(std::thread(&thread_pool::work, this, s, id));
+  }
+}
+
+thread_pool::~thread_pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::vector<std::thread>::iterator i = workers_.begin();
+       i != workers_.end();
+       ++i)
+    i->join();
+  for (std::vector<slot *>::iterator s = slots_.begin(); s != slots_.end(); ++s)
+    delete *s;
+}
+
+bool thread_pool::in_parallel_region() { return in_region;}
+
+void thread_pool::run(length_type n, std::function<void(index_type)> const &task)
+{
+  if (!n) return;
+  // Execute serially if there is nothing to share, if we are called
+  // from within a task, or if another thread is using the pool.
+  if (n == 1 || workers_.empty() || in_region || !submit_mutex_.try_lock())
+  {
+    region_guard guard;
+    for (index_type i = 0; i != n; ++i) task(i);
+    return;
+  }
+  std::lock_guard<std::mutex> submit_lock(submit_mutex_, std::adopt_lock);
+  // The caller runs slot 0, so it needs to sit on that slot's CPU
+  // for the placement of the data it touches to be predictable.
+  // Other application threads may issue loops, too, so it is only
+  // bound for the loop's duration.
+  cpu_binding binding(caller_cpu_);
+  length_type const threads = slots_.size();
+  for (index_type s = 0; s != threads; ++s)
+  {
+    std::lock_guard<std::mutex> lock(slots_[s]->mutex);
+    slots_[s]->begin = s * n / threads;
+    slots_[s]->end = (s + 1) * n / threads;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    active_ = workers_.size();
+    ++generation_;
+  }
+  wake_.notify_all();
+  {
+    region_guard guard;
+    process(0);
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (active_) done_.wait(lock);
+    task_ = 0;
+  }
+#if OVXX_HAS_EXCEPTIONS
+  if (error_)
+  {
+    std::exception_ptr error = error_;
+    error_ = std::exception_ptr();
+    std::rethrow_exception(error);
+  }
+#endif
+}
+
+bool thread_pool::take(slot &own, index_type &begin, index_type &end)
+{
+  if (own.begin == own.end) return false;
+  // Take a quarter of the remaining range at a time, leaving the
+  // rest to be stolen.
+  length_type const size = std::max<length_type>((own.end - own.begin) / 4, 1);
+  begin = own.begin;
+  end = own.begin += size;
+  return true;
+}
+
+bool thread_pool::next(unsigned int s, index_type &first, index_type &last)
+{
+  slot &own = *slots_[s];
+  {
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (take(own, first, last)) return true;
+  }
+  for (std::vector<unsigned int>::iterator v = own.victims.begin();
+       v != own.victims.end();
+       ++v)
+  {
+    slot &victim = *slots_[*v];
+    index_type begin, end;
+    {
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (victim.begin == victim.end) continue;
+      // Steal the upper half of the victim's range.
+      begin = victim.begin + (victim.end - victim.begin) / 2;
+      end = victim.end;
+      victim.end = begin;
+    }
+    std::lock_guard<std::mutex> lock(own.mutex);
+    own.begin = begin;
+    own.end = end;
+    return take(own, first, last);
+  }
+  return false;
+}
+
+void thread_pool::process(unsigned int s)
+{
+  index_type begin, end;
+  while (next(s, begin, end))
+    for (index_type i = begin; i != end; ++i)
+    {
+#if OVXX_HAS_EXCEPTIONS
+      try { (*task_)(i);}
+      catch (...)
+      {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!error_) error_ = std::current_exception();
+      }
+#else
+      (*task_)(i);
+#endif
+    }
+}
+
+void thread_pool::work(unsigned int s, int cpu)
+{
+  if (cpu >= 0) bind_to_cpu(cpu);
+  // Tasks may allocate temporaries, so workers need
+  // their own (thread-local) default allocator.
+  int argc = 0;
+  char **argv = 0;
+  allocator::initialize(argc, argv);
+  in_region = true;
+  unsigned long generation = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (!stop_ && generation == generation_) wake_.wait(lock);
+      if (stop_) break;
+      generation = generation_;
+    }
+    process(s);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!--active_) done_.notify_one();
+    }
+  }
+  allocator::finalize();
+}
+
+} // namespace ovxx
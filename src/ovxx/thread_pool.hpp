@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.BSD file.
+
+#ifndef ovxx_thread_pool_hpp_
+#define ovxx_thread_pool_hpp_
+
+#include <ovxx/support.hpp>
+#include <ovxx/thread.hpp>
+#include <ovxx/detail/noncopyable.hpp>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <vector>
+#if OVXX_HAS_EXCEPTIONS
+# include <exception>
+#endif
+
+namespace ovxx
+{
+
+/// A persistent, work-stealing pool of worker threads.
+///
+/// The pool executes data-parallel loops: `parallel_for(n, f)` calls
+/// `f(i)` for all `i` in `[0, n)`, with the calling thread joining the
+/// workers until all calls have completed.
+///
+/// The index space is initially divided evenly among all participating
+/// threads. Each thread takes its range a quarter at a time; a thread
+/// that runs out of work steals the upper half of another thread's
+/// remaining range, preferring threads on its own NUMA node.
+///
+/// Parallel loops never nest: a loop issued from within a running
+/// loop (or while another thread holds the pool) is executed serially
+/// by the calling thread, so the library never oversubscribes the
+/// cores it was given.
+class thread_pool : detail::noncopyable
+{
+public:
+  /// How worker threads are bound to CPUs.
+  enum affinity_type
+  {
+    /// Leave thread placement to the operating system.
+    none,
+    /// Bind threads to consecutive CPUs.
+    compact,
+    /// Distribute threads round-robin over NUMA nodes,
+    /// binding each to a CPU of its node.
+    scatter
+  };
+
+  struct parameters
+  {
+    parameters() : threads(0), affinity(none) {}
+
+    /// The number of threads taking part in parallel loops,
+    /// including the calling thread. 0 selects the number of
+    /// CPUs available to the process. Without threading support,
+    /// this is always 1.
+    unsigned int threads;
+    /// With `compact` or `scatter`, the thread issuing a loop is
+    /// bound to the first CPU while it runs its part of the loop,
+    /// and its previous affinity is restored afterwards.
+    affinity_type affinity;
+  };
+
+  /// Scan the command line for thread pool options, removing
+  /// the ones that are recognized:
+  ///
+  ///   --ovxx-threads=<n>
+  ///   --ovxx-affinity=none|compact|scatter
+  static void parse_options(int &argc, char **&argv, parameters &);
+
+  explicit thread_pool(parameters const &p = parameters());
+  ~thread_pool();
+
+  /// The number of threads taking part in a parallel loop,
+  /// including the calling thread.
+  unsigned int concurrency() const { return slots_.size();}
+  /// The number of NUMA nodes the pool's threads are spread over.
+  unsigned int nodes() const { return nodes_;}
+
+  template <typename F>
+  void parallel_for(length_type n, F f)
+  {
+    std::function<void(index_type)> task(f);
+    run(n, task);
+  }
+
+  /// Return true if the calling thread currently executes a task.
+  static bool in_parallel_region();
+
+  /// Return the library's pool, or 0 if there is none.
+  static thread_pool *get_default() { return default_;}
+  static void set_default(thread_pool *p) { default_ = p;}
+
+private:
+  // Per-thread state. Slot 0 is used by the thread calling run().
+  struct slot
+  {
+    slot() : begin(0), end(0), node(0) {}
+    std::mutex mutex;
+    index_type begin;
+    index_type end;
+    unsigned int node;
+    // Other slots in the order they are visited when stealing.
+    std::vector<unsigned int> victims;
+  };
+
+  void run(length_type n, std::function<void(index_type)> const &task);
+  static bool take(slot &own, index_type &begin, index_type &end);
+  bool next(unsigned int s, index_type &begin, index_type &end);
+  void process(unsigned int s);
+  void work(unsigned int s, int cpu);
+
+  std::vector<slot *> slots_;
+  std::vector<std::thread> workers_;
+  unsigned int nodes_;
+  // The CPU the thread issuing a loop (slot 0) is bound to, or -1.
+  int caller_cpu_;
+  // Serialize parallel loops.
+  std::mutex submit_mutex_;
+  // Protect the state below.
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::function<void(index_type)> const *task_;
+  unsigned int active_;
+  std::atomic<unsigned long> generation_;
+  bool stop_;
+#if OVXX_HAS_EXCEPTIONS
+  std::exception_ptr error_;
+#endif
+
+  static thread_pool *default_;
+};
+
+} // namespace ovxx
+
+#endif
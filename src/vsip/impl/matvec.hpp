@@ -14,6 +14,7 @@
 #include <vsip/impl/promotion.hpp>
 #include <ovxx/view/fns_elementwise.hpp>
 #include <ovxx/dispatch.hpp>
+#include <ovxx/linalg/gemm.hpp>
 #ifdef OVXX_HAVE_BLAS
 # include <ovxx/lapack/blas.hpp>
 #endif
@@ -127,6 +128,7 @@ struct List<op::gemp>
 			 be::cuda,
 			 be::blas,
 			 be::cvsip,
+			 be::opt,
 			 be::generic>::type type;
 };
 
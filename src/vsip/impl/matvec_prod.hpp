@@ -31,6 +31,7 @@ struct List<op::prod>
 			 be::cuda,
 			 be::blas,
 			 be::cvsip,
+			 be::opt,
 			 be::generic>::type type;
 };
 
@@ -41,6 +42,7 @@ struct List<op::prodj>
                          be::cuda,
 			 be::blas,
 			 be::cvsip,
+			 be::opt,
 			 be::generic>::type type;
 };
 
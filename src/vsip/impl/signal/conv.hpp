@@ -16,9 +16,14 @@
 #include <ovxx/domain_utils.hpp>
 #include <vsip/impl/signal/types.hpp>
 #include <ovxx/signal/conv.hpp>
+#include <ovxx/signal/fast_conv.hpp>
 #if OVXX_HAVE_CVSIP
 # include <ovxx/cvsip/conv.hpp>
 #endif
+#include <ovxx/profile.hpp>
+#if OVXX_PROFILE
+# include <ovxx/ops_count.hpp>
+#endif
 
 namespace ovxx
 {
@@ -34,6 +39,7 @@ struct List<op::conv<D, S, R, T, N, H> >
 {
   typedef make_type_list<be::user,
 			 be::cvsip,
+			 be::opt,
 			 be::generic>::type type;
 };
 template <dimension_type D,
@@ -63,8 +69,9 @@ class Convolution : public ovxx::dispatcher::Dispatcher<
 {
   static dimension_type const dim = ovxx::dim_of_view<V>::dim;
 
-  typedef typename ovxx::dispatcher::Dispatcher<
-    ovxx::dispatcher::op::conv<dim, S, R, T, N, H> >::type base_type;
+  typedef ovxx::dispatcher::Dispatcher<
+    ovxx::dispatcher::op::conv<dim, S, R, T, N, H> > dispatcher_type;
+  typedef typename dispatcher_type::type base_type;
 
 public:
   template <typename Block>
@@ -90,6 +97,7 @@ public:
       OVXX_PRECONDITION(in.size(d) == this->input_size()[d].size());
     for (dimension_type d=0; d<dim; ++d)
       OVXX_PRECONDITION(out.size(d) == this->output_size()[d].size());
+    OVXX_PROFILE_EVENT(event_tag(), event_ops());
     this->convolve(in, out);
     return out;
   }
@@ -102,9 +110,26 @@ public:
       OVXX_PRECONDITION(in.size(d) == this->input_size()[d].size());
     for (dimension_type d=0; d<dim; ++d)
       OVXX_PRECONDITION(out.size(d) == this->output_size()[d].size());
+    OVXX_PROFILE_EVENT(event_tag(), event_ops());
     this->convolve(in, out);
     return out;
   }
+
+private:
+#if OVXX_PROFILE
+  std::string event_tag() const
+  {
+    std::string op = std::string("Convolution ") +
+      ovxx::dispatcher::detail::backend_name<typename dispatcher_type::backend>::name();
+    return ovxx::ops_count::signal::description<dim, T>::tag
+      (op.c_str(), ovxx::extent(this->output_size()), ovxx::extent(this->kernel_size()));
+  }
+  double event_ops() const
+  {
+    return ovxx::ops_count::signal::conv<dim, T>::value
+      (ovxx::extent(this->output_size()), ovxx::extent(this->kernel_size()));
+  }
+#endif
 };
 
 } // namespace vsip
@@ -15,6 +15,11 @@
 #include <vsip/matrix.hpp>
 #include <vsip/impl/signal/types.hpp>
 #include <ovxx/signal/corr.hpp>
+#include <ovxx/signal/fast_conv.hpp>
+#include <ovxx/profile.hpp>
+#if OVXX_PROFILE
+# include <ovxx/ops_count.hpp>
+#endif
 #if OVXX_HAVE_CVSIP
 # include <ovxx/cvsip/corr.hpp>
 #endif
@@ -32,8 +37,8 @@ struct List<op::corr<D, R, T, N, H> >
 {
   typedef make_type_list<be::user,
                          be::cuda,
-			 be::opt,
 			 be::cvsip,
+			 be::opt,
 			 be::generic>::type type;
 };
 
@@ -64,9 +69,9 @@ class Correlation
 {
   static dimension_type const dim = ovxx::dim_of_view<V>::dim;
 
-  typedef typename 
-  ovxx::dispatcher::Dispatcher<
-    ovxx::dispatcher::op::corr<dim, R, T, N, A> >::type base_type;
+  typedef ovxx::dispatcher::Dispatcher<
+    ovxx::dispatcher::op::corr<dim, R, T, N, A> > dispatcher_type;
+  typedef typename dispatcher_type::type base_type;
 
 public:
   Correlation(Domain<dim> const&   ref_size,
@@ -96,6 +101,7 @@ public:
       OVXX_PRECONDITION(out.size(d) == this->output_size()[d].size());
     }
 
+    OVXX_PROFILE_EVENT(event_tag(), event_ops());
     this->correlate(bias, ref, in, out);
 
     return out;
@@ -116,9 +122,26 @@ public:
       OVXX_PRECONDITION(out.size(d) == this->output_size()[d].size());
     }
 
+    OVXX_PROFILE_EVENT(event_tag(), event_ops());
     this->correlate(bias, ref, in, out);
     return out;
   }
+
+private:
+#if OVXX_PROFILE
+  std::string event_tag() const
+  {
+    std::string op = std::string("Correlation ") +
+      ovxx::dispatcher::detail::backend_name<typename dispatcher_type::backend>::name();
+    return ovxx::ops_count::signal::description<dim, T>::tag
+      (op.c_str(), ovxx::extent(this->output_size()), ovxx::extent(this->reference_size()));
+  }
+  double event_ops() const
+  {
+    return ovxx::ops_count::signal::corr<dim, T>::value
+      (ovxx::extent(this->output_size()), ovxx::extent(this->reference_size()));
+  }
+#endif
 };
 
 } // namespace vsip
@@ -97,9 +97,32 @@ public:
   /// Arguments:
   ///   :dom:   The domain of the view to be operated on.
   ///   :scale: A scalar factor to be applied to the result.
-  Fft(Domain<dim> const& dom, typename base::scalar_type scale)
+  ///   :threads: The number of threads the backend may use.
+  ///             0 (the default) lets the backend decide, based on
+  ///             the size of the transform.
+  Fft(Domain<dim> const& dom, typename base::scalar_type scale,
+      unsigned int threads = 0)
     VSIP_THROW((std::bad_alloc)) 
-    : base(dom, scale) {}
+    : base(dom, scale, threads) {}
+
+  /// Create a 1D :literal:`Fft` object that multiplies its input by
+  /// :literal:`window` (for example one of the cached windows from
+  /// :literal:`ovxx::signal::cached_window`). The multiplication is
+  /// done while the input is copied into the transform's buffer,
+  /// saving the separate pass over the data an explicit :literal:`vmul`
+  /// would take.
+  ///
+  /// Arguments:
+  ///   :dom:   The domain of the view to be operated on.
+  ///   :scale: A scalar factor to be applied to the result.
+  ///   :window: The window, of the same size as the input.
+  ///   :threads: The number of threads the backend may use.
+  template <typename B>
+  Fft(Domain<dim> const& dom, typename base::scalar_type scale,
+      const_Vector<typename base::scalar_type, B> window,
+      unsigned int threads = 0)
+    VSIP_THROW((std::bad_alloc)) 
+    : base(dom, scale, window, threads) {}
 };
 
 /// FFTM operation type.
@@ -155,9 +178,29 @@ public:
   /// Arguments:
   ///   :dom: The domain of the matrix to be operated on.
   ///   :scale: A scalar factor to be applied to the result.
-  Fftm(Domain<2> const& dom, typename base::scalar_type scale)
+  ///   :threads: The number of threads the transforms are spread over,
+  ///             each running a batch of them. 0 (the default) decides
+  ///             based on the size of the transforms.
+  Fftm(Domain<2> const& dom, typename base::scalar_type scale,
+       unsigned int threads = 0)
+    VSIP_THROW((std::bad_alloc))
+    : base(dom, scale, threads) {}
+
+  /// Create an :literal:`Fftm` object that multiplies each input row
+  /// (or column, depending on the orientation) by :literal:`window`,
+  /// while it is copied into the transforms' buffer.
+  ///
+  /// Arguments:
+  ///   :dom: The domain of the matrix to be operated on.
+  ///   :scale: A scalar factor to be applied to the result.
+  ///   :window: The window, of the size of an input row (or column).
+  ///   :threads: The number of threads the transforms are spread over.
+  template <typename B>
+  Fftm(Domain<2> const& dom, typename base::scalar_type scale,
+       const_Vector<typename base::scalar_type, B> window,
+       unsigned int threads = 0)
     VSIP_THROW((std::bad_alloc))
-    : base(dom, scale) {}
+    : base(dom, scale, window, threads) {}
 };
 
 } // namespace vsip
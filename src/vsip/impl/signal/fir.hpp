@@ -16,7 +16,12 @@
 #include <vsip/dda.hpp>
 #include <ovxx/aligned_array.hpp>
 #include <ovxx/signal/fir.hpp>
+#include <ovxx/signal/fast_fir.hpp>
 #include <ovxx/dispatch.hpp>
+#include <ovxx/profile.hpp>
+#if OVXX_PROFILE
+# include <ovxx/ops_count.hpp>
+#endif
 #if OVXX_HAVE_CVSIP
 # include <ovxx/cvsip/fir.hpp>
 #endif
@@ -30,6 +35,7 @@ struct List<op::fir>
 {
   typedef make_type_list<be::user,
 			 be::cuda,
+			 be::opt,
 			 be::generic,
 			 be::cvsip>::type type;
 };
@@ -117,6 +123,14 @@ public:
     OVXX_PRECONDITION(in.size() == backend_->input_size());
     OVXX_PRECONDITION(out.size() == backend_->output_size());
 
+    OVXX_PROFILE_EVENT
+      (ovxx::profile::tag("Fir", backend_->name(),
+			  ovxx::ops_count::datatype<T>::value(),
+			  backend_->kernel_size(), backend_->input_size()),
+       (ovxx::ops_count::signal::fir<T>::value
+	(backend_->kernel_size() - 1, backend_->input_size(),
+	 backend_->decimation())));
+
     typedef typename get_block_layout<Block0>::type LP0;
     typedef typename get_block_layout<Block1>::type LP1;
     typedef typename adjust_layout_storage_format<array, LP0>::type use_LP0;
@@ -13,18 +13,24 @@
 #include <vsip/vector.hpp>
 #include <vsip/matrix.hpp>
 #include <ovxx/dispatch.hpp>
+#include <ovxx/signal/histo.hpp>
+#include <algorithm>
 
 namespace vsip
 {
 namespace impl
 {
+/// Values below `min` go to the first bin, values at or above `max`
+/// to the last. Values in range go to the bins in between; with
+/// integral types, `delta` may be rounded down, so the last of these
+/// also collects the remainder of the range. NaN goes to the first bin.
 template <typename T>
 inline index_type
 hist_bin(T min, T max, T delta, length_type num, T value)
 {
-  if (value < min) return 0;
+  if (!(value >= min)) return 0;
   else if (value >= max) return num - 1;
-  else return (index_type)(((value - min) / delta) + 1);
+  else return std::min((index_type)(((value - min) / delta) + 1), num - 2);
 } 
 
 template <dimension_type D>
@@ -75,6 +81,7 @@ template<>
 struct List<op::hist>
 {
   typedef make_type_list<be::user,
+			 be::opt,
 			 be::generic>::type type;
 };
 
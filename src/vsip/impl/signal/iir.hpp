@@ -11,10 +11,18 @@
 
 #include <vsip/support.hpp>
 #include <vsip/impl/signal/types.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/dda.hpp>
+#include <ovxx/signal/iir.hpp>
 
 namespace vsip
 {
 
+/// The coefficients and the state of all sections are kept in
+/// contiguous arrays, and each section runs through a block of
+/// samples at a time with its state in registers
+/// (see ovxx::signal::iir::cascade).
 template <typename      T = VSIP_DEFAULT_VALUE_TYPE,
 	  obj_state     C = state_save,
 	  unsigned      N = 0,
@@ -27,45 +35,42 @@ public:
   template <typename B1, typename B2>
   Iir(const_Matrix<T, B1> b, const_Matrix<T, B2> a, length_type i)
     VSIP_THROW((std::bad_alloc))
-  : b_(b.size(0), b.size(1)),
-    a_(a.size(0), a.size(1)),
-    w_(b_.size(0), 2, T()),
+  : sections_(a.size(0)),
+    coefficients_(sections_ * ovxx::signal::iir::coefficients),
+    state_(2 * sections_),
     input_size_(i)
   {
-    OVXX_PRECONDITION(b_.size(0) == a_.size(0));
-    OVXX_PRECONDITION(b_.size(1) == 3);
-    OVXX_PRECONDITION(a_.size(1) == 2);
+    OVXX_PRECONDITION(b.size(0) == a.size(0));
+    OVXX_PRECONDITION(b.size(1) == 3);
+    OVXX_PRECONDITION(a.size(1) == 2);
     
-    b_ = b;
-    a_ = a;
+    ovxx::signal::iir::pack_coefficients(b, a, coefficients_.get());
+    reset();
   }
 
   Iir(Iir const &iir) VSIP_THROW((std::bad_alloc))
-    : b_(iir.b_.size(0), 3),
-      a_(iir.a_.size(0), 2),
-      w_(b_.size(0), 2),
+    : sections_(iir.sections_),
+      coefficients_(OVXX_ALLOC_ALIGNMENT, iir.coefficients_.size(),
+		    iir.coefficients_.get()),
+      state_(OVXX_ALLOC_ALIGNMENT, iir.state_.size(), iir.state_.get()),
       input_size_(iir.input_size_)
-  {
-    b_ = iir.b_;
-    a_ = iir.a_;
-    w_ = iir.w_;
-  }
+  {}
 
   Iir& operator=(Iir const &iir) VSIP_THROW((std::bad_alloc))
   {
     OVXX_PRECONDITION(this->kernel_size() == iir.kernel_size());
 
-    b_ = iir.b_;
-    a_ = iir.a_;
-    w_ = iir.w_;
+    std::copy(iir.coefficients_.get(), iir.coefficients_.get() + coefficients_.size(),
+	      coefficients_.get());
+    std::copy(iir.state_.get(), iir.state_.get() + state_.size(), state_.get());
 
     input_size_ = iir.input_size_;
 
     return *this;
   }
 
-  length_type kernel_size()  const VSIP_NOTHROW { return 2 * a_.size(0);}
-  length_type filter_order() const VSIP_NOTHROW { return 2 * a_.size(0);}
+  length_type kernel_size()  const VSIP_NOTHROW { return 2 * sections_;}
+  length_type filter_order() const VSIP_NOTHROW { return 2 * sections_;}
   length_type input_size()   const VSIP_NOTHROW { return input_size_;}
   length_type output_size()  const VSIP_NOTHROW { return input_size_;}
 
@@ -81,13 +86,14 @@ public:
   Vector<T, B2> operator()(const_Vector<T, B1>, Vector<T, B2>)
     VSIP_NOTHROW;
 
-  void reset() VSIP_NOTHROW { w_ = T();}
+  void reset() VSIP_NOTHROW
+  { std::fill(state_.get(), state_.get() + state_.size(), T());}
 
 private:
-  Matrix<T>   b_;
-  Matrix<T>   a_;
-  Matrix<T>   w_;
-  length_type input_size_;
+  length_type            sections_;
+  ovxx::aligned_array<T> coefficients_;
+  ovxx::aligned_array<T> state_;
+  length_type            input_size_;
 };
 
 template <typename      T,
@@ -99,40 +105,25 @@ Vector<T, B2>
 Iir<T, C, N, H>::operator()(const_Vector<T, B1> data, Vector<T, B2> out)
   VSIP_NOTHROW
 {
-  index_type const a1 = 0;
-  index_type const a2 = 1;
-
-  index_type const b0 = 0;
-  index_type const b1 = 1;
-  index_type const b2 = 2;
-
-  index_type const w1 = 0;
-  index_type const w2 = 1;
+  typedef typename get_block_layout<B1>::type LP1;
+  typedef typename get_block_layout<B2>::type LP2;
+  typedef typename ovxx::adjust_layout_storage_format<array, LP1>::type use_LP1;
+  typedef typename ovxx::adjust_layout_storage_format<array, LP2>::type use_LP2;
 
   OVXX_PRECONDITION(data.size() == this->input_size());
   OVXX_PRECONDITION(out.size()  == this->output_size());
 
-  length_type const m_max = a_.size(0);
+  OVXX_PROFILE_EVENT
+    (ovxx::profile::tag("Iir", ovxx::ops_count::datatype<T>::value(),
+			sections_, input_size_),
+     (ovxx::ops_count::signal::iir<T>::value(input_size_, sections_)));
 
-  for (index_type i=0; i<out.size(); ++i)
   {
-    T val = data(i);
-
-    for (index_type m=0; m < m_max; ++m)
-    {
-      T w0 = val
-	   - a_.get(m, a1) * w_.get(m, w1)
-	   - a_.get(m, a2) * w_.get(m, w2);
-
-      val  = b_.get(m, b0) * w0
-	   + b_.get(m, b1) * w_.get(m, w1)
-	   + b_.get(m, b2) * w_.get(m, w2);
-
-      w_.put(m, w2, w_.get(m, w1));
-      w_.put(m, w1, w0);
-    }
-
-    out.put(i, val);
+    dda::Data<B1, dda::in, use_LP1> in_data(data.block());
+    dda::Data<B2, dda::out, use_LP2> out_data(out.block());
+    ovxx::signal::iir::cascade(coefficients_.get(), state_.get(), sections_,
+			       in_data.ptr(), in_data.stride(0),
+			       out_data.ptr(), out_data.stride(0), out.size());
   }
 
   if (C == state_no_save)
@@ -19,7 +19,7 @@ const_Vector<float>
 blackman(length_type len) VSIP_THROW((std::bad_alloc))
 {
   OVXX_PRECONDITION(len > 1);
-  return ovxx::signal::blackman<float>(len);
+  return ovxx::signal::cached_window<float>(ovxx::signal::blackman_window, len);
 }
 
 // Generates Chebyshev window
@@ -27,7 +27,7 @@ const_Vector<float>
 cheby(length_type len, float ripple) VSIP_THROW((std::bad_alloc))
 {
   OVXX_PRECONDITION(len > 1);
-  return ovxx::signal::cheby<float>(len, ripple);
+  return ovxx::signal::cached_window<float>(ovxx::signal::cheby_window, len, ripple);
 }
 
 // Generates Hanning window
@@ -35,7 +35,7 @@ const_Vector<float>
 hanning(length_type len) VSIP_THROW((std::bad_alloc))
 {
   OVXX_PRECONDITION(len > 1);
-  return ovxx::signal::hanning<float>(len);
+  return ovxx::signal::cached_window<float>(ovxx::signal::hanning_window, len);
 }
 
 // Generates Kaiser window
@@ -43,7 +43,7 @@ const_Vector<float>
 kaiser(length_type len, float beta) VSIP_THROW((std::bad_alloc))
 {
   OVXX_PRECONDITION(len > 1);
-  return ovxx::signal::kaiser<float>(len, beta);
+  return ovxx::signal::cached_window<float>(ovxx::signal::kaiser_window, len, beta);
 }
 
 } // namespace vsip
@@ -21,6 +21,7 @@
 #ifdef OVXX_HAVE_CVSIP
 #  include <ovxx/cvsip/cholesky.hpp>
 #endif
+#include <ovxx/linalg/cholesky.hpp>
 
 namespace ovxx
 {
@@ -31,7 +32,8 @@ struct List<op::chold>
 {
   typedef make_type_list<be::user,
 			 be::cvsip,
-			 be::lapack>::type type;
+			 be::lapack,
+			 be::opt>::type type;
 };
 
 } // namespace ovxx::dispatcher
@@ -61,11 +63,22 @@ public:
   mat_uplo uplo() const VSIP_NOTHROW { return backend_.uplo();}
 
   template <typename Block>
-  bool decompose(Matrix<T, Block> m) VSIP_NOTHROW { return backend_.decompose(m);}
+  bool decompose(Matrix<T, Block> m) VSIP_NOTHROW
+  {
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::chold, T>
+			("chold decompose", length(), length())),
+		       ovxx::ops_count::solver::chold<T>::decompose(length()));
+    return backend_.decompose(m);
+  }
 
   template <typename Block0, typename Block1>
   bool solve(const_Matrix<T, Block0> b, Matrix<T, Block1> x) VSIP_NOTHROW
-  { return backend_.solve(b, x);}
+  {
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::chold, T>
+			("chold solve", b.size(0), b.size(1))),
+		       ovxx::ops_count::solver::chold<T>::solve(length(), b.size(1)));
+    return backend_.solve(b, x);
+  }
 
 private:
   backend_type backend_;
@@ -87,13 +100,22 @@ public:
   mat_uplo    uplo()  const VSIP_NOTHROW { return backend_.uplo();}
 
   template <typename Block>
-  bool decompose(Matrix<T, Block> m) VSIP_NOTHROW { return backend_.decompose(m);}
+  bool decompose(Matrix<T, Block> m) VSIP_NOTHROW
+  {
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::chold, T>
+			("chold decompose", length(), length())),
+		       ovxx::ops_count::solver::chold<T>::decompose(length()));
+    return backend_.decompose(m);
+  }
 
   template <typename Block0>
   Matrix<T>
   solve(const_Matrix<T, Block0> b) VSIP_NOTHROW
   {
     Matrix<T> x(b.size(0), b.size(1));
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::chold, T>
+			("chold solve", b.size(0), b.size(1))),
+		       ovxx::ops_count::solver::chold<T>::solve(length(), b.size(1)));
     backend_.solve(b, x); 
     return x;
   }
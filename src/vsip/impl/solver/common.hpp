@@ -10,6 +10,11 @@
 #define vsip_impl_solver_common_hpp_
 
 #include <vsip/impl/math_enum.hpp>
+#include <ovxx/profile.hpp>
+#if OVXX_PROFILE
+# include <ovxx/dispatch.hpp>
+# include <ovxx/ops_count.hpp>
+#endif
 
 namespace vsip
 {
@@ -22,4 +27,23 @@ enum mat_uplo
 
 } // namespace vsip
 
+#if OVXX_PROFILE
+namespace ovxx
+{
+namespace solver
+{
+/// Tag a solver event with the backend `O` dispatches to.
+template <typename O, typename T>
+std::string event_tag(char const *op, length_type rows, length_type cols)
+{
+  typedef typename dispatcher::Dispatcher<O, T>::backend backend;
+  std::ostringstream oss;
+  oss << rows << 'x' << cols;
+  return profile::tag(op, dispatcher::detail::backend_name<backend>::name(),
+		      ops_count::datatype<T>::value(), oss.str());
+}
+} // namespace ovxx::solver
+} // namespace ovxx
+#endif
+
 #endif
@@ -21,6 +21,7 @@
 #ifdef OVXX_HAVE_CVSIP
 #  include <ovxx/cvsip/lu.hpp>
 #endif
+#include <ovxx/linalg/lu.hpp>
 
 namespace ovxx
 {
@@ -31,7 +32,8 @@ struct List<op::lud>
 {
   typedef make_type_list<be::user,
 			 be::cvsip,
-			 be::lapack>::type type;
+			 be::lapack,
+			 be::opt>::type type;
 };
 
 } // namespace ovxx::dispatcher
@@ -59,11 +61,21 @@ public:
 
   template <typename Block>
   bool decompose(Matrix<T, Block> m) VSIP_NOTHROW
-  { return backend_.decompose(m);}
+  {
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::lud, T>
+			("lud decompose", length(), length())),
+		       ovxx::ops_count::solver::lud<T>::decompose(length()));
+    return backend_.decompose(m);
+  }
 
   template <mat_op_type tr, typename Block0, typename Block1>
   bool solve(const_Matrix<T, Block0> b, Matrix<T, Block1> x) VSIP_NOTHROW
-  { return backend_.template solve<tr>(b, x);}
+  {
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::lud, T>
+			("lud solve", b.size(0), b.size(1))),
+		       ovxx::ops_count::solver::lud<T>::solve(length(), b.size(1)));
+    return backend_.template solve<tr>(b, x);
+  }
 private:
   backend_type backend_;
 };
@@ -83,12 +95,20 @@ public:
 
   template <typename Block>
   bool decompose(Matrix<T, Block> m) VSIP_NOTHROW
-  { return backend_.decompose(m);}
+  {
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::lud, T>
+			("lud decompose", length(), length())),
+		       ovxx::ops_count::solver::lud<T>::decompose(length()));
+    return backend_.decompose(m);
+  }
 
   template <mat_op_type tr, typename Block0>
   Matrix<T> solve(const_Matrix<T, Block0> b) VSIP_NOTHROW
   {
     Matrix<T> x(b.size(0), b.size(1));
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::lud, T>
+			("lud solve", b.size(0), b.size(1))),
+		       ovxx::ops_count::solver::lud<T>::solve(length(), b.size(1)));
     backend_.template solve<tr>(b, x); 
     return x;
   }
@@ -21,6 +21,7 @@
 #ifdef OVXX_HAVE_CVSIP
 #  include <ovxx/cvsip/qr.hpp>
 #endif
+#include <ovxx/linalg/qr.hpp>
 
 namespace ovxx
 {
@@ -32,7 +33,8 @@ struct List<op::qrd>
   typedef make_type_list<be::user,
 			 be::cuda,
 			 be::cvsip,
-			 be::lapack>::type type;
+			 be::lapack,
+			 be::opt>::type type;
 };
 
 } // namespace ovxx::dispatcher
@@ -75,7 +77,13 @@ public:
   storage_type qstorage() const VSIP_NOTHROW { return backend_.qstorage();}
 
   template <typename Block>
-  bool decompose(Matrix<T, Block> m) VSIP_NOTHROW { return backend_.decompose(m);}
+  bool decompose(Matrix<T, Block> m) VSIP_NOTHROW
+  {
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::qrd, T>
+			("qrd decompose", rows(), columns())),
+		       ovxx::ops_count::solver::qrd<T>::decompose(rows(), columns()));
+    return backend_.decompose(m);
+  }
 
   template <mat_op_type tr, product_side_type ps,
 	    typename Block0, typename Block1>
@@ -118,7 +126,13 @@ public:
   storage_type qstorage() const VSIP_NOTHROW { return backend_.qstorage();}
 
   template <typename Block>
-  bool decompose(Matrix<T, Block> m) VSIP_NOTHROW { return backend_.decompose(m);}
+  bool decompose(Matrix<T, Block> m) VSIP_NOTHROW
+  {
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::qrd, T>
+			("qrd decompose", rows(), columns())),
+		       ovxx::ops_count::solver::qrd<T>::decompose(rows(), columns()));
+    return backend_.decompose(m);
+  }
 
   template <mat_op_type tr, product_side_type ps, typename Block0>
   Matrix<T>
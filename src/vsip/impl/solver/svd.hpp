@@ -14,6 +14,7 @@
 #include <vsip/matrix.hpp>
 #include <vsip/math.hpp>
 #include <vsip/impl/math_enum.hpp>
+#include <vsip/impl/solver/common.hpp>
 #include <ovxx/dispatch.hpp>
 #ifdef OVXX_HAVE_LAPACK
 #  include <ovxx/lapack/svd.hpp>
@@ -62,7 +63,13 @@ public:
 
   template <typename Block0, typename Block1>
   bool decompose(Matrix<T, Block0> m, Vector<S, Block1> dest) VSIP_NOTHROW
-  { return backend_.decompose(m, dest);}
+  {
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::svd, T>
+			("svd decompose", rows(), columns())),
+		       ovxx::ops_count::solver::svd<T>::decompose
+		       (std::max(rows(), columns()), std::min(rows(), columns())));
+    return backend_.decompose(m, dest);
+  }
 
   template <mat_op_type       tr,
 	    product_side_type ps,
@@ -112,6 +119,10 @@ public:
   decompose(Matrix<T, Block0> m) VSIP_THROW((std::bad_alloc, computation_error))
   {
     Vector<S> dest(backend_.order());
+    OVXX_PROFILE_EVENT((ovxx::solver::event_tag<ovxx::dispatcher::op::svd, T>
+			("svd decompose", rows(), columns())),
+		       ovxx::ops_count::solver::svd<T>::decompose
+		       (std::max(rows(), columns()), std::min(rows(), columns())));
     if (!backend_.decompose(m, dest))
       OVXX_DO_THROW(computation_error("svd::decompose"));
     return dest;
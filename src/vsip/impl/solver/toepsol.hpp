@@ -13,6 +13,7 @@
 #include <vsip/support.hpp>
 #include <vsip/matrix.hpp>
 #include <vsip/math.hpp>
+#include <ovxx/linalg/toeplitz.hpp>
 
 namespace vsip
 {
@@ -50,56 +51,16 @@ toepsol(const_Vector<T, Block0> t,
 	Vector<T, Block3>       x)
 VSIP_THROW((std::bad_alloc, computation_error))
 {
-  typedef typename ovxx::scalar_of<T>::type scalar_type;
-
   OVXX_PRECONDITION(t.size() == b.size());
   OVXX_PRECONDITION(t.size() == y.size());
   OVXX_PRECONDITION(t.size() == x.size());
 
-  length_type n = t.size();
-
-
-  typename const_Vector<T, Block0>::subview_type r = t(Domain<1>(1, 1, n-1));
-  Vector<T> tmpv(n);
-
-  scalar_type beta  = 1.0;
-  scalar_type scale = ovxx::math::impl_real(t.get(0));
-  T           alpha = ovxx::math::impl_conj(-r.get(0)/scale);
-  T           tmps; 
-  
-  alpha = ovxx::math::impl_conj(-r.get(0)/scale);
-  
-  y.put(0, alpha);
-  x.put(0, b.get(0) / scale);
-
-  for (index_type k=1; k<n; ++k)
-  {
-    beta *= (1.0 - magsq(alpha));
-    if (beta == 0.0)
-    { 
-      OVXX_DO_THROW(computation_error("TOEPSOL: not full rank"));
-    } 
-
-    tmps = dot(impl_conj(r(Domain<1>(k))), x(Domain<1>(k-1, -1, k)));
-    T mu = (b.get(k) - tmps) / (scale*beta);
-
-    // x(Domain<1>(k)) += mu * impl_conj(y(Domain<1>(k-1, -1, k)));
-    x(Domain<1>(k)) = mu * impl_conj(y(Domain<1>(k-1, -1, k)))
-                    + x(Domain<1>(k));
-    x.put(k, mu);
-
-    if (k < (n - 1))
-    {
-      tmps  = dot(impl_conj(r(Domain<1>(k))), y(Domain<1>(k-1, -1, k)));
-      alpha = -(tmps + ovxx::math::impl_conj(r.get(k))) / (scale*beta);
-      
-      tmpv(Domain<1>(k)) = alpha * impl_conj(y(Domain<1>(k-1, -1, k))) 
-	                 + y(Domain<1>(k));
-      y(Domain<1>(k)) = tmpv(Domain<1>(k));
-      y.put(k, alpha);
-    }
-  }
-
+  ovxx::linalg::toepsol(t, b, y, x,
+    ovxx::integral_constant<bool,
+      ovxx::parallel::is_local_map<typename Block0::map_type>::value &&
+      ovxx::parallel::is_local_map<typename Block1::map_type>::value &&
+      ovxx::parallel::is_local_map<typename Block2::map_type>::value &&
+      ovxx::parallel::is_local_map<typename Block3::map_type>::value>());
   return x;
 }
 
@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+#ifndef test_thread_hpp_
+#define test_thread_hpp_
+
+#include <vsip/support.hpp>
+#include <ovxx/thread_pool.hpp>
+
+namespace test
+{
+/// Run `f` with a default thread pool of `threads` threads, or
+/// without a thread pool if `threads` is 0. The previous default
+/// pool is restored afterwards.
+template <typename F>
+void with_pool(unsigned int threads, F f)
+{
+  using ovxx::thread_pool;
+  thread_pool *default_pool = thread_pool::get_default();
+  if (threads)
+  {
+    thread_pool::parameters params;
+    params.threads = threads;
+    thread_pool pool(params);
+    thread_pool::set_default(&pool);
+    f();
+  }
+  else
+  {
+    thread_pool::set_default(0);
+    f();
+  }
+  thread_pool::set_default(default_pool);
+}
+
+/// Run `f` with `threshold` set to `value`. The previous value is
+/// restored afterwards.
+template <typename F>
+void with_threshold(vsip::length_type &threshold, vsip::length_type value, F f)
+{
+  vsip::length_type previous = threshold;
+  threshold = value;
+  f();
+  threshold = previous;
+}
+
+} // namespace test
+
+#endif
@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/math.hpp>
+#include <vsip/random.hpp>
+#include <vsip/signal.hpp>
+#include <ovxx/signal/czt.hpp>
+#include <ovxx/signal/fft/dft.hpp>
+#include <test.hpp>
+
+using namespace ovxx;
+
+typedef dispatcher::make_type_list<dispatcher::be::generic>::type dft_list;
+
+/// Evaluate the z-transform directly.
+template <typename T>
+Vector<complex<T> >
+ref_czt(Vector<complex<T> > x, length_type m, double start, double step)
+{
+  Vector<complex<T> > X(m);
+  for (index_type k = 0; k != m; ++k)
+  {
+    complex<double> sum;
+    for (index_type j = 0; j != x.size(); ++j)
+      sum += complex<double>(x.get(j)) * std::polar(1., -(start + k * step) * j);
+    X.put(k, complex<T>(sum));
+  }
+  return X;
+}
+
+/// The Czt matches the z-transform, for outputs shorter and
+/// longer than the input.
+template <typename T>
+void test_czt(length_type n, length_type m, double start, double step)
+{
+  Rand<complex<T> > rand(n);
+  Vector<complex<T> > x = rand.randu(n);
+  signal::Czt<T> czt(n, m, start, step);
+  Vector<complex<T> > X = czt(x);
+  test_assert(test::diff(X, ref_czt(x, m, start, step)) < -100);
+}
+
+/// Zoom into a band holding a tone: its peak lies where expected.
+void test_zoom()
+{
+  length_type const n = 1000, m = 200;
+  double const fs = 1000., f0 = 100., f1 = 120., tone = 110.5;
+  Vector<float> x(n);
+  for (index_type j = 0; j != n; ++j)
+    x.put(j, std::cos(2 * OVXX_PI * tone * j / fs));
+  signal::Czt<float> zoom(n, m, 2 * OVXX_PI * f0 / fs,
+			  2 * OVXX_PI * (f1 - f0) / (m * fs));
+  Vector<complex<float> > X = zoom(x);
+  Index<1> idx;
+  maxval(mag(X), idx);
+  test_assert(idx[0] == index_type((tone - f0) / (f1 - f0) * m));
+}
+
+/// Fft and Fftm objects use the chirp-z transform for sizes with
+/// large prime factors.
+template <typename T>
+void test_fft(length_type size)
+{
+  typedef complex<T> C;
+  typedef Fft<const_Vector, C, C, fft_fwd, by_reference> fft_type;
+  test_assert(signal::fft::use_bluestein(size));
+
+  Rand<C> rand(size);
+  Vector<C> in = rand.randu(size);
+  Vector<C> out(size), ref(size);
+  fft_type fft(Domain<1>(size), 1.);
+  signal::Fft<1, C, C, dft_list, fft_fwd, by_reference> ref_fft(Domain<1>(size), 1.);
+  fft(in, out);
+  ref_fft(in, ref);
+  test_assert(test::diff(out, ref) < -100);
+
+  Fft<const_Vector, C, C, fft_inv, by_reference> inv(Domain<1>(size), 1./size);
+  inv(out);
+  test_assert(test::diff(out, in) < -100);
+
+  Rand<T> rrand(size);
+  Vector<T> rin = rrand.randu(size);
+  Vector<C> rout(size / 2 + 1), rref(size / 2 + 1);
+  Fft<const_Vector, T, C, 0, by_reference> rfft(Domain<1>(size), 1.);
+  signal::Fft<1, T, C, dft_list, 0, by_reference> ref_rfft(Domain<1>(size), 1.);
+  rfft(rin, rout);
+  ref_rfft(rin, rref);
+  test_assert(test::diff(rout, rref) < -100);
+  Fft<const_Vector, C, T, 0, by_reference> irfft(Domain<1>(size), 1./size);
+  Vector<T> back(size);
+  irfft(rout, back);
+  test_assert(test::diff(back, rin) < -100);
+}
+
+template <typename T, int A>
+void test_fftm(length_type rows, length_type cols)
+{
+  typedef complex<T> C;
+  Rand<C> rand(rows);
+  Matrix<C> in = rand.randu(rows, cols);
+  Matrix<C> out(rows, cols), ref(rows, cols);
+  Fftm<C, C, A, fft_fwd, by_reference> fftm(Domain<2>(rows, cols), 1.);
+  signal::Fftm<C, C, dft_list, A, fft_fwd, by_reference>
+    ref_fftm(Domain<2>(rows, cols), 1.);
+  fftm(in, out);
+  ref_fftm(in, ref);
+  test_assert(test::diff(out, ref) < -100);
+}
+
+int
+main(int argc, char** argv)
+{
+  vsipl init(argc, argv);
+
+  test_czt<float>(16, 16, 0., 2 * OVXX_PI / 16);
+  test_czt<double>(100, 37, 0.3, 0.01);
+  test_czt<double>(37, 100, -1., 0.02);
+  test_czt<float>(1, 5, 0., 0.1);
+  test_zoom();
+
+#if OVXX_FFTW || OVXX_SAL_FFT || OVXX_IPP_FFT || OVXX_CVSIP_FFT || \
+    OVXX_CUDA_FFT || OVXX_BUILTIN_FFT
+  test_fft<float>(4099);
+  test_fft<double>(6007);
+  test_fft<double>(2 * 3 * 127);
+  test_fftm<float, row>(3, 4099);
+  test_fftm<double, col>(1031, 4);
+#endif
+}
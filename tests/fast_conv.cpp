@@ -0,0 +1,152 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for FFT-based convolution and correlation.
+
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/signal.hpp>
+#include <vsip/random.hpp>
+#include <vsip/initfin.hpp>
+#include <test.hpp>
+#include <test/ref/conv.hpp>
+#include <test/ref/corr.hpp>
+
+using namespace ovxx;
+
+template <typename T, symmetry_type S, support_region_type R>
+void test_conv(length_type M, length_type N, length_type D)
+{
+  typedef Convolution<const_Vector, S, R, T> conv_type;
+  Rand<T> rand(0);
+  Vector<T> coeff = rand.randu(M);
+  Vector<T> in = rand.randu(N);
+
+  conv_type conv(coeff, Domain<1>(N), D);
+  length_type P = conv.output_size().size();
+  Vector<T> out(P, T(100));
+  Vector<T> chk(P, T(101));
+  Vector<T> kernel = test::ref::kernel_from_coeff(S, coeff);
+  conv(in, out);
+  test::ref::conv(nonsym, R, kernel, in, chk, D);
+  test_assert(test::diff(out, chk) < -100);
+}
+
+template <typename T, support_region_type R>
+void test_conv2(Domain<2> const &M, Domain<2> const &N, length_type D)
+{
+  typedef Convolution<const_Matrix, nonsym, R, T> conv_type;
+  Rand<T> rand(1);
+  Matrix<T> coeff = rand.randu(M[0].size(), M[1].size());
+  Matrix<T> in = rand.randu(N[0].size(), N[1].size());
+
+  // Compare against direct summation.
+  length_type threshold = signal::fast_conv_threshold();
+  signal::fast_conv_threshold() = length_type(-1);
+  conv_type direct(coeff, N, D);
+  signal::fast_conv_threshold() = threshold;
+  conv_type conv(coeff, N, D);
+
+  Matrix<T> out(conv.output_size()[0].size(), conv.output_size()[1].size());
+  Matrix<T> chk(out.size(0), out.size(1));
+  conv(in, out);
+  direct(in, chk);
+  test_assert(test::diff(out, chk) < -100);
+}
+
+template <typename T, support_region_type R>
+void test_corr(bias_type bias, length_type M, length_type N)
+{
+  typedef Correlation<const_Vector, R, T> corr_type;
+  Rand<T> rand(2);
+  Vector<T> ref = rand.randu(M);
+  Vector<T> in = rand.randu(N);
+
+  corr_type corr((Domain<1>(M)), Domain<1>(N));
+  length_type P = corr.output_size().size();
+  Vector<T> out(P, T(100));
+  Vector<T> chk(P, T(101));
+  corr(bias, ref, in, out);
+  test::ref::corr(bias, R, ref, in, chk);
+  test_assert(test::diff(out, chk) < -100);
+}
+
+template <typename T, support_region_type R>
+void test_corr2(bias_type bias, Domain<2> const &M, Domain<2> const &N)
+{
+  typedef Correlation<const_Matrix, R, T> corr_type;
+  Rand<T> rand(3);
+  Matrix<T> ref = rand.randu(M[0].size(), M[1].size());
+  Matrix<T> in = rand.randu(N[0].size(), N[1].size());
+
+  corr_type corr(M, N);
+  Matrix<T> out(corr.output_size()[0].size(), corr.output_size()[1].size());
+  Matrix<T> chk(out.size(0), out.size(1));
+  corr(bias, ref, in, out);
+  test::ref::corr(bias, R, ref, in, chk);
+  test_assert(test::diff(out, chk) < -100);
+}
+
+template <typename T, symmetry_type S>
+void conv_cases(length_type M, length_type N)
+{
+  for (length_type D = 1; D <= 3; ++D)
+  {
+    test_conv<T, S, support_full>(M, N, D);
+    test_conv<T, S, support_same>(M, N, D);
+    test_conv<T, S, support_min>(M, N, D);
+  }
+}
+
+template <typename T>
+void corr_cases(length_type M, length_type N)
+{
+  test_corr<T, support_full>(biased, M, N);
+  test_corr<T, support_full>(unbiased, M, N);
+  test_corr<T, support_same>(biased, M, N);
+  test_corr<T, support_same>(unbiased, M, N);
+  test_corr<T, support_min>(biased, M, N);
+  test_corr<T, support_min>(unbiased, M, N);
+}
+
+template <typename T>
+void cases()
+{
+  conv_cases<T, nonsym>(1, 10);
+  conv_cases<T, nonsym>(8, 8);
+  conv_cases<T, nonsym>(7, 100);
+  conv_cases<T, nonsym>(33, 1000);
+  conv_cases<T, sym_even_len_odd>(5, 64);
+  conv_cases<T, sym_even_len_even>(6, 65);
+
+  test_conv2<T, support_full>(Domain<2>(3, 4), Domain<2>(16, 13), 1);
+  test_conv2<T, support_same>(Domain<2>(3, 4), Domain<2>(16, 13), 2);
+  test_conv2<T, support_min>(Domain<2>(5, 2), Domain<2>(13, 16), 3);
+
+  corr_cases<T>(1, 10);
+  corr_cases<T>(8, 8);
+  corr_cases<T>(7, 100);
+  corr_cases<T>(32, 500);
+
+  test_corr2<T, support_full>(unbiased, Domain<2>(2, 3), Domain<2>(16, 13));
+  test_corr2<T, support_same>(unbiased, Domain<2>(3, 4), Domain<2>(13, 16));
+  test_corr2<T, support_same>(biased, Domain<2>(4, 4), Domain<2>(16, 16));
+  test_corr2<T, support_min>(unbiased, Domain<2>(3, 2), Domain<2>(16, 13));
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  // Use FFTs for all kernels.
+  signal::fast_conv_threshold() = 1;
+  cases<float>();
+  cases<complex<float> >();
+  cases<double>();
+  cases<complex<double> >();
+}
@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for the polyphase FIR backend.
+
+#include <vsip/vector.hpp>
+#include <vsip/signal.hpp>
+#include <vsip/random.hpp>
+#include <vsip/initfin.hpp>
+#include <ovxx/signal/fast_fir.hpp>
+#include <test.hpp>
+
+using namespace ovxx;
+
+// Run both the generic and the fast backend over a number of frames,
+// reading the input with stride `s`, and compare their outputs.
+template <typename T, symmetry_type S, obj_state C>
+void test_fir(length_type K, length_type N, length_type D, stride_type s,
+              length_type frames = 4)
+{
+  Rand<T> rand(0);
+  Vector<T> kernel = rand.randu(K);
+  Vector<T> input = rand.randu(N * frames * s);
+
+  aligned_array<T> k1(K), k2(K);
+  for (index_type i = 0; i != K; ++i) k1[i] = k2[i] = kernel.get(i);
+  signal::Fir<T, S, C> generic(k1, K, N, D);
+  signal::Fast_fir<T, S, C> fast(k2, K, N, D);
+  test_assert(generic.output_size() == fast.output_size());
+
+  length_type const P = fast.output_size();
+  Vector<T> out1(P * frames, T(0));
+  Vector<T> out2(2 * P * frames, T(0));
+  length_type got1 = 0, got2 = 0;
+  for (index_type f = 0; f != frames; ++f)
+  {
+    T const *in = input.block().ptr() + f * N * s;
+    // A copy carries the filter state along.
+    std::unique_ptr<signal::Fir_backend<T, S, C> > copy(fast.clone());
+    Vector<T> chk(P);
+    length_type c = copy->apply(in, s, N, chk.block().ptr(), 1, P);
+    length_type g = fast.apply(in, s, N, out2.block().ptr() + 2 * got2, 2, P);
+    test_assert(c == g);
+    test_assert(test::diff(chk(Domain<1>(c)), out2(Domain<1>(2 * got2, 2, g))) < -100);
+    got2 += g;
+
+    Vector<T> frame(N);
+    frame = input(Domain<1>(f * N * s, s, N));
+    got1 += generic.apply(frame.block().ptr(), 1, N, out1.block().ptr() + got1, 1, P);
+  }
+  test_assert(got1 == got2);
+  test_assert(test::diff(out1(Domain<1>(got1)),
+                         out2(Domain<1>(0, 2, got2))) < -100);
+
+  generic.reset();
+  fast.reset();
+  length_type g1 = generic.apply(input.block().ptr(), s, N, out1.block().ptr(), 1, P);
+  length_type g2 = fast.apply(input.block().ptr(), s, N, out2.block().ptr(), 1, P);
+  test_assert(g1 == g2);
+  test_assert(test::diff(out1(Domain<1>(g1)), out2(Domain<1>(g2))) < -100);
+}
+
+template <typename T, symmetry_type S, obj_state C>
+void cases()
+{
+  test_fir<T, S, C>(3, 5, 1, 1);
+  test_fir<T, S, C>(4, 8, 2, 1);
+  test_fir<T, S, C>(4, 9, 3, 2);
+  test_fir<T, S, C>(23, 64, 2, 1);
+  test_fir<T, S, C>(23, 61, 5, 3);
+  test_fir<T, S, C>(32, 1024, 1, 1);
+  test_fir<T, S, C>(32, 1023, 4, 1);
+  test_fir<T, S, C>(17, 700, 16, 2);
+}
+
+template <typename T>
+void cases()
+{
+  cases<T, nonsym, state_save>();
+  cases<T, nonsym, state_no_save>();
+  cases<T, sym_even_len_odd, state_save>();
+  cases<T, sym_even_len_even, state_save>();
+  cases<T, sym_even_len_even, state_no_save>();
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  cases<float>();
+  cases<double>();
+  cases<complex<float> >();
+  cases<complex<double> >();
+}
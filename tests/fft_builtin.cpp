@@ -0,0 +1,272 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Test the built-in FFT backend against the generic DFT, for
+/// sizes with all supported radices (and others), for split and
+/// interleaved complex data, and for strided views.
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/tensor.hpp>
+#include <vsip/math.hpp>
+#include <vsip/random.hpp>
+#include <ovxx/signal/fft/dft.hpp>
+#include <ovxx/signal/fft/builtin.hpp>
+#include <vsip/impl/signal/fft.hpp>
+#include <test.hpp>
+
+using namespace ovxx;
+
+typedef dispatcher::make_type_list<dispatcher::be::builtin>::type builtin_list;
+typedef dispatcher::make_type_list<dispatcher::be::generic>::type dft_list;
+
+storage_format_type const inter = vsip::interleaved_complex;
+storage_format_type const split = vsip::split_complex;
+
+length_type const sizes[] =
+{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 12, 15, 16, 25, 30, 32, 49, 60, 64, 77, 97,
+  100, 121, 128, 243, 256, 1000, 1024};
+
+template <typename T, storage_format_type F>
+void cfft(length_type size, stride_type stride)
+{
+  typedef complex<T> C;
+  typedef Layout<1, row1_type, dense, F> layout_type;
+  typedef Vector<C, Strided<1, C, layout_type> > view_type;
+  Domain<1> dom(0, stride, size);
+
+  Rand<C> rand(size);
+  view_type in(size * stride, C());
+  in(dom) = rand.randu(size);
+  view_type out(size * stride, C());
+  view_type ref(size * stride, C());
+
+  signal::Fft<1, C, C, builtin_list, fft_fwd, by_reference> fwd(Domain<1>(size), 1.);
+  signal::Fft<1, C, C, dft_list, fft_fwd, by_reference> ref_fwd(Domain<1>(size), 1.);
+  fwd(in(dom), out(dom));
+  ref_fwd(in(dom), ref(dom));
+  test_assert(test::diff(out, ref) < -100);
+
+  signal::Fft<1, C, C, builtin_list, fft_inv, by_reference> inv(Domain<1>(size), 1./size);
+  inv(out(dom));
+  test_assert(test::diff(out, in) < -100);
+}
+
+template <typename T, storage_format_type F>
+void rfft(length_type size)
+{
+  typedef complex<T> C;
+  typedef Layout<1, row1_type, dense, F> layout_type;
+  typedef Vector<C, Strided<1, C, layout_type> > view_type;
+  length_type const csize = size / 2 + 1;
+
+  Rand<T> rand(size);
+  Vector<T> in = rand.randu(size);
+  view_type out(csize);
+  view_type ref(csize);
+
+  signal::Fft<1, T, C, builtin_list, 0, by_reference> fwd(Domain<1>(size), 1.);
+  signal::Fft<1, T, C, dft_list, 0, by_reference> ref_fwd(Domain<1>(size), 1.);
+  fwd(in, out);
+  ref_fwd(in, ref);
+  test_assert(test::diff(out, ref) < -100);
+
+  signal::Fft<1, C, T, builtin_list, 0, by_reference> inv(Domain<1>(size), 1./size);
+  Vector<T> back(size);
+  inv(out, back);
+  test_assert(test::diff(back, in) < -100);
+}
+
+template <typename T, storage_format_type F, int S>
+void cfft2(length_type rows, length_type cols)
+{
+  typedef complex<T> C;
+  typedef Layout<2, row2_type, dense, F> layout_type;
+  typedef Matrix<C, Strided<2, C, layout_type> > view_type;
+  Domain<2> dom(rows, cols);
+
+  Rand<C> rand(rows);
+  view_type in(rows, cols);
+  in = rand.randu(rows, cols);
+  view_type out(rows, cols);
+  view_type ref(rows, cols);
+
+  signal::Fft<2, C, C, builtin_list, S, by_reference> fft(dom, 1.);
+  signal::Fft<2, C, C, dft_list, S, by_reference> ref_fft(dom, 1.);
+  fft(in, out);
+  ref_fft(in, ref);
+  test_assert(test::diff(out, ref) < -100);
+  fft(in);
+  test_assert(test::diff(in, ref) < -100);
+}
+
+template <typename T, int A>
+void rfft2(length_type rows, length_type cols)
+{
+  typedef complex<T> C;
+  Domain<2> dom(rows, cols);
+  length_type const out_rows = A == 0 ? rows / 2 + 1 : rows;
+  length_type const out_cols = A == 1 ? cols / 2 + 1 : cols;
+
+  Rand<T> rand(rows);
+  Matrix<T> in = rand.randu(rows, cols);
+  Matrix<C> out(out_rows, out_cols);
+  Matrix<C> ref(out_rows, out_cols);
+
+  signal::Fft<2, T, C, builtin_list, A, by_reference> fwd(dom, 1.);
+  signal::Fft<2, T, C, dft_list, A, by_reference> ref_fwd(dom, 1.);
+  fwd(in, out);
+  ref_fwd(in, ref);
+  test_assert(test::diff(out, ref) < -100);
+
+  signal::Fft<2, C, T, builtin_list, A, by_reference> inv(dom, 1./(rows * cols));
+  Matrix<T> back(rows, cols);
+  inv(out, back);
+  test_assert(test::diff(back, in) < -100);
+}
+
+template <typename T, int A>
+void rfft3(length_type x, length_type y, length_type z)
+{
+  typedef complex<T> C;
+  Domain<3> dom(x, y, z);
+  length_type const ox = A == 0 ? x / 2 + 1 : x;
+  length_type const oy = A == 1 ? y / 2 + 1 : y;
+  length_type const oz = A == 2 ? z / 2 + 1 : z;
+
+  Rand<T> rand(x);
+  Tensor<T> in(x, y, z);
+  for (index_type i = 0; i != x; ++i)
+    in(i, whole_domain, whole_domain) = rand.randu(y, z);
+  Tensor<C> out(ox, oy, oz);
+  Tensor<C> ref(ox, oy, oz);
+
+  signal::Fft<3, T, C, builtin_list, A, by_reference> fwd(dom, 1.);
+  signal::Fft<3, T, C, dft_list, A, by_reference> ref_fwd(dom, 1.);
+  fwd(in, out);
+  ref_fwd(in, ref);
+  test_assert(test::diff(out, ref) < -100);
+
+  signal::Fft<3, C, T, builtin_list, A, by_reference> inv(dom, 1./(x * y * z));
+  Tensor<T> back(x, y, z);
+  inv(out, back);
+  test_assert(test::diff(back, in) < -100);
+}
+
+template <typename T, int S>
+void cfft3(length_type x, length_type y, length_type z)
+{
+  typedef complex<T> C;
+  Domain<3> dom(x, y, z);
+  Rand<C> rand(x);
+  Tensor<C> in(x, y, z);
+  for (index_type i = 0; i != x; ++i)
+    in(i, whole_domain, whole_domain) = rand.randu(y, z);
+  Tensor<C> out(x, y, z);
+  Tensor<C> ref(x, y, z);
+
+  signal::Fft<3, C, C, builtin_list, S, by_reference> fft(dom, 1.);
+  signal::Fft<3, C, C, dft_list, S, by_reference> ref_fft(dom, 1.);
+  fft(in, out);
+  ref_fft(in, ref);
+  test_assert(test::diff(out, ref) < -100);
+}
+
+template <typename T, storage_format_type F, int A>
+void fftm(length_type rows, length_type cols)
+{
+  typedef complex<T> C;
+  typedef Layout<2, row2_type, dense, F> layout_type;
+  typedef Matrix<C, Strided<2, C, layout_type> > view_type;
+  Domain<2> dom(rows, cols);
+  length_type const out_rows = A == col ? rows / 2 + 1 : rows;
+  length_type const out_cols = A == row ? cols / 2 + 1 : cols;
+
+  Rand<C> crand(rows);
+  view_type in(rows, cols);
+  in = crand.randu(rows, cols);
+  view_type out(rows, cols);
+  view_type ref(rows, cols);
+  signal::Fftm<C, C, builtin_list, A, fft_fwd, by_reference> fftm(dom, 1.);
+  signal::Fftm<C, C, dft_list, A, fft_fwd, by_reference> ref_fftm(dom, 1.);
+  fftm(in, out);
+  ref_fftm(in, ref);
+  test_assert(test::diff(out, ref) < -100);
+
+  Rand<T> rand(rows);
+  Matrix<T> rin = rand.randu(rows, cols);
+  view_type rout(out_rows, out_cols);
+  view_type rref(out_rows, out_cols);
+  signal::Fftm<T, C, builtin_list, A, fft_fwd, by_reference> rfftm(dom, 1.);
+  signal::Fftm<T, C, dft_list, A, fft_fwd, by_reference> ref_rfftm(dom, 1.);
+  rfftm(rin, rout);
+  ref_rfftm(rin, rref);
+  test_assert(test::diff(rout, rref) < -100);
+
+  length_type const size = A == row ? cols : rows;
+  signal::Fftm<C, T, builtin_list, A, fft_inv, by_reference> irfftm(dom, 1./size);
+  Matrix<T> back(rows, cols);
+  irfftm(rout, back);
+  test_assert(test::diff(back, rin) < -100);
+}
+
+/// Large sizes go through many passes: check the round trip.
+template <typename T>
+void round_trip(length_type size)
+{
+  typedef complex<T> C;
+  Rand<C> rand(size);
+  Vector<C> in = rand.randu(size);
+  Vector<C> data(size);
+  data = in;
+  signal::Fft<1, C, C, builtin_list, fft_fwd, by_reference> fwd(Domain<1>(size), 1.);
+  signal::Fft<1, C, C, builtin_list, fft_inv, by_reference> inv(Domain<1>(size), 1./size);
+  fwd(data);
+  inv(data);
+  test_assert(test::diff(data, in) < -100);
+}
+
+template <typename T>
+void test_sizes()
+{
+  for (length_type const *s = sizes; s != sizes + sizeof(sizes)/sizeof(*sizes); ++s)
+  {
+    cfft<T, inter>(*s, 1);
+    cfft<T, split>(*s, 1);
+    cfft<T, inter>(*s, 3);
+    cfft<T, split>(*s, 2);
+    rfft<T, inter>(*s);
+    rfft<T, split>(*s);
+  }
+  cfft2<T, inter, fft_fwd>(12, 10);
+  cfft2<T, split, fft_inv>(7, 16);
+  rfft2<T, 0>(16, 9);
+  rfft2<T, 1>(16, 9);
+  rfft2<T, 0>(15, 8);
+  rfft2<T, 1>(6, 15);
+  cfft3<T, fft_fwd>(4, 6, 5);
+  cfft3<T, fft_inv>(3, 8, 9);
+  rfft3<T, 0>(6, 4, 5);
+  rfft3<T, 1>(3, 6, 4);
+  rfft3<T, 2>(5, 4, 7);
+  fftm<T, inter, row>(5, 24);
+  fftm<T, split, row>(4, 15);
+  fftm<T, inter, col>(24, 5);
+  fftm<T, split, col>(15, 3);
+}
+
+int
+main(int argc, char** argv)
+{
+  vsipl init(argc, argv);
+  test_sizes<float>();
+  test_sizes<double>();
+  round_trip<double>(1 << 16);
+  round_trip<double>(59049); // 3^10
+  round_trip<double>(5 * 7 * 11 * 13);
+}
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Fft and Fftm objects constructed with a window multiply their
+/// input by it, giving the same result as an explicit multiplication.
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/math.hpp>
+#include <vsip/random.hpp>
+#include <vsip/signal.hpp>
+#include <test.hpp>
+
+using namespace ovxx;
+
+template <typename T>
+void cfft(length_type size)
+{
+  typedef complex<T> C;
+  const_Vector<T> w = signal::cached_window<T>(signal::hanning_window, size);
+  Rand<C> rand(size);
+  Vector<C> in = rand.randu(size);
+  Vector<C> out(size), ref(size);
+
+  Fft<const_Vector, C, C, fft_fwd, by_reference> fft(Domain<1>(size), 1.);
+  Fft<const_Vector, C, C, fft_fwd, by_reference> wfft(Domain<1>(size), 1., w);
+  fft(in * w, ref);
+  wfft(in, out);
+  test_assert(test::diff(out, ref) < -100);
+  // Strided input
+  Vector<C> strided(2 * size);
+  strided(Domain<1>(0, 2, size)) = in;
+  wfft(strided(Domain<1>(0, 2, size)), out);
+  test_assert(test::diff(out, ref) < -100);
+  // Split complex input
+  Vector<C, Strided<1, C, Layout<1, row1_type, dense, split_complex> > > split(size);
+  split = in;
+  wfft(split, out);
+  test_assert(test::diff(out, ref) < -100);
+  // In place
+  wfft(in);
+  test_assert(test::diff(in, ref) < -100);
+
+  Fft<const_Vector, C, C, fft_inv, by_value> wifft(Domain<1>(size), 1., w);
+  Fft<const_Vector, C, C, fft_inv, by_value> ifft(Domain<1>(size), 1.);
+  test_assert(test::diff(wifft(out), ifft(out * w)) < -100);
+}
+
+template <typename T>
+void rfft(length_type size)
+{
+  typedef complex<T> C;
+  const_Vector<T> w = signal::cached_window<T>(signal::kaiser_window, size, 3.5);
+  Rand<T> rand(size);
+  Vector<T> in = rand.randu(size);
+  Vector<C> out(size / 2 + 1), ref(size / 2 + 1);
+
+  Fft<const_Vector, T, C, 0, by_reference> fft(Domain<1>(size), 1.);
+  Fft<const_Vector, T, C, 0, by_reference> wfft(Domain<1>(size), 1., w);
+  fft(in * w, ref);
+  wfft(in, out);
+  test_assert(test::diff(out, ref) < -100);
+}
+
+template <typename T, int A>
+void fftm(length_type rows, length_type cols)
+{
+  typedef complex<T> C;
+  length_type const size = A == row ? cols : rows;
+  const_Vector<T> w = signal::cached_window<T>(signal::blackman_window, size);
+  Rand<C> rand(rows);
+  Matrix<C> in = rand.randu(rows, cols);
+  Matrix<C> windowed(rows, cols), out(rows, cols), ref(rows, cols);
+  if (A == row) windowed = vmmul<row>(w, in);
+  else windowed = vmmul<col>(w, in);
+
+  Fftm<C, C, A, fft_fwd, by_reference> fftm(Domain<2>(rows, cols), 1.);
+  Fftm<C, C, A, fft_fwd, by_reference> wfftm(Domain<2>(rows, cols), 1., w);
+  fftm(windowed, ref);
+  wfftm(in, out);
+  test_assert(test::diff(out, ref) < -100);
+  wfftm(in);
+  test_assert(test::diff(in, ref) < -100);
+
+  Fftm<C, C, A, fft_fwd, by_value> wfftm_v(Domain<2>(rows, cols), 1., w);
+  Matrix<C> again = rand.randu(rows, cols);
+  if (A == row) windowed = vmmul<row>(w, again);
+  else windowed = vmmul<col>(w, again);
+  fftm(windowed, ref);
+  test_assert(test::diff(wfftm_v(again), ref) < -100);
+}
+
+int
+main(int argc, char** argv)
+{
+  vsipl init(argc, argv);
+
+  cfft<float>(64);
+  cfft<double>(100);
+  rfft<float>(128);
+  rfft<double>(30);
+  fftm<float, row>(8, 32);
+  fftm<double, col>(24, 5);
+  fftm<float, col>(16, 12);
+}
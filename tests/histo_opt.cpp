@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/signal.hpp>
+#include <vsip/random.hpp>
+#include <ovxx/signal/histo.hpp>
+#include <test.hpp>
+#include <limits>
+
+using namespace ovxx;
+
+typedef Dense<1, int> hist_block_type;
+
+/// Compare the optimized histogram of `input` against the generic one.
+template <typename T, typename Block>
+void
+compare(T min, T max, length_type bins, Block const &input)
+{
+  typedef dispatcher::Evaluator<dispatcher::op::hist, dispatcher::be::opt,
+    void(T, T, hist_block_type &, Block const &)> evaluator;
+  test_assert(evaluator::ct_valid);
+
+  // Start from non-zero counts, as when accumulating.
+  Vector<int> expected(bins, 3), hist(bins, 3);
+  vsip::impl::Histogram_accumulator<Block::dim>::exec(min, max, expected.block(), input);
+  evaluator::exec(min, max, hist.block(), input);
+  for (index_type b = 0; b != bins; ++b)
+    test_assert(hist(b) == expected(b));
+}
+
+template <typename T>
+void
+test_vector(length_type size, T scale)
+{
+  Rand<float> rgen(0);
+  Vector<float> tmp = rgen.randu(size);
+  Vector<T> v(size);
+  for (index_type i = 0; i != size; ++i)
+    v.put(i, static_cast<T>((tmp.get(i) * 1.2f - 0.1f) * scale));
+
+  compare(T(0), scale, 10, v.block());
+  compare(T(0), scale, 257, v.block());
+  // Strided
+  compare(T(0), scale, 17, v(Domain<1>(1, 3, size / 3)).block());
+}
+
+template <typename T>
+void
+test_matrix(length_type rows, length_type cols, T scale)
+{
+  Rand<float> rgen(1);
+  Matrix<float> tmp = rgen.randu(rows, cols);
+  Matrix<T> m(rows, cols);
+  Matrix<T, Dense<2, T, col2_type> > mc(rows, cols);
+  for (index_type i = 0; i != rows; ++i)
+    for (index_type j = 0; j != cols; ++j)
+    {
+      m.put(i, j, static_cast<T>((tmp.get(i, j) * 1.2f - 0.1f) * scale));
+      mc.put(i, j, m.get(i, j));
+    }
+
+  compare(T(0), scale, 10, m.block());
+  compare(T(0), scale, 10, mc.block());
+  // Rows that aren't contiguous to each other.
+  compare(T(0), scale, 33, m(Domain<2>(Domain<1>(1, 1, rows - 2),
+				       Domain<1>(2, 1, cols - 5))).block());
+  compare(T(0), scale, 33, mc(Domain<2>(Domain<1>(0, 2, rows / 2),
+					Domain<1>(1, 1, cols - 1))).block());
+}
+
+/// Values far outside the range, and NaN, are counted in the
+/// first and last bins.
+template <typename T>
+void
+test_extremes()
+{
+  Vector<T> v(8, T(5));
+  v.put(0, -std::numeric_limits<T>::max());
+  v.put(1, std::numeric_limits<T>::max());
+  v.put(2, -std::numeric_limits<T>::infinity());
+  v.put(3, std::numeric_limits<T>::infinity());
+  v.put(4, std::numeric_limits<T>::quiet_NaN());
+  compare(T(0), T(10), 12, v.block());
+
+  Vector<int> hist(12, 0);
+  dispatcher::Evaluator<dispatcher::op::hist, dispatcher::be::opt,
+    void(T, T, hist_block_type &, typename Vector<T>::block_type const &)>::
+    exec(T(0), T(10), hist.block(), v.block());
+  test_assert(hist(0) == 3 && hist(11) == 2 && hist(6) == 3);
+}
+
+/// The Histogram object uses the optimized backend, including to
+/// accumulate.
+void
+test_histogram()
+{
+  length_type const size = 4000;
+  Vector<short> frame(size);
+  for (index_type i = 0; i != size; ++i)
+    frame.put(i, static_cast<short>((i * 37) % 1000));
+  Histogram<const_Vector, short> h(0, 1000, 102);
+  Vector<scalar_i> q = h(frame);
+  q = h(frame, true);
+  test_assert(q(0) == 0 && q(101) == 0);
+  for (index_type b = 1; b != 101; ++b)
+    test_assert(q(b) == 2 * 40);
+}
+
+template <typename T>
+void
+test_type(T scale)
+{
+  test_vector<T>(1000, scale);
+  test_matrix<T>(31, 40, scale);
+}
+
+int
+main(int argc, char** argv)
+{
+  vsipl init(argc, argv);
+
+  test_type<float>(100.f);
+  test_type<double>(100.);
+  test_type<int>(1000);
+  test_type<short>(4096);
+
+  // Split among threads (if any), each with its own histogram.
+  length_type threshold = signal::histo::threaded_threshold();
+  signal::histo::threaded_threshold() = 64;
+  test_type<float>(100.f);
+  test_type<short>(4096);
+  signal::histo::threaded_threshold() = 0;
+  test_type<float>(100.f);
+  signal::histo::threaded_threshold() = threshold;
+
+  test_extremes<float>();
+  test_extremes<double>();
+  test_histogram();
+}
@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/signal.hpp>
+#include <vsip/selgen.hpp>
+#include <ovxx/signal/iir.hpp>
+#include <test.hpp>
+#include <vector>
+
+using namespace ovxx;
+
+template <typename T>
+void
+coefficients(Matrix<T> b, Matrix<T> a)
+{
+  for (index_type m = 0; m != a.size(0); ++m)
+  {
+    b(m, 0) = T(0.2);
+    b(m, 1) = T(0.4 - 0.1 * m);
+    b(m, 2) = T(0.2);
+    a(m, 0) = T(-0.5 + 0.1 * m);
+    a(m, 1) = T(0.1);
+  }
+}
+
+/// Filter `channels` channels, `chunk` samples at a time, with an
+/// Iirm, and compare against one Iir per channel.
+template <typename T, obj_state State, typename Block>
+void
+test_bank(Matrix<T, Block> data, length_type sections, length_type chunk)
+{
+  length_type const channels = data.size(0);
+  length_type const size = data.size(1);
+  test_assert(size % chunk == 0);
+
+  Matrix<T> b(sections, 3), a(sections, 2);
+  coefficients(b, a);
+
+  for (index_type c = 0; c != channels; ++c)
+    data.row(c) = ramp(T(c), T(1), size) / T(size);
+
+  signal::Iirm<T, State> bank(b, a, channels, chunk);
+  test_assert(bank.kernel_size() == 2 * sections);
+  test_assert(bank.channels() == channels);
+  test_assert(bank.input_size() == chunk);
+  test_assert(bank.continuous_filtering == State);
+
+  std::vector<Iir<T, State> > iir(channels, Iir<T, State>(b, a, chunk));
+
+  Matrix<T, Block> out(channels, size);
+  Matrix<T> expected(channels, size);
+  for (index_type pos = 0; pos < size; pos += chunk)
+  {
+    Domain<1> d(pos, 1, chunk);
+    bank(data(Domain<2>(channels, d)), out(Domain<2>(channels, d)));
+    for (index_type c = 0; c != channels; ++c)
+      iir[c](data.row(c)(d), expected.row(c)(d));
+  }
+  test_assert(test::diff(out, expected) < -100);
+}
+
+/// Copies carry the state along.
+template <typename T>
+void
+test_copy()
+{
+  length_type const channels = 3, size = 64;
+  Matrix<T> b(2, 3), a(2, 2);
+  coefficients(b, a);
+  Matrix<T> data(channels, size, T(1));
+  Matrix<T> out1(channels, size), out2(channels, size);
+
+  signal::Iirm<T> bank(b, a, channels, size);
+  bank(data, out1);
+  signal::Iirm<T> copy(bank);
+  bank(data, out1);
+  copy(data, out2);
+  test_assert(test::diff(out1, out2) < -100);
+  bank.reset();
+  copy = bank;
+  bank(data, out1);
+  copy(data, out2);
+  test_assert(test::diff(out1, out2) < -100);
+}
+
+template <typename T>
+void
+test_type()
+{
+  // Channel counts below, at and above the group width.
+  Matrix<T> m1(5, 128);
+  test_bank<T, state_save>(m1, 1, 128);
+  Matrix<T> m2(8, 512);
+  test_bank<T, state_save>(m2, 3, 128);
+  Matrix<T> m3(21, 600);
+  test_bank<T, state_save>(m3, 4, 300);
+  test_bank<T, state_no_save>(m3, 4, 200);
+  // Channels stored column-wise.
+  Matrix<T, Dense<2, T, col2_type> > m4(13, 256);
+  test_bank<T, state_save>(m4, 2, 64);
+  // Groups of channels filtered in parallel.
+  length_type threshold = signal::iir::threaded_threshold();
+  signal::iir::threaded_threshold() = 0;
+  test_bank<T, state_save>(m3, 4, 300);
+  signal::iir::threaded_threshold() = threshold;
+  test_copy<T>();
+}
+
+int
+main(int argc, char** argv)
+{
+  vsipl init(argc, argv);
+
+  test_type<float>();
+  test_type<double>();
+  test_type<complex<float> >();
+}
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for the built-in blocked matrix product backend.
+
+#include <vsip/initfin.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/math.hpp>
+#include <ovxx/linalg/gemm.hpp>
+#include <test.hpp>
+#include <test/thread.hpp>
+#include <test/ref/matvec.hpp>
+
+using namespace ovxx;
+namespace d = ovxx::dispatcher;
+
+// Evaluate the product with the built-in backend, bypassing any
+// library (such as BLAS) that may be ahead of it in the dispatch list.
+template <typename O, typename B0, typename B1, typename B2>
+void opt_prod(B0 &r, B1 const &a, B2 const &b)
+{
+  typedef d::Evaluator<O, d::be::opt, void(B0 &, B1 const &, B2 const &)> evaluator;
+  test_assert(evaluator::ct_valid);
+  test_assert(evaluator::rt_valid(r, a, b));
+  evaluator::exec(r, a, b);
+}
+
+template <typename T, typename OR, typename OA, typename OB, storage_format_type F>
+void test_prod(length_type m, length_type n, length_type k)
+{
+  typedef Layout<2, OR, dense, F> layout_r;
+  typedef Layout<2, OA, dense, F> layout_a;
+  typedef Layout<2, OB, dense, F> layout_b;
+  typedef Matrix<T, Strided<2, T, layout_r> > view_r;
+  typedef Matrix<T, Strided<2, T, layout_a> > view_a;
+  typedef Matrix<T, Strided<2, T, layout_b> > view_b;
+  view_a a(m, k);
+  view_b b(k, n);
+  view_r r(m, n, T(-1));
+  test::randm(a);
+  test::randm(b);
+
+  opt_prod<d::op::prod>(r.block(), a.block(), b.block());
+  view_r chk(m, n);
+  chk = test::ref::prod(a, b);
+  test_assert(test::diff(r, chk) < -100);
+
+  // Transposed operand
+  view_b bt(n, k);
+  test::randm(bt);
+  opt_prod<d::op::prod>(r.block(), a.block(), bt.transpose().block());
+  chk = test::ref::prod(a, bt.transpose());
+  test_assert(test::diff(r, chk) < -100);
+
+  // General product, accumulating into the result
+  typedef d::Evaluator<d::op::gemp, d::be::opt,
+    void(typename view_r::block_type &, T,
+	 typename view_a::block_type const &,
+	 typename view_b::block_type const &, T)> gemp;
+  test_assert(gemp::ct_valid);
+  chk = T(2) * test::ref::prod(a, b) + T(3) * r;
+  gemp::exec(r.block(), T(2), a.block(), b.block(), T(3));
+  test_assert(test::diff(r, chk) < -100);
+}
+
+template <typename T, storage_format_type F>
+void test_prodj(length_type m, length_type n, length_type k)
+{
+  typedef Layout<2, row2_type, dense, F> layout_type;
+  typedef Matrix<T, Strided<2, T, layout_type> > view_type;
+  view_type a(m, k);
+  view_type b(k, n);
+  view_type r(m, n);
+  test::randm(a);
+  test::randm(b);
+  opt_prod<d::op::prodj>(r.block(), a.block(), b.block());
+  view_type chk(m, n);
+  chk = test::ref::prod(a, conj(b));
+  test_assert(test::diff(r, chk) < -100);
+}
+
+template <typename T, typename O>
+void test_prodmv(length_type m, length_type n)
+{
+  Matrix<T, Dense<2, T, O> > a(m, n);
+  Vector<T> x(n), xt(m);
+  Vector<T> y(m), yt(n);
+  test::randm(a);
+  test::randv(x);
+  test::randv(xt);
+
+  opt_prod<d::op::prod>(y.block(), a.block(), x.block());
+  Vector<T> chk(m);
+  chk = test::ref::prod(a, x);
+  test_assert(test::diff(y, chk) < -100);
+
+  opt_prod<d::op::prod>(yt.block(), xt.block(), a.block());
+  Vector<T> chkt(n);
+  chkt = test::ref::prod(xt, a);
+  test_assert(test::diff(yt, chkt) < -100);
+
+  // Strided vectors
+  Vector<T> xs(2 * n);
+  test::randv(xs);
+  Vector<T> ys(3 * m, T(5));
+  opt_prod<d::op::prod>(ys(Domain<1>(0, 3, m)).block(), a.block(),
+			xs(Domain<1>(1, 2, n)).block());
+  chk = test::ref::prod(a, xs(Domain<1>(1, 2, n)));
+  test_assert(test::diff(ys(Domain<1>(0, 3, m)), chk) < -100);
+  test_assert(ys.get(1) == T(5));
+}
+
+template <typename T, storage_format_type F>
+void prod_cases()
+{
+  test_prod<T, row2_type, row2_type, row2_type, F>(16, 16, 16);
+  test_prod<T, row2_type, col2_type, row2_type, F>(37, 29, 41);
+  test_prod<T, col2_type, row2_type, col2_type, F>(5, 300, 9);
+  test_prod<T, col2_type, col2_type, col2_type, F>(130, 3, 270);
+  test_prod<T, row2_type, row2_type, col2_type, F>(300, 520, 70);
+}
+
+template <typename T>
+void cases()
+{
+  prod_cases<T, array>();
+  test_prodmv<T, row2_type>(67, 129);
+  test_prodmv<T, col2_type>(67, 129);
+}
+
+template <typename T>
+void complex_cases()
+{
+  cases<complex<T> >();
+  prod_cases<complex<T>, split_complex>();
+  test_prodj<complex<T>, array>(33, 65, 17);
+  test_prodj<complex<T>, split_complex>(300, 20, 300);
+}
+
+void test_all()
+{
+  cases<float>();
+  cases<double>();
+  complex_cases<float>();
+  complex_cases<double>();
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  linalg::prod_threshold() = 1;
+  test_all();
+
+  // Compute tiles in parallel.
+  test::with_threshold(linalg::threaded_prod_threshold(), 1,
+                       []() { test::with_pool(3, test_all);});
+
+  // The public API uses the backend for split-complex products.
+  typedef Layout<2, row2_type, dense, split_complex> layout_type;
+  typedef Strided<2, complex<float>, layout_type> block_type;
+  Matrix<complex<float>, block_type> a(50, 60), b(60, 70), r(50, 70);
+  test::randm(a);
+  test::randm(b);
+  r = prod(a, b);
+  Matrix<complex<float> > chk(50, 70);
+  chk = test::ref::prod(a, b);
+  test_assert(test::diff(r, chk) < -100);
+}
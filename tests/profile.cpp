@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+#define OVXX_PROFILE 1
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/math.hpp>
+#include <vsip/signal.hpp>
+#include <vsip/solvers.hpp>
+#include <ovxx/profile.hpp>
+#include <test.hpp>
+#include <sstream>
+
+using namespace ovxx;
+
+void run()
+{
+  typedef complex<float> C;
+  length_type const size = 256;
+
+  Vector<C> in(size, C(1.f)), out(size);
+  Fft<const_Vector, C, C, fft_fwd, by_reference> fft(Domain<1>(size), 1.f);
+  for (int i = 0; i != 3; ++i) fft(in, out);
+
+  Vector<float> a(size, 2.f), b(size);
+  b = a * a + 1.f;
+  test_assert(sumval(b) == 5.f * size);
+
+  Vector<float> kernel(16, 1.f);
+  Convolution<const_Vector, nonsym, support_full, float> conv(kernel, Domain<1>(size));
+  Vector<float> conv_out(conv.output_size()[0].size());
+  conv(a, conv_out);
+
+  Fir<float> fir(kernel, size);
+  fir(a, b);
+
+  Matrix<float> m(8, 8, 1.f);
+  m.diag() = 10.f;
+  lud<float, by_reference> lu(8);
+  lu.decompose(m);
+}
+
+/// Each kind of operation shows up in the summary, tagged with its
+/// backend.
+void test_summary()
+{
+  profile::set_mode(profile::summary);
+  run();
+  profile::set_mode(profile::off);
+
+  std::ostringstream oss;
+  profile::dump_summary(oss);
+  std::string s = oss.str();
+  test_assert(s.find("Fft fwd") != std::string::npos);
+  test_assert(s.find("assign") != std::string::npos);
+  test_assert(s.find("reduce Sum_value") != std::string::npos);
+  test_assert(s.find("Convolution") != std::string::npos);
+  test_assert(s.find("Fir") != std::string::npos);
+  test_assert(s.find("lud decompose") != std::string::npos);
+
+  // The three transforms are accumulated into a single line.
+  std::istringstream lines(s);
+  std::string line;
+  unsigned fft_lines = 0;
+  while (std::getline(lines, line))
+    if (line.find("Fft fwd") == 0)
+    {
+      ++fft_lines;
+      std::istringstream fields(line.substr(48));
+      unsigned calls = 0;
+      fields >> calls;
+      test_assert(calls == 3);
+    }
+  test_assert(fft_lines == 1);
+  profile::clear();
+}
+
+/// Traces hold one complete event per call.
+void test_trace()
+{
+  profile::set_mode(profile::trace);
+  run();
+  profile::set_mode(profile::off);
+
+  std::ostringstream oss;
+  profile::dump_trace(oss);
+  std::string s = oss.str();
+  test_assert(s.find("{\"traceEvents\":[") == 0);
+  test_assert(s.find("\"ph\":\"X\"") != std::string::npos);
+  std::string::size_type pos = 0;
+  unsigned ffts = 0;
+  while ((pos = s.find("\"name\":\"Fft fwd", pos)) != std::string::npos)
+    ++ffts, ++pos;
+  test_assert(ffts == 3);
+  profile::clear();
+}
+
+/// Nothing is recorded unless asked for.
+void test_off()
+{
+  run();
+  std::ostringstream summary, trace;
+  profile::dump_summary(summary);
+  profile::dump_trace(trace);
+  test_assert(summary.str().find("Fft") == std::string::npos);
+  test_assert(trace.str().find("Fft") == std::string::npos);
+}
+
+int
+main(int argc, char** argv)
+{
+  vsipl init(argc, argv);
+
+  test_summary();
+  test_trace();
+  test_off();
+}
@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Tests for fused multi-reductions, which must agree with the
+///   individual reductions, independently of the number of threads.
+
+#include <vsip/initfin.hpp>
+#include <vsip/math.hpp>
+#include <vsip/random.hpp>
+#include <vsip/signal.hpp>
+#include <ovxx/reductions/reductions.hpp>
+#include <ovxx/reductions/multi.hpp>
+#include <test.hpp>
+#include <test/thread.hpp>
+#include <vector>
+
+using namespace ovxx;
+
+// Run `f` without a thread pool, and with pools of various sizes.
+template <typename F>
+void with_threads(F f)
+{
+  test::with_pool(0, f);
+#if OVXX_ENABLE_THREADING
+  for (unsigned int threads = 2; threads <= 4; ++threads)
+    test::with_pool(threads, f);
+#endif
+}
+
+template <typename T>
+void test_vector(length_type size)
+{
+  Rand<T> rand(size);
+  Vector<T> v(size);
+  v = rand.randu(size) - T(0.5);
+  v.put(size / 2, T(1));
+  v.put(size - 1, T(-1));
+  with_threads([&]()
+  {
+    multi_reduction<1, T, Sum_value, Sum_sq_value, Mean_value, Max_value, Min_value> r =
+      multi_reduce<Sum_value, Sum_sq_value, Mean_value, Max_value, Min_value>(v);
+    // The sums are formed exactly like those of the individual reductions.
+    test_assert(r.template get<0>() == sumval(v));
+    test_assert(r.template get<1>() == sumsqval(v));
+    test_assert(r.template get<2>() == meanval(v));
+    Index<1> idx;
+    test_assert(r.template get<3>() == maxval(v, idx));
+    test_assert(r.template index<3>() == idx && idx[0] == size / 2);
+    test_assert(r.template get<4>() == minval(v, idx));
+    test_assert(r.template index<4>() == idx && idx[0] == size - 1);
+  });
+}
+
+void test_complex(length_type size)
+{
+  typedef complex<float> T;
+  Rand<T> rand(size);
+  Vector<T> v(size);
+  v = rand.randu(size);
+  v.put(3, T(0.f, 0.f));
+  v.put(size - 5, T(2.f, 2.f));
+  with_threads([&]()
+  {
+    // Fused with an element-wise expression.
+    multi_reduction<1, float, Sum_value, Max_value, Min_value> r =
+      multi_reduce<Sum_value, Max_value, Min_value>(magsq(v));
+    test_assert(r.get<0>() == sumval(magsq(v)));
+    test_assert(r.get<1>() == 8.f && r.index<1>()[0] == size - 5);
+    test_assert(r.get<2>() == 0.f && r.index<2>()[0] == 3);
+
+    multi_reduction<1, T, Sum_magsq_value, Mean_magsq_value, Max_mag_value, Min_magsq_value> s =
+      multi_reduce<Sum_magsq_value, Mean_magsq_value, Max_mag_value, Min_magsq_value>(v);
+    test_assert(s.get<0>() == sumval(magsq(v)));
+    test_assert(s.get<1>() == meansqval(v));
+    Index<1> idx;
+    test_assert(s.get<2>() == maxmgval(v, idx) && s.index<2>() == idx);
+    test_assert(s.get<3>() == 0.f && s.index<3>()[0] == 3);
+  });
+}
+
+void test_ties(length_type size)
+{
+  // Ties resolve to the first occurrence, also across chunk boundaries.
+  Vector<float> v(size, 1.f);
+  index_type const a = reduction::chunk_size - 1;
+  v.put(a, 5.f);
+  v.put(a + 1, 5.f);
+  v.put(size - 2, 5.f);
+  with_threads([&]()
+  {
+    multi_reduction<1, float, Max_value, Min_value, Sum_value> r =
+      multi_reduce<Max_value, Min_value, Sum_value>(v);
+    test_assert(r.get<0>() == 5.f && r.index<0>()[0] == a);
+    test_assert(r.get<1>() == 1.f && r.index<1>()[0] == 0);
+    test_assert(r.get<2>() == size + 12.f);
+  });
+}
+
+template <typename O>
+void test_matrix(length_type rows, length_type cols)
+{
+  Matrix<float, Dense<2, float, O> > m(rows, cols);
+  Rand<float> rand(rows);
+  m = rand.randu(rows, cols);
+  m.put(rows / 2, cols - 1, 3.f);
+  m.put(rows - 1, cols / 3, 3.f);
+  m.put(1, 2, -1.f);
+  bool const row_major = is_same<O, row2_type>::value;
+  with_threads([&]()
+  {
+    multi_reduction<2, float, Sum_value, Max_value, Min_value> r =
+      multi_reduce<Sum_value, Max_value, Min_value>(m);
+    test_assert(r.get<0>() == sumval(m));
+    test_assert(r.get<1>() == 3.f);
+    test_assert(r.index<1>() == (row_major ? Index<2>(rows / 2, cols - 1)
+				            : Index<2>(rows - 1, cols / 3)));
+    test_assert(r.get<2>() == -1.f && r.index<2>() == Index<2>(1, 2));
+
+    // A subview that isn't dense.
+    Domain<2> dom(rows, cols - 1);
+    r = multi_reduce<Sum_value, Max_value, Min_value>(m(dom));
+    test_assert(equal(r.get<0>(), sumval(m(dom))));
+    test_assert(r.get<1>() == 3.f && r.index<1>() == Index<2>(rows - 1, cols / 3));
+    test_assert(r.get<2>() == -1.f && r.index<2>() == Index<2>(1, 2));
+  });
+}
+
+/// Non-elementwise expressions are evaluated before they are traversed.
+void test_nonelementwise(length_type size)
+{
+  Vector<float> v(size);
+  for (index_type i = 0; i != size; ++i) v.put(i, float(i % 5));
+  v.put(size / 4, 10.f);
+  float const sum = sumval(v);
+  with_threads([&]()
+  {
+    multi_reduction<1, float, Sum_value, Max_value> r =
+      multi_reduce<Sum_value, Max_value>(freqswap(v));
+    test_assert(r.get<0>() == sum);
+    test_assert(r.get<1>() == 10.f && r.index<1>()[0] == size / 4 + size / 2);
+  });
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  reduction::threaded_threshold() = 1;
+  test_vector<float>(100);
+  test_vector<float>(1000003);
+  test_vector<double>(65536);
+  test_complex(250001);
+  test_ties(50000);
+  test_matrix<row2_type>(301, 257);
+  test_matrix<col2_type>(301, 257);
+  test_nonelementwise(1 << 20);
+
+  // Strided data.
+  Vector<float> v(20000, 1.f);
+  v.put(3 * 1234, 7.f);
+  multi_reduction<1, float, Sum_value, Max_value> r =
+    multi_reduce<Sum_value, Max_value>(v(Domain<1>(0, 3, 6000)));
+  test_assert(r.get<0>() == 6006.f && r.index<1>()[0] == 1234);
+}
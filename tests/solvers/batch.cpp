@@ -0,0 +1,276 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for the batched LU, Cholesky and QR solvers.
+
+#include <vsip/initfin.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/tensor.hpp>
+#include <vsip/math.hpp>
+#include <ovxx/linalg/batch.hpp>
+#include <test.hpp>
+#include <test/thread.hpp>
+#include <test/ref/matvec.hpp>
+
+using namespace ovxx;
+
+// Return op(a) as a new matrix.
+template <mat_op_type tr, typename T, typename B>
+Matrix<T> op(const_Matrix<T, B> a)
+{
+  bool const t = tr != mat_ntrans;
+  Matrix<T> r(t ? a.size(1) : a.size(0), t ? a.size(0) : a.size(1));
+  for (index_type i = 0; i != r.size(0); ++i)
+    for (index_type j = 0; j != r.size(1); ++j)
+    {
+      T v = t ? a.get(j, i) : a.get(i, j);
+      r.put(i, j, tr == mat_herm ? math::impl_conj(v) : v);
+    }
+  return r;
+}
+
+template <typename T>
+void randt(Tensor<T> t)
+{
+  for (index_type k = 0; k != t.size(0); ++k)
+    test::randm(t(k, whole_domain, whole_domain));
+}
+
+// Check op(A) X = B for problem `k` of a stack of problems.
+template <mat_op_type tr, typename T>
+void check(Tensor<T> a, Tensor<T> b, Tensor<T> x, index_type k)
+{
+  Matrix<T> chk(b.size(1), b.size(2));
+  chk = test::ref::prod(op<tr>(a(k, whole_domain, whole_domain)),
+			x(k, whole_domain, whole_domain));
+  test_assert(test::diff(chk, b(k, whole_domain, whole_domain)) < -80);
+}
+
+template <typename T, mat_op_type tr>
+void test_lud_solve(linalg::batch_lud<T> &lu, Tensor<T> a, length_type p)
+{
+  length_type const batch = a.size(0);
+  length_type const n = a.size(1);
+  Tensor<T> b(batch, n, p);
+  Tensor<T> x(batch, n, p);
+  randt(b);
+  test_assert(lu.template solve<tr>(b, x));
+  for (index_type k = 0; k != batch; ++k)
+    check<tr>(a, b, x, k);
+}
+
+template <typename T>
+void test_lud(length_type n, length_type batch)
+{
+  Tensor<T> a(batch, n, n);
+  randt(a);
+  // Make the problems diagonally dominant, with the dominant
+  // entries off the diagonal to force pivoting.
+  for (index_type k = 0; k != batch; ++k)
+    for (index_type i = 0; i != n; ++i)
+      a.put(k, (i + k) % n, i, a.get(k, (i + k) % n, i) + T(n));
+
+  linalg::batch_lud<T> lu(n, batch);
+  test_assert(lu.length() == n && lu.batch() == batch);
+  test_assert(lu.decompose(a));
+  test_lud_solve<T, mat_ntrans>(lu, a, 1);
+  test_lud_solve<T, mat_ntrans>(lu, a, 3);
+  test_lud_solve<T, mat_trans>(lu, a, 2);
+  if (is_complex<T>::value)
+    test_lud_solve<T, mat_herm>(lu, a, 2);
+
+  // The same problems, stacked in a matrix.
+  Matrix<T> as(batch * n, n);
+  for (index_type k = 0; k != batch; ++k)
+    as(Domain<2>(Domain<1>(k * n, 1, n), n)) = a(k, whole_domain, whole_domain);
+  Matrix<T> bs(batch * n, 2);
+  Matrix<T> xs(batch * n, 2);
+  test::randm(bs);
+  test_assert(lu.decompose(as));
+  test_assert(lu.template solve<mat_ntrans>(bs, xs));
+  for (index_type k = 0; k != batch; ++k)
+  {
+    Domain<2> dom(Domain<1>(k * n, 1, n), 2);
+    Matrix<T> chk(n, 2);
+    chk = test::ref::prod(a(k, whole_domain, whole_domain), xs(dom));
+    test_assert(test::diff(chk, bs(dom)) < -80);
+  }
+
+  // A singular problem doesn't affect the others.
+  if (n > 1)
+  {
+    index_type const bad = batch / 2;
+    a(bad, whole_domain, n - 1) = T(0);
+    test_assert(!lu.decompose(a));
+    Tensor<T> b(batch, n, 1);
+    Tensor<T> x(batch, n, 1);
+    randt(b);
+    lu.template solve<mat_ntrans>(b, x);
+    for (index_type k = 0; k != batch; ++k)
+    {
+      test_assert(lu.valid(k) == (k != bad));
+      if (k != bad) check<mat_ntrans>(a, b, x, k);
+    }
+  }
+}
+
+template <typename T>
+void test_chold(mat_uplo uplo, length_type n, length_type batch)
+{
+  // A = B B^H + n I is Hermitian positive definite.
+  Tensor<T> a(batch, n, n);
+  Tensor<T> t(batch, n, n);
+  for (index_type k = 0; k != batch; ++k)
+  {
+    Matrix<T> b(n, n);
+    test::randm(b);
+    Matrix<T> ak(n, n);
+    ak = test::ref::prod(b, op<mat_herm>(b));
+    ak.diag() += T(n);
+    a(k, whole_domain, whole_domain) = ak;
+    // The other triangle must not be referenced.
+    for (index_type i = 0; i != n; ++i)
+      for (index_type j = 0; j != n; ++j)
+	if (uplo == lower ? j > i : j < i) ak.put(i, j, T(-1000));
+    t(k, whole_domain, whole_domain) = ak;
+  }
+
+  linalg::batch_chold<T> ch(uplo, n, batch);
+  test_assert(ch.uplo() == uplo && ch.length() == n && ch.batch() == batch);
+  test_assert(ch.decompose(t));
+  Tensor<T> b(batch, n, 3);
+  Tensor<T> x(batch, n, 3);
+  randt(b);
+  test_assert(ch.solve(b, x));
+  for (index_type k = 0; k != batch; ++k)
+    check<mat_ntrans>(a, b, x, k);
+
+  // A problem that is not positive definite doesn't affect the others.
+  index_type const bad = batch - 1;
+  t(bad, 0, 0) = T(-1);
+  test_assert(!ch.decompose(t));
+  ch.solve(b, x);
+  for (index_type k = 0; k != batch; ++k)
+  {
+    test_assert(ch.valid(k) == (k != bad));
+    if (k != bad) check<mat_ntrans>(a, b, x, k);
+  }
+}
+
+template <typename T>
+void test_qrd(length_type m, length_type n, length_type batch)
+{
+  Tensor<T> a(batch, m, n);
+  randt(a);
+  // Keep the problems well-conditioned.
+  for (index_type k = 0; k != batch; ++k)
+    for (index_type i = 0; i != n; ++i)
+      a.put(k, (i + k) % m, i, a.get(k, (i + k) % m, i) + T(n));
+  // A^H A, and A^H applied to the right-hand sides below.
+  Tensor<T> aha(batch, n, n);
+  for (index_type k = 0; k != batch; ++k)
+    aha(k, whole_domain, whole_domain) =
+      test::ref::prod(op<mat_herm>(a(k, whole_domain, whole_domain)),
+		      a(k, whole_domain, whole_domain));
+
+  linalg::batch_qrd<T> qr(m, n, batch);
+  test_assert(qr.rows() == m && qr.columns() == n && qr.batch() == batch);
+  test_assert(qr.decompose(a));
+
+  // The least-squares solutions satisfy the normal equations.
+  Tensor<T> b(batch, m, 2);
+  Tensor<T> x(batch, n, 2);
+  Tensor<T> ahb(batch, n, 2);
+  randt(b);
+  for (index_type k = 0; k != batch; ++k)
+    ahb(k, whole_domain, whole_domain) =
+      test::ref::prod(op<mat_herm>(a(k, whole_domain, whole_domain)),
+		      b(k, whole_domain, whole_domain));
+  test_assert(qr.lsqsol(b, x));
+  for (index_type k = 0; k != batch; ++k)
+    check<mat_ntrans>(aha, ahb, x, k);
+
+  Tensor<T> c(batch, n, 3);
+  Tensor<T> y(batch, n, 3);
+  randt(c);
+  test_assert(qr.covsol(c, y));
+  for (index_type k = 0; k != batch; ++k)
+    check<mat_ntrans>(aha, c, y, k);
+
+  // The same problems, stacked in a matrix.
+  Matrix<T> as(batch * m, n);
+  Matrix<T> bs(batch * m, 2);
+  Matrix<T> xs(batch * n, 2);
+  for (index_type k = 0; k != batch; ++k)
+  {
+    as(Domain<2>(Domain<1>(k * m, 1, m), n)) = a(k, whole_domain, whole_domain);
+    bs(Domain<2>(Domain<1>(k * m, 1, m), 2)) = b(k, whole_domain, whole_domain);
+  }
+  test_assert(qr.decompose(as));
+  test_assert(qr.lsqsol(bs, xs));
+  for (index_type k = 0; k != batch; ++k)
+  {
+    Matrix<T> xk(n, 2);
+    xk = xs(Domain<2>(Domain<1>(k * n, 1, n), 2));
+    test_assert(test::diff(xk, x(k, whole_domain, whole_domain)) < -80);
+  }
+
+  Tensor<T> z(batch, n, 2);
+  linalg::batch_llsqsol(a, b, z);
+  for (index_type k = 0; k != batch; ++k)
+    check<mat_ntrans>(aha, ahb, z, k);
+
+  // A rank-deficient problem doesn't affect the others.
+  index_type const bad = batch / 2;
+  a(bad, whole_domain, n - 1) = T(0);
+  test_assert(!qr.decompose(a));
+  qr.lsqsol(b, x);
+  for (index_type k = 0; k != batch; ++k)
+  {
+    test_assert(qr.valid(k) == (k != bad));
+    if (k != bad) check<mat_ntrans>(aha, ahb, x, k);
+  }
+}
+
+template <typename T>
+void cases()
+{
+  test_lud<T>(1, 3);
+  test_lud<T>(4, 8);
+  test_lud<T>(16, 13);
+  test_lud<T>(33, 20);
+
+  test_chold<T>(lower, 1, 2);
+  test_chold<T>(upper, 5, 9);
+  test_chold<T>(lower, 16, 17);
+  test_chold<T>(upper, 40, 8);
+
+  test_qrd<T>(1, 1, 3);
+  test_qrd<T>(6, 4, 8);
+  test_qrd<T>(16, 16, 11);
+  test_qrd<T>(48, 20, 17);
+}
+
+void test_all()
+{
+  cases<float>();
+  cases<double>();
+  cases<complex<float> >();
+  cases<complex<double> >();
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  test_all();
+
+  // Process groups of problems in parallel.
+  test::with_threshold(linalg::threaded_prod_threshold(), 1,
+                       []() { test::with_pool(3, test_all);});
+}
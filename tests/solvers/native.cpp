@@ -0,0 +1,271 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for the built-in LU, Cholesky and QR backends.
+
+#include <vsip/initfin.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/math.hpp>
+#include <ovxx/linalg/lu.hpp>
+#include <ovxx/linalg/cholesky.hpp>
+#include <ovxx/linalg/qr.hpp>
+#include <test.hpp>
+#include <test/thread.hpp>
+#include <test/ref/matvec.hpp>
+
+using namespace ovxx;
+
+// Return op(a) as a new matrix.
+template <mat_op_type tr, typename T, typename B>
+Matrix<T> op(const_Matrix<T, B> a)
+{
+  bool const t = tr != mat_ntrans;
+  Matrix<T> r(t ? a.size(1) : a.size(0), t ? a.size(0) : a.size(1));
+  for (index_type i = 0; i != r.size(0); ++i)
+    for (index_type j = 0; j != r.size(1); ++j)
+    {
+      T v = t ? a.get(j, i) : a.get(i, j);
+      r.put(i, j, tr == mat_herm ? math::impl_conj(v) : v);
+    }
+  return r;
+}
+
+// Return a random, diagonally dominant n x n matrix.
+template <typename T>
+Matrix<T> random_matrix(length_type n)
+{
+  Matrix<T> a(n, n);
+  test::randm(a);
+  a.diag() += T(n);
+  return a;
+}
+
+template <typename T, mat_op_type tr>
+void test_lud_solve(linalg::lud<T> &lu, Matrix<T> a, length_type p)
+{
+  Matrix<T> b(a.size(0), p);
+  Matrix<T> x(a.size(0), p);
+  test::randm(b);
+  test_assert(lu.template solve<tr>(b, x));
+  Matrix<T> chk(a.size(0), p);
+  chk = test::ref::prod(op<tr>(a), x);
+  test_assert(test::diff(chk, b) < -80);
+}
+
+template <typename T>
+void test_lud(length_type n)
+{
+  Matrix<T> a = random_matrix<T>(n);
+  // Move the dominant entries off the diagonal to force pivoting.
+  Matrix<T> ap(n, n);
+  for (index_type i = 0; i != n; ++i)
+    ap.row(i) = a.row((i + 1) % n);
+
+  linalg::lud<T> lu(n);
+  test_assert(lu.decompose(ap));
+  test_lud_solve<T, mat_ntrans>(lu, ap, 1);
+  test_lud_solve<T, mat_ntrans>(lu, ap, 7);
+  test_lud_solve<T, mat_trans>(lu, ap, 3);
+  if (is_complex<T>::value)
+    test_lud_solve<T, mat_herm>(lu, ap, 3);
+
+  linalg::lud<T> copy(lu);
+  test_lud_solve<T, mat_ntrans>(copy, ap, 2);
+
+  // A singular matrix
+  if (n > 1)
+  {
+    ap.col(n - 1) = T(0);
+    test_assert(!lu.decompose(ap));
+  }
+}
+
+template <typename T>
+void test_chold(mat_uplo uplo, length_type n)
+{
+  // A = B B^H + n I is Hermitian positive definite.
+  Matrix<T> b(n, n);
+  test::randm(b);
+  Matrix<T> a(n, n);
+  a = test::ref::prod(b, op<mat_herm>(b));
+  a.diag() += T(n);
+  // The other triangle must not be referenced.
+  Matrix<T> t(n, n);
+  t = a;
+  for (index_type i = 0; i != n; ++i)
+    for (index_type j = 0; j != n; ++j)
+      if (uplo == lower ? j > i : j < i) t.put(i, j, T(-1000));
+
+  linalg::chold<T> ch(uplo, n);
+  test_assert(ch.uplo() == uplo && ch.length() == n);
+  test_assert(ch.decompose(t));
+  Matrix<T> r(n, 5);
+  Matrix<T> x(n, 5);
+  test::randm(r);
+  test_assert(ch.solve(r, x));
+  Matrix<T> chk(n, 5);
+  chk = test::ref::prod(a, x);
+  test_assert(test::diff(chk, r) < -80);
+
+  // A matrix that is not positive definite
+  a.diag() -= T(1000 * n);
+  test_assert(!ch.decompose(a));
+}
+
+// Compare `x` to op(b, Q) on side `ps`, with Q given explicitly.
+template <mat_op_type tr, product_side_type ps, typename T>
+void test_prodq(linalg::qrd<T> &qr, Matrix<T> q, length_type p)
+{
+  Matrix<T> oq = op<tr>(q);
+  length_type const rows = ps == mat_lside ? oq.size(1) : p;
+  length_type const cols = ps == mat_lside ? p : oq.size(0);
+  Matrix<T> b(rows, cols);
+  test::randm(b);
+  Matrix<T> x(ps == mat_lside ? oq.size(0) : p, ps == mat_lside ? p : oq.size(1));
+  test_assert((qr.template prodq<tr, ps>(b, x)));
+  Matrix<T> chk(x.size(0), x.size(1));
+  if (ps == mat_lside) chk = test::ref::prod(oq, b);
+  else chk = test::ref::prod(b, oq);
+  test_assert(test::diff(x, chk) < -80);
+}
+
+template <mat_op_type tr, typename T>
+void test_rsol(linalg::qrd<T> &qr, Matrix<T> r)
+{
+  length_type const n = r.size(0);
+  Matrix<T> b(n, 4);
+  Matrix<T> x(n, 4);
+  test::randm(b);
+  T const alpha(2);
+  test_assert(qr.template rsol<tr>(b, alpha, x));
+  Matrix<T> chk(n, 4);
+  chk = test::ref::prod(op<tr>(r), x);
+  b *= alpha;
+  test_assert(test::diff(chk, b) < -80);
+}
+
+template <typename T>
+void test_qrd(length_type m, length_type n)
+{
+  Matrix<T> a(m, n);
+  test::randm(a);
+  for (index_type i = 0; i != n; ++i) a.put(i, i, a.get(i, i) + T(m));
+
+  linalg::qrd<T> qr(m, n, qrd_saveq);
+  test_assert(qr.rows() == m && qr.columns() == n && qr.qstorage() == qrd_saveq);
+  test_assert(qr.decompose(a));
+
+  // Q, explicitly
+  Matrix<T> eye(m, m, T(0));
+  eye.diag() = T(1);
+  Matrix<T> q(m, m);
+  test_assert((qr.template prodq<mat_ntrans, mat_lside>(eye, q)));
+  Matrix<T> qhq(m, m);
+  qhq = test::ref::prod(op<mat_herm>(q), q);
+  test_assert(test::diff(qhq, eye) < -80);
+
+  // R = Q^H A is upper triangular.
+  Matrix<T> r(m, n);
+  test_assert((qr.template prodq<mat_herm, mat_lside>(a, r)));
+  Matrix<T> triu(m, n, T(0));
+  for (index_type j = 0; j != n; ++j)
+    for (index_type i = 0; i <= j; ++i) triu.put(i, j, r.get(i, j));
+  test_assert(test::diff(r, triu) < -80);
+  Matrix<T> qr_prod(m, n);
+  qr_prod = test::ref::prod(q, triu);
+  test_assert(test::diff(qr_prod, a) < -80);
+
+  test_prodq<mat_ntrans, mat_lside>(qr, q, 3);
+  test_prodq<mat_trans, mat_lside>(qr, q, 3);
+  test_prodq<mat_herm, mat_lside>(qr, q, 3);
+  test_prodq<mat_ntrans, mat_rside>(qr, q, 2);
+  test_prodq<mat_trans, mat_rside>(qr, q, 2);
+  test_prodq<mat_herm, mat_rside>(qr, q, 2);
+
+  Matrix<T> rn(n, n);
+  rn = triu(Domain<2>(n, n));
+  test_rsol<mat_ntrans>(qr, rn);
+  test_rsol<mat_trans>(qr, rn);
+  if (is_complex<T>::value)
+    test_rsol<mat_herm>(qr, rn);
+
+  // A^H A X = B
+  Matrix<T> b(n, 3);
+  Matrix<T> x(n, 3);
+  test::randm(b);
+  test_assert(qr.covsol(b, x));
+  Matrix<T> aha(n, n);
+  aha = test::ref::prod(op<mat_herm>(a), a);
+  Matrix<T> chk(n, 3);
+  chk = test::ref::prod(aha, x);
+  test_assert(test::diff(chk, b) < -80);
+
+  // Least squares: A^H A X = A^H B
+  Matrix<T> bl(m, 3);
+  test::randm(bl);
+  test_assert(qr.lsqsol(bl, x));
+  chk = test::ref::prod(aha, x);
+  Matrix<T> ahb(n, 3);
+  ahb = test::ref::prod(op<mat_herm>(a), bl);
+  test_assert(test::diff(chk, ahb) < -80);
+
+  // Skinny Q
+  linalg::qrd<T> qr1(m, n, qrd_saveq1);
+  test_assert(qr1.decompose(a));
+  Matrix<T> q1(m, n);
+  q1 = q(Domain<2>(m, n));
+  test_prodq<mat_ntrans, mat_lside>(qr1, q1, 3);
+  test_prodq<mat_herm, mat_lside>(qr1, q1, 3);
+  test_prodq<mat_trans, mat_rside>(qr1, q1, 2);
+  test_prodq<mat_ntrans, mat_rside>(qr1, q1, 2);
+
+  linalg::qrd<T> copy(qr);
+  test_rsol<mat_ntrans>(copy, rn);
+}
+
+template <typename T>
+void cases()
+{
+  test_lud<T>(1);
+  test_lud<T>(5);
+  test_lud<T>(32);
+  test_lud<T>(33);
+  test_lud<T>(100);
+
+  test_chold<T>(lower, 1);
+  test_chold<T>(upper, 1);
+  test_chold<T>(lower, 31);
+  test_chold<T>(upper, 31);
+  test_chold<T>(lower, 70);
+  test_chold<T>(upper, 100);
+
+  test_qrd<T>(1, 1);
+  test_qrd<T>(5, 3);
+  test_qrd<T>(40, 40);
+  test_qrd<T>(80, 33);
+  test_qrd<T>(100, 70);
+}
+
+void test_all()
+{
+  cases<float>();
+  cases<double>();
+  cases<complex<float> >();
+  cases<complex<double> >();
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  test_all();
+
+  // Update the trailing matrices in parallel.
+  test::with_threshold(linalg::threaded_prod_threshold(), 1,
+                       []() { test::with_pool(3, test_all);});
+}
@@ -16,7 +16,9 @@
 #include <vsip/random.hpp>
 #include <vsip/map.hpp>
 #include <vsip/parallel.hpp>
+#include <ovxx/linalg/toeplitz.hpp>
 #include <test.hpp>
+#include <test/thread.hpp>
 #include "common.hpp"
 
 #define VERBOSE  0
@@ -206,6 +208,59 @@ test_toepsol_dist(return_mechanism_type rtm,
 
 
 
+/// Test the batched solver over the rows of a matrix, against
+/// the solver for a single system.
+
+template <typename T,
+	  typename OrderT>
+void
+test_toepsol_batch(length_type rows,
+		   length_type size)
+{
+  typedef Dense<2, T, OrderT> block_type;
+
+  Matrix<T, block_type> a(rows, size, T());
+  Matrix<T, block_type> b(rows, size);
+  Matrix<T, block_type> y(rows, size);
+  Matrix<T, block_type> x(rows, size);
+
+  Rand<T> rand(1);
+  b = rand.randu(rows, size);
+  for (index_type r=0; r<rows; ++r)
+    for (index_type i=0; i<size; ++i)
+      a(r, i) = Toepsol_traits<T>::value(i) + T(r % 3);
+
+  linalg::batch_toepsol(a, b, y, x);
+
+  for (index_type r=0; r<rows; ++r)
+  {
+    Vector<T> yr(size);
+    Vector<T> xr(size);
+    toepsol(a.row(r), b.row(r), yr, xr);
+    test_assert(test::diff(x.row(r), xr) < -150);
+  }
+
+#if VSIP_HAS_EXCEPTIONS
+  // Specify a non positive-definite matrix in one of the rows.
+  a.row(rows - 1) = T();
+  a(rows - 1, 0) = T(1);
+  a(rows - 1, 1) = T(1);
+  int pass = 0;
+  try
+  {
+    linalg::batch_toepsol(a, b, y, x);
+  }
+  catch (const std::exception& error)
+  {
+    if (error.what() == std::string("TOEPSOL: not full rank"))
+      pass = 1;
+  }
+  test_assert(pass == 1);
+#endif
+}
+
+
+
 /// Test a non positive-definite toeplitz linear system.
 
 template <typename T>
@@ -266,6 +321,17 @@ toepsol_cases(return_mechanism_type rtm)
   test_toepsol_dist<float, Map<Block_dist> >(rtm, 4, 5);
 #endif
 }
+
+void
+toepsol_batch_cases()
+{
+  test_toepsol_batch<float, row2_type>           (5, 8);
+  test_toepsol_batch<complex<float>, col2_type>  (7, 33);
+#if VSIP_IMPL_TEST_DOUBLE
+  test_toepsol_batch<double, col2_type>          (3, 16);
+  test_toepsol_batch<complex<double>, row2_type> (9, 65);
+#endif
+}
   
 int
 main(int argc, char** argv)
@@ -277,4 +343,10 @@ main(int argc, char** argv)
 
   toepsol_cases(by_reference);
   toepsol_cases(by_value);
+
+  toepsol_batch_cases();
+
+  // Solve the rows in parallel.
+  test::with_threshold(linalg::threaded_prod_threshold(), 1,
+                       []() { test::with_pool(3, toepsol_batch_cases);});
 }
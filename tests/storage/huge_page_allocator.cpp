@@ -0,0 +1,201 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for the huge page allocator.
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <ovxx/huge_page_allocator.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <test.hpp>
+#include <algorithm>
+#include <vector>
+
+using namespace ovxx;
+
+#if OVXX_ENABLE_HUGE_PAGE_POOL
+
+bool is_aligned(void *ptr)
+{
+  return reinterpret_cast<size_t>(ptr) % huge_page_allocator::align == 0;
+}
+
+huge_page_allocator::parameters transparent(size_t size)
+{
+  huge_page_allocator::parameters p;
+  p.source = huge_page_allocator::transparent;
+  p.size = size;
+  return p;
+}
+
+void test_arena()
+{
+  huge_page_allocator a(transparent(1));
+  allocator &base = a;
+  test_assert(a.source() == huge_page_allocator::transparent);
+  test_assert(a.size() == a.page_size());
+  size_t const avail = a.total_avail();
+  test_assert(avail > 0 && avail <= a.size());
+
+  // Blocks of assorted sizes, each filled with its own index.
+  std::vector<int *> blocks;
+  std::vector<length_type> sizes;
+  for (index_type i = 0; i != 200; ++i)
+  {
+    length_type size = (i * 7919) % 2000;
+    int *ptr = base.allocate<int>(size);
+    test_assert(is_aligned(ptr));
+    std::fill(ptr, ptr + size, int(i));
+    blocks.push_back(ptr);
+    sizes.push_back(size);
+  }
+  test_assert(a.fallbacks() == 0);
+  test_assert(a.total_avail() < avail);
+
+  // Release every other block, then refill the holes.
+  for (index_type i = 0; i < blocks.size(); i += 2)
+    base.deallocate(blocks[i], sizes[i]);
+  for (index_type i = 0; i < blocks.size(); i += 2)
+  {
+    blocks[i] = base.allocate<int>(sizes[i]);
+    std::fill(blocks[i], blocks[i] + sizes[i], int(i));
+  }
+  for (index_type i = 0; i != blocks.size(); ++i)
+    for (index_type j = 0; j != sizes[i]; ++j)
+      test_assert(blocks[i][j] == int(i));
+
+  // Release in scrambled order. Neighbouring blocks are merged,
+  // so afterwards the whole arena is available as one block.
+  for (index_type i = 0; i != blocks.size(); ++i)
+  {
+    index_type k = (i * 83) % blocks.size();
+    base.deallocate(blocks[k], sizes[k]);
+  }
+  test_assert(a.total_avail() == avail);
+  char *all = base.allocate<char>(avail - 2 * sizeof(void *));
+  test_assert(a.fallbacks() == 0 && a.total_avail() == 0);
+
+  // Once the arena is exhausted, requests go to normal pages.
+  char *extra = base.allocate<char>(100);
+  test_assert(extra && is_aligned(extra) && a.fallbacks() == 1);
+  base.deallocate(extra, 100);
+  base.deallocate(all, avail - 2 * sizeof(void *));
+  test_assert(a.total_avail() == avail);
+}
+
+void test_sources()
+{
+  // Without reserved huge pages, anonymous mappings fall back
+  // to transparent huge pages.
+  huge_page_allocator::parameters p;
+  p.size = 1;
+  huge_page_allocator a(p);
+  test_assert(a.source() == huge_page_allocator::anonymous ||
+	      a.source() == huge_page_allocator::transparent);
+
+  p.source = huge_page_allocator::hugetlbfs;
+  p.file = "/nonexistent/ovxx/huge.bin";
+  huge_page_allocator b(p);
+  test_assert(b.source() == huge_page_allocator::transparent);
+
+  p.source = huge_page_allocator::none;
+  huge_page_allocator c(p);
+  test_assert(c.source() == huge_page_allocator::none && c.size() == 0);
+  allocator &base = c;
+  float *f = base.allocate<float>(10);
+  test_assert(is_aligned(f) && c.fallbacks() == 1);
+  base.deallocate(f, 10);
+
+#if OVXX_HAS_EXCEPTIONS
+  p.source = huge_page_allocator::transparent;
+  p.fallback = false;
+  huge_page_allocator d(p);
+  allocator &strict = d;
+  bool caught = false;
+  try { strict.allocate<char>(2 * d.size());}
+  catch (std::bad_alloc const &) { caught = true;}
+  test_assert(caught && d.fallbacks() == 0);
+
+  caught = false;
+  try { huge_page_allocator e("/nonexistent/ovxx/huge.bin", 1);}
+  catch (std::bad_alloc const &) { caught = true;}
+  test_assert(caught);
+#endif
+}
+
+// Threads allocating from, and releasing to, several arenas.
+void test_threads()
+{
+  huge_page_allocator::parameters p = transparent(4 << 20);
+  p.arenas = 3;
+  huge_page_allocator a(p);
+  allocator &base = a;
+  size_t const avail = a.total_avail();
+  thread_pool::parameters params;
+  params.threads = 3;
+  thread_pool pool(params);
+  length_type const n = 96;
+  std::vector<double *> blocks(n);
+  for (unsigned int round = 0; round != 3; ++round)
+  {
+    pool.parallel_for(n, [&](index_type i)
+    {
+      blocks[i] = base.allocate<double>(100 * (i + 1));
+      std::fill(blocks[i], blocks[i] + 100 * (i + 1), double(i));
+    });
+    pool.parallel_for(n, [&](index_type i)
+    {
+      index_type k = n - 1 - i;
+      test_assert(blocks[k][100 * k] == k);
+      base.deallocate(blocks[k], 100 * (k + 1));
+    });
+  }
+  test_assert(a.total_avail() == avail);
+}
+
+// The allocator as the default allocator for views.
+void test_default()
+{
+  huge_page_allocator a(transparent(1));
+  allocator *old = allocator::get_default();
+  allocator::set_default(&a);
+  size_t const avail = a.total_avail();
+  {
+    Vector<float> v(1000, 1.f);
+    Vector<complex<double> > w(1000, 2.);
+    test_assert(a.total_avail() < avail);
+    test_assert(v.get(999) == 1.f && w.get(0) == complex<double>(2.));
+  }
+  test_assert(a.total_avail() == avail);
+  allocator::set_default(old);
+}
+
+#endif
+
+int main(int argc, char **argv)
+{
+#if OVXX_ENABLE_HUGE_PAGE_POOL
+  // Select the huge page allocator on the command line.
+  std::vector<char *> args(argv, argv + argc);
+  char option[] = "--ovxx-allocator=huge";
+  args.push_back(option);
+  args.push_back(0);
+  int nargs = argc + 1;
+  char **pargs = &args[0];
+  vsipl library(nargs, pargs);
+  test_assert(nargs == argc);
+  test_assert(dynamic_cast<huge_page_allocator *>(allocator::get_default()));
+
+  test_arena();
+  test_sources();
+  test_threads();
+  test_default();
+#else
+  vsipl library(argc, argv);
+#endif
+}
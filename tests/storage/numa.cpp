@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for NUMA placement and the NUMA allocator.
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/selgen.hpp>
+#include <ovxx/numa_allocator.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <test.hpp>
+#include <vector>
+
+using namespace ovxx;
+
+bool valid_node(int node)
+{
+  return node == -1 || (node >= 0 && unsigned(node) < numa::nodes());
+}
+
+void test_policy(numa::policy_type policy)
+{
+  size_t const page = numa::page_size();
+  numa_allocator a(policy, 0, 4 * page);
+  allocator &base = a;
+  test_assert(a.policy() == policy);
+
+  // Small requests are served as usual.
+  float *small = base.allocate<float>(100);
+  test_assert(reinterpret_cast<size_t>(small) % numa_allocator::align == 0);
+  base.deallocate(small, 100);
+
+  // Large ones get pages of their own.
+  length_type const size = 10 * page / sizeof(double) + 3;
+  double *large = base.allocate<double>(size);
+  test_assert(reinterpret_cast<size_t>(large) % page == 0);
+  for (index_type i = 0; i != size; ++i) test_assert(large[i] == 0.);
+  for (index_type i = 0; i != size; ++i) large[i] = i;
+  for (index_type i = 0; i < size; i += page / sizeof(double))
+  {
+    test_assert(large[i] == i);
+    test_assert(valid_node(numa::node_of(large + i)));
+  }
+  // Moving the pages doesn't alter their content.
+  numa::migrate(large, size * sizeof(double), 0);
+  for (index_type i = 0; i != size; ++i) test_assert(large[i] == i);
+  base.deallocate(large, size);
+}
+
+void test_migrate()
+{
+  Vector<float> v(100000);
+  v = ramp(0.f, 1.f, v.size());
+  Matrix<complex<float> > m(300, 300, complex<float>(1.f, -1.f));
+  bool const moved = numa::migrate(v.block(), 0);
+  numa::migrate(m.block(), 0);
+  // On systems with a single node, the data is where it belongs.
+  if (numa::nodes() == 1) test_assert(moved);
+  test_assert(v.get(99999) == 99999.f);
+  test_assert(m.get(299, 299) == complex<float>(1.f, -1.f));
+}
+
+int main(int argc, char **argv)
+{
+  // Select first-touch placement on the command line.
+  std::vector<char *> args(argv, argv + argc);
+  char option[] = "--ovxx-allocator=first-touch";
+  char threads[] = "--ovxx-threads=3";
+  args.push_back(option);
+  args.push_back(threads);
+  args.push_back(0);
+  int nargs = argc + 2;
+  char **pargs = &args[0];
+  vsipl library(nargs, pargs);
+  test_assert(nargs == argc);
+  numa_allocator *numa_alloc = dynamic_cast<numa_allocator *>(allocator::get_default());
+  test_assert(numa_alloc && numa_alloc->policy() == numa::first_touch);
+
+  test_assert(numa::nodes() >= 1);
+  test_assert((numa::page_size() & (numa::page_size() - 1)) == 0);
+
+  test_policy(numa::local);
+  test_policy(numa::interleave);
+  test_policy(numa::bind);
+  test_policy(numa::first_touch);
+  test_migrate();
+
+  // Blocks allocated from within a parallel loop are touched serially.
+  thread_pool *pool = thread_pool::get_default();
+  if (pool)
+    pool->parallel_for(4, [](index_type i)
+    {
+      Vector<double> v(1 << 18, double(i));
+      test_assert(v.get((1 << 18) - 1) == double(i));
+    });
+}
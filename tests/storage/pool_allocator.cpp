@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for the pool allocator.
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <ovxx/pool_allocator.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <test.hpp>
+#include <vector>
+
+using namespace ovxx;
+
+bool is_aligned(void *ptr)
+{
+  return reinterpret_cast<size_t>(ptr) % pool_allocator::align == 0;
+}
+
+void test_reuse()
+{
+  pool_allocator a;
+  allocator &base = a;
+  pool_allocator::statistics s = a.stats();
+  test_assert(s.hits == 0 && s.misses == 0 && s.in_use == 0);
+
+  float *f = base.allocate<float>(100);
+  test_assert(is_aligned(f));
+  for (index_type i = 0; i != 100; ++i) f[i] = i;
+  s = a.stats();
+  test_assert(s.misses == 1 && s.in_use == 512);
+  base.deallocate(f, 100);
+  s = a.stats();
+  test_assert(s.in_use == 0 && s.cached == 512);
+
+  // A request of the same size class reuses the block.
+  char *c = base.allocate<char>(300);
+  test_assert(static_cast<void*>(c) == static_cast<void*>(f));
+  s = a.stats();
+  test_assert(s.hits == 1 && s.misses == 1 && s.cached == 0);
+  base.deallocate(c, 300);
+
+  // Zero-sized and tiny requests are served from the smallest class.
+  double *d0 = base.allocate<double>(0);
+  double *d1 = base.allocate<double>(1);
+  test_assert(d0 && d1 && d0 != d1 && is_aligned(d0) && is_aligned(d1));
+  test_assert(a.stats().in_use == 128);
+  base.deallocate(d0, 0);
+  base.deallocate(d1, 1);
+
+  // Fill a thread cache beyond its depth, so blocks
+  // spill to the shared lists.
+  std::vector<int *> blocks;
+  for (unsigned int i = 0; i != 3 * pool_allocator::cache_depth; ++i)
+    blocks.push_back(base.allocate<int>(1000));
+  size_t const peak = a.stats().in_use;
+  test_assert(peak == 3 * pool_allocator::cache_depth * 4096);
+  for (unsigned int i = 0; i != blocks.size(); ++i)
+    base.deallocate(blocks[i], 1000);
+  for (unsigned int i = 0; i != blocks.size(); ++i)
+  {
+    blocks[i] = base.allocate<int>(1000);
+    test_assert(is_aligned(blocks[i]));
+  }
+  s = a.stats();
+  test_assert(s.hits == 1 + blocks.size() && s.high_water_mark == peak);
+  for (unsigned int i = 0; i != blocks.size(); ++i)
+    base.deallocate(blocks[i], 1000);
+
+  // Requests beyond the largest class bypass the pool.
+  size_t const large = (size_t(1) << pool_allocator::max_class) + 1;
+  char *l = base.allocate<char>(large);
+  test_assert(is_aligned(l));
+  test_assert(a.stats().in_use == large);
+  base.deallocate(l, large);
+  s = a.stats();
+  test_assert(s.in_use == 0 && s.high_water_mark == large);
+
+  a.release();
+  test_assert(a.stats().cached == 0);
+}
+
+// Blocks allocated on one thread and freed on another.
+void test_threads()
+{
+  pool_allocator a;
+  allocator &base = a;
+  thread_pool::parameters params;
+  params.threads = 3;
+  thread_pool pool(params);
+  length_type const n = 64;
+  std::vector<double *> blocks(n);
+  for (unsigned int round = 0; round != 3; ++round)
+  {
+    pool.parallel_for(n, [&](index_type i)
+    {
+      blocks[i] = base.allocate<double>(16 << (i % 8));
+      for (index_type j = 0; j != length_type(16 << (i % 8)); ++j)
+	blocks[i][j] = i;
+    });
+    pool.parallel_for(n, [&](index_type i)
+    {
+      index_type k = n - 1 - i;
+      test_assert(blocks[k][0] == k);
+      base.deallocate(blocks[k], 16 << (k % 8));
+    });
+  }
+  pool_allocator::statistics s = a.stats();
+  test_assert(s.in_use == 0 && s.hits + s.misses == 3 * n && s.hits > 0);
+}
+
+// The pool as the default allocator for views.
+void test_default()
+{
+  pool_allocator a;
+  allocator *old = allocator::get_default();
+  allocator::set_default(&a);
+  {
+    Vector<float> v(1000, 1.f);
+    Vector<complex<double> > w(1000, 2.);
+    test_assert(a.stats().in_use == 4096 + 16384);
+    test_assert(v.get(999) == 1.f && w.get(0) == complex<double>(2.));
+  }
+  {
+    Vector<float> v(1000, 1.f);
+    test_assert(a.stats().hits == 1);
+  }
+  test_assert(a.stats().in_use == 0);
+  allocator::set_default(old);
+}
+
+int main(int argc, char **argv)
+{
+  // Select the pool allocator on the command line.
+  std::vector<char *> args(argv, argv + argc);
+  char option[] = "--ovxx-allocator=pool";
+  char threads[] = "--ovxx-threads=3";
+  args.push_back(option);
+  args.push_back(threads);
+  args.push_back(0);
+  int nargs = argc + 2;
+  char **pargs = &args[0];
+  vsipl library(nargs, pargs);
+  test_assert(nargs == argc);
+
+  pool_allocator *pool = dynamic_cast<pool_allocator *>(allocator::get_default());
+  test_assert(pool);
+  // Worker threads share the pool.
+  thread_pool *tp = thread_pool::get_default();
+  if (tp)
+  {
+    std::atomic<unsigned int> shared(0);
+    tp->parallel_for(tp->concurrency(), [&](index_type)
+    {
+      if (allocator::get_default() == pool) ++shared;
+    });
+    test_assert(shared == tp->concurrency());
+  }
+
+  test_reuse();
+  test_threads();
+  test_default();
+}
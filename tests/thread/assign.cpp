@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for the multi-threaded assignment evaluator.
+
+#include <vsip/initfin.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/tensor.hpp>
+#include <vsip/math.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <test.hpp>
+
+using namespace ovxx;
+
+template <typename T>
+void test_vector(length_type size)
+{
+  Vector<T> a(size), b(size), c(size), r(size);
+  for (index_type i = 0; i != size; ++i)
+  {
+    a.put(i, T(i % 17));
+    b.put(i, T(i % 5 + 1));
+    c.put(i, T(3));
+  }
+  r = a * b + c;
+  for (index_type i = 0; i != size; ++i)
+    test_assert(equal(r.get(i), a.get(i) * b.get(i) + c.get(i)));
+
+  r = ma(a, b, c) - T(1);
+  for (index_type i = 0; i != size; ++i)
+    test_assert(equal(r.get(i), a.get(i) * b.get(i) + c.get(i) - T(1)));
+
+  Domain<1> dom(1, 2, size / 2 - 1);
+  Vector<T> s(dom.size());
+  s = (a + b)(dom);
+  for (index_type i = 0; i != dom.size(); ++i)
+    test_assert(equal(s.get(i), a.get(1 + 2*i) + b.get(1 + 2*i)));
+
+  r(dom) = -a(dom);
+  for (index_type i = 0; i != dom.size(); ++i)
+    test_assert(equal(r.get(1 + 2*i), -a.get(1 + 2*i)));
+}
+
+template <typename T, typename O>
+void test_matrix(length_type rows, length_type cols)
+{
+  typedef Dense<2, T, O> block_type;
+  Matrix<T, block_type> a(rows, cols), r(rows, cols);
+  Vector<T> v(cols);
+  for (index_type i = 0; i != rows; ++i)
+    for (index_type j = 0; j != cols; ++j)
+      a.put(i, j, T(i * cols + j));
+  for (index_type j = 0; j != cols; ++j)
+    v.put(j, T(j % 7));
+
+  r = T(2) * a + a;
+  for (index_type i = 0; i != rows; ++i)
+    for (index_type j = 0; j != cols; ++j)
+      test_assert(equal(r.get(i, j), T(3) * a.get(i, j)));
+
+  r = vmmul<0>(v, a);
+  for (index_type i = 0; i != rows; ++i)
+    for (index_type j = 0; j != cols; ++j)
+      test_assert(equal(r.get(i, j), v.get(j) * a.get(i, j)));
+}
+
+/// Vectors may use 2-D blocks, which are assigned without splitting.
+template <typename T>
+void test_vector_of_matrix(length_type size)
+{
+  Matrix<T> am(size, 1), bm(size, 1), rm(size, 1);
+  Vector<T, Dense<2, T> > a(am.block()), b(bm.block()), r(rm.block());
+  for (index_type i = 0; i != size; ++i)
+  {
+    a.put(i, T(i % 17));
+    b.put(i, T(i % 5 + 1));
+  }
+  r = ma(a, b, b) + a;
+  for (index_type i = 0; i != size; ++i)
+    test_assert(equal(r.get(i), a.get(i) * b.get(i) + b.get(i) + a.get(i)));
+}
+
+template <typename T>
+void test_tensor(length_type size0, length_type size1, length_type size2)
+{
+  Tensor<T> a(size0, size1, size2), r(size0, size1, size2);
+  for (index_type i = 0; i != size0; ++i)
+    for (index_type j = 0; j != size1; ++j)
+      for (index_type k = 0; k != size2; ++k)
+	a.put(i, j, k, T(i + j + k));
+  r = a * a;
+  for (index_type i = 0; i != size0; ++i)
+    for (index_type j = 0; j != size1; ++j)
+      for (index_type k = 0; k != size2; ++k)
+	test_assert(equal(r.get(i, j, k), a.get(i, j, k) * a.get(i, j, k)));
+}
+
+void test_all()
+{
+  test_vector<float>(100000);
+  test_vector<complex<float> >(50000);
+  test_vector<int>(100003);
+  test_vector_of_matrix<float>(100000);
+  test_matrix<float, row2_type>(300, 257);
+  test_matrix<float, col2_type>(300, 257);
+  test_matrix<complex<double>, row2_type>(64, 1000);
+  test_tensor<float>(17, 40, 60);
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  // Run with whatever the library set up by default...
+  test_all();
+  // ...and with a pool of our own, to exercise the threaded evaluator
+  // even on single-core hosts.
+  thread_pool *default_pool = thread_pool::get_default();
+  thread_pool::parameters params;
+  params.threads = 4;
+  thread_pool pool(params);
+  thread_pool::set_default(&pool);
+  test_all();
+  // Split even tiny assignments.
+  assignment::threaded_threshold() = 1;
+  test_vector<float>(7);
+  thread_pool::set_default(default_pool);
+}
@@ -0,0 +1,201 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for the FFT thread count policy, and threaded Fftm.
+
+#include <vsip/initfin.hpp>
+#include <vsip/signal.hpp>
+#include <vsip/vector.hpp>
+#include <vsip/matrix.hpp>
+#include <vsip/math.hpp>
+#include <ovxx/signal/fft/util.hpp>
+#include <ovxx/signal/fft/threaded.hpp>
+#include <ovxx/numa.hpp>
+#include <test.hpp>
+
+using namespace ovxx;
+namespace fft = ovxx::signal::fft;
+
+void test_policy()
+{
+  thread_pool *default_pool = thread_pool::get_default();
+  thread_pool::parameters params;
+  params.threads = 4;
+  thread_pool pool(params);
+  thread_pool::set_default(&pool);
+
+  // Small transforms stay single-threaded...
+  test_assert(fft::planning_threads(1024) == 1);
+  test_assert(fft::planning_threads(2 * fft::points_per_thread) == 2);
+  // ...and large ones are limited by the pool.
+  test_assert(fft::planning_threads(64 * fft::points_per_thread) == 4);
+  {
+    fft::thread_request request(3);
+    test_assert(fft::planning_threads(1024) == 3);
+    {
+      fft::thread_request inner(0);
+      test_assert(fft::planning_threads(1024) == 1);
+    }
+    test_assert(fft::planning_threads(1024) == 3);
+  }
+  test_assert(fft::requested_threads() == 0);
+
+  thread_pool::set_default(0);
+  test_assert(fft::planning_threads(64 * fft::points_per_thread) == 1);
+  thread_pool::set_default(default_pool);
+}
+
+// The thread count must not change the result.
+void test_fft(length_type size, unsigned int threads)
+{
+  typedef Fft<const_Vector, complex<float>, complex<float>, fft_fwd, by_reference> fwd_type;
+  typedef Fft<const_Vector, complex<float>, complex<float>, fft_inv, by_reference> inv_type;
+  fwd_type fwd(Domain<1>(size), 1.f, threads);
+  inv_type inv(Domain<1>(size), 1.f / size, threads);
+  fwd_type ref(Domain<1>(size), 1.f);
+
+  Vector<complex<float> > in(size), out(size), expected(size), back(size);
+  for (index_type i = 0; i != size; ++i)
+    in.put(i, complex<float>(i % 7, -float(i % 3)));
+  fwd(in, out);
+  ref(in, expected);
+  inv(out, back);
+  for (index_type i = 0; i != size; ++i)
+  {
+    test_assert(equal(out.get(i), expected.get(i)));
+    test_assert(equal(back.get(i), in.get(i)));
+  }
+}
+
+void test_fftm(length_type rows, length_type cols, unsigned int threads)
+{
+  typedef Fftm<complex<float>, complex<float>, row, fft_fwd, by_reference> fwd_type;
+  typedef Fftm<complex<float>, complex<float>, row, fft_inv, by_reference> inv_type;
+  fwd_type fwd(Domain<2>(rows, cols), 1.f, threads);
+  inv_type inv(Domain<2>(rows, cols), 1.f / cols, threads);
+
+  Matrix<complex<float> > in(rows, cols), out(rows, cols), back(rows, cols);
+  for (index_type r = 0; r != rows; ++r)
+    for (index_type c = 0; c != cols; ++c)
+      in.put(r, c, complex<float>(float(r + c % 5), 1.f));
+  fwd(in, out);
+  inv(out, back);
+  for (index_type r = 0; r != rows; ++r)
+    for (index_type c = 0; c != cols; ++c)
+      test_assert(equal(back.get(r, c), in.get(r, c)));
+}
+
+// Make a pool with the given number of threads the default one.
+class scoped_pool
+{
+public:
+  scoped_pool(unsigned int threads)
+    : default_(thread_pool::get_default()), pool_(parameters(threads))
+  { thread_pool::set_default(&pool_);}
+  ~scoped_pool() { thread_pool::set_default(default_);}
+
+private:
+  static thread_pool::parameters parameters(unsigned int threads)
+  {
+    thread_pool::parameters params;
+    params.threads = threads;
+    return params;
+  }
+  thread_pool *default_;
+  thread_pool pool_;
+};
+
+void test_batch_size()
+{
+  // Transforms that fit into a page are batched by whole pages...
+  length_type const per_page = numa::page_size() / 256;
+  length_type batch = fft::batch_size(100 * per_page, 256, 3);
+  test_assert(batch % per_page == 0 && 3 * batch >= 100 * per_page);
+  test_assert(2 * batch < 100 * per_page);
+  // ...other ones by transforms.
+  test_assert(fft::batch_size(100, 192, 3) == 34);
+  test_assert(fft::batch_size(5, 1 << 20, 4) == 2);
+}
+
+// Run a threaded Fftm over a matrix with the given layout,
+// and compare it to a single-threaded one.
+template <typename I, typename O, int A, int D>
+void test_fftm_batches(length_type rows, length_type cols, unsigned int threads)
+{
+  typedef dispatcher::op::fftm<I, O, A, D, by_reference, 0> operation_type;
+  typedef typename dispatcher::List<operation_type>::type list_type;
+  typedef fft::fftm_backend<I, O, A, D> backend_type;
+  typedef dispatcher::Dispatcher<
+    operation_type,
+    std::unique_ptr<backend_type>(Domain<2> const &, typename scalar_of<I>::type),
+    list_type> dispatcher_type;
+  typedef fft::threaded_fftm<I, O, A, D> threaded_type;
+  typedef Fftm<I, O, A, D, by_reference> fftm_type;
+
+  scoped_pool pool(threads);
+  Domain<2> dom(rows, cols);
+  // The transforms are split into batches, each with its own backend.
+  std::unique_ptr<backend_type> backend =
+    fft::create_fftm<I, O, A, D, dispatcher_type>(dom, 1.f, threads);
+  test_assert(dynamic_cast<threaded_type*>(backend.get()));
+  backend = fft::create_fftm<I, O, A, D, dispatcher_type>(dom, 1.f, 1);
+  test_assert(!dynamic_cast<threaded_type*>(backend.get()));
+
+  fftm_type threaded(dom, 1.f, threads);
+  fftm_type single(dom, 1.f, 1);
+  Matrix<I> in(threaded.input_size()[0].size(), threaded.input_size()[1].size());
+  Matrix<O> out(threaded.output_size()[0].size(), threaded.output_size()[1].size());
+  Matrix<O> expected(out.size(0), out.size(1));
+  for (index_type r = 0; r != in.size(0); ++r)
+    for (index_type c = 0; c != in.size(1); ++c)
+      in.put(r, c, I(float(r % 7) - float(c % 5)));
+  threaded(in, out);
+  single(in, expected);
+  test_assert(alltrue(out == expected));
+}
+
+template <int A, typename O>
+void test_fftm_in_place(length_type rows, length_type cols, unsigned int threads)
+{
+  typedef Fftm<complex<float>, complex<float>, A, fft_fwd, by_reference> fftm_type;
+  scoped_pool pool(threads);
+  fftm_type threaded(Domain<2>(rows, cols), 1.f, threads);
+  fftm_type single(Domain<2>(rows, cols), 1.f, 1);
+  Matrix<complex<float>, Dense<2, complex<float>, O> > a(rows, cols), b(rows, cols);
+  for (index_type r = 0; r != rows; ++r)
+    for (index_type c = 0; c != cols; ++c)
+      a.put(r, c, complex<float>(float(r % 3), float(c % 11)));
+  b = a;
+  threaded(a);
+  single(b);
+  test_assert(alltrue(a == b));
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  test_policy();
+  test_fft(64, 0);
+  test_fft(64, 2);
+  test_fft(256, 4);
+  test_fftm(8, 32, 0);
+  test_fftm(8, 32, 3);
+
+  test_batch_size();
+  typedef complex<float> C;
+  test_fftm_batches<C, C, row, fft_fwd>(100, 32, 3);
+  test_fftm_batches<C, C, col, fft_inv>(24, 77, 4);
+  test_fftm_batches<float, C, row, fft_fwd>(61, 24, 2);
+  test_fftm_batches<float, C, col, fft_fwd>(16, 200, 3);
+  test_fftm_batches<C, float, row, fft_inv>(50, 16, 3);
+  test_fftm_batches<C, float, col, fft_inv>(12, 33, 4);
+  test_fftm_in_place<row, row2_type>(70, 16, 3);
+  test_fftm_in_place<col, row2_type>(16, 70, 3);
+  test_fftm_in_place<col, col2_type>(20, 35, 2);
+}
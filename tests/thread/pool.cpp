@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Unit tests for the library's thread pool.
+
+#include <vsip/initfin.hpp>
+#include <ovxx/thread_pool.hpp>
+#include <test.hpp>
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#if defined(__linux__)
+# include <sched.h>
+#endif
+
+using namespace ovxx;
+
+void test_options()
+{
+  char const *args[] = {"program", "--ovxx-threads=3", "-v",
+			"--ovxx-affinity=scatter", "file", 0};
+  int argc = 5;
+  char **argv = const_cast<char **>(args);
+  thread_pool::parameters p;
+  thread_pool::parse_options(argc, argv, p);
+  test_assert(p.threads == 3);
+  test_assert(p.affinity == thread_pool::scatter);
+  test_assert(argc == 3);
+  test_assert(!std::strcmp(argv[1], "-v"));
+  test_assert(!std::strcmp(argv[2], "file"));
+  test_assert(argv[3] == 0);
+}
+
+void test_pool(thread_pool::parameters const &p)
+{
+  thread_pool pool(p);
+  test_assert(pool.concurrency() == p.threads);
+  test_assert(pool.nodes() >= 1);
+
+#if defined(__linux__)
+  cpu_set_t before;
+  CPU_ZERO(&before);
+  test_assert(sched_getaffinity(0, sizeof(before), &before) == 0);
+#endif
+  std::thread::id const caller = std::this_thread::get_id();
+  bool caller_bound = true;
+
+  // Unbalanced work forces threads to steal from each other.
+  length_type const size = 1000;
+  std::vector<int> counts(size, 0);
+  std::vector<double> results(size, 0.);
+  pool.parallel_for(size, [&](index_type i)
+  {
+#if defined(__linux__)
+    // While running its part of the loop, the calling thread is
+    // bound to a CPU, too.
+    if (p.affinity != thread_pool::none && p.threads > 1 &&
+	std::this_thread::get_id() == caller)
+    {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      if (sched_getaffinity(0, sizeof(set), &set) || CPU_COUNT(&set) != 1)
+	caller_bound = false;
+    }
+#endif
+    double sum = 0.;
+    for (index_type j = 0; j < (i < size / 8 ? 20000 : 10); ++j)
+      sum += j;
+    results[i] = sum;
+    ++counts[i];
+  });
+  for (index_type i = 0; i != size; ++i)
+    test_assert(counts[i] == 1);
+  test_assert(caller_bound);
+
+#if defined(__linux__)
+  // Afterwards, its affinity is restored.
+  cpu_set_t after;
+  CPU_ZERO(&after);
+  test_assert(sched_getaffinity(0, sizeof(after), &after) == 0);
+  test_assert(CPU_EQUAL(&before, &after));
+#endif
+
+  // Nested loops run serially within the calling task.
+  std::vector<int> nested(16 * 16, 0);
+  pool.parallel_for(16, [&](index_type i)
+  {
+    test_assert(thread_pool::in_parallel_region());
+    pool.parallel_for(16, [&](index_type j) { ++nested[i * 16 + j];});
+  });
+  for (index_type i = 0; i != nested.size(); ++i)
+    test_assert(nested[i] == 1);
+  test_assert(!thread_pool::in_parallel_region());
+
+#if OVXX_HAS_EXCEPTIONS
+  bool caught = false;
+  try
+  {
+    pool.parallel_for(100, [](index_type i)
+    { if (i == 57) throw std::runtime_error("task failed");});
+  }
+  catch (std::runtime_error const &) { caught = true;}
+  test_assert(caught);
+  test_assert(!thread_pool::in_parallel_region());
+#endif
+}
+
+int main(int argc, char **argv)
+{
+  thread_pool::parameters params;
+  params.threads = 2;
+  ovxx::library library(argc, argv, params);
+
+#if OVXX_ENABLE_THREADING
+  test_assert(thread_pool::get_default());
+  test_assert(thread_pool::get_default()->concurrency() == 2);
+#endif
+
+  test_options();
+  thread_pool::parameters p;
+  p.threads = 1;
+  test_pool(p);
+  p.threads = 4;
+  test_pool(p);
+  p.affinity = thread_pool::compact;
+  test_pool(p);
+  p.affinity = thread_pool::scatter;
+  p.threads = 7;
+  test_pool(p);
+}
@@ -0,0 +1,222 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Tests for threaded reductions, whose results must not depend
+///   on the number of threads.
+
+#include <vsip/initfin.hpp>
+#include <vsip/math.hpp>
+#include <vsip/random.hpp>
+#include <vsip/signal.hpp>
+#include <ovxx/reductions/reductions.hpp>
+#include <test.hpp>
+#include <test/thread.hpp>
+#include <vector>
+
+using namespace ovxx;
+
+template <typename T>
+struct results
+{
+  typedef typename scalar_of<T>::type scalar_type;
+  T sum, mean, sumsq, meansq_t;
+  scalar_type meansq;
+  std::vector<scalar_type> extrema;
+  std::vector<Index<1> > indices;
+
+  template <typename V>
+  explicit results(V v)
+    : sum(sumval(v)), mean(meanval(v)), sumsq(sumsqval(v)), meansq(meansqval(v))
+  {
+    Index<1> idx;
+    extrema.push_back(maxmgval(v, idx)); indices.push_back(idx);
+    extrema.push_back(minmgval(v, idx)); indices.push_back(idx);
+    extrema.push_back(reduce_idx<Max_magsq_value>(v, idx)); indices.push_back(idx);
+    extrema.push_back(reduce_idx<Min_magsq_value>(v, idx)); indices.push_back(idx);
+  }
+  bool operator==(results const &o) const
+  {
+    return sum == o.sum && mean == o.mean && sumsq == o.sumsq &&
+      meansq == o.meansq && extrema == o.extrema && indices == o.indices;
+  }
+};
+
+// Run `f` without a thread pool, and with pools of various sizes,
+// returning the results of all runs.
+template <typename R, typename F>
+std::vector<R> with_threads(F f)
+{
+  std::vector<R> r;
+  for (unsigned int threads : {0, 2, 3, 4})
+    test::with_pool(threads, [&]() { r.push_back(f());});
+  return r;
+}
+
+template <typename T>
+void test_vector(length_type size)
+{
+  Rand<T> rand(size);
+  Vector<T> v(size);
+  v = rand.randu(size) - T(0.5);
+  std::vector<results<T> > r = with_threads<results<T> >([&]() { return results<T>(v);});
+  for (index_type i = 1; i != r.size(); ++i)
+    test_assert(r[i] == r[0]);
+
+  // The threaded backend is used.
+  reduction::reader<typename Vector<T>::block_type> in(v.block());
+  test_assert(r[0].sum == reduction::sum<Sum_value>(in));
+
+  // Compare against a more accurate summation.
+  complex<double> ref = 0.;
+  for (index_type i = 0; i != size; ++i) ref += complex<double>(v.get(i));
+  test_assert(std::abs(complex<double>(r[0].sum) - ref) < 1e-4 * std::sqrt(double(size)));
+}
+
+void test_vector_idx(length_type size)
+{
+  Vector<float> v(size, 1.f);
+  // Ties resolve to the first occurrence, also across chunk boundaries.
+  index_type const a = reduction::chunk_size - 1;
+  index_type const b = size - 3;
+  v.put(a, 5.f);
+  v.put(a + 1, 5.f);
+  v.put(b, 5.f);
+  v.put(a + 2, -5.f);
+  v.put(b - 1, -5.f);
+  v.put(7, 0.5f);
+  v.put(b + 1, 0.5f);
+  auto run = [&]()
+  {
+    std::vector<index_type> r;
+    Index<1> idx;
+    test_assert(maxval(v, idx) == 5.f); r.push_back(idx[0]);
+    test_assert(minval(v, idx) == -5.f); r.push_back(idx[0]);
+    test_assert(maxmgval(v, idx) == 5.f); r.push_back(idx[0]);
+    test_assert(minmgval(v, idx) == 0.5f); r.push_back(idx[0]);
+    return r;
+  };
+  std::vector<std::vector<index_type> > r = with_threads<std::vector<index_type> >(run);
+  for (index_type i = 0; i != r.size(); ++i)
+  {
+    test_assert(r[i][0] == a && r[i][1] == a + 2 && r[i][2] == a && r[i][3] == 7);
+  }
+  // The first element is the extremum.
+  v.put(0, 10.f);
+  Index<1> idx;
+  test_assert(maxval(v, idx) == 10.f && idx[0] == 0);
+}
+
+template <typename O>
+void test_matrix(length_type rows, length_type cols)
+{
+  Matrix<float, Dense<2, float, O> > m(rows, cols);
+  Rand<float> rand(rows);
+  m = rand.randu(rows, cols);
+  m.put(rows / 2, cols - 1, 3.f);
+  m.put(rows - 1, cols / 3, 3.f);
+  auto run = [&]()
+  {
+    std::vector<float> r;
+    r.push_back(sumval(m));
+    r.push_back(meansqval(m));
+    Index<2> idx;
+    r.push_back(maxval(m, idx));
+    r.push_back(idx[0]);
+    r.push_back(idx[1]);
+    // A subview that isn't dense.
+    r.push_back(sumval(m(Domain<2>(rows, cols - 1))));
+    return r;
+  };
+  std::vector<std::vector<float> > r = with_threads<std::vector<float> >(run);
+  for (index_type i = 1; i != r.size(); ++i)
+    test_assert(r[i] == r[0]);
+  // The maximum comes first in storage order.
+  bool const row_major = is_same<O, row2_type>::value;
+  test_assert(r[0][2] == 3.f);
+  test_assert(r[0][3] == (row_major ? rows / 2 : rows - 1));
+  test_assert(r[0][4] == (row_major ? cols - 1 : cols / 3));
+
+  double ref = 0., sub = 0.;
+  for (index_type i = 0; i != rows; ++i)
+    for (index_type j = 0; j != cols; ++j)
+    {
+      ref += m.get(i, j);
+      if (j != cols - 1) sub += m.get(i, j);
+    }
+  test_assert(std::abs(r[0][0] - ref) < 1e-3 * ref);
+  test_assert(std::abs(r[0][5] - sub) < 1e-3 * sub);
+}
+
+void test_tensor(length_type n0, length_type n1, length_type n2)
+{
+  Tensor<double, Dense<3, double, tuple<2, 0, 1> > > t(n0, n1, n2, 1.);
+  t.put(n0 - 1, 1, n2 - 2, 2.);
+  auto run = [&]()
+  {
+    Index<3> idx;
+    double m = maxval(t, idx);
+    test_assert(m == 2. && idx == Index<3>(n0 - 1, 1, n2 - 2));
+    return sumval(t);
+  };
+  std::vector<double> r = with_threads<double>(run);
+  for (index_type i = 0; i != r.size(); ++i)
+    test_assert(r[i] == n0 * n1 * n2 + 1.);
+}
+
+/// Non-elementwise expressions (here freqswap) are evaluated before
+/// the workers read them.
+void test_nonelementwise(length_type size)
+{
+  Vector<float> v(size);
+  float expected = 0.f;
+  for (index_type i = 0; i != size; ++i)
+  {
+    v.put(i, float(i % 5));
+    expected += float(i % 5);
+  }
+  v.put(size / 4, 10.f);
+  expected += 10.f - float(size / 4 % 5);
+  auto run = [&]()
+  {
+    std::vector<float> r;
+    r.push_back(sumval(freqswap(v)));
+    Index<1> idx;
+    r.push_back(maxval(freqswap(v), idx));
+    r.push_back(idx[0]);
+    return r;
+  };
+  std::vector<std::vector<float> > r = with_threads<std::vector<float> >(run);
+  for (index_type i = 0; i != r.size(); ++i)
+  {
+    test_assert(r[i][0] == expected);
+    test_assert(r[i][1] == 10.f);
+    test_assert(r[i][2] == size / 4 + size / 2);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  reduction::threaded_threshold() = 1;
+  test_vector<float>(100);
+  test_vector<float>(1000003);
+  test_vector<double>(65536);
+  test_vector<complex<float> >(250001);
+  test_vector_idx(50000);
+  test_matrix<row2_type>(301, 257);
+  test_matrix<col2_type>(301, 257);
+  test_tensor(30, 40, 50);
+  test_nonelementwise(1 << 20);
+
+  // Expressions are summed by chunks, too.
+  Vector<float> a(100000, 2.f), b(100000, 0.5f);
+  std::vector<float> r = with_threads<float>([&]() { return sumval(a * b);});
+  for (index_type i = 0; i != r.size(); ++i)
+    test_assert(r[i] == 100000.f);
+}
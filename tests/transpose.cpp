@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2014 Stefan Seefeld
+// All rights reserved.
+//
+// This file is part of OpenVSIP. It is made available under the
+// license contained in the accompanying LICENSE.GPL file.
+
+/// Description
+///   Tests for the tiled and threaded transpose evaluator, out of place
+///   and in place, with and without thread pools.
+
+#include <vsip/initfin.hpp>
+#include <vsip/support.hpp>
+#include <vsip/matrix.hpp>
+#include <test.hpp>
+#include <test/thread.hpp>
+
+using namespace ovxx;
+
+// Run `f` without a thread pool, and with a pool of three threads.
+template <typename F>
+void with_threads(F f)
+{
+  test::with_pool(0, f);
+  test::with_pool(3, f);
+}
+
+template <typename T>
+T value(index_type r, index_type c) { return T(1000 * r + c);}
+
+template <typename T, typename LB, typename RB>
+void test_blocks(length_type rows, length_type cols)
+{
+  Matrix<T, RB> src(rows, cols);
+  for (index_type r = 0; r != rows; ++r)
+    for (index_type c = 0; c != cols; ++c)
+      src.put(r, c, value<T>(r, c));
+  Matrix<T, LB> dst(rows, cols, T(-1));
+  dst = src;
+  for (index_type r = 0; r != rows; ++r)
+    for (index_type c = 0; c != cols; ++c)
+      test_assert(dst.get(r, c) == value<T>(r, c));
+
+  // Transposed views of blocks with the same dimension-ordering.
+  Matrix<T, RB> dst_t(cols, rows, T(-1));
+  dst_t = src.transpose();
+  for (index_type r = 0; r != rows; ++r)
+    for (index_type c = 0; c != cols; ++c)
+      test_assert(dst_t.get(c, r) == value<T>(r, c));
+
+  // Subviews with non-unit strides.
+  Domain<2> dom(Domain<1>(0, 2, rows / 2), Domain<1>(1, 1, cols - 1));
+  Matrix<T, LB> sub(rows / 2, cols - 1, T(-1));
+  sub = src(dom);
+  for (index_type r = 0; r != rows / 2; ++r)
+    for (index_type c = 0; c != cols - 1; ++c)
+      test_assert(sub.get(r, c) == value<T>(2 * r, c + 1));
+}
+
+template <typename T, typename O1, typename O2>
+void test_assign(length_type rows, length_type cols)
+{
+  typedef Dense<2, T, O1> lhs_type;
+  typedef Dense<2, T, O2> rhs_type;
+  test_blocks<T, lhs_type, rhs_type>(rows, cols);
+}
+
+void test_split(length_type rows, length_type cols)
+{
+  typedef complex<float> T;
+  typedef Strided<2, T, Layout<2, row2_type, dense, split_complex> > row_type;
+  typedef Strided<2, T, Layout<2, col2_type, dense, split_complex> > col_type;
+  test_blocks<T, row_type, col_type>(rows, cols);
+  test_blocks<T, col_type, row_type>(rows, cols);
+}
+
+template <typename T>
+void test_square_in_place(length_type size)
+{
+  Matrix<T> m(size, size);
+  for (index_type r = 0; r != size; ++r)
+    for (index_type c = 0; c != size; ++c)
+      m.put(r, c, value<T>(r, c));
+  m = m.transpose();
+  for (index_type r = 0; r != size; ++r)
+    for (index_type c = 0; c != size; ++c)
+      test_assert(m.get(r, c) == value<T>(c, r));
+}
+
+// Non-square blocks of different dimension-ordering sharing storage.
+template <typename T, typename O1, typename O2>
+void test_in_place(length_type rows, length_type cols)
+{
+  std::vector<T> data(rows * cols);
+  Dense<2, T, O1> lhs_block(Domain<2>(rows, cols), &data.front());
+  Dense<2, T, O2> rhs_block(Domain<2>(rows, cols), &data.front());
+  lhs_block.admit(false);
+  rhs_block.admit(false);
+  Matrix<T, Dense<2, T, O1> > lhs(lhs_block);
+  Matrix<T, Dense<2, T, O2> > rhs(rhs_block);
+  for (index_type r = 0; r != rows; ++r)
+    for (index_type c = 0; c != cols; ++c)
+      rhs.put(r, c, value<T>(r, c));
+  lhs = rhs;
+  for (index_type r = 0; r != rows; ++r)
+    for (index_type c = 0; c != cols; ++c)
+      test_assert(lhs.get(r, c) == value<T>(r, c));
+  rhs_block.release(false);
+  lhs_block.release(false);
+}
+
+int main(int argc, char **argv)
+{
+  vsipl library(argc, argv);
+
+  assignment::threaded_threshold() = 1;
+  with_threads([]()
+  {
+    length_type const sizes[][2] = { {1, 1}, {3, 5}, {8, 8}, {31, 33}, {64, 200}, {257, 129}};
+    for (auto const &s : sizes)
+    {
+      length_type const rows = std::max<length_type>(s[0], 2);
+      length_type const cols = std::max<length_type>(s[1], 2);
+      test_assign<float, col2_type, row2_type>(rows, cols);
+      test_assign<float, row2_type, col2_type>(rows, cols);
+      test_assign<double, col2_type, row2_type>(rows, cols);
+      test_assign<complex<float>, row2_type, col2_type>(rows, cols);
+      test_assign<complex<double>, col2_type, row2_type>(rows, cols);
+      test_split(rows, cols);
+
+      test_in_place<float, col2_type, row2_type>(s[0], s[1]);
+      test_in_place<float, row2_type, col2_type>(s[0], s[1]);
+      test_in_place<complex<float>, col2_type, row2_type>(s[1], s[0]);
+    }
+    test_square_in_place<float>(1);
+    test_square_in_place<float>(67);
+    test_square_in_place<complex<float> >(200);
+  });
+}
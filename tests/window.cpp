@@ -148,5 +148,25 @@ main(int argc, char** argv)
       test_assert( equal( v.get(n), testvec_kaiser[n] ) );
   }
 
+  // Windows are computed once, and shared thereafter.
+  {
+    const_Vector<scalar_f> k1 = kaiser(24, 3.5);
+    const_Vector<scalar_f> k2 = kaiser(24, 3.5);
+    test_assert(&k1.block() == &k2.block());
+    test_assert(&kaiser(24, 4.f).block() != &k1.block());
+    test_assert(&hanning(24).block() != &blackman(24).block());
+
+    const_Vector<double> h = signal::cached_window<double>(signal::hanning_window, 24);
+    test_assert(&h.block() ==
+		&signal::cached_window<double>(signal::hanning_window, 24, 1.).block());
+    for (index_type n = 0; n < 24; ++n)
+      test_assert(equal(static_cast<scalar_f>(h.get(n)), testvec_hanning[n]));
+
+    // Copies are independent of the cached window.
+    Vector<scalar_f> v = kaiser(24, 3.5);
+    v = 0.f;
+    test_assert(equal(kaiser(24, 3.5).get(0), testvec_kaiser[0]));
+  }
+
   return EXIT_SUCCESS;
 }